@@ -0,0 +1,462 @@
+/**
+ *  Microbenchmarks of storage operations compared with equivalent hand-written sqlite3 C API code.
+ *  Every case is run over in-memory and file databases. Reported time is a median of repetitions
+ *  per single operation. `ratio` is ORM time divided by raw sqlite3 time: 1.00 means no overhead.
+ *
+ *  Usage: benchmarks [filter] [--repetitions N] [--scale N]
+ *  filter - runs only cases which names contain it
+ *  --repetitions - how many times every case is repeated (default 7)
+ *  --scale - multiplies operations count of every case (default 1)
+ *
+ *  Build in Release mode for meaningful numbers.
+ */
+
+#include <sqlite_orm/sqlite_orm.h>
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+#include <functional>
+#include <system_error>
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
+
+using namespace sqlite_orm;
+using std::cout;
+using std::endl;
+
+struct User {
+    int id;
+    std::string name;
+    int age;
+    double score;
+};
+
+/**
+ *  Rows count every case starts with
+ */
+static const int initialRowsCount = 1000;
+
+static int repetitions = 7;
+static int scale = 1;
+
+inline auto make_benchmark_storage(const std::string &filename) {
+    return make_storage(filename,
+                        make_table("users",
+                                   make_column("id", &User::id, primary_key()),
+                                   make_column("name", &User::name),
+                                   make_column("age", &User::age),
+                                   make_column("score", &User::score)));
+}
+
+using Storage = decltype(make_benchmark_storage(""));
+
+User make_user(int i) {
+    return {0, "user" + std::to_string(i), i % 80, i * 0.5};
+}
+
+/**
+ *  Hand-written sqlite3 counterpart of the storage.
+ */
+struct raw_database {
+    sqlite3 *db = nullptr;
+    
+    raw_database(const std::string &filename) {
+        if(sqlite3_open(filename.c_str(), &this->db) != SQLITE_OK) {
+            throw std::system_error(std::error_code(sqlite3_errcode(this->db), get_sqlite_error_category()));
+        }
+    }
+    
+    raw_database(const raw_database &) = delete;
+    
+    ~raw_database() {
+        sqlite3_close(this->db);
+    }
+    
+    void exec(const char *query) {
+        if(sqlite3_exec(this->db, query, nullptr, nullptr, nullptr) != SQLITE_OK) {
+            throw std::system_error(std::error_code(sqlite3_errcode(this->db), get_sqlite_error_category()));
+        }
+    }
+    
+    sqlite3_stmt* prepare(const char *query) {
+        sqlite3_stmt *stmt;
+        if(sqlite3_prepare_v2(this->db, query, -1, &stmt, nullptr) != SQLITE_OK) {
+            throw std::system_error(std::error_code(sqlite3_errcode(this->db), get_sqlite_error_category()));
+        }
+        return stmt;
+    }
+    
+    void step_done(sqlite3_stmt *stmt) {
+        if(sqlite3_step(stmt) != SQLITE_DONE) {
+            throw std::system_error(std::error_code(sqlite3_errcode(this->db), get_sqlite_error_category()));
+        }
+    }
+    
+    void bind_user(sqlite3_stmt *stmt, int index, const User &user) {
+        sqlite3_bind_text(stmt, index, user.name.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_int(stmt, index + 1, user.age);
+        sqlite3_bind_double(stmt, index + 2, user.score);
+    }
+    
+    static User extract_user(sqlite3_stmt *stmt) {
+        User user;
+        user.id = sqlite3_column_int(stmt, 0);
+        auto name = (const char*)sqlite3_column_text(stmt, 1);
+        user.name = name ? name : "";
+        user.age = sqlite3_column_int(stmt, 2);
+        user.score = sqlite3_column_double(stmt, 3);
+        return user;
+    }
+};
+
+/**
+ *  Databases a case is run over. Every case gets freshly created and filled databases.
+ */
+struct database_kind {
+    const char *name;
+    std::string ormFilename;
+    std::string rawFilename;
+};
+
+struct fixture {
+    Storage storage;
+    raw_database raw;
+    
+    fixture(const database_kind &kind):
+    storage(make_benchmark_storage(kind.ormFilename)),
+    raw(kind.rawFilename)
+    {
+        
+        //  both sides keep a single connection open
+        this->storage.open_forever();
+        this->storage.sync_schema();
+        this->raw.exec("CREATE TABLE IF NOT EXISTS users (id INTEGER PRIMARY KEY NOT NULL, name TEXT NOT NULL, age INTEGER NOT NULL, score REAL NOT NULL)");
+        
+        std::vector<User> users;
+        users.reserve(initialRowsCount);
+        for(auto i = 0; i < initialRowsCount; ++i) {
+            users.push_back(make_user(i));
+        }
+        this->storage.transaction([this, &users] {
+            for(auto &user : users) {
+                this->storage.insert(user);
+            }
+            return true;
+        });
+        this->raw.exec("BEGIN");
+        auto stmt = this->raw.prepare("INSERT INTO users (name, age, score) VALUES (?, ?, ?)");
+        statement_finalizer finalizer{stmt};
+        for(auto &user : users) {
+            this->raw.bind_user(stmt, 1, user);
+            this->raw.step_done(stmt);
+            sqlite3_reset(stmt);
+        }
+        this->raw.exec("COMMIT");
+    }
+};
+
+/**
+ *  @return median time of a single operation in nanoseconds. `f` performs `operations` operations.
+ */
+double measure(int operations, const std::function<void()> &f) {
+    std::vector<double> samples;
+    samples.reserve(repetitions);
+    for(auto i = 0; i < repetitions; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        f();
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        samples.push_back(double(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()) / operations);
+    }
+    std::sort(samples.begin(), samples.end());
+    return samples[samples.size() / 2];
+}
+
+struct benchmark_case {
+    std::string name;
+    
+    /**
+     *  Operations performed by a single repetition
+     */
+    int operations;
+    
+    std::function<void(fixture &, int)> orm;
+    std::function<void(fixture &, int)> raw;
+};
+
+std::vector<benchmark_case> make_cases() {
+    std::vector<benchmark_case> res;
+    
+    res.push_back({"insert", 100, [](fixture &f, int operations) {
+        f.storage.transaction([&f, operations] {
+            for(auto i = 0; i < operations; ++i) {
+                f.storage.insert(make_user(i));
+            }
+            return true;
+        });
+    }, [](fixture &f, int operations) {
+        f.raw.exec("BEGIN");
+        auto stmt = f.raw.prepare("INSERT INTO users (name, age, score) VALUES (?, ?, ?)");
+        statement_finalizer finalizer{stmt};
+        for(auto i = 0; i < operations; ++i) {
+            f.raw.bind_user(stmt, 1, make_user(i));
+            f.raw.step_done(stmt);
+            sqlite3_reset(stmt);
+        }
+        f.raw.exec("COMMIT");
+    }});
+    
+    for(auto size : {10, 100, 1000}) {
+        std::vector<User> users;
+        for(auto i = 0; i < size; ++i) {
+            users.push_back(make_user(i));
+        }
+        res.push_back({"insert_range " + std::to_string(size), 10, [users](fixture &f, int operations) {
+            f.storage.transaction([&f, &users, operations] {
+                for(auto i = 0; i < operations; ++i) {
+                    f.storage.insert_range(users.begin(), users.end());
+                }
+                return true;
+            });
+        }, [users](fixture &f, int operations) {
+            
+            //  a single multi row statement like insert_range does
+            std::string query = "INSERT INTO users (name, age, score) VALUES ";
+            for(size_t i = 0; i < users.size(); ++i) {
+                query += i ? ", (?, ?, ?)" : "(?, ?, ?)";
+            }
+            f.raw.exec("BEGIN");
+            for(auto i = 0; i < operations; ++i) {
+                auto stmt = f.raw.prepare(query.c_str());
+                statement_finalizer finalizer{stmt};
+                auto index = 1;
+                for(auto &user : users) {
+                    f.raw.bind_user(stmt, index, user);
+                    index += 3;
+                }
+                f.raw.step_done(stmt);
+            }
+            f.raw.exec("COMMIT");
+        }});
+    }
+    
+    res.push_back({"get", 1000, [](fixture &f, int operations) {
+        for(auto i = 0; i < operations; ++i) {
+            auto user = f.storage.get<User>(i % initialRowsCount + 1);
+            (void)user;
+        }
+    }, [](fixture &f, int operations) {
+        auto stmt = f.raw.prepare("SELECT id, name, age, score FROM users WHERE id = ?");
+        statement_finalizer finalizer{stmt};
+        for(auto i = 0; i < operations; ++i) {
+            sqlite3_bind_int(stmt, 1, i % initialRowsCount + 1);
+            if(sqlite3_step(stmt) != SQLITE_ROW) {
+                throw std::system_error(std::make_error_code(orm_error_code::not_found));
+            }
+            auto user = raw_database::extract_user(stmt);
+            (void)user;
+            sqlite3_reset(stmt);
+        }
+    }});
+    
+    res.push_back({"get_all", 10, [](fixture &f, int operations) {
+        for(auto i = 0; i < operations; ++i) {
+            auto users = f.storage.get_all<User>();
+            (void)users;
+        }
+    }, [](fixture &f, int operations) {
+        for(auto i = 0; i < operations; ++i) {
+            auto stmt = f.raw.prepare("SELECT id, name, age, score FROM users");
+            statement_finalizer finalizer{stmt};
+            std::vector<User> users;
+            while(sqlite3_step(stmt) == SQLITE_ROW) {
+                users.push_back(raw_database::extract_user(stmt));
+            }
+        }
+    }});
+    
+    res.push_back({"get_all where", 100, [](fixture &f, int operations) {
+        for(auto i = 0; i < operations; ++i) {
+            auto users = f.storage.get_all<User>(where(c(&User::age) == i % 80));
+            (void)users;
+        }
+    }, [](fixture &f, int operations) {
+        auto stmt = f.raw.prepare("SELECT id, name, age, score FROM users WHERE age = ?");
+        statement_finalizer finalizer{stmt};
+        for(auto i = 0; i < operations; ++i) {
+            sqlite3_bind_int(stmt, 1, i % 80);
+            std::vector<User> users;
+            while(sqlite3_step(stmt) == SQLITE_ROW) {
+                users.push_back(raw_database::extract_user(stmt));
+            }
+            sqlite3_reset(stmt);
+        }
+    }});
+    
+    res.push_back({"iterate", 10, [](fixture &f, int operations) {
+        for(auto i = 0; i < operations; ++i) {
+            int64 sum = 0;
+            for(auto &user : f.storage.iterate<User>()) {
+                sum += user.age;
+            }
+            (void)sum;
+        }
+    }, [](fixture &f, int operations) {
+        for(auto i = 0; i < operations; ++i) {
+            auto stmt = f.raw.prepare("SELECT id, name, age, score FROM users");
+            statement_finalizer finalizer{stmt};
+            int64 sum = 0;
+            while(sqlite3_step(stmt) == SQLITE_ROW) {
+                sum += raw_database::extract_user(stmt).age;
+            }
+            (void)sum;
+        }
+    }});
+    
+    res.push_back({"update", 100, [](fixture &f, int operations) {
+        f.storage.transaction([&f, operations] {
+            for(auto i = 0; i < operations; ++i) {
+                auto user = make_user(i);
+                user.id = i % initialRowsCount + 1;
+                f.storage.update(user);
+            }
+            return true;
+        });
+    }, [](fixture &f, int operations) {
+        f.raw.exec("BEGIN");
+        auto stmt = f.raw.prepare("UPDATE users SET name = ?, age = ?, score = ? WHERE id = ?");
+        statement_finalizer finalizer{stmt};
+        for(auto i = 0; i < operations; ++i) {
+            auto user = make_user(i);
+            f.raw.bind_user(stmt, 1, user);
+            sqlite3_bind_int(stmt, 4, i % initialRowsCount + 1);
+            f.raw.step_done(stmt);
+            sqlite3_reset(stmt);
+        }
+        f.raw.exec("COMMIT");
+    }});
+    
+    res.push_back({"update_all", 10, [](fixture &f, int operations) {
+        for(auto i = 0; i < operations; ++i) {
+            f.storage.update_all(set(c(&User::score) = i * 1.5), where(c(&User::age) == i % 80));
+        }
+    }, [](fixture &f, int operations) {
+        auto stmt = f.raw.prepare("UPDATE users SET score = ? WHERE age = ?");
+        statement_finalizer finalizer{stmt};
+        for(auto i = 0; i < operations; ++i) {
+            sqlite3_bind_double(stmt, 1, i * 1.5);
+            sqlite3_bind_int(stmt, 2, i % 80);
+            f.raw.step_done(stmt);
+            sqlite3_reset(stmt);
+        }
+    }});
+    
+    res.push_back({"select columns", 10, [](fixture &f, int operations) {
+        for(auto i = 0; i < operations; ++i) {
+            auto rows = f.storage.select(columns(&User::id, &User::name));
+            (void)rows;
+        }
+    }, [](fixture &f, int operations) {
+        for(auto i = 0; i < operations; ++i) {
+            auto stmt = f.raw.prepare("SELECT id, name FROM users");
+            statement_finalizer finalizer{stmt};
+            std::vector<std::tuple<int, std::string>> rows;
+            while(sqlite3_step(stmt) == SQLITE_ROW) {
+                auto name = (const char*)sqlite3_column_text(stmt, 1);
+                rows.emplace_back(sqlite3_column_int(stmt, 0), name ? name : "");
+            }
+        }
+    }});
+    
+    res.push_back({"select aggregate", 100, [](fixture &f, int operations) {
+        for(auto i = 0; i < operations; ++i) {
+            auto average = f.storage.avg(&User::score, where(c(&User::age) > i % 40));
+            (void)average;
+        }
+    }, [](fixture &f, int operations) {
+        auto stmt = f.raw.prepare("SELECT AVG(score) FROM users WHERE age > ?");
+        statement_finalizer finalizer{stmt};
+        for(auto i = 0; i < operations; ++i) {
+            sqlite3_bind_int(stmt, 1, i % 40);
+            double average = 0;
+            if(sqlite3_step(stmt) == SQLITE_ROW) {
+                average = sqlite3_column_double(stmt, 0);
+            }
+            (void)average;
+            sqlite3_reset(stmt);
+        }
+    }});
+    
+    res.push_back({"sync_schema", 10, [](fixture &f, int operations) {
+        for(auto i = 0; i < operations; ++i) {
+            f.storage.sync_schema();
+        }
+    }, [](fixture &f, int operations) {
+        
+        //  schema already in sync: introspection only
+        for(auto i = 0; i < operations; ++i) {
+            auto stmt = f.raw.prepare("PRAGMA table_info('users')");
+            statement_finalizer finalizer{stmt};
+            while(sqlite3_step(stmt) == SQLITE_ROW) {
+                //..
+            }
+        }
+    }});
+    
+    return res;
+}
+
+int main(int argc, char **argv) {
+    std::string filter;
+    for(auto i = 1; i < argc; ++i) {
+        if(!std::strcmp(argv[i], "--repetitions") && i + 1 < argc) {
+            repetitions = std::max(1, std::atoi(argv[++i]));
+        }else if(!std::strcmp(argv[i], "--scale") && i + 1 < argc) {
+            scale = std::max(1, std::atoi(argv[++i]));
+        }else{
+            filter = argv[i];
+        }
+    }
+    
+    std::vector<database_kind> kinds = {
+        {"memory", "", ":memory:"},
+        {"file", "benchmark_orm.sqlite", "benchmark_raw.sqlite"},
+    };
+    
+    cout << "SQLite " << sqlite3_libversion() << ", " << repetitions << " repetitions" << endl;
+    cout << std::left << std::setw(20) << "case" << std::setw(8) << "db"
+    << std::right << std::setw(14) << "orm ns/op" << std::setw(14) << "raw ns/op" << std::setw(8) << "ratio" << endl;
+    for(auto &benchmarkCase : make_cases()) {
+        if(benchmarkCase.name.find(filter) == std::string::npos) {
+            continue;
+        }
+        for(auto &kind : kinds) {
+            std::remove(kind.ormFilename.c_str());
+            std::remove(kind.rawFilename.c_str());
+            auto operations = benchmarkCase.operations * scale;
+            double ormTime;
+            double rawTime;
+            {
+                fixture f(kind);
+                ormTime = measure(operations, [&] {
+                    benchmarkCase.orm(f, operations);
+                });
+                rawTime = measure(operations, [&] {
+                    benchmarkCase.raw(f, operations);
+                });
+            }
+            cout << std::left << std::setw(20) << benchmarkCase.name << std::setw(8) << kind.name
+            << std::right << std::fixed << std::setprecision(0) << std::setw(14) << ormTime << std::setw(14) << rawTime
+            << std::setprecision(2) << std::setw(8) << (rawTime > 0 ? ormTime / rawTime : 0) << endl;
+        }
+    }
+    for(auto &kind : kinds) {
+        std::remove(kind.ormFilename.c_str());
+        std::remove(kind.rawFilename.c_str());
+    }
+    return 0;
+}
@@ -0,0 +1,181 @@
+/**
+ *  Compile time and object size benchmark of the amalgamated header. Generates translation units with
+ *  storages of different tables and columns counts, compiles every unit with the same compiler the target
+ *  is built with and reports wall time of the compilation and size of the produced object file.
+ *  Every generated table is used with `sync_schema`, `insert`, `get`, `get_all`, `update` and `remove`
+ *  so the unit instantiates what a regular application instantiates.
+ *
+ *  Usage: compile_time [options]
+ *  --tables LIST - comma separated tables counts (default 10,50,200)
+ *  --columns LIST - comma separated columns counts per table (default 5,20,50)
+ *  --repetitions N - how many times every unit is compiled, minimum time is reported (default 1)
+ *  --compiler PATH - compiler to use (default is the one the target is built with)
+ *  --flags FLAGS - compiler flags (default "-std=c++14 -O2")
+ *  --keep - doesn't remove generated sources and objects
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+
+using std::cout;
+using std::cerr;
+using std::endl;
+
+#ifndef SQLITE_ORM_COMPILER
+#define SQLITE_ORM_COMPILER "c++"
+#endif
+
+#ifndef SQLITE_ORM_INCLUDE_DIR
+#define SQLITE_ORM_INCLUDE_DIR "include"
+#endif
+
+struct options {
+    std::vector<int> tables = {10, 50, 200};
+    std::vector<int> columns = {5, 20, 50};
+    int repetitions = 1;
+    std::string compiler = SQLITE_ORM_COMPILER;
+    std::string flags = "-std=c++14 -O2";
+    bool keep = false;
+};
+
+std::vector<int> parse_list(const std::string &value) {
+    std::vector<int> res;
+    std::stringstream ss(value);
+    std::string item;
+    while(std::getline(ss, item, ',')) {
+        res.push_back(std::max(1, std::atoi(item.c_str())));
+    }
+    return res;
+}
+
+/**
+ *  Generates a translation unit with `tablesCount` mapped structs having `columnsCount` members each.
+ *  Members types are cycled through int, std::string and double. First member is an integer primary key.
+ */
+std::string generate_source(int tablesCount, int columnsCount) {
+    static const char *types[] = {"int", "std::string", "double"};
+    std::stringstream ss;
+    ss << "#include <sqlite_orm/sqlite_orm.h>\n\n";
+    ss << "using namespace sqlite_orm;\n\n";
+    for(auto t = 0; t < tablesCount; ++t) {
+        ss << "struct Table" << t << " {\n";
+        ss << "    int id;\n";
+        for(auto c = 1; c < columnsCount; ++c) {
+            ss << "    " << types[c % 3] << " c" << c << ";\n";
+        }
+        ss << "};\n\n";
+    }
+    ss << "inline auto make_generated_storage(const std::string &filename) {\n";
+    ss << "    return make_storage(filename";
+    for(auto t = 0; t < tablesCount; ++t) {
+        ss << ",\n                        make_table(\"table" << t << "\",\n";
+        ss << "                                   make_column(\"id\", &Table" << t << "::id, primary_key())";
+        for(auto c = 1; c < columnsCount; ++c) {
+            ss << ",\n                                   make_column(\"c" << c << "\", &Table" << t << "::c" << c << ")";
+        }
+        ss << ")";
+    }
+    ss << ");\n}\n\n";
+    ss << "int main() {\n";
+    ss << "    auto storage = make_generated_storage(\":memory:\");\n";
+    ss << "    storage.sync_schema();\n";
+    for(auto t = 0; t < tablesCount; ++t) {
+        ss << "    {\n";
+        ss << "        Table" << t << " object{};\n";
+        ss << "        object.id = storage.insert(object);\n";
+        ss << "        storage.update(storage.get<Table" << t << ">(object.id));\n";
+        ss << "        storage.get_all<Table" << t << ">();\n";
+        ss << "        storage.remove<Table" << t << ">(object.id);\n";
+        ss << "    }\n";
+    }
+    ss << "    return 0;\n}\n";
+    return ss.str();
+}
+
+long file_size(const std::string &path) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if(!file) {
+        return -1;
+    }
+    return static_cast<long>(file.tellg());
+}
+
+int main(int argc, char **argv) {
+    options opts;
+    for(auto i = 1; i < argc; ++i) {
+        std::string name = argv[i];
+        if(name == "--keep") {
+            opts.keep = true;
+            continue;
+        }
+        if(i + 1 >= argc) {
+            cerr << "option " << name << " requires a value" << endl;
+            return 1;
+        }
+        std::string value = argv[++i];
+        if(name == "--tables") {
+            opts.tables = parse_list(value);
+        }else if(name == "--columns") {
+            opts.columns = parse_list(value);
+        }else if(name == "--repetitions") {
+            opts.repetitions = std::max(1, std::atoi(value.c_str()));
+        }else if(name == "--compiler") {
+            opts.compiler = value;
+        }else if(name == "--flags") {
+            opts.flags = value;
+        }else{
+            cerr << "unknown option " << name << endl;
+            return 1;
+        }
+    }
+    
+    cout << opts.compiler << " " << opts.flags << endl;
+    cout << std::setw(8) << "tables" << std::setw(8) << "columns" << std::setw(12) << "time s" << std::setw(14) << "object KiB" << endl;
+    for(auto tablesCount : opts.tables) {
+        for(auto columnsCount : opts.columns) {
+            auto baseName = "compile_time_" + std::to_string(tablesCount) + "_" + std::to_string(columnsCount);
+            auto sourcePath = baseName + ".cpp";
+            auto objectPath = baseName + ".o";
+            {
+                std::ofstream file(sourcePath);
+                file << generate_source(tablesCount, columnsCount);
+            }
+            auto command = opts.compiler + " " + opts.flags + " -I\"" + SQLITE_ORM_INCLUDE_DIR + "\" -c " + sourcePath + " -o " + objectPath;
+            double bestTime = 0;
+            auto failed = false;
+            for(auto r = 0; r < opts.repetitions; ++r) {
+                std::remove(objectPath.c_str());
+                auto start = std::chrono::steady_clock::now();
+                auto rc = std::system(command.c_str());
+                auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                if(rc != 0) {
+                    failed = true;
+                    break;
+                }
+                if(r == 0 || elapsed < bestTime) {
+                    bestTime = elapsed;
+                }
+            }
+            cout << std::setw(8) << tablesCount << std::setw(8) << columnsCount;
+            if(failed) {
+                cout << std::setw(12) << "failed" << endl;
+            }else{
+                cout << std::fixed << std::setprecision(2) << std::setw(12) << bestTime
+                << std::setprecision(0) << std::setw(14) << file_size(objectPath) / 1024.0 << endl;
+            }
+            if(!opts.keep) {
+                std::remove(sourcePath.c_str());
+                std::remove(objectPath.c_str());
+            }
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,280 @@
+/**
+ *  Multi-threaded load generator. Runs a mixed read/write workload against a key-value storage
+ *  (see examples/key_value.cpp) with 1, 2, 4 ... N threads for every journal mode and `synchronous`
+ *  value and reports throughput and latency percentiles. Every thread uses its own storage object with
+ *  its own connection (`open_forever`) to a shared file database.
+ *
+ *  Usage: load_generator [options]
+ *  --threads N - maximum threads count (default hardware concurrency)
+ *  --reads R - share of reads in 0..1 (default 0.9)
+ *  --distribution uniform|zipf - keys distribution (default uniform)
+ *  --keys N - keys count (default 10000)
+ *  --value-size N - value length in bytes (default 100)
+ *  --duration MS - duration of a single run in milliseconds (default 2000)
+ *  --journal wal|delete|both - journal modes to run (default both)
+ *  --synchronous LIST - comma separated `synchronous` values to run (default 0,1,2)
+ *
+ *  Build in Release mode for meaningful numbers.
+ */
+
+#include <sqlite_orm/sqlite_orm.h>
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <system_error>
+#include <sstream>
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
+#include <cmath>
+
+using namespace sqlite_orm;
+using std::cout;
+using std::endl;
+
+struct KeyValue {
+    std::string key;
+    std::string value;
+};
+
+inline auto make_key_value_storage(const std::string &filename) {
+    return make_storage(filename,
+                        make_table("key_value",
+                                   make_column("key", &KeyValue::key, primary_key()),
+                                   make_column("value", &KeyValue::value)));
+}
+
+static const char *filename = "load_generator.sqlite";
+
+struct options {
+    int threads = std::max(1, int(std::thread::hardware_concurrency()));
+    double reads = 0.9;
+    bool zipf = false;
+    int keys = 10000;
+    int valueSize = 100;
+    int duration = 2000;
+    std::vector<std::string> journalModes = {"wal", "delete"};
+    std::vector<int> synchronousValues = {0, 1, 2};
+};
+
+/**
+ *  Generates keys indexes with uniform or zipfian (s = 0.99) distribution.
+ */
+struct key_generator {
+    
+    key_generator(int keys, bool zipf, unsigned seed): engine(seed), uniform(0, keys - 1), real(0, 1) {
+        if(zipf) {
+            this->cdf.reserve(keys);
+            double sum = 0;
+            for(auto i = 0; i < keys; ++i) {
+                sum += 1 / std::pow(i + 1, 0.99);
+                this->cdf.push_back(sum);
+            }
+            for(auto &value : this->cdf) {
+                value /= sum;
+            }
+        }
+    }
+    
+    int next() {
+        if(this->cdf.empty()) {
+            return this->uniform(this->engine);
+        }
+        auto it = std::lower_bound(this->cdf.begin(), this->cdf.end(), this->real(this->engine));
+        return int(std::min<std::ptrdiff_t>(it - this->cdf.begin(), this->cdf.size() - 1));
+    }
+    
+    double probability() {
+        return this->real(this->engine);
+    }
+    
+protected:
+    std::mt19937 engine;
+    std::uniform_int_distribution<int> uniform;
+    std::uniform_real_distribution<double> real;
+    std::vector<double> cdf;
+};
+
+std::string make_key(int index) {
+    return "key" + std::to_string(index);
+}
+
+struct thread_result {
+    std::vector<int64> readLatencies;
+    std::vector<int64> writeLatencies;
+    int64 busyErrors = 0;
+};
+
+/**
+ *  @return latency in microseconds at percentile p (0 - 1) of sorted latencies in nanoseconds
+ */
+double percentile(const std::vector<int64> &sorted, double p) {
+    if(sorted.empty()) {
+        return 0;
+    }
+    auto index = std::min(sorted.size() - 1, size_t(p * double(sorted.size() - 1)));
+    return sorted[index] / 1000.0;
+}
+
+void prepare_database(const options &opts, const std::string &journalMode) {
+    std::remove(filename);
+    std::remove((std::string(filename) + "-wal").c_str());
+    std::remove((std::string(filename) + "-shm").c_str());
+    
+    //  journal mode is persistent for WAL so it is set once by a separate connection
+    sqlite3 *db;
+    sqlite3_open(filename, &db);
+    sqlite3_exec(db, ("PRAGMA journal_mode = " + journalMode).c_str(), nullptr, nullptr, nullptr);
+    sqlite3_close(db);
+    
+    auto storage = make_key_value_storage(filename);
+    storage.sync_schema();
+    std::string value(opts.valueSize, 'v');
+    storage.transaction([&] {
+        for(auto i = 0; i < opts.keys; ++i) {
+            storage.replace(KeyValue{make_key(i), value});
+        }
+        return true;
+    });
+}
+
+void run(const options &opts, const std::string &journalMode, int synchronous, int threadsCount) {
+    std::vector<thread_result> results(threadsCount);
+    std::atomic<bool> isRunning{true};
+    std::atomic<int> readyThreads{0};
+    std::vector<std::thread> threads;
+    for(auto t = 0; t < threadsCount; ++t) {
+        threads.emplace_back([&, t] {
+            auto storage = make_key_value_storage(filename);
+            storage.open_forever();
+            storage.busy_timeout(5000);
+            
+            //  journal mode is kept by the database file but synchronous is per connection
+            storage.pragma.synchronous(synchronous);
+            key_generator generator(opts.keys, opts.zipf, 42 + unsigned(t));
+            std::string value(opts.valueSize, 'w');
+            auto &result = results[t];
+            ++readyThreads;
+            while(readyThreads < threadsCount) {
+                std::this_thread::yield();
+            }
+            while(isRunning) {
+                auto key = make_key(generator.next());
+                auto isRead = generator.probability() < opts.reads;
+                auto start = std::chrono::steady_clock::now();
+                try{
+                    if(isRead) {
+                        auto kv = storage.get_no_throw<KeyValue>(key);
+                        (void)kv;
+                    }else{
+                        storage.replace(KeyValue{key, value});
+                    }
+                }catch(const std::system_error &e) {
+                    if(e.code() == std::error_code(SQLITE_BUSY, get_sqlite_error_category()) ||
+                       e.code() == std::error_code(SQLITE_LOCKED, get_sqlite_error_category())) {
+                        ++result.busyErrors;
+                        continue;
+                    }
+                    throw;
+                }
+                auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+                (isRead ? result.readLatencies : result.writeLatencies).push_back(elapsed);
+            }
+        });
+    }
+    while(readyThreads < threadsCount) {
+        std::this_thread::yield();
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(opts.duration));
+    isRunning = false;
+    for(auto &thread : threads) {
+        thread.join();
+    }
+    
+    std::vector<int64> reads;
+    std::vector<int64> writes;
+    int64 busyErrors = 0;
+    for(auto &result : results) {
+        reads.insert(reads.end(), result.readLatencies.begin(), result.readLatencies.end());
+        writes.insert(writes.end(), result.writeLatencies.begin(), result.writeLatencies.end());
+        busyErrors += result.busyErrors;
+    }
+    std::sort(reads.begin(), reads.end());
+    std::sort(writes.begin(), writes.end());
+    auto throughput = double(reads.size() + writes.size()) * 1000 / opts.duration;
+    cout << std::left << std::setw(8) << journalMode << std::right << std::setw(6) << synchronous << std::setw(8) << threadsCount
+    << std::fixed << std::setprecision(0) << std::setw(12) << throughput
+    << std::setprecision(1)
+    << std::setw(10) << percentile(reads, 0.5) << std::setw(10) << percentile(reads, 0.99) << std::setw(10) << percentile(reads, 0.999)
+    << std::setw(10) << percentile(writes, 0.5) << std::setw(10) << percentile(writes, 0.99) << std::setw(10) << percentile(writes, 0.999)
+    << std::setw(8) << busyErrors << endl;
+}
+
+int main(int argc, char **argv) {
+    options opts;
+    for(auto i = 1; i + 1 < argc; i += 2) {
+        std::string name = argv[i];
+        std::string value = argv[i + 1];
+        if(name == "--threads") {
+            opts.threads = std::max(1, std::atoi(value.c_str()));
+        }else if(name == "--reads") {
+            opts.reads = std::atof(value.c_str());
+        }else if(name == "--distribution") {
+            opts.zipf = value == "zipf";
+        }else if(name == "--keys") {
+            opts.keys = std::max(1, std::atoi(value.c_str()));
+        }else if(name == "--value-size") {
+            opts.valueSize = std::max(0, std::atoi(value.c_str()));
+        }else if(name == "--duration") {
+            opts.duration = std::max(1, std::atoi(value.c_str()));
+        }else if(name == "--journal") {
+            if(value == "both") {
+                opts.journalModes = {"wal", "delete"};
+            }else{
+                opts.journalModes = {value};
+            }
+        }else if(name == "--synchronous") {
+            opts.synchronousValues.clear();
+            std::stringstream ss(value);
+            std::string item;
+            while(std::getline(ss, item, ',')) {
+                opts.synchronousValues.push_back(std::atoi(item.c_str()));
+            }
+        }else{
+            std::cerr << "unknown option " << name << endl;
+            return 1;
+        }
+    }
+    
+    cout << "SQLite " << sqlite3_libversion() << ", reads " << opts.reads << ", " << (opts.zipf ? "zipf" : "uniform")
+    << ", " << opts.keys << " keys, " << opts.valueSize << " bytes values, " << opts.duration << " ms per run" << endl;
+    cout << "latencies are in microseconds" << endl;
+    cout << std::left << std::setw(8) << "journal" << std::right << std::setw(6) << "sync" << std::setw(8) << "threads"
+    << std::setw(12) << "ops/s"
+    << std::setw(10) << "read p50" << std::setw(10) << "p99" << std::setw(10) << "p99.9"
+    << std::setw(10) << "write p50" << std::setw(10) << "p99" << std::setw(10) << "p99.9"
+    << std::setw(8) << "busy" << endl;
+    for(auto &journalMode : opts.journalModes) {
+        for(auto synchronous : opts.synchronousValues) {
+            prepare_database(opts, journalMode);
+            for(auto threadsCount = 1; ; threadsCount *= 2) {
+                threadsCount = std::min(threadsCount, opts.threads);
+                run(opts, journalMode, synchronous, threadsCount);
+                if(threadsCount == opts.threads) {
+                    break;
+                }
+            }
+        }
+    }
+    std::remove(filename);
+    std::remove((std::string(filename) + "-wal").c_str());
+    std::remove((std::string(filename) + "-shm").c_str());
+    return 0;
+}
@@ -0,0 +1,168 @@
+/**
+ *  Replays a workload log written by `storage.start_recording(path)` against a copy of a database and
+ *  compares replayed latencies with recorded ones. Is useful to reproduce performance regressions and
+ *  to compare pragma and index changes on real traffic.
+ *
+ *  Usage: replay LOG DATABASE [options]
+ *  DATABASE is copied to DATABASE.replay before replay and is not modified.
+ *  --max-rate - executes statements one after another instead of original pacing
+ *  --setup SQL - statement executed on the copy before replay e.g. "PRAGMA journal_mode = WAL" or
+ *  "CREATE INDEX ...". Can be repeated.
+ */
+
+#include <sqlite_orm/sqlite_orm.h>
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <map>
+#include <chrono>
+#include <thread>
+#include <algorithm>
+#include <system_error>
+#include <cstdio>
+
+using namespace sqlite_orm;
+using std::cout;
+using std::cerr;
+using std::endl;
+
+/**
+ *  @return latency in microseconds at percentile p (0 - 1) of sorted latencies in nanoseconds
+ */
+double percentile(const std::vector<int64> &sorted, double p) {
+    if(sorted.empty()) {
+        return 0;
+    }
+    auto index = std::min(sorted.size() - 1, size_t(p * double(sorted.size() - 1)));
+    return sorted[index] / 1000.0;
+}
+
+/**
+ *  Copies database with backup API so WAL content is included.
+ */
+void copy_database(const std::string &source, const std::string &destination) {
+    std::remove(destination.c_str());
+    sqlite3 *from;
+    sqlite3 *to;
+    sqlite3_open(source.c_str(), &from);
+    sqlite3_open(destination.c_str(), &to);
+    auto backup = sqlite3_backup_init(to, "main", from, "main");
+    if(backup) {
+        sqlite3_backup_step(backup, -1);
+        sqlite3_backup_finish(backup);
+    }
+    auto rc = sqlite3_errcode(to);
+    sqlite3_close(from);
+    sqlite3_close(to);
+    if(rc != SQLITE_OK) {
+        throw std::system_error(std::error_code(rc, get_sqlite_error_category()));
+    }
+}
+
+struct statement_summary {
+    int64 calls = 0;
+    int64 recorded = 0;
+    int64 replayed = 0;
+};
+
+int main(int argc, char **argv) {
+    if(argc < 3) {
+        cerr << "usage: " << argv[0] << " LOG DATABASE [--max-rate] [--setup SQL]..." << endl;
+        return 1;
+    }
+    std::string logPath = argv[1];
+    std::string databasePath = argv[2];
+    auto maxRate = false;
+    std::vector<std::string> setupStatements;
+    for(auto i = 3; i < argc; ++i) {
+        std::string arg = argv[i];
+        if(arg == "--max-rate") {
+            maxRate = true;
+        }else if(arg == "--setup" && i + 1 < argc) {
+            setupStatements.push_back(argv[++i]);
+        }else{
+            cerr << "unknown option " << arg << endl;
+            return 1;
+        }
+    }
+    
+    auto records = read_workload(logPath);
+    auto copyPath = databasePath + ".replay";
+    copy_database(databasePath, copyPath);
+    
+    sqlite3 *db;
+    if(sqlite3_open(copyPath.c_str(), &db) != SQLITE_OK) {
+        throw std::system_error(std::error_code(sqlite3_errcode(db), get_sqlite_error_category()));
+    }
+    for(auto &statement : setupStatements) {
+        if(sqlite3_exec(db, statement.c_str(), nullptr, nullptr, nullptr) != SQLITE_OK) {
+            cerr << "setup statement failed: " << statement << ": " << sqlite3_errmsg(db) << endl;
+            return 1;
+        }
+    }
+    
+    std::vector<int64> recordedLatencies;
+    std::vector<int64> replayedLatencies;
+    std::map<std::string, statement_summary> summaries;
+    int64 errors = 0;
+    auto start = std::chrono::steady_clock::now();
+    for(auto &record : records) {
+        if(!maxRate) {
+            std::this_thread::sleep_until(start + record.offset);
+        }
+        auto statementStart = std::chrono::steady_clock::now();
+        sqlite3_stmt *stmt;
+        if(sqlite3_prepare_v2(db, record.sql.c_str(), -1, &stmt, nullptr) == SQLITE_OK) {
+            statement_finalizer finalizer{stmt};
+            int rc;
+            while((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+                //..
+            }
+            if(rc != SQLITE_DONE) {
+                ++errors;
+            }
+        }else{
+            ++errors;
+        }
+        auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - statementStart).count();
+        recordedLatencies.push_back(record.elapsed.count());
+        replayedLatencies.push_back(elapsed);
+        auto &summary = summaries[record.prepared_sql];
+        ++summary.calls;
+        summary.recorded += record.elapsed.count();
+        summary.replayed += elapsed;
+    }
+    auto wallTime = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+    sqlite3_close(db);
+    
+    auto sum = [](const std::vector<int64> &values) {
+        int64 res = 0;
+        for(auto value : values) {
+            res += value;
+        }
+        return res;
+    };
+    cout << records.size() << " statements, " << errors << " errors, wall time " << wallTime << " ms" << endl;
+    cout << std::fixed << std::setprecision(1);
+    cout << "execution time ms: recorded " << sum(recordedLatencies) / 1e6 << ", replayed " << sum(replayedLatencies) / 1e6 << endl;
+    std::sort(recordedLatencies.begin(), recordedLatencies.end());
+    std::sort(replayedLatencies.begin(), replayedLatencies.end());
+    cout << "p50 us: recorded " << percentile(recordedLatencies, 0.5) << ", replayed " << percentile(replayedLatencies, 0.5) << endl;
+    cout << "p99 us: recorded " << percentile(recordedLatencies, 0.99) << ", replayed " << percentile(replayedLatencies, 0.99) << endl;
+    
+    std::vector<std::pair<std::string, statement_summary>> top(summaries.begin(), summaries.end());
+    std::sort(top.begin(), top.end(), [](const auto &lhs, const auto &rhs) {
+        return lhs.second.replayed > rhs.second.replayed;
+    });
+    if(top.size() > 10) {
+        top.resize(10);
+    }
+    cout << "slowest statements (calls, recorded ms, replayed ms):" << endl;
+    for(auto &p : top) {
+        cout << std::setw(8) << p.second.calls << std::setw(10) << p.second.recorded / 1e6 << std::setw(10) << p.second.replayed / 1e6
+        << "  " << p.first.substr(0, 100) << endl;
+    }
+    return 0;
+}
@@ -1,8 +1,13 @@
 #pragma once
 
 #include <string>   //  std::string
+#include <memory>   //  std::shared_ptr
+#include <vector>   //  std::vector
 #include <sqlite3.h>
 #include <system_error> //  std::error_code, std::system_error
+#include <map>  //  std::map
+#include <set>  //  std::set
+#include <utility>  //  std::move
 
 #include "error_code.h"
 
@@ -19,7 +24,15 @@ namespace sqlite_orm {
                 }
             }
             
+            database_connection(const database_connection &) = delete;
+            
             ~database_connection() {
+                for(auto &p : this->statements) {
+                    sqlite3_finalize(p.second);
+                }
+                for(auto &p : this->keyedStatements) {
+                    sqlite3_finalize(p.second);
+                }
                 sqlite3_close(this->db);
             }
             
@@ -27,8 +40,108 @@ namespace sqlite_orm {
                 return this->db;
             }
             
+            /**
+             *  Returns prepared statement for a given query. Statement is prepared once per connection
+             *  and is reused by subsequent calls with the same query text so query must not contain any
+             *  values - bind them instead. Statement is owned by connection: do not finalize it, reset it
+             *  after usage with `statement_resetter` instead.
+             */
+            sqlite3_stmt* get_statement(const std::string &query) {
+                auto it = this->statements.find(query);
+                if(it != this->statements.end()){
+                    return it->second;
+                }
+                sqlite3_stmt *stmt = nullptr;
+                if(sqlite3_prepare_v2(this->db, query.c_str(), -1, &stmt, nullptr) == SQLITE_OK) {
+                    this->statements.insert({query, stmt});
+                    return stmt;
+                }else{
+                    throw std::system_error(std::error_code(sqlite3_errcode(this->db), get_sqlite_error_category()));
+                }
+            }
+            
+            /**
+             *  The same as `get_statement` but statement is looked up by `key` so `makeQuery` building
+             *  query text is called only once per connection and key.
+             */
+            template<class F>
+            sqlite3_stmt* get_statement(const std::string &key, const F &makeQuery) {
+                auto it = this->keyedStatements.find(key);
+                if(it != this->keyedStatements.end()){
+                    return it->second;
+                }
+                auto query = makeQuery();
+                sqlite3_stmt *stmt = nullptr;
+                if(sqlite3_prepare_v2(this->db, query.c_str(), -1, &stmt, nullptr) == SQLITE_OK) {
+                    this->keyedStatements.insert({key, stmt});
+                    return stmt;
+                }else{
+                    throw std::system_error(std::error_code(sqlite3_errcode(this->db), get_sqlite_error_category()));
+                }
+            }
+            
+            /**
+             *  Returns id of a temp table for `in` condition values which is not used by any alive statement
+             *  of this connection. Released ids are reused starting from the smallest one so query texts
+             *  stay the same from call to call.
+             */
+            int acquire_in_table() {
+                if(!this->freeInTables.empty()){
+                    auto it = this->freeInTables.begin();
+                    auto id = *it;
+                    this->freeInTables.erase(it);
+                    return id;
+                }
+                return this->inTablesCount++;
+            }
+            
+            /**
+             *  Marks temp table with id `id` as free. Must be called once statement using it is finished.
+             */
+            void release_in_table(int id) {
+                this->freeInTables.insert(id);
+            }
+            
         protected:
             sqlite3 *db = nullptr;
+            
+            /**
+             *  Cached statements. Key is a query text.
+             */
+            std::map<std::string, sqlite3_stmt*> statements;
+            
+            /**
+             *  Cached statements looked up by a key. See `get_statement(key, makeQuery)`.
+             */
+            std::map<std::string, sqlite3_stmt*> keyedStatements;
+            
+            /**
+             *  Count of temp tables created for `in` conditions and ids of ones not used right now.
+             */
+            int inTablesCount = 0;
+            std::set<int> freeInTables;
+        };
+        
+        /**
+         *  Is passed down while a query is built. `in` conditions put their values into temp tables of
+         *  `connection` and keep their ids here so tables are released when the statement is finished: keep
+         *  context alive as long as the statement. If `connection` is null values are written into query text.
+         */
+        struct query_context {
+            std::shared_ptr<database_connection> connection;
+            std::vector<int> inTables;
+            
+            query_context(std::shared_ptr<database_connection> connection_): connection(std::move(connection_)) {}
+            
+            query_context(const query_context &) = delete;
+            
+            query_context(query_context &&) = default;
+            
+            ~query_context() {
+                for(auto id : this->inTables) {
+                    this->connection->release_in_table(id);
+                }
+            }
         };
     }
 }
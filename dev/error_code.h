@@ -17,6 +17,8 @@ namespace sqlite_orm {
         table_has_no_primary_key_column,
         cannot_start_a_transaction_within_a_transaction,
         no_active_transaction,
+        incorrect_workload_log,
+        incorrect_page_token,
     };
     
 }
@@ -50,6 +52,10 @@ namespace sqlite_orm {
                     return "Cannot start a transaction within a transaction";
                 case orm_error_code::no_active_transaction:
                     return "No active transaction";
+                case orm_error_code::incorrect_workload_log:
+                    return "Incorrect workload log";
+                case orm_error_code::incorrect_page_token:
+                    return "Incorrect page token";
                 default:
                     return "unknown error";
             }
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <memory>   //  std::shared_ptr, std::unique_ptr
+
+namespace sqlite_orm {
+    
+    /**
+     *  Is used to compare members mapped to objects in storage_t::update(o, original) member function
+     *  to find out which columns are changed. Other developers can create own specialization to compare
+     *  custom types which have no operator==
+     */
+    template<class T>
+    struct field_comparator {
+        bool operator()(const T &lhs, const T &rhs) const {
+            return lhs == rhs;
+        }
+    };
+    
+    /**
+     *  Pointers are compared by pointed values cause they are stored as values
+     */
+    template<class T>
+    struct field_comparator<std::shared_ptr<T>> {
+        bool operator()(const std::shared_ptr<T> &lhs, const std::shared_ptr<T> &rhs) const {
+            if(lhs && rhs){
+                return field_comparator<T>()(*lhs, *rhs);
+            }else{
+                return !lhs && !rhs;
+            }
+        }
+    };
+    
+    template<class T>
+    struct field_comparator<std::unique_ptr<T>> {
+        bool operator()(const std::unique_ptr<T> &lhs, const std::unique_ptr<T> &rhs) const {
+            if(lhs && rhs){
+                return field_comparator<T>()(*lhs, *rhs);
+            }else{
+                return !lhs && !rhs;
+            }
+        }
+    };
+}
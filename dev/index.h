@@ -21,6 +21,13 @@ namespace sqlite_orm {
         };
     }
     
+    /**
+     *  Index construction function. Every argument except name is one of:
+     *  * column member pointer or getter/setter - indexed column
+     *  * expression like `lower(&User::email)` - expression index
+     *  * `order_by(&User::name).collate_nocase().desc()` - indexed column with COLLATE and/or ASC/DESC
+     *  * `where(c(&User::status) == 1)` - makes partial index with a given condition
+     */
     template<class ...Cols>
     internal::index_t<Cols...> make_index(const std::string &name, Cols ...cols) {
         return {name, false, std::make_tuple(cols...)};
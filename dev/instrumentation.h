@@ -0,0 +1,210 @@
+#pragma once
+
+#include <string>   //  std::string
+#include <vector>   //  std::vector
+#include <map>  //  std::map
+#include <array>    //  std::array
+#include <mutex>    //  std::mutex, std::lock_guard
+#include <memory>   //  std::shared_ptr, std::make_shared
+#include <chrono>   //  std::chrono::steady_clock, std::chrono::nanoseconds
+#include <algorithm>    //  std::max, std::min
+
+#include "sqlite_type.h"
+#include "profiler.h"
+
+namespace sqlite_orm {
+    
+    /**
+     *  Parts of a storage operation measured by instrumentation policy.
+     *  build - ORM work before SQLite is called: query string building, table lookup
+     *  connect - opening a connection if storage doesn't keep one
+     *  prepare - `sqlite3_prepare_v2`
+     *  bind - binding values to a statement
+     *  step - `sqlite3_step` (and whole transaction lambda for `transaction`)
+     *  hydrate - extracting column values into objects
+     */
+    enum class instrumentation_phase {
+        build,
+        connect,
+        prepare,
+        bind,
+        step,
+        hydrate,
+    };
+    
+    /**
+     *  Default storage instrumentation policy. Does nothing and is optimized out completely.
+     *  A custom policy must have the same interface: `measurement` type constructible from policy reference
+     *  and operation name with `phase(instrumentation_phase)` function which is called every time operation
+     *  switches to another phase. Operation is finished when measurement is destroyed.
+     */
+    struct no_instrumentation {
+        
+        struct measurement {
+            
+            measurement(no_instrumentation &, const char * /*operation*/) {}
+            
+            void phase(instrumentation_phase) {}
+        };
+    };
+    
+    /**
+     *  Latency statistics of an operation or its phase.
+     */
+    struct latency_stats {
+        std::chrono::nanoseconds total;
+        std::chrono::nanoseconds p50;
+        std::chrono::nanoseconds p99;
+        std::chrono::nanoseconds max;
+    };
+    
+    /**
+     *  Latency statistics of a storage operation collected by `latency_instrumentation`.
+     */
+    struct operation_latency {
+        
+        /**
+         *  Storage function name e.g. `get_all`
+         */
+        std::string operation;
+        
+        int64 calls;
+        
+        /**
+         *  Whole operation latency
+         */
+        latency_stats latency;
+        
+        /**
+         *  Latency of every phase indexed with `instrumentation_phase`
+         */
+        std::array<latency_stats, 6> phases;
+        
+        const latency_stats& operator[](instrumentation_phase phase) const {
+            return this->phases[static_cast<size_t>(phase)];
+        }
+    };
+    
+    /**
+     *  Instrumentation policy which records latency histograms of every instrumented storage operation and
+     *  its phases. Storage copies share collected data. Thread safe. Usage:
+     *
+     *  auto storage = make_instrumented_storage<latency_instrumentation>("db.sqlite", make_table(...));
+     *  ...
+     *  for(auto &op : storage.instrumentation().snapshot()) {
+     *      cout << op.operation << " " << op[instrumentation_phase::step].p99.count() << endl;
+     *  }
+     */
+    struct latency_instrumentation {
+        static constexpr const size_t phases_count = 6;
+        
+        struct measurement {
+            
+            measurement(latency_instrumentation &instrumentation_, const char *operation_):
+            instrumentation(instrumentation_),
+            operation(operation_),
+            start(std::chrono::steady_clock::now()),
+            phaseStart(start)
+            {}
+            
+            measurement(const measurement &) = delete;
+            
+            void phase(instrumentation_phase value) {
+                auto now = std::chrono::steady_clock::now();
+                this->durations[static_cast<size_t>(this->currentPhase)] += now - this->phaseStart;
+                this->phaseStart = now;
+                this->currentPhase = value;
+            }
+            
+            ~measurement() {
+                this->phase(this->currentPhase);
+                this->instrumentation.add(this->operation, this->phaseStart - this->start, this->durations);
+            }
+            
+        protected:
+            latency_instrumentation &instrumentation;
+            const char *operation;
+            std::chrono::steady_clock::time_point start;
+            std::chrono::steady_clock::time_point phaseStart;
+            instrumentation_phase currentPhase = instrumentation_phase::build;
+            std::array<std::chrono::steady_clock::duration, phases_count> durations{};
+        };
+        
+        /**
+         *  @return statistics of every operation called at least once since creation or `reset`.
+         */
+        std::vector<operation_latency> snapshot() const {
+            std::vector<operation_latency> res;
+            std::lock_guard<std::mutex> lock(this->data->mutex);
+            res.reserve(this->data->entries.size());
+            for(auto &p : this->data->entries) {
+                auto &entry = p.second;
+                operation_latency value;
+                value.operation = p.first;
+                value.calls = entry.calls;
+                value.latency = entry.latency.stats();
+                for(size_t i = 0; i < phases_count; ++i) {
+                    value.phases[i] = entry.phases[i].stats();
+                }
+                res.push_back(std::move(value));
+            }
+            return res;
+        }
+        
+        void reset() {
+            std::lock_guard<std::mutex> lock(this->data->mutex);
+            this->data->entries.clear();
+        }
+        
+    protected:
+        struct recorder {
+            internal::latency_histogram histogram;
+            uint64 total = 0;
+            uint64 max = 0;
+            
+            void add(uint64 value) {
+                this->histogram.add(value);
+                this->total += value;
+                this->max = std::max(this->max, value);
+            }
+            
+            /**
+             *  Histogram percentiles are bucket bounds so they are clamped with the exact maximum.
+             */
+            latency_stats stats() const {
+                return {
+                    std::chrono::nanoseconds(this->total),
+                    std::chrono::nanoseconds(std::min(this->histogram.percentile(0.5), this->max)),
+                    std::chrono::nanoseconds(std::min(this->histogram.percentile(0.99), this->max)),
+                    std::chrono::nanoseconds(this->max),
+                };
+            }
+        };
+        
+        struct entry {
+            int64 calls = 0;
+            recorder latency;
+            std::array<recorder, phases_count> phases;
+        };
+        
+        struct storage_data {
+            std::mutex mutex;
+            std::map<std::string, entry> entries;
+        };
+        
+        std::shared_ptr<storage_data> data = std::make_shared<storage_data>();
+        
+        void add(const char *operation, std::chrono::steady_clock::duration elapsed, const std::array<std::chrono::steady_clock::duration, phases_count> &durations) {
+            auto toNanoseconds = [](std::chrono::steady_clock::duration d) {
+                return static_cast<uint64>(std::chrono::duration_cast<std::chrono::nanoseconds>(d).count());
+            };
+            std::lock_guard<std::mutex> lock(this->data->mutex);
+            auto &e = this->data->entries[operation];
+            ++e.calls;
+            e.latency.add(toNanoseconds(elapsed));
+            for(size_t i = 0; i < phases_count; ++i) {
+                e.phases[i].add(toNanoseconds(durations[i]));
+            }
+        }
+    };
+}
@@ -1,118 +1,59 @@
 #pragma once
 
+#include <type_traits>  //  std::true_type, std::false_type
+
 #include "conditions.h"
 
 namespace sqlite_orm {
     
     namespace internal {
         
-        template<class ...Args>
-        struct join_iterator {
-            
-            template<class L>
-            void operator()(L) {
-                //..
-            }
-        };
+        /**
+         *  Join traits. Common case.
+         */
+        template<class T>
+        struct is_join : std::false_type {};
         
-        template<>
-        struct join_iterator<> {
-            
-            template<class L>
-            void operator()(L) {
-                //..
-            }
-        };
+        template<class T>
+        struct is_join<conditions::cross_join_t<T>> : std::true_type {};
         
-        template<class H, class ...Tail>
-        struct join_iterator<H, Tail...> : public join_iterator<Tail...>{
-            using super = join_iterator<Tail...>;
-            
-            H h;
-            
-            template<class L>
-            void operator()(L l) {
-                this->super::operator()(l);
-            }
-            
-        };
+        template<class T>
+        struct is_join<conditions::natural_join_t<T>> : std::true_type {};
         
-        template<class T, class ...Tail>
-        struct join_iterator<conditions::cross_join_t<T>, Tail...> : public join_iterator<Tail...>{
-            using super = join_iterator<Tail...>;
-            
-            conditions::cross_join_t<T> h;
-            
-            template<class L>
-            void operator()(L l) {
-                l(h);
-                this->super::operator()(l);
-            }
-        };
+        template<class T, class O>
+        struct is_join<conditions::left_join_t<T, O>> : std::true_type {};
         
-        template<class T, class ...Tail>
-        struct join_iterator<conditions::natural_join_t<T>, Tail...> : public join_iterator<Tail...>{
-            using super = join_iterator<Tail...>;
-            
-            conditions::natural_join_t<T> h;
-            
-            template<class L>
-            void operator()(L l) {
-                l(h);
-                this->super::operator()(l);
-            }
-        };
+        template<class T, class O>
+        struct is_join<conditions::join_t<T, O>> : std::true_type {};
         
-        template<class T, class O, class ...Tail>
-        struct join_iterator<conditions::left_join_t<T, O>, Tail...> : public join_iterator<Tail...> {
-            using super = join_iterator<Tail...>;
-            
-            conditions::left_join_t<T, O> h;
-            
-            template<class L>
-            void operator()(L l) {
-                l(h);
-                this->super::operator()(l);
-            }
-        };
+        template<class T, class O>
+        struct is_join<conditions::left_outer_join_t<T, O>> : std::true_type {};
         
-        template<class T, class O, class ...Tail>
-        struct join_iterator<conditions::join_t<T, O>, Tail...> : public join_iterator<Tail...> {
-            using super = join_iterator<Tail...>;
-            
-            conditions::join_t<T, O> h;
-            
-            template<class L>
-            void operator()(L l) {
-                l(h);
-                this->super::operator()(l);
-            }
-        };
+        template<class T, class O>
+        struct is_join<conditions::inner_join_t<T, O>> : std::true_type {};
         
-        template<class T, class O, class ...Tail>
-        struct join_iterator<conditions::left_outer_join_t<T, O>, Tail...> : public join_iterator<Tail...> {
-            using super = join_iterator<Tail...>;
-            
-            conditions::left_outer_join_t<T, O> h;
+        /**
+         *  Calls lambda with a value of every join type from Args. Other arguments are skipped.
+         */
+        template<class ...Args>
+        struct join_iterator {
             
             template<class L>
             void operator()(L l) {
-                l(h);
-                this->super::operator()(l);
+                int _[] = {0, (this->template apply_if<Args>(l, is_join<Args>{}), int{})...};
+                (void)_;
+                (void)l;
             }
-        };
-        
-        template<class T, class O, class ...Tail>
-        struct join_iterator<conditions::inner_join_t<T, O>, Tail...> : public join_iterator<Tail...> {
-            using super = join_iterator<Tail...>;
-            
-            conditions::inner_join_t<T, O> h;
             
-            template<class L>
-            void operator()(L l) {
-                l(h);
-                this->super::operator()(l);
+        protected:
+            template<class J, class L>
+            void apply_if(L &l, std::true_type) {
+                J j{};
+                l(j);
             }
+            
+            template<class J, class L>
+            void apply_if(L &, std::false_type) {}
         };
     }
 }
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <string>   //  std::string
+#include <chrono>   //  std::chrono::milliseconds
+
+#include "sqlite_type.h"
+
+namespace sqlite_orm {
+    
+    /**
+     *  Online table migration state passed to a progress callback after every copied chunk.
+     *  See `storage_t::enable_online_migration`.
+     */
+    struct migration_progress {
+        
+        /**
+         *  Name of table being migrated
+         */
+        std::string table_name;
+        
+        /**
+         *  Rows copied so far
+         */
+        int64 rows_copied;
+        
+        /**
+         *  Rows count at the moment migration started. Rows inserted later are copied too so
+         *  `rows_copied` may exceed it.
+         */
+        int64 rows_total;
+        
+        std::chrono::milliseconds elapsed;
+        
+        /**
+         *  Estimated time left based on average speed of copied chunks
+         */
+        std::chrono::milliseconds eta;
+    };
+}
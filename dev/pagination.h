@@ -0,0 +1,193 @@
+#pragma once
+
+#include <sqlite3.h>
+#include <string>   //  std::string
+#include <vector>   //  std::vector
+#include <cstring>  //  std::memcpy
+#include <cstdlib>  //  std::strtoll
+#include <system_error> //  std::system_error
+
+#include "sqlite_type.h"
+#include "error_code.h"
+
+namespace sqlite_orm {
+    
+    /**
+     *  Result of `storage_t::paginate`.
+     */
+    template<class O>
+    struct page {
+        
+        /**
+         *  Objects of the page. There are less objects than page size on the last page only.
+         */
+        std::vector<O> objects;
+        
+        /**
+         *  Token passed to `paginate` to fetch the next page. Is empty if this page is the last one.
+         */
+        std::string next_token;
+    };
+    
+    namespace internal {
+        
+        /**
+         *  Continuation token of keyset pagination. Keeps sort key values of the last row of a page with their
+         *  storage classes so they are compared exactly like stored values. Token is printable:
+         *  every value is a type letter followed by its payload - 'n' null, 'i' decimal integer, 'f' hex of
+         *  double bits, 't' hex of text bytes, 'b' hex of blob bytes. Payloads are terminated with ';'.
+         */
+        struct page_token {
+            
+            struct value {
+                int type = SQLITE_NULL;
+                int64 integer = 0;
+                double real = 0;
+                std::string bytes;
+            };
+            
+            /**
+             *  Encodes `count` result columns starting from `firstColumn`.
+             */
+            static std::string encode(sqlite3_stmt *stmt, int firstColumn, int count) {
+                std::string res;
+                for(auto column = firstColumn; column < firstColumn + count; ++column) {
+                    switch(sqlite3_column_type(stmt, column)) {
+                        case SQLITE_INTEGER:
+                            res += 'i';
+                            res += std::to_string(sqlite3_column_int64(stmt, column));
+                            break;
+                        case SQLITE_FLOAT:{
+                            auto real = sqlite3_column_double(stmt, column);
+                            uint64 bits;
+                            std::memcpy(&bits, &real, sizeof(bits));
+                            res += 'f';
+                            for(auto shift = 60; shift >= 0; shift -= 4) {
+                                res += hex_digit(static_cast<int>((bits >> shift) & 0xf));
+                            }
+                        }break;
+                        case SQLITE_TEXT:
+                        case SQLITE_BLOB:{
+                            auto isText = sqlite3_column_type(stmt, column) == SQLITE_TEXT;
+                            auto data = static_cast<const unsigned char*>(isText ? sqlite3_column_text(stmt, column) : sqlite3_column_blob(stmt, column));
+                            auto length = sqlite3_column_bytes(stmt, column);
+                            res += isText ? 't' : 'b';
+                            for(auto i = 0; i < length; ++i) {
+                                res += hex_digit(data[i] >> 4);
+                                res += hex_digit(data[i] & 0xf);
+                            }
+                        }break;
+                        default:
+                            res += 'n';
+                            break;
+                    }
+                    res += ';';
+                }
+                return res;
+            }
+            
+            /**
+             *  throws std::system_error with orm_error_code::incorrect_page_token if token is corrupted or
+             *  has a different values count.
+             */
+            static std::vector<value> decode(const std::string &token, size_t count) {
+                std::vector<value> res;
+                size_t position = 0;
+                while(position < token.length()) {
+                    auto end = token.find(';', position);
+                    if(end == std::string::npos) {
+                        throw std::system_error(std::make_error_code(orm_error_code::incorrect_page_token));
+                    }
+                    auto type = token[position];
+                    auto payload = token.substr(position + 1, end - position - 1);
+                    value v;
+                    switch(type) {
+                        case 'n':
+                            if(payload.length()) {
+                                throw std::system_error(std::make_error_code(orm_error_code::incorrect_page_token));
+                            }
+                            break;
+                        case 'i':{
+                            char *parsedEnd = nullptr;
+                            v.type = SQLITE_INTEGER;
+                            v.integer = std::strtoll(payload.c_str(), &parsedEnd, 10);
+                            if(payload.empty() || *parsedEnd) {
+                                throw std::system_error(std::make_error_code(orm_error_code::incorrect_page_token));
+                            }
+                        }break;
+                        case 'f':{
+                            auto bytes = from_hex(payload);
+                            if(bytes.length() != sizeof(uint64)) {
+                                throw std::system_error(std::make_error_code(orm_error_code::incorrect_page_token));
+                            }
+                            uint64 bits = 0;
+                            for(auto c : bytes) {
+                                bits = (bits << 8) | static_cast<unsigned char>(c);
+                            }
+                            v.type = SQLITE_FLOAT;
+                            std::memcpy(&v.real, &bits, sizeof(bits));
+                        }break;
+                        case 't':
+                            v.type = SQLITE_TEXT;
+                            v.bytes = from_hex(payload);
+                            break;
+                        case 'b':
+                            v.type = SQLITE_BLOB;
+                            v.bytes = from_hex(payload);
+                            break;
+                        default:
+                            throw std::system_error(std::make_error_code(orm_error_code::incorrect_page_token));
+                    }
+                    res.push_back(std::move(v));
+                    position = end + 1;
+                }
+                if(res.size() != count) {
+                    throw std::system_error(std::make_error_code(orm_error_code::incorrect_page_token));
+                }
+                return res;
+            }
+            
+            static int bind(sqlite3_stmt *stmt, int index, const value &v) {
+                switch(v.type) {
+                    case SQLITE_INTEGER:
+                        return sqlite3_bind_int64(stmt, index, v.integer);
+                    case SQLITE_FLOAT:
+                        return sqlite3_bind_double(stmt, index, v.real);
+                    case SQLITE_TEXT:
+                        return sqlite3_bind_text(stmt, index, v.bytes.c_str(), static_cast<int>(v.bytes.length()), SQLITE_TRANSIENT);
+                    case SQLITE_BLOB:
+                        return sqlite3_bind_blob(stmt, index, v.bytes.data(), static_cast<int>(v.bytes.length()), SQLITE_TRANSIENT);
+                    default:
+                        return sqlite3_bind_null(stmt, index);
+                }
+            }
+            
+        protected:
+            static char hex_digit(int value) {
+                return "0123456789abcdef"[value];
+            }
+            
+            static std::string from_hex(const std::string &hex) {
+                if(hex.length() % 2) {
+                    throw std::system_error(std::make_error_code(orm_error_code::incorrect_page_token));
+                }
+                std::string res;
+                res.reserve(hex.length() / 2);
+                for(size_t i = 0; i < hex.length(); i += 2) {
+                    res += static_cast<char>(hex_value(hex[i]) * 16 + hex_value(hex[i + 1]));
+                }
+                return res;
+            }
+            
+            static int hex_value(char c) {
+                if(c >= '0' && c <= '9') {
+                    return c - '0';
+                }else if(c >= 'a' && c <= 'f') {
+                    return c - 'a' + 10;
+                }else{
+                    throw std::system_error(std::make_error_code(orm_error_code::incorrect_page_token));
+                }
+            }
+        };
+    }
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <sqlite3.h>
+#include <tuple>    //  std::tuple, std::get
+#include <type_traits>  //  std::decay
+#include <utility>  //  std::index_sequence, std::index_sequence_for
+
+#include "tuple_helper.h"
+#include "statement_binder.h"
+#include "row_extractor.h"
+
+namespace sqlite_orm {
+    
+    namespace internal {
+        
+        /**
+         *  Binds and extracts primary key values used by multi-get functions. Single column primary key
+         *  is a value of its field type. Composite primary key is `std::tuple` with values in the same order
+         *  as columns are passed to `primary_key()`. Its columns are bound in reversed order just like
+         *  `storage_t::get` binds ids and `table_t::primary_key_column_names` returns names.
+         */
+        template<class T>
+        struct primary_key_value {
+            static constexpr const int columns_count = 1;
+            
+            static void bind(sqlite3_stmt *stmt, int &index, const T &value) {
+                statement_binder<T>().bind(stmt, index++, value);
+            }
+            
+            static T extract(sqlite3_stmt *stmt, int &index) {
+                return row_extractor<T>().extract(stmt, index++);
+            }
+        };
+        
+        template<class ...Ts>
+        struct primary_key_value<std::tuple<Ts...>> {
+            static constexpr const int columns_count = static_cast<int>(sizeof...(Ts));
+            
+            static void bind(sqlite3_stmt *stmt, int &index, const std::tuple<Ts...> &value) {
+                tuple_helper::iterator<sizeof...(Ts) - 1, Ts...>()(value, [stmt, &index](auto &v){
+                    using field_type = typename std::decay<decltype(v)>::type;
+                    statement_binder<field_type>().bind(stmt, index++, v);
+                });
+            }
+            
+            static std::tuple<Ts...> extract(sqlite3_stmt *stmt, int &index) {
+                std::tuple<Ts...> res;
+                extract_reversed(res, stmt, index, std::index_sequence_for<Ts...>{});
+                return res;
+            }
+            
+        protected:
+            template<size_t ...I>
+            static void extract_reversed(std::tuple<Ts...> &res, sqlite3_stmt *stmt, int &index, std::index_sequence<I...>) {
+                int _[] = {0, (extract_element<sizeof...(Ts) - 1 - I>(res, stmt, index), int{})...};
+                (void)_;
+            }
+            
+            template<size_t N>
+            static void extract_element(std::tuple<Ts...> &res, sqlite3_stmt *stmt, int &index) {
+                using field_type = typename std::tuple_element<N, std::tuple<Ts...>>::type;
+                std::get<N>(res) = row_extractor<field_type>().extract(stmt, index++);
+            }
+        };
+    }
+}
@@ -0,0 +1,282 @@
+#pragma once
+
+#include <sqlite3.h>
+#include <string>   //  std::string
+#include <vector>   //  std::vector
+#include <map>  //  std::map
+#include <array>    //  std::array
+#include <mutex>    //  std::mutex, std::lock_guard
+#include <chrono>   //  std::chrono::nanoseconds
+#include <algorithm>    //  std::sort, std::max, std::min
+#include <cctype>   //  std::isdigit, std::isalpha, std::isalnum, std::isspace, std::toupper
+
+#include "sqlite_type.h"
+
+namespace sqlite_orm {
+    
+    /**
+     *  Aggregated statistics of a normalized SQL statement collected by storage profiler.
+     *  See `storage_t::enable_profiling`.
+     */
+    struct query_profile {
+        
+        /**
+         *  Statement text with literals replaced with `?`
+         */
+        std::string sql;
+        
+        /**
+         *  How many times statement was executed
+         */
+        int64 calls;
+        
+        /**
+         *  Rows returned by all executions
+         */
+        int64 rows;
+        
+        std::chrono::nanoseconds total;
+        
+        /**
+         *  Median and 99th percentile latencies. Histogram based so precision is about 25%.
+         */
+        std::chrono::nanoseconds p50;
+        std::chrono::nanoseconds p99;
+        
+        std::chrono::nanoseconds max;
+    };
+    
+    namespace internal {
+        
+        /**
+         *  Logarithmic latency histogram: every power of two is split into 4 buckets.
+         */
+        struct latency_histogram {
+            
+            void add(uint64 value) {
+                ++this->buckets[index(value)];
+                ++this->count;
+            }
+            
+            /**
+             *  Returns upper bound of a bucket containing a given percentile (0 - 1).
+             */
+            uint64 percentile(double p) const {
+                if(!this->count){
+                    return 0;
+                }
+                auto rank = static_cast<uint64>(p * static_cast<double>(this->count - 1)) + 1;
+                uint64 seen = 0;
+                for(size_t i = 0; i < this->buckets.size(); ++i) {
+                    seen += this->buckets[i];
+                    if(seen >= rank) {
+                        return upper_bound(i);
+                    }
+                }
+                return upper_bound(this->buckets.size() - 1);
+            }
+            
+        protected:
+            std::array<uint64, 256> buckets{};
+            uint64 count = 0;
+            
+            static size_t index(uint64 value) {
+                if(value < 4){
+                    return static_cast<size_t>(value);
+                }
+                size_t msb = 0;
+                for(auto v = value; v > 1; v >>= 1) {
+                    ++msb;
+                }
+                auto sub = static_cast<size_t>((value >> (msb - 2)) & 3);
+                return msb * 4 + sub;
+            }
+            
+            static uint64 upper_bound(size_t index) {
+                if(index < 4){
+                    return index;
+                }
+                auto msb = index / 4;
+                auto sub = index % 4;
+                return ((4 + sub + 1) << (msb - 2)) - 1;
+            }
+        };
+        
+        /**
+         *  Collects statistics of statements executed by storage connections. Is fed by
+         *  `sqlite3_trace_v2` callback so it must be thread safe: storage may use several
+         *  connections from different threads.
+         */
+        struct profiler {
+            
+            /**
+             *  SQLITE_TRACE_ROW event
+             */
+            void on_row(sqlite3_stmt *stmt) {
+                std::lock_guard<std::mutex> lock(this->mutex);
+                ++this->rowsInProgress[stmt];
+            }
+            
+            /**
+             *  SQLITE_TRACE_PROFILE event. Fired once statement is finished.
+             */
+            void on_profile(sqlite3_stmt *stmt, uint64 nanoseconds) {
+                auto rawSql = sqlite3_sql(stmt);
+                auto sql = normalize_sql(rawSql ? rawSql : "");
+                std::lock_guard<std::mutex> lock(this->mutex);
+                auto &entry = this->entries[sql];
+                ++entry.calls;
+                entry.total += nanoseconds;
+                entry.max = std::max(entry.max, nanoseconds);
+                entry.histogram.add(nanoseconds);
+                auto rowsIt = this->rowsInProgress.find(stmt);
+                if(rowsIt != this->rowsInProgress.end()) {
+                    entry.rows += rowsIt->second;
+                    this->rowsInProgress.erase(rowsIt);
+                }
+            }
+            
+            /**
+             *  @return statistics of at most `topN` statements with the biggest total time.
+             */
+            std::vector<query_profile> snapshot(size_t topN) {
+                std::vector<query_profile> res;
+                {
+                    std::lock_guard<std::mutex> lock(this->mutex);
+                    res.reserve(this->entries.size());
+                    for(auto &p : this->entries) {
+                        auto &entry = p.second;
+                        
+                        //  bucket upper bounds may exceed the slowest call for a few samples
+                        res.push_back({
+                            p.first,
+                            entry.calls,
+                            entry.rows,
+                            std::chrono::nanoseconds(entry.total),
+                            std::chrono::nanoseconds(std::min(entry.histogram.percentile(0.5), entry.max)),
+                            std::chrono::nanoseconds(std::min(entry.histogram.percentile(0.99), entry.max)),
+                            std::chrono::nanoseconds(entry.max),
+                        });
+                    }
+                }
+                std::sort(res.begin(), res.end(), [](const query_profile &lhs, const query_profile &rhs) {
+                    return lhs.total > rhs.total;
+                });
+                if(res.size() > topN) {
+                    res.resize(topN);
+                }
+                return res;
+            }
+            
+            void reset() {
+                std::lock_guard<std::mutex> lock(this->mutex);
+                this->entries.clear();
+                this->rowsInProgress.clear();
+            }
+            
+            /**
+             *  Replaces numeric and string literals with `?` and collapses whitespaces so statements
+             *  which differ by inlined values only are aggregated together. Single quoted strings used
+             *  as identifiers (followed by `.` or preceded by FROM, INTO, JOIN, UPDATE, TABLE, ON) are kept.
+             *  Lists of literals like `IN (1, 2, 3)` are collapsed into a single `?`.
+             */
+            static std::string normalize_sql(const std::string &sql) {
+                std::string res;
+                res.reserve(sql.length());
+                
+                //  true after FROM, INTO etc keyword and inside comma separated list after it
+                auto identifierContext = false;
+                auto appendPlaceholder = [&res] {
+                    
+                    //  `?, ?` -> `?`
+                    auto end = res.find_last_not_of(' ');
+                    if(end != std::string::npos && res[end] == ',' && end > 0) {
+                        auto previous = res.find_last_not_of(' ', end - 1);
+                        if(previous != std::string::npos && res[previous] == '?') {
+                            res.resize(previous + 1);
+                            return;
+                        }
+                    }
+                    res += '?';
+                };
+                for(size_t i = 0; i < sql.length(); ) {
+                    auto c = sql[i];
+                    if(std::isspace(static_cast<unsigned char>(c))) {
+                        if(!res.empty() && res.back() != ' ') {
+                            res += ' ';
+                        }
+                        ++i;
+                    }else if(c == '\'') {
+                        auto end = i + 1;
+                        while(end < sql.length()) {
+                            if(sql[end] == '\'') {
+                                if(end + 1 < sql.length() && sql[end + 1] == '\'') {
+                                    end += 2;
+                                    continue;
+                                }
+                                break;
+                            }
+                            ++end;
+                        }
+                        auto next = end + 1;
+                        if(identifierContext || (next < sql.length() && sql[next] == '.')) {
+                            res.append(sql, i, next - i);
+                        }else{
+                            appendPlaceholder();
+                        }
+                        i = next;
+                    }else if(c == '"' || c == '`' || c == '[') {
+                        auto closing = c == '[' ? ']' : c;
+                        auto end = sql.find(closing, i + 1);
+                        if(end == std::string::npos) {
+                            end = sql.length() - 1;
+                        }
+                        res.append(sql, i, end - i + 1);
+                        i = end + 1;
+                    }else if(std::isalpha(static_cast<unsigned char>(c)) || c == '_') {
+                        auto end = i;
+                        std::string word;
+                        while(end < sql.length() && (std::isalnum(static_cast<unsigned char>(sql[end])) || sql[end] == '_' || sql[end] == '$')) {
+                            word += static_cast<char>(std::toupper(static_cast<unsigned char>(sql[end])));
+                            ++end;
+                        }
+                        identifierContext = word == "FROM" || word == "INTO" || word == "JOIN" || word == "UPDATE" || word == "TABLE" || word == "ON";
+                        res.append(sql, i, end - i);
+                        i = end;
+                    }else if(std::isdigit(static_cast<unsigned char>(c))) {
+                        auto end = i + 1;
+                        while(end < sql.length() && (std::isalnum(static_cast<unsigned char>(sql[end])) || sql[end] == '.')) {
+                            ++end;
+                        }
+                        appendPlaceholder();
+                        identifierContext = false;
+                        i = end;
+                    }else{
+                        if(c != ','){
+                            identifierContext = false;
+                        }
+                        res += c;
+                        ++i;
+                    }
+                }
+                while(!res.empty() && res.back() == ' ') {
+                    res.pop_back();
+                }
+                return res;
+            }
+            
+        protected:
+            struct entry {
+                int64 calls = 0;
+                int64 rows = 0;
+                uint64 total = 0;
+                uint64 max = 0;
+                latency_histogram histogram;
+            };
+            
+            std::mutex mutex;
+            std::map<std::string, entry> entries;
+            std::map<sqlite3_stmt*, int64> rowsInProgress;
+        };
+    }
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <string>   //  std::string
+#include <vector>   //  std::vector
+#include <sstream>  //  std::stringstream
+
+namespace sqlite_orm {
+    
+    /**
+     *  Single row of `EXPLAIN QUERY PLAN` output e.g. `SCAN users` or
+     *  `SEARCH users USING INTEGER PRIMARY KEY (rowid=?)`.
+     */
+    struct query_plan_node {
+        int id;
+        int parent;
+        std::string detail;
+        std::vector<query_plan_node> children;
+    };
+    
+    /**
+     *  `EXPLAIN QUERY PLAN` result returned by `storage_t::explain`. SQLite older than 3.24.0 doesn't
+     *  report nodes hierarchy so all nodes are roots there.
+     */
+    struct query_plan {
+        
+        /**
+         *  Explained query
+         */
+        std::string sql;
+        
+        /**
+         *  Top level nodes
+         */
+        std::vector<query_plan_node> nodes;
+        
+        /**
+         *  @return true if plan contains full scan of a table with name `tableName`
+         *  (`SCAN TABLE tableName` or `SCAN tableName` for SQLite 3.36.0 and newer).
+         */
+        bool scans(const std::string &tableName) const {
+            return scans(this->nodes, tableName);
+        }
+        
+        /**
+         *  @return plan as text with a node per line. Children are indented.
+         */
+        std::string to_string() const {
+            std::stringstream ss;
+            print(ss, this->nodes, 0);
+            return ss.str();
+        }
+        
+    protected:
+        static bool scans(const std::vector<query_plan_node> &nodes, const std::string &tableName) {
+            for(auto &node : nodes) {
+                std::string prefix = "SCAN ";
+                if(node.detail.compare(0, prefix.length(), prefix) == 0) {
+                    auto rest = node.detail.substr(prefix.length());
+                    std::string tablePrefix = "TABLE ";
+                    if(rest.compare(0, tablePrefix.length(), tablePrefix) == 0) {
+                        rest = rest.substr(tablePrefix.length());
+                    }
+                    if(rest.substr(0, rest.find(' ')) == tableName) {
+                        return true;
+                    }
+                }
+                if(scans(node.children, tableName)) {
+                    return true;
+                }
+            }
+            return false;
+        }
+        
+        static void print(std::stringstream &ss, const std::vector<query_plan_node> &nodes, size_t depth) {
+            for(auto &node : nodes) {
+                ss << std::string(depth * 2, ' ') << node.detail << std::endl;
+                print(ss, node.children, depth + 1);
+            }
+        }
+    };
+}
@@ -118,6 +118,30 @@ namespace sqlite_orm {
             conditions_type conditions;
         };
         
+        /**
+         *  `SELECT * FROM T` expression object. Is not executed by itself: is used with
+         *  `storage_t::sql` and `storage_t::explain`.
+         */
+        template<class T, class ...Args>
+        struct get_all_t {
+            using type = T;
+            using conditions_type = std::tuple<Args...>;
+            
+            conditions_type conditions;
+        };
+        
+        /**
+         *  `SELECT COUNT(*) FROM T` expression object. Is not executed by itself: is used with
+         *  `storage_t::sql` and `storage_t::explain`.
+         */
+        template<class T, class ...Args>
+        struct count_all_t {
+            using type = T;
+            using conditions_type = std::tuple<Args...>;
+            
+            conditions_type conditions;
+        };
+        
         /**
          *  Union object type.
          */
@@ -133,7 +157,7 @@ namespace sqlite_orm {
             union_t(left_type l, right_type r, decltype(all) all_): left(std::move(l)), right(std::move(r)), all(all_) {}
             
             union_t(left_type l, right_type r): left(std::move(l)), right(std::move(r)) {}
-
+            
             operator std::string() const {
                 if(!this->all){
                     return "UNION";
@@ -205,6 +229,24 @@ namespace sqlite_orm {
         return {std::move(t), std::make_tuple<Args...>(std::forward<Args>(args)...)};
     }
     
+    /**
+     *  Public function for `storage.get_all<T>(args...)` expression preview.
+     *  Example: storage.explain(get_all<User>(where(c(&User::name) == "Bob")));
+     */
+    template<class T, class ...Args>
+    internal::get_all_t<T, Args...> get_all(Args ...args) {
+        return {std::make_tuple<Args...>(std::forward<Args>(args)...)};
+    }
+    
+    /**
+     *  Public function for `storage.count<T>(args...)` expression preview.
+     *  Example: storage.sql(count<User>(where(is_null(&User::email))));
+     */
+    template<class T, class ...Args>
+    internal::count_all_t<T, Args...> count(Args ...args) {
+        return {std::make_tuple<Args...>(std::forward<Args>(args)...)};
+    }
+    
     /**
      *  Public function for UNION operator.
      *  lhs and rhs are subselect objects.
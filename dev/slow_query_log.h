@@ -0,0 +1,163 @@
+#pragma once
+
+#include <sqlite3.h>
+#include <string>   //  std::string
+#include <vector>   //  std::vector
+#include <deque>    //  std::deque
+#include <mutex>    //  std::mutex, std::lock_guard
+#include <chrono>   //  std::chrono::nanoseconds
+#include <functional>   //  std::function
+
+#include "sqlite_type.h"
+
+namespace sqlite_orm {
+    
+    /**
+     *  Statement which took longer than slow query log threshold.
+     *  See `storage_t::enable_slow_query_log`.
+     */
+    struct slow_query {
+        
+        /**
+         *  Statement text as it was prepared
+         */
+        std::string sql;
+        
+        /**
+         *  Statement text with bound parameters values (`sqlite3_expanded_sql`)
+         */
+        std::string expanded_sql;
+        
+        /**
+         *  Name of the table mapped to a type storage operation was called for. Empty if operation
+         *  is not bound to a single mapped type (e.g. `select`).
+         */
+        std::string table_name;
+        
+        /**
+         *  Storage function name e.g. `get_all` or `update_all`. Empty for statements executed
+         *  outside of storage operations (e.g. by iterator of `iterate`).
+         */
+        std::string operation;
+        
+        std::chrono::nanoseconds elapsed;
+    };
+    
+    namespace internal {
+        
+        /**
+         *  Storage operation being performed by current thread. Operations form a stack cause
+         *  one operation may call another one.
+         */
+        struct operation_context {
+            const char *operation;
+            const std::string *table_name;
+            operation_context *previous;
+            
+            static operation_context*& current() {
+                static thread_local operation_context *res = nullptr;
+                return res;
+            }
+        };
+        
+        /**
+         *  RAII object which marks storage operation for trace callbacks fired within it.
+         */
+        struct operation_scope {
+            
+            operation_scope(const char *operation, const std::string *tableName = nullptr): context{operation, tableName, operation_context::current()} {
+                operation_context::current() = &this->context;
+            }
+            
+            operation_scope(const operation_scope &) = delete;
+            
+            ~operation_scope() {
+                operation_context::current() = this->context.previous;
+            }
+            
+        protected:
+            operation_context context;
+        };
+        
+        /**
+         *  Keeps statements slower than threshold. Records are passed to sink if it is set or
+         *  are kept in a ring buffer otherwise. Is fed by `sqlite3_trace_v2` callback so it must be thread safe.
+         */
+        struct slow_query_log {
+            
+            void configure(std::chrono::nanoseconds threshold_, std::function<void(const slow_query&)> sink_, size_t capacity_) {
+                std::lock_guard<std::mutex> lock(this->mutex);
+                this->threshold = threshold_;
+                this->sink = std::move(sink_);
+                this->capacity = capacity_;
+                while(this->records.size() > this->capacity) {
+                    this->records.pop_front();
+                }
+            }
+            
+            /**
+             *  SQLITE_TRACE_PROFILE event. Statement is still valid so bound values can be extracted.
+             */
+            void on_profile(sqlite3_stmt *stmt, uint64 nanoseconds) {
+                std::function<void(const slow_query&)> sinkCopy;
+                {
+                    std::lock_guard<std::mutex> lock(this->mutex);
+                    if(std::chrono::nanoseconds(nanoseconds) < this->threshold) {
+                        return;
+                    }
+                    sinkCopy = this->sink;
+                }
+                slow_query record;
+                if(auto sql = sqlite3_sql(stmt)) {
+                    record.sql = sql;
+                }
+#if SQLITE_VERSION_NUMBER >= 3014000
+                if(auto expandedSql = sqlite3_expanded_sql(stmt)) {
+                    record.expanded_sql = expandedSql;
+                    sqlite3_free(expandedSql);
+                }
+#endif
+                if(auto context = operation_context::current()) {
+                    record.operation = context->operation;
+                    if(context->table_name) {
+                        record.table_name = *context->table_name;
+                    }
+                }
+                record.elapsed = std::chrono::nanoseconds(nanoseconds);
+                
+                //  sink is called without lock so it is able to use storage
+                if(sinkCopy) {
+                    sinkCopy(record);
+                }else{
+                    std::lock_guard<std::mutex> lock(this->mutex);
+                    if(this->capacity) {
+                        if(this->records.size() == this->capacity) {
+                            this->records.pop_front();
+                        }
+                        this->records.push_back(std::move(record));
+                    }
+                }
+            }
+            
+            /**
+             *  @return records kept in ring buffer from oldest to newest.
+             */
+            std::vector<slow_query> get_records() {
+                std::lock_guard<std::mutex> lock(this->mutex);
+                return {this->records.begin(), this->records.end()};
+            }
+            
+            void clear() {
+                std::lock_guard<std::mutex> lock(this->mutex);
+                this->records.clear();
+            }
+            
+        protected:
+            std::mutex mutex;
+            std::chrono::nanoseconds threshold = std::chrono::nanoseconds::zero();
+            std::function<void(const slow_query&)> sink;
+            size_t capacity = 0;
+            std::deque<slow_query> records;
+        };
+    }
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <sqlite3.h>
+
+namespace sqlite_orm {
+    
+    /**
+     *  Guard class which resets and clears bindings of a cached `sqlite3_stmt` in dtor.
+     *  Is used instead of `statement_finalizer` with statements owned by `database_connection`.
+     */
+    struct statement_resetter {
+        sqlite3_stmt *stmt = nullptr;
+        
+        statement_resetter(decltype(stmt) stmt_): stmt(stmt_) {}
+        
+        inline ~statement_resetter() {
+            sqlite3_reset(this->stmt);
+            sqlite3_clear_bindings(this->stmt);
+        }
+    };
+}
@@ -0,0 +1,161 @@
+#pragma once
+
+#include <sqlite3.h>
+#include <string>   //  std::string
+#include <map>  //  std::map
+#include <utility>  //  std::pair, std::make_pair
+#include <mutex>    //  std::mutex, std::lock_guard
+#include <algorithm>    //  std::max
+
+#include "sqlite_type.h"
+#include "slow_query_log.h"
+
+namespace sqlite_orm {
+    
+    /**
+     *  `sqlite3_stmt_status` counters summed over statements executed by storage operations.
+     *  See `storage_t::enable_statement_stats`.
+     */
+    struct statement_counters {
+        
+        /**
+         *  Statements executed
+         */
+        int64 calls = 0;
+        
+        /**
+         *  SQLITE_STMTSTATUS_FULLSCAN_STEP: steps of full table scans. Non zero value usually means
+         *  that an index is missing.
+         */
+        int64 fullscan_steps = 0;
+        
+        /**
+         *  SQLITE_STMTSTATUS_SORT: sort operations which could not be served by an index
+         */
+        int64 sorts = 0;
+        
+        /**
+         *  SQLITE_STMTSTATUS_AUTOINDEX: rows inserted into transient automatic indexes
+         */
+        int64 autoindexes = 0;
+        
+        /**
+         *  SQLITE_STMTSTATUS_VM_STEP: virtual machine operations executed
+         */
+        int64 vm_steps = 0;
+        
+        /**
+         *  SQLITE_STMTSTATUS_REPREPARE: automatic statement regenerations caused by schema changes
+         */
+        int64 reprepares = 0;
+        
+        /**
+         *  SQLITE_STMTSTATUS_MEMUSED: the biggest heap usage of a single statement in bytes
+         */
+        int64 max_memused = 0;
+        
+        statement_counters& operator+=(const statement_counters &other) {
+            this->calls += other.calls;
+            this->fullscan_steps += other.fullscan_steps;
+            this->sorts += other.sorts;
+            this->autoindexes += other.autoindexes;
+            this->vm_steps += other.vm_steps;
+            this->reprepares += other.reprepares;
+            this->max_memused = std::max(this->max_memused, other.max_memused);
+            return *this;
+        }
+    };
+    
+    /**
+     *  Statement counters grouped by mapped table name and storage operation name (e.g. `get_all`).
+     *  Statements executed outside of storage operations are stored with empty table and operation names.
+     */
+    struct statement_stats {
+        using key_type = std::pair<std::string, std::string>;
+        
+        std::map<key_type, statement_counters> entries;
+        
+        /**
+         *  @return counters of `operation` called for table `tableName`. Counters of all operations called for
+         *  the table are summed if `operation` is empty.
+         */
+        statement_counters get(const std::string &tableName, const std::string &operation = {}) const {
+            statement_counters res;
+            if(!operation.empty()) {
+                auto it = this->entries.find(std::make_pair(tableName, operation));
+                if(it != this->entries.end()) {
+                    res = it->second;
+                }
+            }else{
+                for(auto &p : this->entries) {
+                    if(p.first.first == tableName) {
+                        res += p.second;
+                    }
+                }
+            }
+            return res;
+        }
+        
+        /**
+         *  @return counters of all statements
+         */
+        statement_counters total() const {
+            statement_counters res;
+            for(auto &p : this->entries) {
+                res += p.second;
+            }
+            return res;
+        }
+    };
+    
+    namespace internal {
+        
+        /**
+         *  Accumulates `sqlite3_stmt_status` counters of finished statements. Counters are reset after reading
+         *  cause cached statements are reused. Is fed by `sqlite3_trace_v2` callback so it must be thread safe.
+         */
+        struct statement_stats_collector {
+            
+            /**
+             *  SQLITE_TRACE_PROFILE event
+             */
+            void on_profile(sqlite3_stmt *stmt) {
+                statement_counters counters;
+                counters.calls = 1;
+                counters.fullscan_steps = sqlite3_stmt_status(stmt, SQLITE_STMTSTATUS_FULLSCAN_STEP, 1);
+                counters.sorts = sqlite3_stmt_status(stmt, SQLITE_STMTSTATUS_SORT, 1);
+                counters.autoindexes = sqlite3_stmt_status(stmt, SQLITE_STMTSTATUS_AUTOINDEX, 1);
+#if SQLITE_VERSION_NUMBER >= 3010000
+                counters.vm_steps = sqlite3_stmt_status(stmt, SQLITE_STMTSTATUS_VM_STEP, 1);
+#endif
+#if SQLITE_VERSION_NUMBER >= 3020000
+                counters.reprepares = sqlite3_stmt_status(stmt, SQLITE_STMTSTATUS_REPREPARE, 1);
+                counters.max_memused = sqlite3_stmt_status(stmt, SQLITE_STMTSTATUS_MEMUSED, 0);
+#endif
+                statement_stats::key_type key;
+                if(auto context = operation_context::current()) {
+                    key.second = context->operation;
+                    if(context->table_name) {
+                        key.first = *context->table_name;
+                    }
+                }
+                std::lock_guard<std::mutex> lock(this->mutex);
+                this->stats.entries[key] += counters;
+            }
+            
+            statement_stats snapshot() {
+                std::lock_guard<std::mutex> lock(this->mutex);
+                return this->stats;
+            }
+            
+            void reset() {
+                std::lock_guard<std::mutex> lock(this->mutex);
+                this->stats.entries.clear();
+            }
+            
+        protected:
+            std::mutex mutex;
+            statement_stats stats;
+        };
+    }
+}
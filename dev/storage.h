@@ -5,7 +5,7 @@
 #include <sqlite3.h>
 #include <type_traits>  //  std::remove_reference, std::is_base_of, std::decay
 #include <cstddef>  //  std::ptrdiff_t
-#include <iterator> //  std::input_iterator_tag, std::iterator_traits, std::distance
+#include <iterator> //  std::input_iterator_tag, std::iterator_traits, std::distance, std::back_inserter
 #include <system_error> //  std::system_error
 #include <functional>   //  std::function
 #include <sstream>  //  std::stringstream
@@ -14,12 +14,19 @@
 #include <tuple>    //  std::tuple_size, std::tuple
 #include <utility>  //  std::forward
 #include <set>  //  std::set
-#include <algorithm>    //  std::find
+#include <algorithm>    //  std::find, std::copy_if, std::min, std::max
+#include <cctype>   //  std::isspace
+#include <iomanip>  //  std::setw, std::setfill
+#include <chrono>   //  std::chrono::steady_clock, std::chrono::duration_cast
+#include <thread>   //  std::this_thread::yield
+#include <limits>   //  std::numeric_limits
+#include <cassert>  //  assert
 
 #include "alias.h"
 #include "database_connection.h"
 #include "row_extractor.h"
 #include "statement_finalizer.h"
+#include "statement_resetter.h"
 #include "error_code.h"
 #include "type_printer.h"
 #include "tuple_helper.h"
@@ -27,6 +34,7 @@
 #include "table_type.h"
 #include "type_is_nullable.h"
 #include "field_printer.h"
+#include "field_comparator.h"
 #include "rowid.h"
 #include "aggregate_functions.h"
 #include "operators.h"
@@ -37,7 +45,14 @@
 #include "column_result.h"
 #include "mapped_type_proxy.h"
 #include "sync_schema_result.h"
+#include "migration_progress.h"
+#include "tracer.h"
+#include "query_plan.h"
+#include "storage_stats.h"
+#include "instrumentation.h"
 #include "table_info.h"
+#include "primary_key_value.h"
+#include "pagination.h"
 #include "storage_impl.h"
 #include "transaction_guard.h"
 
@@ -47,27 +62,35 @@ namespace sqlite_orm {
         
         /**
          *  Storage class itself. Create an instanse to use it as an interfacto to sqlite db by calling `make_storage` function.
+         *  P - instrumentation policy (see `no_instrumentation` and `latency_instrumentation`)
          */
-        template<class ...Ts>
-        struct storage_t {
-            using storage_type = storage_t<Ts...>;
+        template<class P, class ...Ts>
+        struct basic_storage {
+            using storage_type = basic_storage<P, Ts...>;
             using impl_type = storage_impl<Ts...>;
+            using instrumentation_type = P;
             
             template<class T, class ...Args>
             struct view_t {
                 using mapped_type = T;
                 
-                storage_t &storage;
+                basic_storage &storage;
                 std::shared_ptr<internal::database_connection> connection;
                 
+                /**
+                 *  Owns temp tables of `in` conditions used by `query`.
+                 */
+                internal::query_context context;
+                
                 const std::string query;
                 
-                view_t(storage_t &stor, decltype(connection) conn, Args&& ...args):
+                view_t(basic_storage &stor, decltype(connection) conn, Args&& ...args):
                 storage(stor),
                 connection(conn),
-                query([&args..., &stor]{
+                context(conn),
+                query([&args..., &stor, this]{
                     std::string q;
-                    stor.template generate_select_asterisk<T>(&q, args...);
+                    stor.template generate_select_asterisk<T>(this->context, &q, args...);
                     return q;
                 }()){}
                 
@@ -231,7 +254,7 @@ namespace sqlite_orm {
                     this->set_pragma("auto_vacuum", value);
                 }
                 
-                friend struct storage_t<Ts...>;
+                friend struct basic_storage<P, Ts...>;
                 
             protected:
                 storage_type &storage;
@@ -240,28 +263,22 @@ namespace sqlite_orm {
                 template<class T>
                 T get_pragma(const std::string &name) {
                     auto connection = this->storage.get_or_create_connection();
-                    std::string query = "PRAGMA " + name;
-                    int res = -1;
-                    auto rc = sqlite3_exec(connection->get_db(),
-                                           query.c_str(),
-                                           [](void *data, int argc, char **argv, char **) -> int {
-                                               auto &res = *(T*)data;
-                                               if(argc){
-                                                   res = row_extractor<T>().extract(argv[0]);
-                                               }
-                                               return 0;
-                                           }, &res, nullptr);
-                    if(rc != SQLITE_OK) {
-                        throw std::system_error(std::error_code(sqlite3_errcode(connection->get_db()), get_sqlite_error_category()));
+                    auto db = connection->get_db();
+                    auto stmt = connection->get_statement("PRAGMA " + name);
+                    statement_resetter resetter{stmt};
+                    if(sqlite3_step(stmt) == SQLITE_ROW) {
+                        return row_extractor<T>().extract(stmt, 0);
+                    }else{
+                        throw std::system_error(std::error_code(sqlite3_errcode(db), get_sqlite_error_category()));
                     }
-                    return res;
                 }
                 
                 template<class T>
                 void set_pragma(const std::string &name, const T &value) {
                     auto connection = this->storage.get_or_create_connection();
+                    internal::query_context context{nullptr};
                     std::stringstream ss;
-                    ss << "PRAGMA " << name << " = " << this->storage.string_from_expression(value);
+                    ss << "PRAGMA " << name << " = " << this->storage.string_from_expression(context, value);
                     auto query = ss.str();
                     auto rc = sqlite3_exec(connection->get_db(), query.c_str(), nullptr, nullptr, nullptr);
                     if(rc != SQLITE_OK) {
@@ -376,7 +393,7 @@ namespace sqlite_orm {
                  */
                 std::map<int, int> limits;
                 
-                friend struct storage_t<Ts...>;
+                friend struct basic_storage<P, Ts...>;
                 
                 limit_accesor(decltype(storage) storage_): storage(storage_) {}
                 
@@ -395,7 +412,7 @@ namespace sqlite_orm {
             /**
              *  @param filename_ database filename.
              */
-            storage_t(const std::string &filename_, impl_type impl_):
+            basic_storage(const std::string &filename_, impl_type impl_):
             filename(filename_),
             impl(impl_),
             inMemory(filename_.empty() || filename_ == ":memory:"),
@@ -407,14 +424,20 @@ namespace sqlite_orm {
                 }
             }
             
-            storage_t(const storage_t &other):
+            basic_storage(const basic_storage &other):
             filename(other.filename),
             impl(other.impl),
             inMemory(other.inMemory),
             pragma(*this),
             limit(*this),
             collatingFunctions(other.collatingFunctions),
-            currentTransaction(other.currentTransaction)
+            currentTransaction(other.currentTransaction),
+            useSchemaFingerprint(other.useSchemaFingerprint),
+            migrationChunkSize(other.migrationChunkSize),
+            onMigrationProgress(other.onMigrationProgress),
+            tracer(other.tracer),
+            largeTables(other.largeTables),
+            instrumentationPolicy(other.instrumentationPolicy)
             {}
             
         protected:
@@ -425,6 +448,23 @@ namespace sqlite_orm {
             std::shared_ptr<internal::database_connection> currentTransaction;
             const bool inMemory;
             bool isOpenedForever = false;
+            bool useSchemaFingerprint = false;
+            int migrationChunkSize = 0;
+            std::function<void(const migration_progress&)> onMigrationProgress;
+            
+            /**
+             *  Is shared between storage copies cause connections keep pointer to it as a trace context.
+             */
+            std::shared_ptr<internal::tracer> tracer = std::make_shared<internal::tracer>();
+            
+            /**
+             *  Tables which must not be scanned. See `mark_large_table`.
+             */
+            std::set<std::string> largeTables;
+            
+            instrumentation_type instrumentationPolicy;
+            
+            using measurement_type = typename instrumentation_type::measurement;
             std::map<std::string, collating_function> collatingFunctions;
             
             using collating_function_pair = typename decltype(collatingFunctions)::value_type;
@@ -493,8 +533,11 @@ namespace sqlite_orm {
             }
 #endif
             
+            /**
+             *  Returns `CREATE TABLE` query for a table with a given name and columns of impl's table.
+             */
             template<class I>
-            void create_table(sqlite3 *db, const std::string &tableName, I *impl) {
+            std::string create_table_query(const std::string &tableName, I *impl) {
                 std::stringstream ss;
                 ss << "CREATE TABLE '" << tableName << "' ( ";
                 auto columnsCount = impl->table.columns_count();
@@ -510,7 +553,12 @@ namespace sqlite_orm {
                 if(impl->table._without_rowid) {
                     ss << "WITHOUT ROWID ";
                 }
-                auto query = ss.str();
+                return ss.str();
+            }
+            
+            template<class I>
+            void create_table(sqlite3 *db, const std::string &tableName, I *impl) {
+                auto query = this->create_table_query(tableName, impl);
                 sqlite3_stmt *stmt;
                 if (sqlite3_prepare_v2(db, query.c_str(), -1, &stmt, nullptr) == SQLITE_OK) {
                     statement_finalizer finalizer{stmt};
@@ -525,18 +573,19 @@ namespace sqlite_orm {
             }
             
             template<class I>
-            void backup_table(sqlite3 *db, I *impl) {
+            void backup_table(database_connection &connection, I *impl) {
+                auto db = connection.get_db();
                 
                 //  here we copy source table to another with a name with '_backup' suffix, but in case table with such
                 //  a name already exists we append suffix 1, then 2, etc until we find a free name..
                 auto backupTableName = impl->table.name + "_backup";
-                if(impl->table_exists(backupTableName, db)){
+                if(impl->table_exists(backupTableName, connection)){
                     int suffix = 1;
                     do{
                         std::stringstream stream;
                         stream << suffix;
                         auto anotherBackupTableName = backupTableName + stream.str();
-                        if(!impl->table_exists(anotherBackupTableName, db)){
+                        if(!impl->table_exists(anotherBackupTableName, connection)){
                             backupTableName = anotherBackupTableName;
                             break;
                         }
@@ -546,6 +595,13 @@ namespace sqlite_orm {
                 
                 this->create_table(db, backupTableName, impl);
                 
+                //  chunks need their own transactions so online mode is not available inside user's transaction
+                //  and rows are copied in rowid order so WITHOUT ROWID tables are copied at once
+                if(this->migrationChunkSize > 0 && sqlite3_get_autocommit(db) && !impl->table._without_rowid) {
+                    this->copy_table_online(connection, impl, backupTableName);
+                    return;
+                }
+                
                 impl->copy_table(db, backupTableName);
                 
                 this->drop_table_internal(impl->table.name, db);
@@ -553,6 +609,143 @@ namespace sqlite_orm {
                 impl->rename_table(db, backupTableName, impl->table.name);
             }
             
+            /**
+             *  Online version of `copy_table` + `drop_table_internal` + `rename_table` sequence. Rows are copied
+             *  in rowid order by chunks of `migrationChunkSize` rows and every chunk is copied within its own short
+             *  transaction so other connections can read and write the table between chunks. Changes made to
+             *  the source table during copying are mirrored to the copy by triggers. Finally source table is
+             *  dropped and the copy is renamed within a single transaction.
+             */
+            template<class I>
+            void copy_table_online(database_connection &connection, I *impl, const std::string &backupTableName) {
+                auto db = connection.get_db();
+                auto &tableName = impl->table.name;
+                
+                //  only columns existing both in storage and in db can be copied..
+                auto dbTableInfo = impl->get_table_info(tableName, connection);
+                std::stringstream columnsStream;
+                std::stringstream newValuesStream;
+                impl->table.for_each_column([&columnsStream, &newValuesStream, &dbTableInfo](auto &c) {
+                    auto it = std::find_if(dbTableInfo.begin(),
+                                           dbTableInfo.end(),
+                                           [&c](const table_info &ti) {
+                                               return ti.name == c.name;
+                                           });
+                    if(it != dbTableInfo.end()) {
+                        columnsStream << ", \"" << c.name << "\"";
+                        newValuesStream << ", NEW.\"" << c.name << "\"";
+                    }
+                });
+                auto columns = columnsStream.str();
+                auto newValues = newValuesStream.str();
+                
+                std::stringstream ss;
+                ss << "CREATE TRIGGER '" << backupTableName << "_insert' AFTER INSERT ON '" << tableName << "' BEGIN ";
+                ss << "INSERT OR REPLACE INTO '" << backupTableName << "' (rowid" << columns << ") VALUES (NEW.rowid" << newValues << "); END; ";
+                ss << "CREATE TRIGGER '" << backupTableName << "_update' AFTER UPDATE ON '" << tableName << "' BEGIN ";
+                ss << "DELETE FROM '" << backupTableName << "' WHERE rowid = OLD.rowid; ";
+                ss << "INSERT OR REPLACE INTO '" << backupTableName << "' (rowid" << columns << ") VALUES (NEW.rowid" << newValues << "); END; ";
+                ss << "CREATE TRIGGER '" << backupTableName << "_delete' AFTER DELETE ON '" << tableName << "' BEGIN ";
+                ss << "DELETE FROM '" << backupTableName << "' WHERE rowid = OLD.rowid; END;";
+                
+                //  triggers write into the copy so on failure they are dropped together with the copy,
+                //  otherwise the source table stays unwritable
+                auto cleanup = [db, &backupTableName]{
+                    auto query = "DROP TRIGGER IF EXISTS '" + backupTableName + "_insert'; "
+                    "DROP TRIGGER IF EXISTS '" + backupTableName + "_update'; "
+                    "DROP TRIGGER IF EXISTS '" + backupTableName + "_delete'; "
+                    "DROP TABLE IF EXISTS '" + backupTableName + "';";
+                    sqlite3_exec(db, query.c_str(), nullptr, nullptr, nullptr);
+                };
+                try{
+                    auto query = ss.str();
+                    if(sqlite3_exec(db, query.c_str(), nullptr, nullptr, nullptr) != SQLITE_OK) {
+                        throw std::system_error(std::error_code(sqlite3_errcode(db), get_sqlite_error_category()));
+                    }
+                    
+                    migration_progress progress{tableName, 0, 0, std::chrono::milliseconds::zero(), std::chrono::milliseconds::zero()};
+                    {
+                        auto stmt = connection.get_statement("SELECT COUNT(*) FROM '" + tableName + "'");
+                        statement_resetter resetter{stmt};
+                        if(sqlite3_step(stmt) == SQLITE_ROW) {
+                            progress.rows_total = row_extractor<int64>().extract(stmt, 0);
+                        }else{
+                            throw std::system_error(std::error_code(sqlite3_errcode(db), get_sqlite_error_category()));
+                        }
+                    }
+                    
+                    auto boundsQuery = "SELECT MAX(rowid), COUNT(*) FROM (SELECT rowid FROM '" + tableName + "' WHERE rowid > ? ORDER BY rowid LIMIT ?)";
+                    auto copyQuery = "INSERT OR REPLACE INTO '" + backupTableName + "' (rowid" + columns + ") SELECT rowid" + columns + " FROM '" + tableName + "' WHERE rowid > ? AND rowid <= ?";
+                    auto startTime = std::chrono::steady_clock::now();
+                    auto lastRowid = std::numeric_limits<int64>::min();
+                    int64 chunkRowsCount;
+                    do{
+                        impl->begin_transaction(db);
+                        try{
+                            int64 chunkLastRowid = lastRowid;
+                            {
+                                auto stmt = connection.get_statement(boundsQuery);
+                                statement_resetter resetter{stmt};
+                                statement_binder<int64>().bind(stmt, 1, lastRowid);
+                                statement_binder<int>().bind(stmt, 2, this->migrationChunkSize);
+                                if(sqlite3_step(stmt) == SQLITE_ROW) {
+                                    chunkRowsCount = row_extractor<int64>().extract(stmt, 1);
+                                    if(chunkRowsCount) {
+                                        chunkLastRowid = row_extractor<int64>().extract(stmt, 0);
+                                    }
+                                }else{
+                                    throw std::system_error(std::error_code(sqlite3_errcode(db), get_sqlite_error_category()));
+                                }
+                            }
+                            if(chunkRowsCount) {
+                                auto stmt = connection.get_statement(copyQuery);
+                                statement_resetter resetter{stmt};
+                                statement_binder<int64>().bind(stmt, 1, lastRowid);
+                                statement_binder<int64>().bind(stmt, 2, chunkLastRowid);
+                                if(sqlite3_step(stmt) != SQLITE_DONE) {
+                                    throw std::system_error(std::error_code(sqlite3_errcode(db), get_sqlite_error_category()));
+                                }
+                            }
+                            impl->commit(db);
+                            lastRowid = chunkLastRowid;
+                        }catch(...){
+                            impl->rollback(db);
+                            throw;
+                        }
+                        if(chunkRowsCount) {
+                            progress.rows_copied += chunkRowsCount;
+                            progress.elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - startTime);
+                            auto rowsLeft = progress.rows_total - progress.rows_copied;
+                            if(rowsLeft > 0) {
+                                progress.eta = std::chrono::duration_cast<std::chrono::milliseconds>(progress.elapsed * rowsLeft / progress.rows_copied);
+                            }else{
+                                progress.eta = std::chrono::milliseconds::zero();
+                            }
+                            if(this->onMigrationProgress) {
+                                this->onMigrationProgress(progress);
+                            }
+                            
+                            //  let other threads take the lock before the next chunk..
+                            std::this_thread::yield();
+                        }
+                    }while(chunkRowsCount);
+                    
+                    //  triggers are dropped together with source table
+                    impl->begin_transaction(db);
+                    try{
+                        this->drop_table_internal(tableName, db);
+                        impl->rename_table(db, backupTableName, tableName);
+                        impl->commit(db);
+                    }catch(...){
+                        impl->rollback(db);
+                        throw;
+                    }
+                }catch(...){
+                    cleanup();
+                    throw;
+                }
+            }
+            
             template<class O>
             void assert_mapped_type() {
                 using mapped_types_tuples = std::tuple<typename Ts::object_type...>;
@@ -577,7 +770,7 @@ namespace sqlite_orm {
             }
             
             template<class T>
-            std::string string_from_expression(T t, bool /*noTableName*/ = false, bool escape = false) {
+            std::string string_from_expression(internal::query_context &/*context*/, T t, bool /*noTableName*/ = false, bool escape = false) {
                 auto isNullable = type_is_nullable<T>::value;
                 if(isNullable && !type_is_nullable<T>()(t)){
                     return "NULL";
@@ -600,16 +793,16 @@ namespace sqlite_orm {
             }
             
             template<class T, class C>
-            std::string string_from_expression(const alias_column_t<T, C> &als, bool noTableName = false, bool /*escape*/ = false) {
+            std::string string_from_expression(internal::query_context &context, const alias_column_t<T, C> &als, bool noTableName = false, bool /*escape*/ = false) {
                 std::stringstream ss;
                 if(!noTableName){
                     ss << "'" << T::get() << "'.";
                 }
-                ss << this->string_from_expression(als.column, true);
+                ss << this->string_from_expression(context, als.column, true);
                 return ss.str();
             }
             
-            std::string string_from_expression(const std::string &t, bool /*noTableName*/ = false, bool escape = false) {
+            std::string string_from_expression(internal::query_context &/*context*/, const std::string &t, bool /*noTableName*/ = false, bool escape = false) {
                 std::stringstream ss;
                 std::string text = t;
                 if(escape){
@@ -619,7 +812,7 @@ namespace sqlite_orm {
                 return ss.str();
             }
             
-            std::string string_from_expression(const char *t, bool /*noTableName*/ = false, bool escape = false) {
+            std::string string_from_expression(internal::query_context &/*context*/, const char *t, bool /*noTableName*/ = false, bool escape = false) {
                 std::stringstream ss;
                 std::string text = t;
                 if(escape){
@@ -630,7 +823,7 @@ namespace sqlite_orm {
             }
             
             template<class F, class O>
-            std::string string_from_expression(F O::*m, bool noTableName = false, bool /*escape*/ = false) {
+            std::string string_from_expression(internal::query_context &/*context*/, F O::*m, bool noTableName = false, bool /*escape*/ = false) {
                 std::stringstream ss;
                 if(!noTableName){
                     ss << "'" << this->impl.template find_table_name<O>() << "'.";
@@ -639,20 +832,20 @@ namespace sqlite_orm {
                 return ss.str();
             }
             
-            std::string string_from_expression(const rowid_t &rid, bool /*noTableName*/ = false, bool /*escape*/ = false) {
+            std::string string_from_expression(internal::query_context &/*context*/, const rowid_t &rid, bool /*noTableName*/ = false, bool /*escape*/ = false) {
                 return static_cast<std::string>(rid);
             }
             
-            std::string string_from_expression(const oid_t &rid, bool /*noTableName*/ = false, bool /*escape*/ = false) {
+            std::string string_from_expression(internal::query_context &/*context*/, const oid_t &rid, bool /*noTableName*/ = false, bool /*escape*/ = false) {
                 return static_cast<std::string>(rid);
             }
             
-            std::string string_from_expression(const _rowid_t &rid, bool /*noTableName*/ = false, bool /*escape*/ = false) {
+            std::string string_from_expression(internal::query_context &/*context*/, const _rowid_t &rid, bool /*noTableName*/ = false, bool /*escape*/ = false) {
                 return static_cast<std::string>(rid);
             }
             
             template<class O>
-            std::string string_from_expression(const table_rowid_t<O> &rid, bool noTableName = false, bool /*escape*/ = false) {
+            std::string string_from_expression(internal::query_context &/*context*/, const table_rowid_t<O> &rid, bool noTableName = false, bool /*escape*/ = false) {
                 std::stringstream ss;
                 if(!noTableName){
                     ss << "'" << this->impl.template find_table_name<O>() << "'.";
@@ -662,7 +855,7 @@ namespace sqlite_orm {
             }
             
             template<class O>
-            std::string string_from_expression(const table_oid_t<O> &rid, bool noTableName = false, bool /*escape*/ = false) {
+            std::string string_from_expression(internal::query_context &/*context*/, const table_oid_t<O> &rid, bool noTableName = false, bool /*escape*/ = false) {
                 std::stringstream ss;
                 if(!noTableName){
                     ss << "'" << this->impl.template find_table_name<O>() << "'.";
@@ -672,7 +865,7 @@ namespace sqlite_orm {
             }
             
             template<class O>
-            std::string string_from_expression(const table__rowid_t<O> &rid, bool noTableName = false, bool /*escape*/ = false) {
+            std::string string_from_expression(internal::query_context &/*context*/, const table__rowid_t<O> &rid, bool noTableName = false, bool /*escape*/ = false) {
                 std::stringstream ss;
                 if(!noTableName){
                     ss << "'" << this->impl.template find_table_name<O>() << "'.";
@@ -682,236 +875,236 @@ namespace sqlite_orm {
             }
             
             template<class T>
-            std::string string_from_expression(const aggregate_functions::group_concat_double_t<T> &f, bool /*noTableName*/ = false, bool /*escape*/ = false) {
+            std::string string_from_expression(internal::query_context &context, const aggregate_functions::group_concat_double_t<T> &f, bool /*noTableName*/ = false, bool /*escape*/ = false) {
                 std::stringstream ss;
-                auto expr = this->string_from_expression(f.t);
-                auto expr2 = this->string_from_expression(f.y);
+                auto expr = this->string_from_expression(context, f.t);
+                auto expr2 = this->string_from_expression(context, f.y);
                 ss << static_cast<std::string>(f) << "(" << expr << ", " << expr2 << ") ";
                 return ss.str();
             }
             
             template<class T>
-            std::string string_from_expression(const aggregate_functions::group_concat_single_t<T> &f, bool /*noTableName*/ = false, bool /*escape*/ = false) {
+            std::string string_from_expression(internal::query_context &context, const aggregate_functions::group_concat_single_t<T> &f, bool /*noTableName*/ = false, bool /*escape*/ = false) {
                 std::stringstream ss;
-                auto expr = this->string_from_expression(f.t);
+                auto expr = this->string_from_expression(context, f.t);
                 ss << static_cast<std::string>(f) << "(" << expr << ") ";
                 return ss.str();
             }
             
             template<class L, class R>
-            std::string string_from_expression(const conc_t<L, R> &f, bool /*noTableName*/ = false, bool /*escape*/ = false) {
+            std::string string_from_expression(internal::query_context &context, const conc_t<L, R> &f, bool noTableName = false, bool /*escape*/ = false) {
                 std::stringstream ss;
-                auto lhs = this->string_from_expression(f.l);
-                auto rhs = this->string_from_expression(f.r);
+                auto lhs = this->string_from_expression(context, f.l, noTableName);
+                auto rhs = this->string_from_expression(context, f.r, noTableName);
                 ss << "(" << lhs << " || " << rhs << ") ";
                 return ss.str();
             }
             
             template<class L, class R>
-            std::string string_from_expression(const add_t<L, R> &f, bool /*noTableName*/ = false, bool /*escape*/ = false) {
+            std::string string_from_expression(internal::query_context &context, const add_t<L, R> &f, bool noTableName = false, bool /*escape*/ = false) {
                 std::stringstream ss;
-                auto lhs = this->string_from_expression(f.l);
-                auto rhs = this->string_from_expression(f.r);
+                auto lhs = this->string_from_expression(context, f.l, noTableName);
+                auto rhs = this->string_from_expression(context, f.r, noTableName);
                 ss << "(" << lhs << " + " << rhs << ") ";
                 return ss.str();
             }
             
             template<class L, class R>
-            std::string string_from_expression(const sub_t<L, R> &f, bool /*noTableName*/ = false, bool /*escape*/ = false) {
+            std::string string_from_expression(internal::query_context &context, const sub_t<L, R> &f, bool noTableName = false, bool /*escape*/ = false) {
                 std::stringstream ss;
-                auto lhs = this->string_from_expression(f.l);
-                auto rhs = this->string_from_expression(f.r);
+                auto lhs = this->string_from_expression(context, f.l, noTableName);
+                auto rhs = this->string_from_expression(context, f.r, noTableName);
                 ss << "(" << lhs << " - " << rhs << ") ";
                 return ss.str();
             }
             
             template<class L, class R>
-            std::string string_from_expression(const mul_t<L, R> &f, bool /*noTableName*/ = false, bool /*escape*/ = false) {
+            std::string string_from_expression(internal::query_context &context, const mul_t<L, R> &f, bool noTableName = false, bool /*escape*/ = false) {
                 std::stringstream ss;
-                auto lhs = this->string_from_expression(f.l);
-                auto rhs = this->string_from_expression(f.r);
+                auto lhs = this->string_from_expression(context, f.l, noTableName);
+                auto rhs = this->string_from_expression(context, f.r, noTableName);
                 ss << "(" << lhs << " * " << rhs << ") ";
                 return ss.str();
             }
             
             template<class L, class R>
-            std::string string_from_expression(const div_t<L, R> &f, bool /*noTableName*/ = false, bool /*escape*/ = false) {
+            std::string string_from_expression(internal::query_context &context, const div_t<L, R> &f, bool noTableName = false, bool /*escape*/ = false) {
                 std::stringstream ss;
-                auto lhs = this->string_from_expression(f.l);
-                auto rhs = this->string_from_expression(f.r);
+                auto lhs = this->string_from_expression(context, f.l, noTableName);
+                auto rhs = this->string_from_expression(context, f.r, noTableName);
                 ss << "(" << lhs << " / " << rhs << ") ";
                 return ss.str();
             }
             
             template<class L, class R>
-            std::string string_from_expression(const mod_t<L, R> &f, bool /*noTableName*/ = false, bool /*escape*/ = false) {
+            std::string string_from_expression(internal::query_context &context, const mod_t<L, R> &f, bool noTableName = false, bool /*escape*/ = false) {
                 std::stringstream ss;
-                auto lhs = this->string_from_expression(f.l);
-                auto rhs = this->string_from_expression(f.r);
+                auto lhs = this->string_from_expression(context, f.l, noTableName);
+                auto rhs = this->string_from_expression(context, f.r, noTableName);
                 ss << "(" << lhs << " % " << rhs << ") ";
                 return ss.str();
             }
             
             template<class T>
-            std::string string_from_expression(const aggregate_functions::min_t<T> &f, bool /*noTableName*/ = false, bool /*escape*/ = false) {
+            std::string string_from_expression(internal::query_context &context, const aggregate_functions::min_t<T> &f, bool /*noTableName*/ = false, bool /*escape*/ = false) {
                 std::stringstream ss;
-                auto expr = this->string_from_expression(f.t);
+                auto expr = this->string_from_expression(context, f.t);
                 ss << static_cast<std::string>(f) << "(" << expr << ") ";
                 return ss.str();
             }
             
             template<class T>
-            std::string string_from_expression(const aggregate_functions::max_t<T> &f, bool /*noTableName*/ = false, bool /*escape*/ = false) {
+            std::string string_from_expression(internal::query_context &context, const aggregate_functions::max_t<T> &f, bool /*noTableName*/ = false, bool /*escape*/ = false) {
                 std::stringstream ss;
-                auto expr = this->string_from_expression(f.t);
+                auto expr = this->string_from_expression(context, f.t);
                 ss << static_cast<std::string>(f) << "(" << expr << ") ";
                 return ss.str();
             }
             
             template<class T>
-            std::string string_from_expression(const aggregate_functions::total_t<T> &f, bool /*noTableName*/ = false, bool /*escape*/ = false) {
+            std::string string_from_expression(internal::query_context &context, const aggregate_functions::total_t<T> &f, bool /*noTableName*/ = false, bool /*escape*/ = false) {
                 std::stringstream ss;
-                auto expr = this->string_from_expression(f.t);
+                auto expr = this->string_from_expression(context, f.t);
                 ss << static_cast<std::string>(f) << "(" << expr << ") ";
                 return ss.str();
             }
             
             template<class T>
-            std::string string_from_expression(const aggregate_functions::sum_t<T> &f, bool /*noTableName*/ = false, bool /*escape*/ = false) {
+            std::string string_from_expression(internal::query_context &context, const aggregate_functions::sum_t<T> &f, bool /*noTableName*/ = false, bool /*escape*/ = false) {
                 std::stringstream ss;
-                auto expr = this->string_from_expression(f.t);
+                auto expr = this->string_from_expression(context, f.t);
                 ss << static_cast<std::string>(f) << "(" << expr << ") ";
                 return ss.str();
             }
             
-            std::string string_from_expression(const aggregate_functions::count_asterisk_t &f, bool /*noTableName*/ = false, bool /*escape*/ = false) {
+            std::string string_from_expression(internal::query_context &/*context*/, const aggregate_functions::count_asterisk_t &f, bool /*noTableName*/ = false, bool /*escape*/ = false) {
                 std::stringstream ss;
                 ss << static_cast<std::string>(f) << "(*) ";
                 return ss.str();
             }
             
             template<class T>
-            std::string string_from_expression(const aggregate_functions::count_t<T> &f, bool /*noTableName*/ = false, bool /*escape*/ = false) {
+            std::string string_from_expression(internal::query_context &context, const aggregate_functions::count_t<T> &f, bool /*noTableName*/ = false, bool /*escape*/ = false) {
                 std::stringstream ss;
-                auto expr = this->string_from_expression(f.t);
+                auto expr = this->string_from_expression(context, f.t);
                 ss << static_cast<std::string>(f) << "(" << expr << ") ";
                 return ss.str();
             }
             
             template<class T>
-            std::string string_from_expression(const aggregate_functions::avg_t<T> &a, bool /*noTableName*/ = false, bool /*escape*/ = false) {
+            std::string string_from_expression(internal::query_context &context, const aggregate_functions::avg_t<T> &a, bool /*noTableName*/ = false, bool /*escape*/ = false) {
                 std::stringstream ss;
-                auto expr = this->string_from_expression(a.t);
+                auto expr = this->string_from_expression(context, a.t);
                 ss << static_cast<std::string>(a) << "(" << expr << ") ";
                 return ss.str();
             }
             
             template<class T>
-            std::string string_from_expression(const distinct_t<T> &f, bool /*noTableName*/ = false, bool /*escape*/ = false) {
+            std::string string_from_expression(internal::query_context &context, const distinct_t<T> &f, bool /*noTableName*/ = false, bool /*escape*/ = false) {
                 std::stringstream ss;
-                auto expr = this->string_from_expression(f.t);
+                auto expr = this->string_from_expression(context, f.t);
                 ss << static_cast<std::string>(f) << "(" << expr << ") ";
                 return ss.str();
             }
             
             template<class T>
-            std::string string_from_expression(const all_t<T> &f, bool /*noTableName*/ = false, bool /*escape*/ = false) {
+            std::string string_from_expression(internal::query_context &context, const all_t<T> &f, bool /*noTableName*/ = false, bool /*escape*/ = false) {
                 std::stringstream ss;
-                auto expr = this->string_from_expression(f.t);
+                auto expr = this->string_from_expression(context, f.t);
                 ss << static_cast<std::string>(f) << "(" << expr << ") ";
                 return ss.str();
             }
             
             template<class X, class Y>
-            std::string string_from_expression(const core_functions::rtrim_double_t<X, Y> &f, bool /*noTableName*/ = false, bool /*escape*/ = false) {
+            std::string string_from_expression(internal::query_context &context, const core_functions::rtrim_double_t<X, Y> &f, bool noTableName = false, bool /*escape*/ = false) {
                 std::stringstream ss;
-                auto expr = this->string_from_expression(f.x);
-                auto expr2 = this->string_from_expression(f.y);
+                auto expr = this->string_from_expression(context, f.x, noTableName);
+                auto expr2 = this->string_from_expression(context, f.y, noTableName);
                 ss << static_cast<std::string>(f) << "(" << expr << ", " << expr2 << ") ";
                 return ss.str();
             }
             
             template<class X>
-            std::string string_from_expression(const core_functions::rtrim_single_t<X> &f, bool /*noTableName*/ = false, bool /*escape*/ = false) {
+            std::string string_from_expression(internal::query_context &context, const core_functions::rtrim_single_t<X> &f, bool noTableName = false, bool /*escape*/ = false) {
                 std::stringstream ss;
-                auto expr = this->string_from_expression(f.x);
+                auto expr = this->string_from_expression(context, f.x, noTableName);
                 ss << static_cast<std::string>(f) << "(" << expr << ") ";
                 return ss.str();
             }
             
             template<class X, class Y>
-            std::string string_from_expression(const core_functions::ltrim_double_t<X, Y> &f, bool /*noTableName*/ = false, bool /*escape*/ = false) {
+            std::string string_from_expression(internal::query_context &context, const core_functions::ltrim_double_t<X, Y> &f, bool noTableName = false, bool /*escape*/ = false) {
                 std::stringstream ss;
-                auto expr = this->string_from_expression(f.x);
-                auto expr2 = this->string_from_expression(f.y);
+                auto expr = this->string_from_expression(context, f.x, noTableName);
+                auto expr2 = this->string_from_expression(context, f.y, noTableName);
                 ss << static_cast<std::string>(f) << "(" << expr << ", " << expr2 << ") ";
                 return ss.str();
             }
             
             template<class X>
-            std::string string_from_expression(const core_functions::ltrim_single_t<X> &f, bool /*noTableName*/ = false, bool /*escape*/ = false) {
+            std::string string_from_expression(internal::query_context &context, const core_functions::ltrim_single_t<X> &f, bool noTableName = false, bool /*escape*/ = false) {
                 std::stringstream ss;
-                auto expr = this->string_from_expression(f.x);
+                auto expr = this->string_from_expression(context, f.x, noTableName);
                 ss << static_cast<std::string>(f) << "(" << expr << ") ";
                 return ss.str();
             }
             
             template<class X, class Y>
-            std::string string_from_expression(const core_functions::trim_double_t<X, Y> &f, bool /*noTableName*/ = false, bool /*escape*/ = false) {
+            std::string string_from_expression(internal::query_context &context, const core_functions::trim_double_t<X, Y> &f, bool noTableName = false, bool /*escape*/ = false) {
                 std::stringstream ss;
-                auto expr = this->string_from_expression(f.x);
-                auto expr2 = this->string_from_expression(f.y);
+                auto expr = this->string_from_expression(context, f.x, noTableName);
+                auto expr2 = this->string_from_expression(context, f.y, noTableName);
                 ss << static_cast<std::string>(f) << "(" << expr << ", " << expr2 << ") ";
                 return ss.str();
             }
             
             template<class X>
-            std::string string_from_expression(const core_functions::trim_single_t<X> &f, bool /*noTableName*/ = false, bool /*escape*/ = false) {
+            std::string string_from_expression(internal::query_context &context, const core_functions::trim_single_t<X> &f, bool noTableName = false, bool /*escape*/ = false) {
                 std::stringstream ss;
-                auto expr = this->string_from_expression(f.x);
+                auto expr = this->string_from_expression(context, f.x, noTableName);
                 ss << static_cast<std::string>(f) << "(" << expr << ") ";
                 return ss.str();
             }
             
-            std::string string_from_expression(const core_functions::changes_t &ch, bool /*noTableName*/ = false, bool /*escape*/ = false) {
+            std::string string_from_expression(internal::query_context &/*context*/, const core_functions::changes_t &ch, bool /*noTableName*/ = false, bool /*escape*/ = false) {
                 std::stringstream ss;
                 ss << static_cast<std::string>(ch) << "() ";
                 return ss.str();
             }
             
             template<class T>
-            std::string string_from_expression(const core_functions::length_t<T> &len, bool /*noTableName*/ = false, bool /*escape*/ = false) {
+            std::string string_from_expression(internal::query_context &context, const core_functions::length_t<T> &len, bool noTableName = false, bool /*escape*/ = false) {
                 std::stringstream ss;
-                auto expr = this->string_from_expression(len.t);
+                auto expr = this->string_from_expression(context, len.t, noTableName);
                 ss << static_cast<std::string>(len) << "(" << expr << ") ";
                 return ss.str();
             }
             
             template<class T, class ...Args>
-            std::string string_from_expression(const core_functions::datetime_t<T, Args...> &f, bool /*noTableName*/ = false, bool /*escape*/ = false) {
+            std::string string_from_expression(internal::query_context &context, const core_functions::datetime_t<T, Args...> &f, bool /*noTableName*/ = false, bool /*escape*/ = false) {
                 std::stringstream ss;
-                ss << static_cast<std::string>(f) << "(" << this->string_from_expression(f.timestring);
+                ss << static_cast<std::string>(f) << "(" << this->string_from_expression(context, f.timestring);
                 using tuple_t = std::tuple<Args...>;
-                tuple_helper::iterator<std::tuple_size<tuple_t>::value - 1, Args...>()(f.modifiers, [&ss, this](auto &v){
-                    ss << ", " << this->string_from_expression(v);
+                tuple_helper::iterator<std::tuple_size<tuple_t>::value - 1, Args...>()(f.modifiers, [&context, &ss, this](auto &v){
+                    ss << ", " << this->string_from_expression(context, v);
                 });
                 ss << ") ";
                 return ss.str();
             }
             
             template<class T, class ...Args>
-            std::string string_from_expression(const core_functions::date_t<T, Args...> &f, bool /*noTableName*/ = false, bool /*escape*/ = false) {
+            std::string string_from_expression(internal::query_context &context, const core_functions::date_t<T, Args...> &f, bool /*noTableName*/ = false, bool /*escape*/ = false) {
                 std::stringstream ss;
-                ss << static_cast<std::string>(f) << "(" << this->string_from_expression(f.timestring);
+                ss << static_cast<std::string>(f) << "(" << this->string_from_expression(context, f.timestring);
                 using tuple_t = std::tuple<Args...>;
-                tuple_helper::iterator<std::tuple_size<tuple_t>::value - 1, Args...>()(f.modifiers, [&ss, this](auto &v){
-                    ss << ", " << this->string_from_expression(v);
+                tuple_helper::iterator<std::tuple_size<tuple_t>::value - 1, Args...>()(f.modifiers, [&context, &ss, this](auto &v){
+                    ss << ", " << this->string_from_expression(context, v);
                 });
                 ss << ") ";
                 return ss.str();
             }
             
-            std::string string_from_expression(const core_functions::random_t &f, bool /*noTableName*/ = false, bool /*escape*/ = false) {
+            std::string string_from_expression(internal::query_context &/*context*/, const core_functions::random_t &f, bool /*noTableName*/ = false, bool /*escape*/ = false) {
                 std::stringstream ss;
                 ss << static_cast<std::string>(f) << "() ";
                 return ss.str();
@@ -920,13 +1113,13 @@ namespace sqlite_orm {
 #if SQLITE_VERSION_NUMBER >= 3007016
             
             template<class ...Args>
-            std::string string_from_expression(const core_functions::char_t_<Args...> &f, bool /*noTableName*/ = false, bool /*escape*/ = false) {
+            std::string string_from_expression(internal::query_context &context, const core_functions::char_t_<Args...> &f, bool /*noTableName*/ = false, bool /*escape*/ = false) {
                 std::stringstream ss;
                 using tuple_t = decltype(f.args);
                 std::vector<std::string> args;
                 args.reserve(std::tuple_size<tuple_t>::value);
-                tuple_helper::tuple_for_each(f.args, [&args, this](auto &v){
-                    auto expression = this->string_from_expression(v);
+                tuple_helper::tuple_for_each(f.args, [&context, &args, this](auto &v){
+                    auto expression = this->string_from_expression(context, v);
                     args.emplace_back(std::move(expression));
                 });
                 ss << static_cast<std::string>(f) << "(";
@@ -945,31 +1138,31 @@ namespace sqlite_orm {
 #endif
             
             template<class T>
-            std::string string_from_expression(const core_functions::upper_t<T> &a, bool /*noTableName*/ = false, bool /*escape*/ = false) {
+            std::string string_from_expression(internal::query_context &context, const core_functions::upper_t<T> &a, bool noTableName = false, bool /*escape*/ = false) {
                 std::stringstream ss;
-                auto expr = this->string_from_expression(a.t);
+                auto expr = this->string_from_expression(context, a.t, noTableName);
                 ss << static_cast<std::string>(a) << "(" << expr << ") ";
                 return ss.str();
             }
             
             template<class T>
-            std::string string_from_expression(const core_functions::lower_t<T> &a, bool /*noTableName*/ = false, bool /*escape*/ = false) {
+            std::string string_from_expression(internal::query_context &context, const core_functions::lower_t<T> &a, bool noTableName = false, bool /*escape*/ = false) {
                 std::stringstream ss;
-                auto expr = this->string_from_expression(a.t);
+                auto expr = this->string_from_expression(context, a.t, noTableName);
                 ss << static_cast<std::string>(a) << "(" << expr << ") ";
                 return ss.str();
             }
             
             template<class T>
-            std::string string_from_expression(const core_functions::abs_t<T> &a, bool /*noTableName*/ = false, bool /*escape*/ = false) {
+            std::string string_from_expression(internal::query_context &context, const core_functions::abs_t<T> &a, bool noTableName = false, bool /*escape*/ = false) {
                 std::stringstream ss;
-                auto expr = this->string_from_expression(a.t);
+                auto expr = this->string_from_expression(context, a.t, noTableName);
                 ss << static_cast<std::string>(a) << "(" << expr << ") ";
                 return ss.str();
             }
             
             template<class T, class F>
-            std::string string_from_expression(const column_pointer<T, F> &c, bool noTableName = false, bool escape = false) {
+            std::string string_from_expression(internal::query_context &/*context*/, const column_pointer<T, F> &c, bool noTableName = false, bool escape = false) {
                 std::stringstream ss;
                 if(!noTableName){
                     ss << "'" << this->impl.template find_table_name<T>() << "'.";
@@ -980,8 +1173,8 @@ namespace sqlite_orm {
             }
             
             template<class T>
-            std::vector<std::string> get_column_names(const T &t) {
-                auto columnName = this->string_from_expression(t);
+            std::vector<std::string> get_column_names(internal::query_context &context, const T &t) {
+                auto columnName = this->string_from_expression(context, t);
                 if(columnName.length()){
                     return {columnName};
                 }else{
@@ -990,11 +1183,11 @@ namespace sqlite_orm {
             }
             
             template<class ...Args>
-            std::vector<std::string> get_column_names(const internal::columns_t<Args...> &cols) {
+            std::vector<std::string> get_column_names(internal::query_context &context, const internal::columns_t<Args...> &cols) {
                 std::vector<std::string> columnNames;
                 columnNames.reserve(cols.count());
-                cols.for_each([&columnNames, this](auto &m) {
-                    auto columnName = this->string_from_expression(m);
+                cols.for_each([&context, &columnNames, this](auto &m) {
+                    auto columnName = this->string_from_expression(context, m);
                     if(columnName.length()){
                         columnNames.push_back(columnName);
                     }else{
@@ -1008,13 +1201,13 @@ namespace sqlite_orm {
              *  Takes select_t object and returns SELECT query string
              */
             template<class T, class ...Args>
-            std::string string_from_expression(const internal::select_t<T, Args...> &sel, bool /*noTableName*/ = false, bool /*escape*/ = false) {
+            std::string string_from_expression(internal::query_context &context, const internal::select_t<T, Args...> &sel, bool /*noTableName*/ = false, bool /*escape*/ = false) {
                 std::stringstream ss;
                 ss << "SELECT ";
                 if(get_distinct(sel.col)) {
                     ss << static_cast<std::string>(distinct(0)) << " ";
                 }
-                auto columnNames = this->get_column_names(sel.col);
+                auto columnNames = this->get_column_names(context, sel.col);
                 for(size_t i = 0; i < columnNames.size(); ++i) {
                     ss << columnNames[i];
                     if(i < columnNames.size() - 1) {
@@ -1044,46 +1237,145 @@ namespace sqlite_orm {
                     }
                 }
                 using tuple_t = typename std::decay<decltype(sel)>::type::conditions_type;
-                tuple_helper::iterator<std::tuple_size<tuple_t>::value - 1, Args...>()(sel.conditions, [&ss, this](auto &v){
-                    this->process_single_condition(ss, v);
+                tuple_helper::iterator<std::tuple_size<tuple_t>::value - 1, Args...>()(sel.conditions, [&context, &ss, this](auto &v){
+                    this->process_single_condition(context, ss, v);
+                }, false);
+                return ss.str();
+            }
+            
+            /**
+             *  Takes get_all_t object and returns the same query `get_all` executes
+             */
+            template<class T, class ...Args>
+            std::string string_from_expression(internal::query_context &context, const internal::get_all_t<T, Args...> &expr, bool /*noTableName*/ = false, bool /*escape*/ = false) {
+                std::string query;
+                this->generate_select_asterisk<T>(context, &query);
+                std::stringstream ss;
+                ss << query;
+                tuple_helper::iterator<std::tuple_size<std::tuple<Args...>>::value - 1, Args...>()(expr.conditions, [&context, &ss, this](auto &v){
+                    this->process_single_condition(context, ss, v);
+                }, false);
+                return ss.str();
+            }
+            
+            /**
+             *  Takes count_all_t object and returns the same query `count` executes
+             */
+            template<class T, class ...Args>
+            std::string string_from_expression(internal::query_context &context, const internal::count_all_t<T, Args...> &expr, bool /*noTableName*/ = false, bool /*escape*/ = false) {
+                using mapped_type = typename mapped_type_proxy<T>::type;
+                auto tableAliasString = alias_exractor<T>::get();
+                std::stringstream ss;
+                ss << "SELECT " << static_cast<std::string>(sqlite_orm::count()) << "(*) FROM '" << this->get_impl<mapped_type>().table.name << "' ";
+                if(tableAliasString.length()) {
+                    ss << "'" << tableAliasString << "' ";
+                }
+                tuple_helper::iterator<std::tuple_size<std::tuple<Args...>>::value - 1, Args...>()(expr.conditions, [&context, &ss, this](auto &v){
+                    this->process_single_condition(context, ss, v);
                 }, false);
                 return ss.str();
             }
+            
+            query_plan explain_query(sqlite3 *db, const std::string &query) {
+                query_plan res;
+                res.sql = query;
+                struct row {
+                    int id;
+                    int parent;
+                    std::string detail;
+                };
+                std::vector<row> rows;
+                auto explainQuery = "EXPLAIN QUERY PLAN " + query;
+                sqlite3_stmt *stmt;
+                if (sqlite3_prepare_v2(db, explainQuery.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+                    throw std::system_error(std::error_code(sqlite3_errcode(db), get_sqlite_error_category()));
+                }
+                statement_finalizer finalizer{stmt};
+                int stepRes;
+                while((stepRes = sqlite3_step(stmt)) == SQLITE_ROW) {
+                    row r;
+#if SQLITE_VERSION_NUMBER >= 3024000
+                    r.id = sqlite3_column_int(stmt, 0);
+                    r.parent = sqlite3_column_int(stmt, 1);
+#else
+                    
+                    //  selectid, order, from columns don't describe hierarchy
+                    r.id = static_cast<int>(rows.size()) + 1;
+                    r.parent = 0;
+#endif
+                    r.detail = row_extractor<std::string>().extract(stmt, 3);
+                    rows.push_back(std::move(r));
+                }
+                if(stepRes != SQLITE_DONE) {
+                    throw std::system_error(std::error_code(sqlite3_errcode(db), get_sqlite_error_category()));
+                }
+                std::function<std::vector<query_plan_node>(int)> collectChildren = [&rows, &collectChildren](int parent) {
+                    std::vector<query_plan_node> nodes;
+                    for(auto &r : rows) {
+                        if(r.parent == parent) {
+                            nodes.push_back({r.id, r.parent, r.detail, collectChildren(r.id)});
+                        }
+                    }
+                    return nodes;
+                };
+                res.nodes = collectChildren(0);
+                return res;
+            }
+            
+            /**
+             *  Debug builds only: fires an assertion if `query` plan contains a full scan of a table
+             *  marked with `mark_large_table`.
+             */
+            void assert_no_large_table_scan(sqlite3 *db, const std::string &query) {
+#ifndef NDEBUG
+                if(this->largeTables.empty()) {
+                    return;
+                }
+                auto plan = this->explain_query(db, query);
+                for(auto &tableName : this->largeTables) {
+                    assert(!plan.scans(tableName) && "query plan contains full scan of a large table");
+                    (void)tableName;
+                }
+#else
+                (void)db;
+                (void)query;
+#endif
+            }
              
             template<class T>
-            std::string process_where(const conditions::is_null_t<T> &c) {
+            std::string process_where(internal::query_context &context, const conditions::is_null_t<T> &c) {
                 std::stringstream ss;
-                ss << this->string_from_expression(c.t) << " " << static_cast<std::string>(c) << " ";
+                ss << this->string_from_expression(context, c.t) << " " << static_cast<std::string>(c) << " ";
                 return ss.str();
             }
             
             template<class T>
-            std::string process_where(const conditions::is_not_null_t<T> &c) {
+            std::string process_where(internal::query_context &context, const conditions::is_not_null_t<T> &c) {
                 std::stringstream ss;
-                ss << this->string_from_expression(c.t) << " " << static_cast<std::string>(c) << " ";
+                ss << this->string_from_expression(context, c.t) << " " << static_cast<std::string>(c) << " ";
                 return ss.str();
             }
             
             template<class C>
-            std::string process_where(const conditions::negated_condition_t<C> &c) {
+            std::string process_where(internal::query_context &context, const conditions::negated_condition_t<C> &c) {
                 std::stringstream ss;
                 ss << " " << static_cast<std::string>(c) << " ";
-                auto cString = this->process_where(c.c);
+                auto cString = this->process_where(context, c.c);
                 ss << " (" << cString << " ) ";
                 return ss.str();
             }
             
             template<class L, class R>
-            std::string process_where(const conditions::and_condition_t<L, R> &c) {
+            std::string process_where(internal::query_context &context, const conditions::and_condition_t<L, R> &c) {
                 std::stringstream ss;
-                ss << " (" << this->process_where(c.l) << ") " << static_cast<std::string>(c) << " (" << this->process_where(c.r) << ") ";
+                ss << " (" << this->process_where(context, c.l) << ") " << static_cast<std::string>(c) << " (" << this->process_where(context, c.r) << ") ";
                 return ss.str();
             }
             
             template<class L, class R>
-            std::string process_where(const conditions::or_condition_t<L, R> &c) {
+            std::string process_where(internal::query_context &context, const conditions::or_condition_t<L, R> &c) {
                 std::stringstream ss;
-                ss << " (" << this->process_where(c.l) << ") " << static_cast<std::string>(c) << " (" << this->process_where(c.r) << ") ";
+                ss << " (" << this->process_where(context, c.l) << ") " << static_cast<std::string>(c) << " (" << this->process_where(context, c.r) << ") ";
                 return ss.str();
             }
             
@@ -1091,34 +1383,79 @@ namespace sqlite_orm {
              *  Common case. Is used to process binary conditions like is_equal, not_equal
              */
             template<class C>
-            std::string process_where(const C &c) {
-                auto leftString = this->string_from_expression(c.l, false, true);
-                auto rightString = this->string_from_expression(c.r, false, true);
+            std::string process_where(internal::query_context &context, const C &c) {
+                auto leftString = this->string_from_expression(context, c.l, false, true);
+                auto rightString = this->string_from_expression(context, c.r, false, true);
                 std::stringstream ss;
                 ss << leftString << " " << static_cast<std::string>(c) << " " << rightString;
                 return ss.str();
             }
             
             template<class T>
-            std::string process_where(const conditions::named_collate<T> &col) {
-                auto res = this->process_where(col.expr);
+            std::string process_where(internal::query_context &context, const conditions::named_collate<T> &col) {
+                auto res = this->process_where(context, col.expr);
                 return res + " " + static_cast<std::string>(col);
             }
             
             template<class T>
-            std::string process_where(const conditions::collate_t<T> &col) {
-                auto res = this->process_where(col.expr);
+            std::string process_where(internal::query_context &context, const conditions::collate_t<T> &col) {
+                auto res = this->process_where(context, col.expr);
                 return res + " " + static_cast<std::string>(col);
             }
             
+            /**
+             *  Fills temp table `tableName` with values binding every value so SQLite doesn't have to parse them.
+             *  Statements are cached by connection.
+             */
+            template<class E>
+            void fill_in_table(internal::database_connection &connection, const std::string &tableName, const std::vector<E> &values) {
+                auto db = connection.get_db();
+                auto execute = [db](sqlite3_stmt *stmt) {
+                    statement_resetter resetter{stmt};
+                    if(sqlite3_step(stmt) != SQLITE_DONE) {
+                        throw std::system_error(std::error_code(sqlite3_errcode(db), get_sqlite_error_category()));
+                    }
+                };
+                execute(connection.get_statement("CREATE TEMP TABLE IF NOT EXISTS \"" + tableName + "\" (value)"));
+                execute(connection.get_statement("SAVEPOINT sqlite_orm_in"));
+                try{
+                    execute(connection.get_statement("DELETE FROM temp.\"" + tableName + "\""));
+                    auto stmt = connection.get_statement("INSERT INTO temp.\"" + tableName + "\" (value) VALUES (?)");
+                    for(auto &value : values) {
+                        statement_binder<E>().bind(stmt, 1, value);
+                        execute(stmt);
+                    }
+                }catch(...){
+                    sqlite3_exec(db, "ROLLBACK TO sqlite_orm_in; RELEASE sqlite_orm_in", nullptr, nullptr, nullptr);
+                    throw;
+                }
+                execute(connection.get_statement("RELEASE sqlite_orm_in"));
+            }
+            
+            /**
+             *  Long value lists are bound into a temp table of the context connection and condition is serialized as
+             *  `x IN temp."_sqlite_orm_in_N"` so query text doesn't depend on values count and values are not parsed.
+             *  Temp table belongs to the context until it is destroyed so statements alive at the same time never
+             *  share it. Short lists (filling a table costs several statements) and lists of a context without
+             *  connection are written into query text.
+             */
             template<class L, class E>
-            std::string process_where(const conditions::in_t<L, E> &inCondition) {
+            std::string process_where(internal::query_context &context, const conditions::in_t<L, E> &inCondition) {
                 std::stringstream ss;
-                auto leftString = this->string_from_expression(inCondition.l);
+                auto leftString = this->string_from_expression(context, inCondition.l);
+                const size_t maxInlinedValuesCount = 100;
+                if(context.connection && inCondition.values.size() > maxInlinedValuesCount) {
+                    auto id = context.connection->acquire_in_table();
+                    context.inTables.push_back(id);
+                    auto tableName = "_sqlite_orm_in_" + std::to_string(id);
+                    this->fill_in_table(*context.connection, tableName, inCondition.values);
+                    ss << leftString << " " << static_cast<std::string>(inCondition) << " temp.\"" << tableName << "\"";
+                    return ss.str();
+                }
                 ss << leftString << " " << static_cast<std::string>(inCondition) << " (";
                 for(size_t index = 0; index < inCondition.values.size(); ++index) {
                     auto &value = inCondition.values[index];
-                    ss << " " << this->string_from_expression(value);
+                    ss << " " << this->string_from_expression(context, value);
                     if(index < inCondition.values.size() - 1) {
                         ss << ", ";
                     }
@@ -1128,24 +1465,24 @@ namespace sqlite_orm {
             }
             
             template<class A, class T>
-            std::string process_where(const conditions::like_t<A, T> &l) {
+            std::string process_where(internal::query_context &context, const conditions::like_t<A, T> &l) {
                 std::stringstream ss;
-                ss << this->string_from_expression(l.a) << " " << static_cast<std::string>(l) << " " << this->string_from_expression(l.t) << " ";
+                ss << this->string_from_expression(context, l.a) << " " << static_cast<std::string>(l) << " " << this->string_from_expression(context, l.t) << " ";
                 return ss.str();
             }
             
             template<class A, class T>
-            std::string process_where(const conditions::between_t<A, T> &bw) {
+            std::string process_where(internal::query_context &context, const conditions::between_t<A, T> &bw) {
                 std::stringstream ss;
-                auto expr = this->string_from_expression(bw.expr);
-                ss << expr << " " << static_cast<std::string>(bw) << " " << this->string_from_expression(bw.b1) << " AND " << this->string_from_expression(bw.b2) << " ";
+                auto expr = this->string_from_expression(context, bw.expr);
+                ss << expr << " " << static_cast<std::string>(bw) << " " << this->string_from_expression(context, bw.b1) << " AND " << this->string_from_expression(context, bw.b2) << " ";
                 return ss.str();
             }
             
             template<class O>
-            std::string process_order_by(const conditions::order_by_t<O> &orderBy) {
+            std::string process_order_by(internal::query_context &context, const conditions::order_by_t<O> &orderBy, bool noTableName = false) {
                 std::stringstream ss;
-                auto columnName = this->string_from_expression(orderBy.o);
+                auto columnName = this->string_from_expression(context, orderBy.o, noTableName);
                 ss << columnName << " ";
                 if(orderBy._collate_argument.length()){
                     ss << "COLLATE " << orderBy._collate_argument << " ";
@@ -1162,16 +1499,16 @@ namespace sqlite_orm {
             }
             
             template<class T>
-            void process_join_constraint(std::stringstream &ss, const conditions::on_t<T> &t) {
-                ss << static_cast<std::string>(t) << " " << this->process_where(t.t) << " ";
+            void process_join_constraint(internal::query_context &context, std::stringstream &ss, const conditions::on_t<T> &t) {
+                ss << static_cast<std::string>(t) << " " << this->process_where(context, t.t) << " ";
             }
             
             template<class F, class O>
-            void process_join_constraint(std::stringstream &ss, const conditions::using_t<F, O> &u) {
-                ss << static_cast<std::string>(u) << " (" << this->string_from_expression(u.column, true) << " ) ";
+            void process_join_constraint(internal::query_context &context, std::stringstream &ss, const conditions::using_t<F, O> &u) {
+                ss << static_cast<std::string>(u) << " (" << this->string_from_expression(context, u.column, true) << " ) ";
             }
             
-            void process_single_condition(std::stringstream &ss, const conditions::limit_t &limt) {
+            void process_single_condition(internal::query_context &/*context*/, std::stringstream &ss, const conditions::limit_t &limt) {
                 ss << static_cast<std::string>(limt) << " ";
                 if(limt.has_offset) {
                     if(limt.offset_is_implicit){
@@ -1186,69 +1523,69 @@ namespace sqlite_orm {
             }
             
             template<class O>
-            void process_single_condition(std::stringstream &ss, const conditions::cross_join_t<O> &c) {
+            void process_single_condition(internal::query_context &/*context*/, std::stringstream &ss, const conditions::cross_join_t<O> &c) {
                 ss << static_cast<std::string>(c) << " ";
                 ss << " '" << this->impl.template find_table_name<O>() << "' ";
             }
             
             template<class O>
-            void process_single_condition(std::stringstream &ss, const conditions::natural_join_t<O> &c) {
+            void process_single_condition(internal::query_context &/*context*/, std::stringstream &ss, const conditions::natural_join_t<O> &c) {
                 ss << static_cast<std::string>(c) << " ";
                 ss << " '" << this->impl.template find_table_name<O>() << "' ";
             }
             
             template<class T, class O>
-            void process_single_condition(std::stringstream &ss, const conditions::inner_join_t<T, O> &l) {
+            void process_single_condition(internal::query_context &context, std::stringstream &ss, const conditions::inner_join_t<T, O> &l) {
                 ss << static_cast<std::string>(l) << " ";
                 auto aliasString = alias_exractor<T>::get();
                 ss << " '" << this->impl.template find_table_name<typename mapped_type_proxy<T>::type>() << "' ";
                 if(aliasString.length()){
                     ss << "'" << aliasString << "' ";
                 }
-                this->process_join_constraint(ss, l.constraint);
+                this->process_join_constraint(context, ss, l.constraint);
             }
             
             template<class T, class O>
-            void process_single_condition(std::stringstream &ss, const conditions::left_outer_join_t<T, O> &l) {
+            void process_single_condition(internal::query_context &context, std::stringstream &ss, const conditions::left_outer_join_t<T, O> &l) {
                 ss << static_cast<std::string>(l) << " ";
                 ss << " '" << this->impl.template find_table_name<T>() << "' ";
-                this->process_join_constraint(ss, l.constraint);
+                this->process_join_constraint(context, ss, l.constraint);
             }
             
             template<class T, class O>
-            void process_single_condition(std::stringstream &ss, const conditions::left_join_t<T, O> &l) {
+            void process_single_condition(internal::query_context &context, std::stringstream &ss, const conditions::left_join_t<T, O> &l) {
                 ss << static_cast<std::string>(l) << " ";
                 ss << " '" << this->impl.template find_table_name<T>() << "' ";
-                this->process_join_constraint(ss, l.constraint);
+                this->process_join_constraint(context, ss, l.constraint);
             }
             
             template<class T, class O>
-            void process_single_condition(std::stringstream &ss, const conditions::join_t<T, O> &l) {
+            void process_single_condition(internal::query_context &context, std::stringstream &ss, const conditions::join_t<T, O> &l) {
                 ss << static_cast<std::string>(l) << " ";
                 ss << " '" << this->impl.template find_table_name<T>() << "' ";
-                this->process_join_constraint(ss, l.constraint);
+                this->process_join_constraint(context, ss, l.constraint);
             }
             
             template<class C>
-            void process_single_condition(std::stringstream &ss, const conditions::where_t<C> &w) {
+            void process_single_condition(internal::query_context &context, std::stringstream &ss, const conditions::where_t<C> &w) {
                 ss << static_cast<std::string>(w) << " ";
-                auto whereString = this->process_where(w.c);
+                auto whereString = this->process_where(context, w.c);
                 ss << "( " << whereString << ") ";
             }
             
             template<class O>
-            void process_single_condition(std::stringstream &ss, const conditions::order_by_t<O> &orderBy) {
+            void process_single_condition(internal::query_context &context, std::stringstream &ss, const conditions::order_by_t<O> &orderBy) {
                 ss << static_cast<std::string>(orderBy) << " ";
-                auto orderByString = this->process_order_by(orderBy);
+                auto orderByString = this->process_order_by(context, orderBy);
                 ss << orderByString << " ";
             }
             
             template<class ...Args>
-            void process_single_condition(std::stringstream &ss, const conditions::multi_order_by_t<Args...> &orderBy) {
+            void process_single_condition(internal::query_context &context, std::stringstream &ss, const conditions::multi_order_by_t<Args...> &orderBy) {
                 std::vector<std::string> expressions;
                 using tuple_t = std::tuple<Args...>;
-                tuple_helper::iterator<std::tuple_size<tuple_t>::value - 1, Args...>()(orderBy.args, [&expressions, this](auto &v){
-                    auto expression = this->process_order_by(v);
+                tuple_helper::iterator<std::tuple_size<tuple_t>::value - 1, Args...>()(orderBy.args, [&context, &expressions, this](auto &v){
+                    auto expression = this->process_order_by(context, v);
                     expressions.insert(expressions.begin(), expression);
                 });
                 ss << static_cast<std::string>(orderBy) << " ";
@@ -1262,11 +1599,11 @@ namespace sqlite_orm {
             }
             
             template<class ...Args>
-            void process_single_condition(std::stringstream &ss, const conditions::group_by_t<Args...> &groupBy) {
+            void process_single_condition(internal::query_context &context, std::stringstream &ss, const conditions::group_by_t<Args...> &groupBy) {
                 std::vector<std::string> expressions;
                 using tuple_t = std::tuple<Args...>;
-                tuple_helper::iterator<std::tuple_size<tuple_t>::value - 1, Args...>()(groupBy.args, [&expressions, this](auto &v){
-                    auto expression = this->string_from_expression(v);
+                tuple_helper::iterator<std::tuple_size<tuple_t>::value - 1, Args...>()(groupBy.args, [&context, &expressions, this](auto &v){
+                    auto expression = this->string_from_expression(context, v);
                     expressions.push_back(expression);
                 });
                 ss << static_cast<std::string>(groupBy) << " ";
@@ -1283,14 +1620,14 @@ namespace sqlite_orm {
              *  Recursion end.
              */
             template<class ...Args>
-            void process_conditions(std::stringstream &, Args .../*args*/) {
+            void process_conditions(internal::query_context &/*context*/, std::stringstream &, Args .../*args*/) {
                 //..
             }
             
             template<class C, class ...Args>
-            void process_conditions(std::stringstream &ss, C c, Args&& ...args) {
-                this->process_single_condition(ss, c);
-                this->process_conditions(ss, std::forward<Args>(args)...);
+            void process_conditions(internal::query_context &context, std::stringstream &ss, C c, Args&& ...args) {
+                this->process_single_condition(context, ss, c);
+                this->process_conditions(context, ss, std::forward<Args>(args)...);
             }
             
             void on_open_internal(sqlite3 *db) {
@@ -1319,6 +1656,8 @@ namespace sqlite_orm {
                     sqlite3_limit(db, p.first, p.second);
                 }
                 
+                this->tracer->register_on(db);
+                
                 if(this->on_open){
                     this->on_open(db);
                 }
@@ -1351,6 +1690,161 @@ namespace sqlite_orm {
                 return {*this, connection, std::forward<Args>(args)...};
             }
             
+            /**
+             *  Enables collecting statistics of every statement executed by storage: calls count, rows count,
+             *  total, median, 99th percentile and max latencies. Statements are aggregated by text with literals
+             *  replaced with `?`. Uses `sqlite3_trace_v2` so requires SQLite 3.14.0 or newer. Statistics are
+             *  available with `profile_snapshot`.
+             */
+            void enable_profiling(bool value = true) {
+                this->tracer->isProfilingEnabled = value;
+                if(this->currentTransaction){
+                    this->tracer->register_on(this->currentTransaction->get_db());
+                }
+            }
+            
+            /**
+             *  @return statistics of at most `topN` statements with the biggest total time since profiling was
+             *  enabled or reset.
+             */
+            std::vector<query_profile> profile_snapshot(size_t topN = 10) {
+                return this->tracer->queryProfiler.snapshot(topN);
+            }
+            
+            void reset_profiling() {
+                this->tracer->queryProfiler.reset();
+            }
+            
+            /**
+             *  Enables logging of statements executed longer than `threshold`. Every record contains statement
+             *  text, statement text with bound values, mapped table and storage operation name and elapsed time.
+             *  Records are passed to `sink` if it is set or are kept in a ring buffer of `capacity` size otherwise
+             *  (see `slow_queries`). Sink can be called from any thread storage is used from. Uses `sqlite3_trace_v2`
+             *  so requires SQLite 3.14.0 or newer.
+             */
+            void enable_slow_query_log(std::chrono::nanoseconds threshold, std::function<void(const slow_query&)> sink = {}, size_t capacity = 100) {
+                this->tracer->slowQueryLog.configure(threshold, std::move(sink), capacity);
+                this->tracer->isSlowQueryLogEnabled = true;
+                if(this->currentTransaction){
+                    this->tracer->register_on(this->currentTransaction->get_db());
+                }
+            }
+            
+            void disable_slow_query_log() {
+                this->tracer->isSlowQueryLogEnabled = false;
+                if(this->currentTransaction){
+                    this->tracer->register_on(this->currentTransaction->get_db());
+                }
+            }
+            
+            /**
+             *  @return slow queries kept in ring buffer from oldest to newest.
+             */
+            std::vector<slow_query> slow_queries() {
+                return this->tracer->slowQueryLog.get_records();
+            }
+            
+            /**
+             *  Enables collecting `sqlite3_stmt_status` counters (full scan steps, sorts, automatic index rows,
+             *  VM steps, reprepares and memory used) of every statement executed by storage. Counters are grouped by
+             *  mapped table and storage operation and are available with `statement_stats`. Uses `sqlite3_trace_v2`
+             *  so requires SQLite 3.14.0 or newer.
+             */
+            void enable_statement_stats(bool value = true) {
+                this->tracer->isStatementStatsEnabled = value;
+                if(this->currentTransaction){
+                    this->tracer->register_on(this->currentTransaction->get_db());
+                }
+            }
+            
+            /**
+             *  @return counters collected since statement stats were enabled or reset.
+             */
+            sqlite_orm::statement_stats statement_stats() {
+                return this->tracer->statementStats.snapshot();
+            }
+            
+            /**
+             *  @return counters of `operation` called for mapped type `O`. Counters of all operations
+             *  called for `O` are summed if `operation` is empty.
+             */
+            template<class O>
+            statement_counters statement_stats(const std::string &operation = {}) {
+                this->assert_mapped_type<O>();
+                return this->statement_stats().get(this->get_impl<O>().table.name, operation);
+            }
+            
+            void reset_statement_stats() {
+                this->tracer->statementStats.reset();
+            }
+            
+            /**
+             *  Starts writing every statement executed by storage with bound values and timing into a compact
+             *  binary workload log at `path`. Log can be read with `read_workload` and replayed with `replay`
+             *  tool from benchmarks directory. Statements of all connections and threads are written into
+             *  a single log in order of completion. Uses `sqlite3_trace_v2` so requires SQLite 3.14.0 or newer.
+             *  Note: recorded execution time precision depends on VFS clock and is often a millisecond.
+             *  throws std::system_error if file cannot be opened.
+             */
+            void start_recording(const std::string &path) {
+                this->tracer->workloadRecorder.start(path);
+                this->tracer->isRecording = true;
+                if(this->currentTransaction){
+                    this->tracer->register_on(this->currentTransaction->get_db());
+                }
+            }
+            
+            /**
+             *  Stops recording started with `start_recording` and closes the log.
+             */
+            void stop_recording() {
+                this->tracer->isRecording = false;
+                this->tracer->workloadRecorder.stop();
+                if(this->currentTransaction){
+                    this->tracer->register_on(this->currentTransaction->get_db());
+                }
+            }
+            
+            /**
+             *  @return query which storage would execute for expression `expression` without executing it.
+             *  Accepts `get_all<T>(args...)`, `count<T>(args...)` and `select(...)` expressions, e.g.
+             *  `storage.sql(get_all<User>(where(c(&User::id) > 10)))`. `in` values are written into query text.
+             */
+            template<class T>
+            std::string sql(const T &expression) {
+                
+                //  nothing is executed so `in` values are written into query text
+                internal::query_context context{nullptr};
+                return this->string_from_expression(context, expression);
+            }
+            
+            /**
+             *  Runs `EXPLAIN QUERY PLAN` for an expression accepted by `sql`.
+             *  @return plan nodes tree.
+             */
+            template<class T>
+            query_plan explain(const T &expression) {
+                auto connection = this->get_or_create_connection();
+                internal::query_context context{connection};
+                return this->explain_query(connection->get_db(), this->string_from_expression(context, expression));
+            }
+            
+            /**
+             *  Marks table mapped to `O` as large. In debug builds (NDEBUG is not defined) `get_all`, `select`
+             *  and `count` explain their queries before execution if any table is marked as large and fire
+             *  an assertion if the plan contains full scan of a marked table.
+             */
+            template<class O>
+            void mark_large_table(bool value = true) {
+                this->assert_mapped_type<O>();
+                auto &tableName = this->get_impl<O>().table.name;
+                if(value) {
+                    this->largeTables.insert(tableName);
+                }else{
+                    this->largeTables.erase(tableName);
+                }
+            }
+            
             void create_collation(const std::string &name, collating_function f) {
                 collating_function *functionPointer = nullptr;
                 if(f){
@@ -1376,12 +1870,14 @@ namespace sqlite_orm {
             template<class O, class ...Args>
             void remove_all(Args&& ...args) {
                 this->assert_mapped_type<O>();
+                internal::operation_scope operationScope("remove_all", &this->get_impl<O>().table.name);
                 
                 auto connection = this->get_or_create_connection();
+                internal::query_context context{connection};
                 auto &impl = this->get_impl<O>();
                 std::stringstream ss;
                 ss << "DELETE FROM '" << impl.table.name << "' ";
-                this->process_conditions(ss, std::forward<Args>(args)...);
+                this->process_conditions(context, ss, std::forward<Args>(args)...);
                 auto query = ss.str();
                 sqlite3_stmt *stmt;
                 if (sqlite3_prepare_v2(connection->get_db(), query.c_str(), -1, &stmt, nullptr) == SQLITE_OK) {
@@ -1396,62 +1892,80 @@ namespace sqlite_orm {
                 }
             }
             
+        protected:
+            
             /**
-             *  Delete routine.
-             *  O is an object's type. Must be specified explicitly.
-             *  @param id id of object to be removed.
+             *  `WHERE "pk" = ? AND ...` clause matching a row by all primary key columns of `impl`. Values
+             *  are bound by `bind_primary_key` or `primary_key_value`.
              */
-            template<class O, class I>
-            void remove(I id) {
-                this->assert_mapped_type<O>();
-                
-                auto connection = this->get_or_create_connection();
-                auto &impl = this->get_impl<O>();
+            template<class I>
+            std::string primary_key_where(I &impl) {
                 std::stringstream ss;
-                ss << "DELETE FROM '" << impl.table.name << "' ";
                 ss << "WHERE ";
                 auto primaryKeyColumnNames = impl.table.primary_key_column_names();
                 for(size_t i = 0; i < primaryKeyColumnNames.size(); ++i) {
-                    ss << "\"" << primaryKeyColumnNames[i] << "\"" << " =  ?";
+                    ss << "\"" << primaryKeyColumnNames[i] << "\"" << " = ?";
                     if(i < primaryKeyColumnNames.size() - 1) {
                         ss << " AND ";
                     }else{
                         ss << " ";
                     }
                 }
-                auto query = ss.str();
-                sqlite3_stmt *stmt;
-                if (sqlite3_prepare_v2(connection->get_db(), query.c_str(), -1, &stmt, nullptr) == SQLITE_OK) {
-                    statement_finalizer finalizer{stmt};
-                    auto index = 1;
-                    statement_binder<I>().bind(stmt, index++, id);
-                    if (sqlite3_step(stmt) == SQLITE_DONE) {
-                        //  done..
-                    }else{
-                        throw std::system_error(std::error_code(sqlite3_errcode(connection->get_db()), get_sqlite_error_category()));
-                    }
-                }else{
-                    throw std::system_error(std::error_code(sqlite3_errcode(connection->get_db()), get_sqlite_error_category()));
+                return ss.str();
+            }
+            
+            /**
+             *  Whether `columnName` is one of `primaryKeyColumnNames`. Unlike checking `primary_key()` column
+             *  constraint it also matches columns of a table level (composite) primary key.
+             */
+            static bool is_primary_key_column(const std::string &columnName, const std::vector<std::string> &primaryKeyColumnNames) {
+                return std::find(primaryKeyColumnNames.begin(), primaryKeyColumnNames.end(), columnName) != primaryKeyColumnNames.end();
+            }
+            
+            /**
+             *  Binds primary key columns of `o` starting from `index` in the order of `primary_key_where`.
+             *  @param primaryKeyColumnNames result of `primary_key_column_names` of `impl` table.
+             */
+            template<class I, class O>
+            void bind_primary_key(sqlite3_stmt *stmt, I &impl, const O &o, const std::vector<std::string> &primaryKeyColumnNames, int &index) {
+                for(auto &columnName : primaryKeyColumnNames) {
+                    impl.table.for_each_column([&o, stmt, &index, &columnName] (auto c) {
+                        if(c.name == columnName) {
+                            using field_type = typename decltype(c)::field_type;
+                            const field_type *value = nullptr;
+                            if(c.member_pointer){
+                                value = &(o.*c.member_pointer);
+                            }else{
+                                value = &((o).*(c.getter))();
+                            }
+                            statement_binder<field_type>().bind(stmt, index++, *value);
+                        }
+                    });
                 }
             }
             
             /**
-             *  Update routine. Sets all non primary key fields where primary key is equal.
-             *  O is an object type. May be not specified explicitly cause it can be deduced by
-             *      compiler from first parameter.
-             *  @param o object to be updated.
+             *  Query used by `remove` and `remove_range`: `DELETE FROM 'table' WHERE "pk" = ?`.
              */
-            template<class O>
-            void update(const O &o) {
-                this->assert_mapped_type<O>();
-                
-                auto connection = this->get_or_create_connection();
-                auto &impl = this->get_impl<O>();
+            template<class I>
+            std::string remove_query(I &impl) {
+                std::stringstream ss;
+                ss << "DELETE FROM '" << impl.table.name << "' ";
+                ss << this->primary_key_where(impl);
+                return ss.str();
+            }
+            
+            /**
+             *  Query used by `update` and `update_range`: `UPDATE 'table' SET "c" = ?, ... WHERE "pk" = ?`.
+             */
+            template<class I>
+            std::string update_query(I &impl) {
                 std::stringstream ss;
                 ss << "UPDATE '" << impl.table.name << "' SET ";
                 std::vector<std::string> setColumnNames;
-                impl.table.for_each_column([&setColumnNames](auto c) {
-                    if(!c.template has<constraints::primary_key_t<>>()) {
+                auto primaryKeyColumnNames = impl.table.primary_key_column_names();
+                impl.table.for_each_column([&setColumnNames, &primaryKeyColumnNames](auto c) {
+                    if(!is_primary_key_column(c.name, primaryKeyColumnNames)) {
                         setColumnNames.emplace_back(c.name);
                     }
                 });
@@ -1463,45 +1977,198 @@ namespace sqlite_orm {
                         ss << " ";
                     }
                 }
-                ss << "WHERE ";
+                ss << this->primary_key_where(impl);
+                return ss.str();
+            }
+            
+            template<class O, class F, class I>
+            void update_column_internal(const char *operation, F O::*m, const I &id, const F &value, bool increment) {
+                this->assert_mapped_type<O>();
+                auto &impl = this->get_impl<O>();
+                internal::operation_scope operationScope(operation, &impl.table.name);
+                measurement_type measurement(this->instrumentationPolicy, operation);
+                
+                measurement.phase(instrumentation_phase::connect);
+                auto connection = this->get_or_create_connection();
+                measurement.phase(instrumentation_phase::build);
+                auto columnName = impl.table.find_column_name(m);
+                if(columnName.empty()) {
+                    throw std::system_error(std::make_error_code(orm_error_code::column_not_found));
+                }
                 auto primaryKeyColumnNames = impl.table.primary_key_column_names();
-                for(size_t i = 0; i < primaryKeyColumnNames.size(); ++i) {
-                    ss << "\"" << primaryKeyColumnNames[i] << "\"" << " = ?";
-                    if(i < primaryKeyColumnNames.size() - 1) {
-                        ss << " AND ";
+                if(primaryKeyColumnNames.empty()) {
+                    throw std::system_error(std::make_error_code(orm_error_code::table_has_no_primary_key_column));
+                }
+                std::stringstream ss;
+                ss << "UPDATE '" << impl.table.name << "' SET \"" << columnName << "\" = ";
+                if(increment) {
+                    ss << "\"" << columnName << "\" + ";
+                }
+                ss << "? " << this->primary_key_where(impl);
+                auto query = ss.str();
+                measurement.phase(instrumentation_phase::prepare);
+                auto stmt = connection->get_statement(query);
+                statement_resetter resetter{stmt};
+                measurement.phase(instrumentation_phase::bind);
+                auto index = 1;
+                statement_binder<F>().bind(stmt, index++, value);
+                internal::primary_key_value<I>::bind(stmt, index, id);
+                measurement.phase(instrumentation_phase::step);
+                if (sqlite3_step(stmt) == SQLITE_DONE) {
+                    //  done..
+                }else{
+                    throw std::system_error(std::error_code(sqlite3_errcode(connection->get_db()), get_sqlite_error_category()));
+                }
+            }
+            
+            /**
+             *  Query used by `update(o, original)`: `UPDATE 'table' SET "c" = ? WHERE "pk" = ?` with columns
+             *  set by `changedColumns` only.
+             */
+            template<class I>
+            std::string partial_update_query(I &impl, const std::vector<bool> &changedColumns) {
+                std::stringstream ss;
+                ss << "UPDATE '" << impl.table.name << "' SET ";
+                std::vector<std::string> setColumnNames;
+                auto primaryKeyColumnNames = impl.table.primary_key_column_names();
+                size_t columnIndex = 0;
+                impl.table.for_each_column([&setColumnNames, &primaryKeyColumnNames, &changedColumns, &columnIndex](auto c) {
+                    if(!is_primary_key_column(c.name, primaryKeyColumnNames) && changedColumns[columnIndex++]) {
+                        setColumnNames.emplace_back(c.name);
+                    }
+                });
+                for(size_t i = 0; i < setColumnNames.size(); ++i) {
+                    ss << "\"" << setColumnNames[i] << "\"" << " = ?";
+                    if(i < setColumnNames.size() - 1) {
+                        ss << ", ";
                     }else{
                         ss << " ";
                     }
                 }
-                auto query = ss.str();
+                ss << this->primary_key_where(impl);
+                return ss.str();
+            }
+            
+            /**
+             *  Binds `o` to a statement prepared from `update_query`: non primary key columns first, primary key
+             *  columns after them.
+             *  @param primaryKeyColumnNames result of `primary_key_column_names` of `impl` table.
+             */
+            template<class I, class O>
+            void bind_update(sqlite3_stmt *stmt, I &impl, const O &o, const std::vector<std::string> &primaryKeyColumnNames) {
+                auto index = 1;
+                impl.table.for_each_column([&o, stmt, &index, &primaryKeyColumnNames] (auto c) {
+                    if(!is_primary_key_column(c.name, primaryKeyColumnNames)) {
+                        using field_type = typename decltype(c)::field_type;
+                        const field_type *value = nullptr;
+                        if(c.member_pointer){
+                            value = &(o.*c.member_pointer);
+                        }else{
+                            value = &((o).*(c.getter))();
+                        }
+                        statement_binder<field_type>().bind(stmt, index++, *value);
+                    }
+                });
+                this->bind_primary_key(stmt, impl, o, primaryKeyColumnNames, index);
+            }
+            
+            /**
+             *  Prepares `query` once and calls `bind(stmt, element)` and steps the statement for every element of
+             *  [from, to). Runs inside a transaction: the current one if `db` is already in a transaction or a new one
+             *  which is committed at the end and rolled back if any step fails.
+             */
+            template<class It, class B>
+            void execute_range(sqlite3 *db, const std::string &query, It from, It to, measurement_type &measurement, const B &bind) {
                 sqlite3_stmt *stmt;
+                measurement.phase(instrumentation_phase::prepare);
+                if (sqlite3_prepare_v2(db, query.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+                    throw std::system_error(std::error_code(sqlite3_errcode(db), get_sqlite_error_category()));
+                }
+                statement_finalizer finalizer{stmt};
+                measurement.phase(instrumentation_phase::step);
+                auto ownTransaction = sqlite3_get_autocommit(db) != 0;
+                if(ownTransaction) {
+                    this->impl.begin_transaction(db);
+                }
+                try{
+                    for(auto it = from; it != to; ++it) {
+                        bind(stmt, *it);
+                        if (sqlite3_step(stmt) != SQLITE_DONE) {
+                            throw std::system_error(std::error_code(sqlite3_errcode(db), get_sqlite_error_category()));
+                        }
+                        sqlite3_reset(stmt);
+                        sqlite3_clear_bindings(stmt);
+                    }
+                }catch(...){
+                    if(ownTransaction) {
+                        this->impl.rollback(db);
+                    }
+                    throw;
+                }
+                if(ownTransaction) {
+                    this->impl.commit(db);
+                }
+            }
+            
+        public:
+            
+            /**
+             *  Delete routine.
+             *  O is an object's type. Must be specified explicitly.
+             *  @param id id of object to be removed.
+             */
+            template<class O, class I>
+            void remove(I id) {
+                this->assert_mapped_type<O>();
+                internal::operation_scope operationScope("remove", &this->get_impl<O>().table.name);
+                measurement_type measurement(this->instrumentationPolicy, "remove");
+                
+                measurement.phase(instrumentation_phase::connect);
+                auto connection = this->get_or_create_connection();
+                measurement.phase(instrumentation_phase::build);
+                auto query = this->remove_query(this->get_impl<O>());
+                sqlite3_stmt *stmt;
+                measurement.phase(instrumentation_phase::prepare);
                 if (sqlite3_prepare_v2(connection->get_db(), query.c_str(), -1, &stmt, nullptr) == SQLITE_OK) {
                     statement_finalizer finalizer{stmt};
+                    measurement.phase(instrumentation_phase::bind);
                     auto index = 1;
-                    impl.table.for_each_column([&o, stmt, &index] (auto c) {
-                        if(!c.template has<constraints::primary_key_t<>>()) {
-                            using field_type = typename decltype(c)::field_type;
-                            const field_type *value = nullptr;
-                            if(c.member_pointer){
-                                value = &(o.*c.member_pointer);
-                            }else{
-                                value = &((o).*(c.getter))();
-                            }
-                            statement_binder<field_type>().bind(stmt, index++, *value);
-                        }
-                    });
-                    impl.table.for_each_column([&o, stmt, &index] (auto c) {
-                        if(c.template has<constraints::primary_key_t<>>()) {
-                            typedef typename decltype(c)::field_type field_type;
-                            const field_type *value = nullptr;
-                            if(c.member_pointer){
-                                value = &(o.*c.member_pointer);
-                            }else{
-                                value = &((o).*(c.getter))();
-                            }
-                            statement_binder<field_type>().bind(stmt, index++, *value);
-                        }
-                    });
+                    statement_binder<I>().bind(stmt, index++, id);
+                    measurement.phase(instrumentation_phase::step);
+                    if (sqlite3_step(stmt) == SQLITE_DONE) {
+                        //  done..
+                    }else{
+                        throw std::system_error(std::error_code(sqlite3_errcode(connection->get_db()), get_sqlite_error_category()));
+                    }
+                }else{
+                    throw std::system_error(std::error_code(sqlite3_errcode(connection->get_db()), get_sqlite_error_category()));
+                }
+            }
+            
+            /**
+             *  Update routine. Sets all non primary key fields where primary key is equal.
+             *  O is an object type. May be not specified explicitly cause it can be deduced by
+             *      compiler from first parameter.
+             *  @param o object to be updated.
+             */
+            template<class O>
+            void update(const O &o) {
+                this->assert_mapped_type<O>();
+                internal::operation_scope operationScope("update", &this->get_impl<O>().table.name);
+                measurement_type measurement(this->instrumentationPolicy, "update");
+                
+                measurement.phase(instrumentation_phase::connect);
+                auto connection = this->get_or_create_connection();
+                measurement.phase(instrumentation_phase::build);
+                auto &impl = this->get_impl<O>();
+                auto query = this->update_query(impl);
+                sqlite3_stmt *stmt;
+                measurement.phase(instrumentation_phase::prepare);
+                if (sqlite3_prepare_v2(connection->get_db(), query.c_str(), -1, &stmt, nullptr) == SQLITE_OK) {
+                    statement_finalizer finalizer{stmt};
+                    measurement.phase(instrumentation_phase::bind);
+                    this->bind_update(stmt, impl, o, impl.table.primary_key_column_names());
+                    measurement.phase(instrumentation_phase::step);
                     if (sqlite3_step(stmt) == SQLITE_DONE) {
                         //  done..
                     }else{
@@ -1512,9 +2179,169 @@ namespace sqlite_orm {
                 }
             }
             
+            /**
+             *  Partial update routine. Compares `o` with `original` (usually a copy made when the object was
+             *  fetched) and sets only non primary key fields which values differ. Does nothing if all fields are
+             *  equal. Fields are compared with `field_comparator`. Statements are cached by connection per table
+             *  and changed fields set.
+             *  @param o object to be updated.
+             *  @param original object state the database is known to have. Its primary key is not used.
+             */
+            template<class O>
+            void update(const O &o, const O &original) {
+                this->assert_mapped_type<O>();
+                internal::operation_scope operationScope("update", &this->get_impl<O>().table.name);
+                measurement_type measurement(this->instrumentationPolicy, "update");
+                auto &impl = this->get_impl<O>();
+                std::vector<bool> changedColumns;
+                auto changedColumnsCount = 0;
+                auto primaryKeyColumnNames = impl.table.primary_key_column_names();
+                impl.table.for_each_column([&o, &original, &primaryKeyColumnNames, &changedColumns, &changedColumnsCount] (auto c) {
+                    if(!is_primary_key_column(c.name, primaryKeyColumnNames)) {
+                        using field_type = typename decltype(c)::field_type;
+                        const field_type *value = nullptr;
+                        const field_type *originalValue = nullptr;
+                        if(c.member_pointer){
+                            value = &(o.*c.member_pointer);
+                            originalValue = &(original.*c.member_pointer);
+                        }else{
+                            value = &((o).*(c.getter))();
+                            originalValue = &((original).*(c.getter))();
+                        }
+                        auto changed = !field_comparator<field_type>()(*value, *originalValue);
+                        changedColumns.push_back(changed);
+                        changedColumnsCount += changed;
+                    }
+                });
+                if(!changedColumnsCount) {
+                    return;
+                }
+                
+                measurement.phase(instrumentation_phase::connect);
+                auto connection = this->get_or_create_connection();
+                measurement.phase(instrumentation_phase::build);
+                
+                //  statement is looked up by table and changed columns so query text is built once per connection
+                std::string key = "update " + impl.table.name + " ";
+                for(auto changed : changedColumns) {
+                    key += changed ? '1' : '0';
+                }
+                measurement.phase(instrumentation_phase::prepare);
+                auto stmt = connection->get_statement(key, [this, &impl, &changedColumns]{
+                    return this->partial_update_query(impl, changedColumns);
+                });
+                statement_resetter resetter{stmt};
+                measurement.phase(instrumentation_phase::bind);
+                auto index = 1;
+                size_t columnIndex = 0;
+                impl.table.for_each_column([&o, stmt, &index, &primaryKeyColumnNames, &changedColumns, &columnIndex] (auto c) {
+                    if(!is_primary_key_column(c.name, primaryKeyColumnNames) && changedColumns[columnIndex++]) {
+                        using field_type = typename decltype(c)::field_type;
+                        const field_type *value = nullptr;
+                        if(c.member_pointer){
+                            value = &(o.*c.member_pointer);
+                        }else{
+                            value = &((o).*(c.getter))();
+                        }
+                        statement_binder<field_type>().bind(stmt, index++, *value);
+                    }
+                });
+                this->bind_primary_key(stmt, impl, o, primaryKeyColumnNames, index);
+                measurement.phase(instrumentation_phase::step);
+                if (sqlite3_step(stmt) == SQLITE_DONE) {
+                    //  done..
+                }else{
+                    throw std::system_error(std::error_code(sqlite3_errcode(connection->get_db()), get_sqlite_error_category()));
+                }
+            }
+            
+            /**
+             *  Updates every object of [from, to) like `update` does. The `UPDATE` statement is built and
+             *  prepared once and rebound for every object. All updates are performed in one transaction:
+             *  the current one if it is active or a new one otherwise. If any update fails the new transaction
+             *  is rolled back and the error is thrown.
+             */
+            template<class It>
+            void update_range(It from, It to) {
+                using O = typename std::iterator_traits<It>::value_type;
+                this->assert_mapped_type<O>();
+                internal::operation_scope operationScope("update_range", &this->get_impl<O>().table.name);
+                measurement_type measurement(this->instrumentationPolicy, "update_range");
+                if(from == to) {
+                    return;
+                }
+                
+                measurement.phase(instrumentation_phase::connect);
+                auto connection = this->get_or_create_connection();
+                measurement.phase(instrumentation_phase::build);
+                auto &impl = this->get_impl<O>();
+                auto query = this->update_query(impl);
+                auto primaryKeyColumnNames = impl.table.primary_key_column_names();
+                this->execute_range(connection->get_db(), query, from, to, measurement, [this, &impl, &primaryKeyColumnNames](sqlite3_stmt *stmt, const O &o) {
+                    this->bind_update(stmt, impl, o, primaryKeyColumnNames);
+                });
+            }
+            
+            /**
+             *  Removes objects with ids from [from, to) like `remove` does. The `DELETE` statement is built and
+             *  prepared once and rebound for every id. Removes are performed in one transaction just like
+             *  `update_range` updates.
+             *  O is an object's type. Must be specified explicitly.
+             *  Id type is a primary key field type or `std::tuple` of fields types for a composite primary key
+             *  with values in the same order as columns are passed to `primary_key()`.
+             */
+            template<class O, class It>
+            void remove_range(It from, It to) {
+                using id_type = typename std::iterator_traits<It>::value_type;
+                this->assert_mapped_type<O>();
+                internal::operation_scope operationScope("remove_range", &this->get_impl<O>().table.name);
+                measurement_type measurement(this->instrumentationPolicy, "remove_range");
+                if(from == to) {
+                    return;
+                }
+                
+                measurement.phase(instrumentation_phase::connect);
+                auto connection = this->get_or_create_connection();
+                measurement.phase(instrumentation_phase::build);
+                auto query = this->remove_query(this->get_impl<O>());
+                this->execute_range(connection->get_db(), query, from, to, measurement, [](sqlite3_stmt *stmt, const id_type &id) {
+                    auto index = 1;
+                    internal::primary_key_value<id_type>::bind(stmt, index, id);
+                });
+            }
+            
+            /**
+             *  Sets one field of an object with primary key equal to `id`:
+             *  `UPDATE 'table' SET "column" = ? WHERE "pk" = ?`. Other fields are not touched so there is no
+             *  need to fetch the object first. Statement is cached by connection.
+             *  Id type is a primary key field type or `std::tuple` of fields types for a composite primary key.
+             *  Does nothing if there is no such object.
+             *  @param m member pointer of the field to be set.
+             *  @param value new field value. Is converted to the field type.
+             */
+            template<class O, class F, class I, class V>
+            void update_column(F O::*m, const I &id, const V &value) {
+                this->update_column_internal("update_column", m, id, F(value), false);
+            }
+            
+            /**
+             *  Adds `delta` to one field of an object with primary key equal to `id` inside the database:
+             *  `UPDATE 'table' SET "column" = "column" + ? WHERE "pk" = ?`. Unlike `get` + `update` it is one
+             *  statement so concurrent increments from different connections are not lost.
+             *  Statement is cached by connection. Does nothing if there is no such object.
+             *  @param m member pointer of a numeric field.
+             *  @param delta value added to the field. Pass a negative value to decrement.
+             */
+            template<class O, class F, class I, class V>
+            void increment(F O::*m, const I &id, const V &delta) {
+                this->update_column_internal("increment", m, id, F(delta), true);
+            }
+            
             template<class ...Args, class ...Wargs>
             void update_all(internal::set_t<Args...> set, Wargs ...wh) {
+                internal::operation_scope operationScope("update_all");
                 auto connection = this->get_or_create_connection();
+                internal::query_context context{connection};
                 
                 std::stringstream ss;
                 ss << "UPDATE ";
@@ -1528,9 +2355,9 @@ namespace sqlite_orm {
                         ss << " '" << *tableNamesSet.begin() << "' ";
                         ss << static_cast<std::string>(set) << " ";
                         std::vector<std::string> setPairs;
-                        set.for_each([this, &setPairs](auto &asgn){
+                        set.for_each([&context, this, &setPairs](auto &asgn){
                             std::stringstream sss;
-                            sss << this->string_from_expression(asgn.l, true) << " = " << this->string_from_expression(asgn.r) << " ";
+                            sss << this->string_from_expression(context, asgn.l, true) << " = " << this->string_from_expression(context, asgn.r) << " ";
                             setPairs.push_back(sss.str());
                         });
                         auto setPairsCount = setPairs.size();
@@ -1540,7 +2367,7 @@ namespace sqlite_orm {
                                 ss << ", ";
                             }
                         }
-                        this->process_conditions(ss, wh...);
+                        this->process_conditions(context, ss, wh...);
                         auto query = ss.str();
                         sqlite3_stmt *stmt;
                         if (sqlite3_prepare_v2(connection->get_db(), query.c_str(), -1, &stmt, nullptr) == SQLITE_OK) {
@@ -1570,7 +2397,7 @@ namespace sqlite_orm {
              *  @return impl for O
              */
             template<class O, class ...Args>
-            auto& generate_select_asterisk(std::string *query, Args&& ...args) {
+            auto& generate_select_asterisk(internal::query_context &context, std::string *query, Args&& ...args) {
                 std::stringstream ss;
                 ss << "SELECT ";
                 auto &impl = this->get_impl<O>();
@@ -1589,7 +2416,7 @@ namespace sqlite_orm {
                     }
                 }
                 ss << "FROM '" << impl.table.name << "' ";
-                this->process_conditions(ss, std::forward<Args>(args)...);
+                this->process_conditions(context, ss, std::forward<Args>(args)...);
                 if(query){
                     *query = ss.str();
                 }
@@ -1759,6 +2586,11 @@ namespace sqlite_orm {
                 return this->parse_table_name(f.t);
             }
             
+            template<class O>
+            std::set<std::string> parse_table_name(const conditions::order_by_t<O> &orderBy) {
+                return this->parse_table_name(orderBy.o);
+            }
+            
             template<class L, class R, class ...Args>
             std::set<std::string> parse_table_name(const conc_t<L, R> &f) {
                 std::set<std::string> res;
@@ -1852,20 +2684,22 @@ namespace sqlite_orm {
             template<class F, class O, class ...Args>
             std::string group_concat_internal(F O::*m, std::shared_ptr<const std::string> y, Args&& ...args) {
                 this->assert_mapped_type<O>();
+                internal::operation_scope operationScope("group_concat", &this->get_impl<O>().table.name);
                 
                 auto connection = this->get_or_create_connection();
+                internal::query_context context{connection};
                 auto &impl = this->get_impl<O>();
                 std::string res;
                 std::stringstream ss;
                 ss << "SELECT " << static_cast<std::string>(sqlite_orm::group_concat(0)) << "(";
-                auto columnName = this->string_from_expression(m);
+                auto columnName = this->string_from_expression(context, m);
                 if(columnName.length()){
                     ss << columnName;
                     if(y){
                         ss << ",\"" << *y << "\"";
                     }
                     ss << ") FROM '"<< impl.table.name << "' ";
-                    this->process_conditions(ss, std::forward<Args>(args)...);
+                    this->process_conditions(context, ss, std::forward<Args>(args)...);
                     auto query = ss.str();
                     auto rc = sqlite3_exec(connection->get_db(),
                                            query.c_str(),
@@ -1885,6 +2719,126 @@ namespace sqlite_orm {
                 return res;
             }
             
+            /**
+             *  Multi-get implementation. Fetches unique ids from [from, to) with as few statements as
+             *  `SQLITE_LIMIT_VARIABLE_NUMBER` allows. Composite ids are matched with row values which require
+             *  SQLite 3.15.0, older versions use `OR` chains limited by `SQLITE_LIMIT_EXPR_DEPTH`. Primary key columns are selected after object columns
+             *  so every row is mapped back to its id.
+             */
+            template<class O, class It, class Id = typename std::iterator_traits<It>::value_type>
+            std::map<Id, O> get_map_internal(It from, It to, const char *operation) {
+                this->assert_mapped_type<O>();
+                internal::operation_scope operationScope(operation, &this->get_impl<O>().table.name);
+                using primary_key_value = internal::primary_key_value<Id>;
+                
+                std::map<Id, O> res;
+                std::set<Id> ids(from, to);
+                if(ids.empty()) {
+                    return res;
+                }
+                auto connection = this->get_or_create_connection();
+                auto db = connection->get_db();
+                auto &impl = this->get_impl<O>();
+                auto primaryKeyColumnNames = impl.table.primary_key_column_names();
+                if(primaryKeyColumnNames.empty() || !primaryKeyColumnNames.front().length()) {
+                    throw std::system_error(std::make_error_code(orm_error_code::table_has_no_primary_key_column));
+                }
+                std::stringstream ss;
+                ss << "SELECT ";
+                for(auto &columnName : impl.table.column_names()) {
+                    ss << "\"" << columnName << "\", ";
+                }
+                for(size_t i = 0; i < primaryKeyColumnNames.size(); ++i) {
+                    ss << "\"" << primaryKeyColumnNames[i] << "\"";
+                    if(i < primaryKeyColumnNames.size() - 1) {
+                        ss << ", ";
+                    }
+                }
+                ss << " FROM '" << impl.table.name << "' WHERE ";
+                auto selectPart = ss.str();
+                auto variablesLimit = sqlite3_limit(db, SQLITE_LIMIT_VARIABLE_NUMBER, -1);
+                auto chunkSize = static_cast<size_t>(std::max(1, variablesLimit / primary_key_value::columns_count));
+#if SQLITE_VERSION_NUMBER < 3015000
+                if(primaryKeyColumnNames.size() > 1) {
+                    
+                    //  every `OR` term nests expression one level deeper
+                    auto exprDepthLimit = sqlite3_limit(db, SQLITE_LIMIT_EXPR_DEPTH, -1);
+                    chunkSize = std::min(chunkSize, static_cast<size_t>(std::max(1, exprDepthLimit / 2)));
+                }
+#endif
+                auto it = ids.begin();
+                auto remaining = ids.size();
+                while(remaining) {
+                    auto count = std::min(chunkSize, remaining);
+                    std::stringstream qs;
+                    qs << selectPart;
+                    if(primaryKeyColumnNames.size() == 1) {
+                        qs << "\"" << primaryKeyColumnNames.front() << "\" IN (";
+                        for(size_t i = 0; i < count; ++i) {
+                            qs << (i ? ", ?" : "?");
+                        }
+                        qs << ")";
+                    }else{
+#if SQLITE_VERSION_NUMBER >= 3015000
+                        
+                        //  row values keep expression flat for any ids count
+                        qs << "(";
+                        for(size_t j = 0; j < primaryKeyColumnNames.size(); ++j) {
+                            qs << (j ? ", \"" : "\"") << primaryKeyColumnNames[j] << "\"";
+                        }
+                        qs << ") IN (VALUES ";
+                        for(size_t i = 0; i < count; ++i) {
+                            qs << (i ? ", (" : "(");
+                            for(size_t j = 0; j < primaryKeyColumnNames.size(); ++j) {
+                                qs << (j ? ", ?" : "?");
+                            }
+                            qs << ")";
+                        }
+                        qs << ")";
+#else
+                        for(size_t i = 0; i < count; ++i) {
+                            qs << (i ? " OR (" : "(");
+                            for(size_t j = 0; j < primaryKeyColumnNames.size(); ++j) {
+                                qs << (j ? " AND \"" : "\"") << primaryKeyColumnNames[j] << "\" = ?";
+                            }
+                            qs << ")";
+                        }
+#endif
+                    }
+                    auto query = qs.str();
+                    sqlite3_stmt *stmt;
+                    if(sqlite3_prepare_v2(db, query.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+                        throw std::system_error(std::error_code(sqlite3_errcode(db), get_sqlite_error_category()));
+                    }
+                    statement_finalizer finalizer{stmt};
+                    auto index = 1;
+                    for(size_t i = 0; i < count; ++i, ++it) {
+                        primary_key_value::bind(stmt, index, *it);
+                    }
+                    remaining -= count;
+                    int stepRes;
+                    while((stepRes = sqlite3_step(stmt)) == SQLITE_ROW) {
+                        O object;
+                        index = 0;
+                        impl.table.for_each_column([&index, &object, stmt] (auto c) {
+                            using field_type = typename decltype(c)::field_type;
+                            auto value = row_extractor<field_type>().extract(stmt, index++);
+                            if(c.member_pointer){
+                                object.*c.member_pointer = value;
+                            }else{
+                                ((object).*(c.setter))(std::move(value));
+                            }
+                        });
+                        auto id = primary_key_value::extract(stmt, index);
+                        res.insert({std::move(id), std::move(object)});
+                    }
+                    if(stepRes != SQLITE_DONE) {
+                        throw std::system_error(std::error_code(sqlite3_errcode(db), get_sqlite_error_category()));
+                    }
+                }
+                return res;
+            }
+            
         public:
             
             /**
@@ -1895,19 +2849,28 @@ namespace sqlite_orm {
             template<class O, class C = std::vector<O>, class ...Args>
             C get_all(Args&& ...args) {
                 this->assert_mapped_type<O>();
+                internal::operation_scope operationScope("get_all", &this->get_impl<O>().table.name);
+                measurement_type measurement(this->instrumentationPolicy, "get_all");
                 
+                measurement.phase(instrumentation_phase::connect);
                 auto connection = this->get_or_create_connection();
+                internal::query_context context{connection};
+                measurement.phase(instrumentation_phase::build);
                 C res;
                 std::string query;
-                auto &impl = this->generate_select_asterisk<O>(&query, std::forward<Args>(args)...);
+                auto &impl = this->generate_select_asterisk<O>(context, &query, std::forward<Args>(args)...);
+                this->assert_no_large_table_scan(connection->get_db(), query);
                 sqlite3_stmt *stmt;
+                measurement.phase(instrumentation_phase::prepare);
                 if (sqlite3_prepare_v2(connection->get_db(), query.c_str(), -1, &stmt, nullptr) == SQLITE_OK) {
                     statement_finalizer finalizer{stmt};
                     int stepRes;
                     do{
+                        measurement.phase(instrumentation_phase::step);
                         stepRes = sqlite3_step(stmt);
                         switch(stepRes){
                             case SQLITE_ROW:{
+                                measurement.phase(instrumentation_phase::hydrate);
                                 O obj;
                                 auto index = 0;
                                 impl.table.for_each_column([&index, &obj, stmt] (auto c) {
@@ -1944,8 +2907,12 @@ namespace sqlite_orm {
             template<class O, class ...Ids>
             O get(Ids ...ids) {
                 this->assert_mapped_type<O>();
+                internal::operation_scope operationScope("get", &this->get_impl<O>().table.name);
+                measurement_type measurement(this->instrumentationPolicy, "get");
                 
+                measurement.phase(instrumentation_phase::connect);
                 auto connection = this->get_or_create_connection();
+                measurement.phase(instrumentation_phase::build);
                 auto &impl = this->get_impl<O>();
                 std::shared_ptr<O> res;
                 std::stringstream ss;
@@ -1971,8 +2938,10 @@ namespace sqlite_orm {
                     }
                     auto query = ss.str();
                     sqlite3_stmt *stmt;
+                    measurement.phase(instrumentation_phase::prepare);
                     if (sqlite3_prepare_v2(connection->get_db(), query.c_str(), -1, &stmt, nullptr) == SQLITE_OK) {
                         statement_finalizer finalizer{stmt};
+                        measurement.phase(instrumentation_phase::bind);
                         auto index = 1;
                         auto idsTuple = std::make_tuple(std::forward<Ids>(ids)...);
                         constexpr const auto idsCount = std::tuple_size<decltype(idsTuple)>::value;
@@ -1980,9 +2949,11 @@ namespace sqlite_orm {
                             using field_type = typename std::decay<decltype(v)>::type;
                             statement_binder<field_type>().bind(stmt, index++, v);
                         });
+                        measurement.phase(instrumentation_phase::step);
                         auto stepRes = sqlite3_step(stmt);
                         switch(stepRes){
                             case SQLITE_ROW:{
+                                measurement.phase(instrumentation_phase::hydrate);
                                 O res;
                                 index = 0;
                                 impl.table.for_each_column([&index, &res, stmt] (auto c) {
@@ -2018,6 +2989,7 @@ namespace sqlite_orm {
             template<class O, class ...Ids>
             std::shared_ptr<O> get_no_throw(Ids ...ids) {
                 this->assert_mapped_type<O>();
+                internal::operation_scope operationScope("get_no_throw", &this->get_impl<O>().table.name);
                 
                 auto connection = this->get_or_create_connection();
                 auto &impl = this->get_impl<O>();
@@ -2085,6 +3057,238 @@ namespace sqlite_orm {
                 }
             }
             
+            /**
+             *  Fetches many objects by primary key in a few statements instead of calling `get` per id.
+             *  Ids are deduplicated and bound in `WHERE pk IN (?, ?, ...)` chunks so every statement has no more
+             *  variables than `SQLITE_LIMIT_VARIABLE_NUMBER`. Composite primary key ids are `std::tuple` with values
+             *  in `primary_key()` columns order. It must be a forward iterator cause ids are read twice.
+             *  O is an object type to be extracted. Must be specified explicitly.
+             *  throws std::system_error(orm_error_code::table_has_no_primary_key_column) if table has no primary key.
+             *  @return objects in ids order. Ids which are not found are skipped, repeated ids give repeated objects.
+             */
+            template<class O, class It>
+            std::vector<O> get_all_by_ids(It from, It to) {
+                auto objects = this->get_map_internal<O>(from, to, "get_all_by_ids");
+                std::vector<O> res;
+                res.reserve(objects.size());
+                for(auto it = from; it != to; ++it) {
+                    auto objectIt = objects.find(*it);
+                    if(objectIt != objects.end()) {
+                        res.push_back(objectIt->second);
+                    }
+                }
+                return res;
+            }
+            
+            /**
+             *  The same as `get_all_by_ids` but returns objects mapped by their ids. Ids which are not found
+             *  are absent in result.
+             */
+            template<class O, class C>
+            std::map<typename C::value_type, O> get_map(const C &ids) {
+                return this->get_map_internal<O>(ids.begin(), ids.end(), "get_map");
+            }
+            
+            /**
+             *  Keyset (seek) pagination. Returns up to `pageSize` objects ordered by `orderBy` which can be
+             *  `order_by(...)` or `multi_order_by(...)` and the token of the next page. Pages after the first one
+             *  are fetched with bound `WHERE (a, b) > (?, ?)` predicates built from the token instead of
+             *  `OFFSET` so deep pages cost as much as the first one if there is an index on sort keys.
+             *  Sort keys must identify a row uniquely (add a primary key as the last key) and must not be NULL.
+             *  @param token empty string for the first page or `next_token` of the previous page.
+             *  throws std::system_error with orm_error_code::incorrect_page_token if token is corrupted or was
+             *  made for a different keys count.
+             */
+            template<class O, class Ord>
+            page<O> paginate(const Ord &orderBy, int pageSize, const std::string &token = {}) {
+                return this->paginate_internal<O>(orderBy, pageSize, token, [](internal::query_context &){
+                    return std::string();
+                });
+            }
+            
+            /**
+             *  The same as `paginate` but with objects filtered by `w` condition.
+             */
+            template<class O, class Ord, class C>
+            page<O> paginate(const Ord &orderBy, int pageSize, const std::string &token, const conditions::where_t<C> &w) {
+                return this->paginate_internal<O>(orderBy, pageSize, token, [this, &w](internal::query_context &context){
+                    return this->process_where(context, w.c);
+                });
+            }
+            
+        protected:
+            
+            template<class T>
+            void paginate_keys(internal::query_context &context, const conditions::order_by_t<T> &orderBy, std::vector<std::string> &keyExpressions, std::vector<std::string> &orderExpressions, std::vector<bool> &descending) {
+                auto keyExpression = this->string_from_expression(context, orderBy.o);
+                if(orderBy._collate_argument.length()){
+                    keyExpression += " COLLATE " + orderBy._collate_argument;
+                }
+                keyExpressions.push_back(std::move(keyExpression));
+                orderExpressions.push_back(this->process_order_by(context, orderBy));
+                descending.push_back(orderBy.asc_desc == -1);
+            }
+            
+            template<class ...Args>
+            void paginate_keys(internal::query_context &context, const conditions::multi_order_by_t<Args...> &orderBy, std::vector<std::string> &keyExpressions, std::vector<std::string> &orderExpressions, std::vector<bool> &descending) {
+                tuple_helper::tuple_for_each(orderBy.args, [&context, &keyExpressions, &orderExpressions, &descending, this](auto &v){
+                    this->paginate_keys(context, v, keyExpressions, orderExpressions, descending);
+                });
+            }
+            
+            /**
+             *  Seek predicate selecting rows after the last row of the previous page: `(a, b) > (?, ?)` if all keys
+             *  have the same direction and `a > ? OR (a = ? AND b < ?)` otherwise.
+             *  @param boundKeys indexes of keys in order their values must be bound.
+             */
+            std::string paginate_seek_predicate(const std::vector<std::string> &keyExpressions, const std::vector<bool> &descending, std::vector<size_t> &boundKeys) {
+                std::stringstream ss;
+                auto keysCount = keyExpressions.size();
+                auto sameDirection = std::find(descending.begin(), descending.end(), !descending.front()) == descending.end();
+#if SQLITE_VERSION_NUMBER < 3015000
+                
+                //  row values are not supported
+                sameDirection = sameDirection && keysCount == 1;
+#endif
+                if(sameDirection) {
+                    auto op = descending.front() ? " < " : " > ";
+                    if(keysCount == 1) {
+                        ss << keyExpressions.front() << op << "?";
+                    }else{
+                        ss << "(";
+                        for(size_t i = 0; i < keysCount; ++i) {
+                            ss << keyExpressions[i] << (i < keysCount - 1 ? ", " : ")");
+                        }
+                        ss << op << "(";
+                        for(size_t i = 0; i < keysCount; ++i) {
+                            ss << (i < keysCount - 1 ? "?, " : "?)");
+                        }
+                    }
+                    for(size_t i = 0; i < keysCount; ++i) {
+                        boundKeys.push_back(i);
+                    }
+                }else{
+                    for(size_t i = 0; i < keysCount; ++i) {
+                        ss << (i ? " OR (" : "(");
+                        for(size_t j = 0; j < i; ++j) {
+                            ss << keyExpressions[j] << " = ? AND ";
+                            boundKeys.push_back(j);
+                        }
+                        ss << keyExpressions[i] << (descending[i] ? " < ?)" : " > ?)");
+                        boundKeys.push_back(i);
+                    }
+                }
+                return ss.str();
+            }
+            
+            template<class O, class Ord, class W>
+            page<O> paginate_internal(const Ord &orderBy, int pageSize, const std::string &token, const W &whereString) {
+                this->assert_mapped_type<O>();
+                auto &impl = this->get_impl<O>();
+                internal::operation_scope operationScope("paginate", &impl.table.name);
+                measurement_type measurement(this->instrumentationPolicy, "paginate");
+                page<O> res;
+                if(pageSize <= 0) {
+                    return res;
+                }
+                
+                measurement.phase(instrumentation_phase::connect);
+                auto connection = this->get_or_create_connection();
+                auto db = connection->get_db();
+                measurement.phase(instrumentation_phase::build);
+                internal::query_context context{connection};
+                std::vector<std::string> keyExpressions;
+                std::vector<std::string> orderExpressions;
+                std::vector<bool> descending;
+                this->paginate_keys(context, orderBy, keyExpressions, orderExpressions, descending);
+                auto keysCount = keyExpressions.size();
+                std::vector<internal::page_token::value> lastKeys;
+                if(token.length()) {
+                    lastKeys = internal::page_token::decode(token, keysCount);
+                }
+                std::stringstream ss;
+                ss << "SELECT ";
+                auto columnNames = impl.table.column_names();
+                for(auto &columnName : columnNames) {
+                    ss << "'" << impl.table.name << "'.\"" << columnName << "\", ";
+                }
+                for(size_t i = 0; i < keysCount; ++i) {
+                    ss << keyExpressions[i] << (i < keysCount - 1 ? ", " : " ");
+                }
+                ss << "FROM '" << impl.table.name << "' ";
+                auto condition = whereString(context);
+                std::vector<size_t> boundKeys;
+                if(condition.length() || lastKeys.size()) {
+                    ss << "WHERE ";
+                    if(condition.length()) {
+                        ss << "( " << condition << ") ";
+                        if(lastKeys.size()) {
+                            ss << "AND ";
+                        }
+                    }
+                    if(lastKeys.size()) {
+                        ss << "(" << this->paginate_seek_predicate(keyExpressions, descending, boundKeys) << ") ";
+                    }
+                }
+                ss << "ORDER BY ";
+                for(size_t i = 0; i < keysCount; ++i) {
+                    ss << orderExpressions[i] << (i < keysCount - 1 ? ", " : "");
+                }
+                ss << "LIMIT ?";
+                auto query = ss.str();
+                sqlite3_stmt *stmt;
+                measurement.phase(instrumentation_phase::prepare);
+                if (sqlite3_prepare_v2(db, query.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+                    throw std::system_error(std::error_code(sqlite3_errcode(db), get_sqlite_error_category()));
+                }
+                statement_finalizer finalizer{stmt};
+                measurement.phase(instrumentation_phase::bind);
+                auto index = 1;
+                for(auto key : boundKeys) {
+                    internal::page_token::bind(stmt, index++, lastKeys[key]);
+                }
+                
+                //  one more row tells whether there is a next page
+                sqlite3_bind_int(stmt, index++, pageSize + 1);
+                res.objects.reserve(static_cast<size_t>(pageSize));
+                std::string lastToken;
+                int stepRes;
+                for(;;) {
+                    measurement.phase(instrumentation_phase::step);
+                    stepRes = sqlite3_step(stmt);
+                    if(stepRes != SQLITE_ROW) {
+                        break;
+                    }
+                    if(res.objects.size() == static_cast<size_t>(pageSize)) {
+                        res.next_token = std::move(lastToken);
+                        stepRes = SQLITE_DONE;
+                        break;
+                    }
+                    measurement.phase(instrumentation_phase::hydrate);
+                    O object;
+                    index = 0;
+                    impl.table.for_each_column([&index, &object, stmt] (auto c) {
+                        using field_type = typename decltype(c)::field_type;
+                        auto value = row_extractor<field_type>().extract(stmt, index++);
+                        if(c.member_pointer){
+                            object.*c.member_pointer = value;
+                        }else{
+                            ((object).*(c.setter))(std::move(value));
+                        }
+                    });
+                    res.objects.push_back(std::move(object));
+                    if(res.objects.size() == static_cast<size_t>(pageSize)) {
+                        lastToken = internal::page_token::encode(stmt, static_cast<int>(columnNames.size()), static_cast<int>(keysCount));
+                    }
+                }
+                if(stepRes != SQLITE_DONE) {
+                    throw std::system_error(std::error_code(sqlite3_errcode(db), get_sqlite_error_category()));
+                }
+                return res;
+            }
+            
+        public:
+            
             /**
              *  SELECT COUNT(*) with no conditions routine. https://www.sqlite.org/lang_aggfunc.html#count
              *  @return Number of O object in table.
@@ -2092,9 +3296,11 @@ namespace sqlite_orm {
             template<class O, class ...Args, class R = typename mapped_type_proxy<O>::type>
             int count(Args&& ...args) {
                 this->assert_mapped_type<R>();
+                internal::operation_scope operationScope("count", &this->get_impl<R>().table.name);
                 auto tableAliasString = alias_exractor<O>::get();
                 
                 auto connection = this->get_or_create_connection();
+                internal::query_context context{connection};
                 auto &impl = this->get_impl<R>();
                 int res = 0;
                 std::stringstream ss;
@@ -2102,8 +3308,9 @@ namespace sqlite_orm {
                 if(tableAliasString.length()) {
                     ss << "'" << tableAliasString << "' ";
                 }
-                this->process_conditions(ss, args...);
+                this->process_conditions(context, ss, args...);
                 auto query = ss.str();
+                this->assert_no_large_table_scan(connection->get_db(), query);
                 auto rc = sqlite3_exec(connection->get_db(),
                                        query.c_str(),
                                        [](void *data, int argc, char **argv, char **) -> int {
@@ -2126,16 +3333,18 @@ namespace sqlite_orm {
             template<class F, class O, class ...Args>
             int count(F O::*m, Args&& ...args) {
                 this->assert_mapped_type<O>();
+                internal::operation_scope operationScope("count", &this->get_impl<O>().table.name);
                 
                 auto connection = this->get_or_create_connection();
+                internal::query_context context{connection};
                 auto &impl = this->get_impl<O>();
                 int res = 0;
                 std::stringstream ss;
                 ss << "SELECT " << static_cast<std::string>(sqlite_orm::count(0)) << "(";
-                auto columnName = this->string_from_expression(m);
+                auto columnName = this->string_from_expression(context, m);
                 if(columnName.length()){
                     ss << columnName << ") FROM '"<< impl.table.name << "' ";
-                    this->process_conditions(ss, std::forward<Args>(args)...);
+                    this->process_conditions(context, ss, std::forward<Args>(args)...);
                     auto query = ss.str();
                     auto rc = sqlite3_exec(connection->get_db(),
                                            query.c_str(),
@@ -2163,16 +3372,18 @@ namespace sqlite_orm {
             template<class F, class O, class ...Args>
             double avg(F O::*m, Args&& ...args) {
                 this->assert_mapped_type<O>();
+                internal::operation_scope operationScope("avg", &this->get_impl<O>().table.name);
                 
                 auto connection = this->get_or_create_connection();
+                internal::query_context context{connection};
                 auto &impl = this->get_impl<O>();
                 double res = 0;
                 std::stringstream ss;
                 ss << "SELECT " << static_cast<std::string>(sqlite_orm::avg(0)) << "(";
-                auto columnName = this->string_from_expression(m);
+                auto columnName = this->string_from_expression(context, m);
                 if(columnName.length()){
                     ss << columnName << ") FROM '"<< impl.table.name << "' ";
-                    this->process_conditions(ss, std::forward<Args>(args)...);
+                    this->process_conditions(context, ss, std::forward<Args>(args)...);
                     auto query = ss.str();
                     auto rc = sqlite3_exec(connection->get_db(),
                                            query.c_str(),
@@ -2233,16 +3444,18 @@ namespace sqlite_orm {
             template<class F, class O, class ...Args, class Ret = typename column_result_t<F O::*>::type>
             std::shared_ptr<Ret> max(F O::*m, Args&& ...args) {
                 this->assert_mapped_type<O>();
+                internal::operation_scope operationScope("max", &this->get_impl<O>().table.name);
                 
                 auto connection = this->get_or_create_connection();
+                internal::query_context context{connection};
                 auto &impl = this->get_impl<O>();
                 std::shared_ptr<Ret> res;
                 std::stringstream ss;
                 ss << "SELECT " << static_cast<std::string>(sqlite_orm::max(0)) << "(";
-                auto columnName = this->string_from_expression(m);
+                auto columnName = this->string_from_expression(context, m);
                 if(columnName.length()){
                     ss << columnName << ") FROM '" << impl.table.name << "' ";
-                    this->process_conditions(ss, std::forward<Args>(args)...);
+                    this->process_conditions(context, ss, std::forward<Args>(args)...);
                     auto query = ss.str();
                     auto rc = sqlite3_exec(connection->get_db(),
                                            query.c_str(),
@@ -2272,16 +3485,18 @@ namespace sqlite_orm {
             template<class F, class O, class ...Args, class Ret = typename column_result_t<F O::*>::type>
             std::shared_ptr<Ret> min(F O::*m, Args&& ...args) {
                 this->assert_mapped_type<O>();
+                internal::operation_scope operationScope("min", &this->get_impl<O>().table.name);
                 
                 auto connection = this->get_or_create_connection();
+                internal::query_context context{connection};
                 auto &impl = this->get_impl<O>();
                 std::shared_ptr<Ret> res;
                 std::stringstream ss;
                 ss << "SELECT " << static_cast<std::string>(sqlite_orm::min(0)) << "(";
-                auto columnName = this->string_from_expression(m);
+                auto columnName = this->string_from_expression(context, m);
                 if(columnName.length()){
                     ss << columnName << ") FROM '" << impl.table.name << "' ";
-                    this->process_conditions(ss, std::forward<Args>(args)...);
+                    this->process_conditions(context, ss, std::forward<Args>(args)...);
                     auto query = ss.str();
                     auto rc = sqlite3_exec(connection->get_db(),
                                            query.c_str(),
@@ -2311,16 +3526,18 @@ namespace sqlite_orm {
             template<class F, class O, class ...Args, class Ret = typename column_result_t<F O::*>::type>
             std::shared_ptr<Ret> sum(F O::*m, Args&& ...args) {
                 this->assert_mapped_type<O>();
+                internal::operation_scope operationScope("sum", &this->get_impl<O>().table.name);
                 
                 auto connection = this->get_or_create_connection();
+                internal::query_context context{connection};
                 auto &impl = this->get_impl<O>();
                 std::shared_ptr<Ret> res;
                 std::stringstream ss;
                 ss << "SELECT " << static_cast<std::string>(sqlite_orm::sum(0)) << "(";
-                auto columnName = this->string_from_expression(m);
+                auto columnName = this->string_from_expression(context, m);
                 if(columnName.length()){
                     ss << columnName << ") FROM '"<< impl.table.name << "' ";
-                    this->process_conditions(ss, std::forward<Args>(args)...);
+                    this->process_conditions(context, ss, std::forward<Args>(args)...);
                     auto query = ss.str();
                     auto rc = sqlite3_exec(connection->get_db(),
                                            query.c_str(),
@@ -2348,12 +3565,14 @@ namespace sqlite_orm {
             template<class F, class O, class ...Args>
             double total(F O::*m, Args&& ...args) {
                 this->assert_mapped_type<O>();
+                internal::operation_scope operationScope("total", &this->get_impl<O>().table.name);
                 
                 auto connection = this->get_or_create_connection();
+                internal::query_context context{connection};
                 double res;
                 std::stringstream ss;
                 ss << "SELECT " << static_cast<std::string>(sqlite_orm::total(0)) << "(";
-                auto columnName = this->string_from_expression(m);
+                auto columnName = this->string_from_expression(context, m);
                 if(columnName.length()){
                     ss << columnName << ") ";
                     auto tableNamesSet = this->parse_table_names(m);
@@ -2368,7 +3587,7 @@ namespace sqlite_orm {
                             ss << " ";
                         }
                     }
-                    this->process_conditions(ss, std::forward<Args>(args)...);
+                    this->process_conditions(context, ss, std::forward<Args>(args)...);
                     auto query = ss.str();
                     auto rc = sqlite3_exec(connection->get_db(),
                                            query.c_str(),
@@ -2398,18 +3617,27 @@ namespace sqlite_orm {
             class ...Args,
             class R = typename internal::column_result_t<T>::type>
             std::vector<R> select(T m, Args ...args) {
+                internal::operation_scope operationScope("select");
+                measurement_type measurement(this->instrumentationPolicy, "select");
                 using select_type = select_t<T, Args...>;
-                auto query = this->string_from_expression(select_type{std::move(m), std::make_tuple<Args...>(std::forward<Args>(args)...)});
+                measurement.phase(instrumentation_phase::connect);
                 auto connection = this->get_or_create_connection();
+                internal::query_context context{connection};
+                measurement.phase(instrumentation_phase::build);
+                auto query = this->string_from_expression(context, select_type{std::move(m), std::make_tuple<Args...>(std::forward<Args>(args)...)});
+                this->assert_no_large_table_scan(connection->get_db(), query);
                 sqlite3_stmt *stmt;
+                measurement.phase(instrumentation_phase::prepare);
                 if (sqlite3_prepare_v2(connection->get_db(), query.c_str(), -1, &stmt, nullptr) == SQLITE_OK) {
                     statement_finalizer finalizer{stmt};
                     std::vector<R> res;
                     int stepRes;
                     do{
+                        measurement.phase(instrumentation_phase::step);
                         stepRes = sqlite3_step(stmt);
                         switch(stepRes){
                             case SQLITE_ROW:{
+                                measurement.phase(instrumentation_phase::hydrate);
                                 res.push_back(row_extractor<R>().extract(stmt, 0));
                             }break;
                             case SQLITE_DONE: break;
@@ -2430,12 +3658,14 @@ namespace sqlite_orm {
             class ...Args,
             class Ret = typename internal::column_result_t<union_t<L, R>>::type>
             std::vector<Ret> select(union_t<L, R> op, Args ...args) {
+                internal::operation_scope operationScope("select");
+                auto connection = this->get_or_create_connection();
+                internal::query_context context{connection};
                 std::stringstream ss;
-                ss << this->string_from_expression(op.left) << " ";
+                ss << this->string_from_expression(context, op.left) << " ";
                 ss << static_cast<std::string>(op) << " ";
-                ss << this->string_from_expression(op.right) << " ";
+                ss << this->string_from_expression(context, op.right) << " ";
                 auto query = ss.str();
-                auto connection = this->get_or_create_connection();
                 sqlite3_stmt *stmt;
                 if (sqlite3_prepare_v2(connection->get_db(), query.c_str(), -1, &stmt, nullptr) == SQLITE_OK) {
                     statement_finalizer finalizer{stmt};
@@ -2478,6 +3708,7 @@ namespace sqlite_orm {
             template<class O>
             void replace(const O &o) {
                 this->assert_mapped_type<O>();
+                internal::operation_scope operationScope("replace", &this->get_impl<O>().table.name);
                 
                 auto connection = this->get_or_create_connection();
                 auto &impl = get_impl<O>();
@@ -2531,6 +3762,7 @@ namespace sqlite_orm {
             void replace_range(It from, It to) {
                 using O = typename std::iterator_traits<It>::value_type;
                 this->assert_mapped_type<O>();
+                internal::operation_scope operationScope("replace_range", &this->get_impl<O>().table.name);
                 if(from == to) {
                     return;
                 }
@@ -2538,7 +3770,166 @@ namespace sqlite_orm {
                 auto connection = this->get_or_create_connection();
                 auto &impl = get_impl<O>();
                 std::stringstream ss;
-                ss << "REPLACE INTO '" << impl.table.name << "' (";
+                ss << "REPLACE INTO '" << impl.table.name << "' (";
+                auto columnNames = impl.table.column_names();
+                auto columnNamesCount = columnNames.size();
+                for(size_t i = 0; i < columnNamesCount; ++i) {
+                    ss << "\"" << columnNames[i] << "\"";
+                    if(i < columnNamesCount - 1) {
+                        ss << ", ";
+                    }else{
+                        ss << ") ";
+                    }
+                }
+                ss << "VALUES ";
+                auto valuesString = [columnNamesCount]{
+                    std::stringstream ss;
+                    ss << "(";
+                    for(size_t i = 0; i < columnNamesCount; ++i) {
+                        ss << "?";
+                        if(i < columnNamesCount - 1) {
+                            ss << ", ";
+                        }else{
+                            ss << ")";
+                        }
+                    }
+                    return ss.str();
+                }();
+                auto valuesCount = static_cast<int>(std::distance(from, to));
+                for(auto i = 0; i < valuesCount; ++i) {
+                    ss << valuesString;
+                    if(i < valuesCount - 1) {
+                        ss << ",";
+                    }
+                    ss << " ";
+                }
+                auto query = ss.str();
+                sqlite3_stmt *stmt;
+                if (sqlite3_prepare_v2(connection->get_db(), query.c_str(), -1, &stmt, nullptr) == SQLITE_OK) {
+                    statement_finalizer finalizer{stmt};
+                    auto index = 1;
+                    for(auto it = from; it != to; ++it) {
+                        auto &o = *it;
+                        impl.table.for_each_column([&o, &index, &stmt] (auto c) {
+                            using field_type = typename decltype(c)::field_type;
+                            const field_type *value = nullptr;
+                            if(c.member_pointer){
+                                value = &(o.*c.member_pointer);
+                            }else{
+                                value = &((o).*(c.getter))();
+                            }
+                            statement_binder<field_type>().bind(stmt, index++, *value);
+                        });
+                    }
+                    if (sqlite3_step(stmt) == SQLITE_DONE) {
+                        //..
+                    }else{
+                        throw std::system_error(std::error_code(sqlite3_errcode(connection->get_db()), get_sqlite_error_category()));
+                    }
+                }else {
+                    throw std::system_error(std::error_code(sqlite3_errcode(connection->get_db()), get_sqlite_error_category()));
+                }
+            }
+            
+#if SQLITE_VERSION_NUMBER >= 3024000
+            
+            /**
+             *  UPSERT routine. Inserts object with all fields like `replace` does but if a row with the same
+             *  primary key exists it is updated in place: `INSERT ... ON CONFLICT("pk") DO UPDATE SET ...`.
+             *  Unlike `REPLACE` the row is not deleted and reinserted so delete triggers are not fired, rowid is
+             *  kept and only changed index entries are rewritten. Rows which all fields are equal to the object
+             *  are not written at all.
+             */
+            template<class O>
+            void upsert(const O &o) {
+                this->assert_mapped_type<O>();
+                auto &impl = this->get_impl<O>();
+                this->upsert_internal("upsert", &o, &o + 1, this->upsert_conflict_column_names(impl), this->upsert_update_column_names(impl));
+            }
+            
+            /**
+             *  UPSERT routine with explicit conflict target and updated columns e.g.
+             *  `storage.upsert(user, columns(&User::email), columns(&User::name, &User::visits))`.
+             *  Conflict columns must have a unique index or constraint. Columns not listed in `updateColumns`
+             *  keep their values if the row exists.
+             */
+            template<class O, class ...Cs, class ...Us>
+            void upsert(const O &o, const columns_t<Cs...> &conflictColumns, const columns_t<Us...> &updateColumns) {
+                this->assert_mapped_type<O>();
+                this->upsert_internal("upsert", &o, &o + 1, this->upsert_column_names(conflictColumns), this->upsert_column_names(updateColumns));
+            }
+            
+            /**
+             *  Performs `upsert` for every object of [from, to). Objects are written with multi row
+             *  `INSERT ... VALUES (...), (...) ON CONFLICT ...` statements split by
+             *  `SQLITE_LIMIT_VARIABLE_NUMBER` in one transaction: the current one if it is active or a new one
+             *  otherwise. Statements are cached by connection.
+             */
+            template<class It>
+            void upsert_range(It from, It to) {
+                using O = typename std::iterator_traits<It>::value_type;
+                this->assert_mapped_type<O>();
+                auto &impl = this->get_impl<O>();
+                this->upsert_internal("upsert_range", from, to, this->upsert_conflict_column_names(impl), this->upsert_update_column_names(impl));
+            }
+            
+            template<class It, class ...Cs, class ...Us>
+            void upsert_range(It from, It to, const columns_t<Cs...> &conflictColumns, const columns_t<Us...> &updateColumns) {
+                using O = typename std::iterator_traits<It>::value_type;
+                this->assert_mapped_type<O>();
+                this->upsert_internal("upsert_range", from, to, this->upsert_column_names(conflictColumns), this->upsert_column_names(updateColumns));
+            }
+            
+        protected:
+            
+            template<class I>
+            std::vector<std::string> upsert_conflict_column_names(I &impl) {
+                auto res = impl.table.primary_key_column_names();
+                if(res.empty()) {
+                    throw std::system_error(std::make_error_code(orm_error_code::table_has_no_primary_key_column));
+                }
+                for(auto &columnName : res) {
+                    columnName = "\"" + columnName + "\"";
+                }
+                return res;
+            }
+            
+            template<class I>
+            std::vector<std::string> upsert_update_column_names(I &impl) {
+                auto primaryKeyColumnNames = impl.table.primary_key_column_names();
+                std::vector<std::string> res;
+                for(auto &columnName : impl.table.column_names()) {
+                    if(std::find(primaryKeyColumnNames.begin(), primaryKeyColumnNames.end(), columnName) == primaryKeyColumnNames.end()) {
+                        res.push_back("\"" + columnName + "\"");
+                    }
+                }
+                return res;
+            }
+            
+            template<class ...Cs>
+            std::vector<std::string> upsert_column_names(const columns_t<Cs...> &cols) {
+                std::vector<std::string> res;
+                internal::query_context context{nullptr};
+                cols.for_each([&context, &res, this](auto &m) {
+                    auto columnName = this->string_from_expression(context, m, true);
+                    if(columnName.length()){
+                        res.push_back(columnName);
+                    }else{
+                        throw std::system_error(std::make_error_code(orm_error_code::column_not_found));
+                    }
+                });
+                return res;
+            }
+            
+            /**
+             *  `INSERT INTO 'table' (...) VALUES (...), ... ON CONFLICT (...) DO UPDATE SET "c" = excluded."c", ...
+             *  WHERE "c" IS NOT excluded."c" OR ...` with `rowsCount` rows. `WHERE` skips rows which are not
+             *  changed. Column names must be quoted already.
+             */
+            template<class I>
+            std::string upsert_query(I &impl, size_t rowsCount, const std::vector<std::string> &conflictColumnNames, const std::vector<std::string> &updateColumnNames) {
+                std::stringstream ss;
+                ss << "INSERT INTO '" << impl.table.name << "' (";
                 auto columnNames = impl.table.column_names();
                 auto columnNamesCount = columnNames.size();
                 for(size_t i = 0; i < columnNamesCount; ++i) {
@@ -2550,68 +3941,148 @@ namespace sqlite_orm {
                     }
                 }
                 ss << "VALUES ";
-                auto valuesString = [columnNamesCount]{
-                    std::stringstream ss;
+                for(size_t row = 0; row < rowsCount; ++row) {
                     ss << "(";
                     for(size_t i = 0; i < columnNamesCount; ++i) {
                         ss << "?";
                         if(i < columnNamesCount - 1) {
                             ss << ", ";
-                        }else{
-                            ss << ")";
                         }
                     }
-                    return ss.str();
-                }();
-                auto valuesCount = static_cast<int>(std::distance(from, to));
-                for(auto i = 0; i < valuesCount; ++i) {
-                    ss << valuesString;
-                    if(i < valuesCount - 1) {
-                        ss << ",";
+                    ss << ")";
+                    if(row < rowsCount - 1) {
+                        ss << ", ";
                     }
-                    ss << " ";
                 }
-                auto query = ss.str();
-                sqlite3_stmt *stmt;
-                if (sqlite3_prepare_v2(connection->get_db(), query.c_str(), -1, &stmt, nullptr) == SQLITE_OK) {
-                    statement_finalizer finalizer{stmt};
-                    auto index = 1;
-                    for(auto it = from; it != to; ++it) {
-                        auto &o = *it;
-                        impl.table.for_each_column([&o, &index, &stmt] (auto c) {
-                            using field_type = typename decltype(c)::field_type;
-                            const field_type *value = nullptr;
-                            if(c.member_pointer){
-                                value = &(o.*c.member_pointer);
-                            }else{
-                                value = &((o).*(c.getter))();
+                ss << " ON CONFLICT (";
+                for(size_t i = 0; i < conflictColumnNames.size(); ++i) {
+                    ss << conflictColumnNames[i];
+                    if(i < conflictColumnNames.size() - 1) {
+                        ss << ", ";
+                    }
+                }
+                ss << ") DO ";
+                if(updateColumnNames.empty()) {
+                    ss << "NOTHING";
+                }else{
+                    ss << "UPDATE SET ";
+                    for(size_t i = 0; i < updateColumnNames.size(); ++i) {
+                        ss << updateColumnNames[i] << " = excluded." << updateColumnNames[i];
+                        if(i < updateColumnNames.size() - 1) {
+                            ss << ", ";
+                        }
+                    }
+                    ss << " WHERE ";
+                    for(size_t i = 0; i < updateColumnNames.size(); ++i) {
+                        ss << updateColumnNames[i] << " IS NOT excluded." << updateColumnNames[i];
+                        if(i < updateColumnNames.size() - 1) {
+                            ss << " OR ";
+                        }
+                    }
+                }
+                return ss.str();
+            }
+            
+            template<class It>
+            void upsert_internal(const char *operation, It from, It to, const std::vector<std::string> &conflictColumnNames, const std::vector<std::string> &updateColumnNames) {
+                using O = typename std::iterator_traits<It>::value_type;
+                auto &impl = this->get_impl<O>();
+                internal::operation_scope operationScope(operation, &impl.table.name);
+                measurement_type measurement(this->instrumentationPolicy, operation);
+                if(from == to) {
+                    return;
+                }
+                
+                measurement.phase(instrumentation_phase::connect);
+                auto connection = this->get_or_create_connection();
+                auto db = connection->get_db();
+                measurement.phase(instrumentation_phase::build);
+                auto columnsCount = impl.table.column_names().size();
+                auto rowsPerStatement = std::max(size_t(1), size_t(sqlite3_limit(db, SQLITE_LIMIT_VARIABLE_NUMBER, -1)) / columnsCount);
+                std::string fullQuery;
+                measurement.phase(instrumentation_phase::step);
+                auto ownTransaction = sqlite3_get_autocommit(db) != 0;
+                if(ownTransaction) {
+                    this->impl.begin_transaction(db);
+                }
+                try{
+                    while(from != to) {
+                        auto chunkEnd = from;
+                        size_t rowsCount = 0;
+                        while(chunkEnd != to && rowsCount < rowsPerStatement) {
+                            ++chunkEnd;
+                            ++rowsCount;
+                        }
+                        sqlite3_stmt *stmt;
+                        sqlite3_stmt *tailStmt = nullptr;
+                        if(rowsCount == rowsPerStatement) {
+                            if(fullQuery.empty()) {
+                                fullQuery = this->upsert_query(impl, rowsCount, conflictColumnNames, updateColumnNames);
                             }
-                            statement_binder<field_type>().bind(stmt, index++, *value);
-                        });
+                            stmt = connection->get_statement(fullQuery);
+                        }else if(rowsCount == 1) {
+                            
+                            //  single object upserts are frequent so their statement is cached too
+                            stmt = connection->get_statement(this->upsert_query(impl, rowsCount, conflictColumnNames, updateColumnNames));
+                        }else{
+                            
+                            //  tail length differs from call to call so the statement is not cached
+                            auto query = this->upsert_query(impl, rowsCount, conflictColumnNames, updateColumnNames);
+                            if(sqlite3_prepare_v2(db, query.c_str(), -1, &tailStmt, nullptr) != SQLITE_OK) {
+                                throw std::system_error(std::error_code(sqlite3_errcode(db), get_sqlite_error_category()));
+                            }
+                            stmt = tailStmt;
+                        }
+                        statement_finalizer finalizer{tailStmt};
+                        statement_resetter resetter{stmt};
+                        auto index = 1;
+                        for(; from != chunkEnd; ++from) {
+                            auto &o = *from;
+                            impl.table.for_each_column([&o, &index, stmt] (auto c) {
+                                using field_type = typename decltype(c)::field_type;
+                                const field_type *value = nullptr;
+                                if(c.member_pointer){
+                                    value = &(o.*c.member_pointer);
+                                }else{
+                                    value = &((o).*(c.getter))();
+                                }
+                                statement_binder<field_type>().bind(stmt, index++, *value);
+                            });
+                        }
+                        if (sqlite3_step(stmt) != SQLITE_DONE) {
+                            throw std::system_error(std::error_code(sqlite3_errcode(db), get_sqlite_error_category()));
+                        }
                     }
-                    if (sqlite3_step(stmt) == SQLITE_DONE) {
-                        //..
-                    }else{
-                        throw std::system_error(std::error_code(sqlite3_errcode(connection->get_db()), get_sqlite_error_category()));
+                }catch(...){
+                    if(ownTransaction) {
+                        this->impl.rollback(db);
                     }
-                }else {
-                    throw std::system_error(std::error_code(sqlite3_errcode(connection->get_db()), get_sqlite_error_category()));
+                    throw;
+                }
+                if(ownTransaction) {
+                    this->impl.commit(db);
                 }
             }
             
+        public:
+            
+#endif
+            
             template<class O, class ...Cols>
             int insert(const O &o, columns_t<Cols...> cols) {
                 constexpr const size_t colsCount = std::tuple_size<std::tuple<Cols...>>::value;
                 static_assert(colsCount > 0, "Use insert or replace with 1 argument instead");
                 this->assert_mapped_type<O>();
+                internal::operation_scope operationScope("insert", &this->get_impl<O>().table.name);
                 auto connection = this->get_or_create_connection();
+                internal::query_context context{connection};
                 auto &impl = get_impl<O>();
                 std::stringstream ss;
                 ss << "INSERT INTO '" << impl.table.name << "' ";
                 std::vector<std::string> columnNames;
                 columnNames.reserve(colsCount);
-                cols.for_each([&columnNames, this](auto &m) {
-                    auto columnName = this->string_from_expression(m, true);
+                cols.for_each([&context, &columnNames, this](auto &m) {
+                    auto columnName = this->string_from_expression(context, m, true);
                     if(columnName.length()){
                         columnNames.push_back(columnName);
                     }else{
@@ -2667,8 +4138,12 @@ namespace sqlite_orm {
             template<class O>
             int insert(const O &o) {
                 this->assert_mapped_type<O>();
+                internal::operation_scope operationScope("insert", &this->get_impl<O>().table.name);
+                measurement_type measurement(this->instrumentationPolicy, "insert");
                 
+                measurement.phase(instrumentation_phase::connect);
                 auto connection = this->get_or_create_connection();
+                measurement.phase(instrumentation_phase::build);
                 auto &impl = get_impl<O>();
                 int res = 0;
                 std::stringstream ss;
@@ -2715,8 +4190,10 @@ namespace sqlite_orm {
                 }
                 auto query = ss.str();
                 sqlite3_stmt *stmt;
+                measurement.phase(instrumentation_phase::prepare);
                 if (sqlite3_prepare_v2(connection->get_db(), query.c_str(), -1, &stmt, nullptr) == SQLITE_OK) {
                     statement_finalizer finalizer{stmt};
+                    measurement.phase(instrumentation_phase::bind);
                     auto index = 1;
                     impl.table.for_each_column([&o, &index, &stmt, &impl, &compositeKeyColumnNames] (auto c) {
                         if(impl.table._without_rowid || !c.template has<constraints::primary_key_t<>>()){
@@ -2735,6 +4212,7 @@ namespace sqlite_orm {
                             }
                         }
                     });
+                    measurement.phase(instrumentation_phase::step);
                     if (sqlite3_step(stmt) == SQLITE_DONE) {
                         res = int(sqlite3_last_insert_rowid(connection->get_db()));
                     }else{
@@ -2750,11 +4228,15 @@ namespace sqlite_orm {
             void insert_range(It from, It to) {
                 using O = typename std::iterator_traits<It>::value_type;
                 this->assert_mapped_type<O>();
+                internal::operation_scope operationScope("insert_range", &this->get_impl<O>().table.name);
+                measurement_type measurement(this->instrumentationPolicy, "insert_range");
                 if(from == to) {
                     return;
                 }
                 
+                measurement.phase(instrumentation_phase::connect);
                 auto connection = this->get_or_create_connection();
+                measurement.phase(instrumentation_phase::build);
                 auto &impl = get_impl<O>();
                 
                 std::stringstream ss;
@@ -2799,8 +4281,10 @@ namespace sqlite_orm {
                 }
                 auto query = ss.str();
                 sqlite3_stmt *stmt;
+                measurement.phase(instrumentation_phase::prepare);
                 if (sqlite3_prepare_v2(connection->get_db(), query.c_str(), -1, &stmt, nullptr) == SQLITE_OK) {
                     statement_finalizer finalizer{stmt};
+                    measurement.phase(instrumentation_phase::bind);
                     auto index = 1;
                     for(auto it = from; it != to; ++it) {
                         auto &o = *it;
@@ -2817,6 +4301,7 @@ namespace sqlite_orm {
                             }
                         });
                     }
+                    measurement.phase(instrumentation_phase::step);
                     if (sqlite3_step(stmt) == SQLITE_DONE) {
                         //..
                     }else{
@@ -2845,6 +4330,25 @@ namespace sqlite_orm {
                 }
             }
             
+            /**
+             *  Rebuilds index with a given name or all indexes of a table with a given name using `REINDEX`.
+             *  Rebuilds all indexes in db if name is empty.
+             */
+            void reindex(const std::string &name = {}) {
+                auto connection = this->get_or_create_connection();
+                auto db = connection->get_db();
+                std::stringstream ss;
+                ss << "REINDEX";
+                if(name.length()){
+                    ss << " '" << name << "'";
+                }
+                auto query = ss.str();
+                auto rc = sqlite3_exec(db, query.c_str(), nullptr, nullptr, nullptr);
+                if(rc != SQLITE_OK) {
+                    throw std::system_error(std::error_code(sqlite3_errcode(db), get_sqlite_error_category()));
+                }
+            }
+            
             void vacuum() {
                 auto connection = this->get_or_create_connection();
                 std::string query = "VACUUM";
@@ -2925,31 +4429,99 @@ namespace sqlite_orm {
             
         protected:
             
+            /**
+             *  Adds an element of `make_index` call to index query parts. Columns and expressions are indexed
+             *  as is, `order_by(...)` specifies COLLATE and ASC/DESC for column and `where(...)` makes index partial.
+             *  Column names are not prefixed with table name cause SQLite prohibits it in index expressions.
+             */
+            template<class T>
+            void process_index_element(internal::query_context &context, const T &t, std::vector<std::string> &columns, std::string &) {
+                columns.push_back(this->string_from_expression(context, t, true));
+            }
+            
+            template<class O>
+            void process_index_element(internal::query_context &context, const conditions::order_by_t<O> &orderBy, std::vector<std::string> &columns, std::string &) {
+                columns.push_back(this->process_order_by(context, orderBy, true));
+            }
+            
+            template<class C>
+            void process_index_element(internal::query_context &context, const conditions::where_t<C> &w, std::vector<std::string> &, std::string &whereString) {
+                whereString = this->process_where(context, w.c);
+            }
+            
+            /**
+             *  Returns `CREATE INDEX IF NOT EXISTS` query for index of impl.
+             *  @param ifNotExists pass false to get the statement the way SQLite stores it in `sqlite_master`.
+             */
             template<class ...Tss, class ...Cols>
-            sync_schema_result sync_table(storage_impl<internal::index_t<Cols...>, Tss...> *impl, sqlite3 *db, bool) {
-                auto res = sync_schema_result::already_in_sync;
+            std::string create_index_query(storage_impl<internal::index_t<Cols...>, Tss...> *impl, bool ifNotExists = true) {
                 std::stringstream ss;
                 ss << "CREATE ";
                 if(impl->table.unique){
                     ss << "UNIQUE ";
                 }
                 using columns_type = typename decltype(impl->table)::columns_type;
-                using head_t = typename std::tuple_element<0, columns_type>::type;
-                using indexed_type = typename internal::table_type<head_t>::type;
-                ss << "INDEX IF NOT EXISTS " << impl->table.name << " ON '" << this->impl.template find_table_name<indexed_type>() << "' ( ";
-                std::vector<std::string> columnNames;
-                tuple_helper::iterator<std::tuple_size<columns_type>::value - 1, Cols...>()(impl->table.columns, [&columnNames, this](auto &v){
-                    columnNames.push_back(this->impl.column_name(v));
-                });
-                for(size_t i = 0; i < columnNames.size(); ++i) {
-                    ss << columnNames[i];
-                    if(i < columnNames.size() - 1) {
+                std::vector<std::string> columns;
+                std::string whereString;
+                std::set<std::string> tableNames;
+                
+                //  partial index cannot refer to other tables so `in` values are written into query text
+                internal::query_context context{nullptr};
+                tuple_helper::iterator<std::tuple_size<columns_type>::value - 1, Cols...>()(impl->table.columns, [&context, &columns, &whereString, &tableNames, this](auto &v){
+                    this->process_index_element(context, v, columns, whereString);
+                    auto elementTableNames = this->parse_table_name(v);
+                    tableNames.insert(elementTableNames.begin(), elementTableNames.end());
+                }, false);
+                if(tableNames.empty()){
+                    throw std::system_error(std::make_error_code(orm_error_code::type_is_not_mapped_to_storage));
+                }else if(tableNames.size() > 1){
+                    throw std::system_error(std::make_error_code(orm_error_code::too_many_tables_specified));
+                }
+                ss << "INDEX ";
+                if(ifNotExists){
+                    ss << "IF NOT EXISTS ";
+                }
+                ss << impl->table.name << " ON '" << *tableNames.begin() << "' ( ";
+                for(size_t i = 0; i < columns.size(); ++i) {
+                    ss << columns[i];
+                    if(i < columns.size() - 1) {
                         ss << ",";
                     }
                     ss << " ";
                 }
                 ss << ") ";
-                auto query = ss.str();
+                if(whereString.length()){
+                    ss << "WHERE ( " << whereString << ") ";
+                }
+                return ss.str();
+            }
+            
+            /**
+             *  Removes excess db columns. Columns are dropped in place if SQLite is able to do it and
+             *  table is copied using `backup_table` otherwise.
+             *  @param columns db columns that do not exist in storage.
+             */
+            template<class I>
+            void remove_columns(database_connection &connection, I *impl, const std::vector<table_info> &columns) {
+                auto db = connection.get_db();
+                for(auto &columnInfo : columns) {
+                    if(!impl->drop_column(columnInfo.name, db)) {
+                        this->backup_table(connection, impl);
+                        return;
+                    }
+                }
+            }
+            
+            template<class ...Tss, class ...Cols>
+            sync_schema_result sync_table(storage_impl<internal::index_t<Cols...>, Tss...> *impl, database_connection &connection, const tables_info &, const indexes_info &indexesInfo, bool) {
+                auto db = connection.get_db();
+                auto res = this->index_status(impl, indexesInfo);
+                if(res == decltype(res)::index_recreated) {
+                    this->drop_index_internal(impl->table.name, db);
+                }
+                
+                //  index is created even if it is in sync cause it might be dropped together with its table during this sync..
+                auto query = this->create_index_query(impl);
                 auto rc = sqlite3_exec(db, query.c_str(), nullptr, nullptr, nullptr);
                 if(rc != SQLITE_OK) {
                     throw std::system_error(std::error_code(sqlite3_errcode(db), get_sqlite_error_category()));
@@ -2957,11 +4529,80 @@ namespace sqlite_orm {
                 return res;
             }
             
+            /**
+             *  Compares index from storage with index stored in db. Statements are compared without whitespaces
+             *  so formatting differences don't cause rebuild.
+             */
+            template<class ...Tss, class ...Cols>
+            sync_schema_result index_status(storage_impl<internal::index_t<Cols...>, Tss...> *impl, const indexes_info &indexesInfo) {
+                auto it = indexesInfo.find(impl->table.name);
+                if(it == indexesInfo.end()) {
+                    return sync_schema_result::new_index_created;
+                }
+                auto withoutWhitespaces = [](const std::string &text) {
+                    std::string res;
+                    std::copy_if(text.begin(), text.end(), std::back_inserter(res), [](char c) {
+                        return !std::isspace(static_cast<unsigned char>(c));
+                    });
+                    return res;
+                };
+                if(withoutWhitespaces(it->second.sql) != withoutWhitespaces(this->create_index_query(impl, false))) {
+                    return sync_schema_result::index_recreated;
+                }
+                return sync_schema_result::already_in_sync;
+            }
+            
+            void drop_index_internal(const std::string &indexName, sqlite3 *db) {
+                std::stringstream ss;
+                ss << "DROP INDEX IF EXISTS '" << indexName + "'";
+                auto query = ss.str();
+                sqlite3_stmt *stmt;
+                if (sqlite3_prepare_v2(db, query.c_str(), -1, &stmt, nullptr) == SQLITE_OK) {
+                    statement_finalizer finalizer{stmt};
+                    if (sqlite3_step(stmt) == SQLITE_DONE) {
+                        //  done..
+                    }else{
+                        throw std::system_error(std::error_code(sqlite3_errcode(db), get_sqlite_error_category()));
+                    }
+                }else {
+                    throw std::system_error(std::error_code(sqlite3_errcode(db), get_sqlite_error_category()));
+                }
+            }
+            
+            template<class ...Tss, class ...Cols>
+            void collect_schema_names(storage_impl<internal::index_t<Cols...>, Tss...> *impl, std::set<std::string> &, std::set<std::string> &indexNames) {
+                indexNames.insert(impl->table.name);
+            }
+            
+            template<class ...Tss, class ...Cs>
+            void collect_schema_names(storage_impl<table_t<Cs...>, Tss...> *impl, std::set<std::string> &tableNames, std::set<std::string> &) {
+                tableNames.insert(impl->table.name);
+            }
+            
+            /**
+             *  Returns names of db indexes created on storage tables which are not specified in `make_storage` call.
+             */
+            std::vector<std::string> excess_indexes(const indexes_info &indexesInfo) {
+                std::set<std::string> tableNames;
+                std::set<std::string> indexNames;
+                this->impl.for_each([&tableNames, &indexNames, this](auto impl){
+                    this->collect_schema_names(impl, tableNames, indexNames);
+                });
+                std::vector<std::string> res;
+                for(auto &p : indexesInfo) {
+                    if(tableNames.count(p.second.table_name) && !indexNames.count(p.first)) {
+                        res.push_back(p.first);
+                    }
+                }
+                return res;
+            }
+            
             template<class ...Tss, class ...Cs>
-            sync_schema_result sync_table(storage_impl<table_t<Cs...>, Tss...> *impl, sqlite3 *db, bool preserve) {
+            sync_schema_result sync_table(storage_impl<table_t<Cs...>, Tss...> *impl, database_connection &connection, const tables_info &tablesInfo, const indexes_info &, bool preserve) {
+                auto db = connection.get_db();
                 auto res = sync_schema_result::already_in_sync;
                 
-                auto schema_stat = impl->schema_status(db, preserve);
+                auto schema_stat = impl->schema_status(tablesInfo, preserve);
                 if(schema_stat != decltype(schema_stat)::already_in_sync) {
                     if(schema_stat == decltype(schema_stat)::new_table_created) {
                         this->create_table(db, impl->table.name, impl);
@@ -2975,8 +4616,8 @@ namespace sqlite_orm {
                             //  get table info provided in `make_table` call..
                             auto storageTableInfo = impl->table.get_table_info();
                             
-                            //  now get current table info from db using `PRAGMA table_info` query..
-                            auto dbTableInfo = impl->get_table_info(impl->table.name, db);
+                            //  now get current table info from db loaded by `get_tables_info`..
+                            auto dbTableInfo = tablesInfo.find(impl->table.name)->second;
                             
                             //  this vector will contain pointers to columns that gotta be added..
                             std::vector<table_info*> columnsToAdd;
@@ -2986,7 +4627,7 @@ namespace sqlite_orm {
                             if(schema_stat == sync_schema_result::old_columns_removed) {
                                 
                                 //  extra table columns than storage columns
-                                this->backup_table(db, impl);
+                                this->remove_columns(connection, impl, dbTableInfo);
                                 res = decltype(res)::old_columns_removed;
                             }
                             
@@ -3000,7 +4641,7 @@ namespace sqlite_orm {
                             if(schema_stat == sync_schema_result::new_columns_added_and_old_columns_removed) {
                                 
                                 //remove extra columns
-                                this->backup_table(db, impl);
+                                this->remove_columns(connection, impl, dbTableInfo);
                                 for(auto columnPointer : columnsToAdd) {
                                     impl->add_column(*columnPointer, db);
                                 }
@@ -3016,6 +4657,77 @@ namespace sqlite_orm {
                 return res;
             }
             
+            template<class ...Tss, class ...Cols>
+            sync_schema_result schema_status(storage_impl<internal::index_t<Cols...>, Tss...> *impl, const tables_info &, const indexes_info &indexesInfo, bool) {
+                return this->index_status(impl, indexesInfo);
+            }
+            
+            template<class ...Tss, class ...Cs>
+            sync_schema_result schema_status(storage_impl<table_t<Cs...>, Tss...> *impl, const tables_info &tablesInfo, const indexes_info &, bool preserve) {
+                return impl->schema_status(tablesInfo, preserve);
+            }
+            
+            template<class ...Tss, class ...Cols>
+            std::string schema_definition(storage_impl<internal::index_t<Cols...>, Tss...> *impl) {
+                return this->create_index_query(impl);
+            }
+            
+            template<class ...Tss, class ...Cs>
+            std::string schema_definition(storage_impl<table_t<Cs...>, Tss...> *impl) {
+                return this->create_table_query(impl->table.name, impl);
+            }
+            
+            /**
+             *  Returns schema fingerprint stored by the last successful `sync_schema` call or empty string
+             *  if there is no one. Fingerprint is stored in `_sqlite_orm` metadata table (table names
+             *  starting with `sqlite_` are reserved by SQLite).
+             */
+            std::string stored_schema_fingerprint(database_connection &connection) {
+                auto db = connection.get_db();
+                if(!this->impl.table_exists("_sqlite_orm", connection)) {
+                    return {};
+                }
+                auto stmt = connection.get_statement("SELECT \"value\" FROM '_sqlite_orm' WHERE \"key\" = 'schema_fingerprint'");
+                statement_resetter resetter{stmt};
+                switch(sqlite3_step(stmt)){
+                    case SQLITE_ROW: return row_extractor<std::string>().extract(stmt, 0);
+                    case SQLITE_DONE: return {};
+                    default:{
+                        throw std::system_error(std::error_code(sqlite3_errcode(db), get_sqlite_error_category()));
+                    }
+                }
+            }
+            
+            void store_schema_fingerprint(database_connection &connection, const std::string &fingerprint) {
+                auto db = connection.get_db();
+                auto rc = sqlite3_exec(db, "CREATE TABLE IF NOT EXISTS '_sqlite_orm' ( 'key' TEXT PRIMARY KEY NOT NULL , 'value' TEXT NOT NULL )", nullptr, nullptr, nullptr);
+                if(rc != SQLITE_OK) {
+                    throw std::system_error(std::error_code(sqlite3_errcode(db), get_sqlite_error_category()));
+                }
+                auto stmt = connection.get_statement("REPLACE INTO '_sqlite_orm' (\"key\", \"value\") VALUES ('schema_fingerprint', ?)");
+                statement_resetter resetter{stmt};
+                statement_binder<std::string>().bind(stmt, 1, fingerprint);
+                if(sqlite3_step(stmt) != SQLITE_DONE) {
+                    throw std::system_error(std::error_code(sqlite3_errcode(db), get_sqlite_error_category()));
+                }
+            }
+            
+            /**
+             *  Fills result with `already_in_sync` for every table and index if schema fingerprint is enabled
+             *  and is equal to the one stored in db.
+             *  @return true if schema is known to be in sync and introspection can be skipped.
+             */
+            bool schema_fingerprint_matches(database_connection &connection, std::map<std::string, sync_schema_result> &result) {
+                if(this->useSchemaFingerprint && this->stored_schema_fingerprint(connection) == this->schema_fingerprint()) {
+                    this->impl.for_each([&result](auto impl){
+                        result.insert({impl->table.name, sync_schema_result::already_in_sync});
+                    });
+                    return true;
+                }else{
+                    return false;
+                }
+            }
+            
         public:
             
             /**
@@ -3028,25 +4740,44 @@ namespace sqlite_orm {
              *          * if there are columns in db that do not exist in storage (excess) table will be dropped and recreated
              *          * if there are columns in storage that do not exist in db they will be added using `ALTER TABLE ... ADD COLUMN ...' command
              *          * if there is any column existing in both db and storage but differs by any of properties/constraints (type, pk, notnull, dflt_value) table will be dropped and recreated
+             *  * every index from storage is compared with it's db analog and it is created if it doesn't exist or dropped and created again if its
+             *      definition differs. Indexes of storage tables that exist in db but not in storage are dropped
              *  Be aware that `sync_schema` doesn't guarantee that data will not be dropped. It guarantees only that it will make db schema the same
              *  as you specified in `make_storage` function call. A good point is that if you have no db file at all it will be created and
              *  all tables also will be created with exact tables and columns you specified in `make_storage`, `make_table` and `make_column` call.
              *  The best practice is to call this function right after storage creation.
              *  @param preserve affects on function behaviour in case it is needed to remove a column. If it is `false` so table will be dropped
-             *  if there is column to remove, if `true` -  table is being copied into another table, dropped and copied table is renamed with source table name.
+             *  if there is column to remove, if `true` -  column is dropped in place with `ALTER TABLE ... DROP COLUMN` if SQLite supports it (3.35.0+)
+             *  and allows it for this column, otherwise table is being copied into another table, dropped and copied table is renamed with source table name.
              *  Warning: sync_schema doesn't check foreign keys cause it is unable to do so in sqlite3. If you know how to get foreign key info
              *  please submit an issue https://github.com/fnc12/sqlite_orm/issues
              *  @return std::map with std::string key equal table name and `sync_schema_result` as value. `sync_schema_result` is a enum value that stores
              *  table state after syncing a schema. `sync_schema_result` can be printed out on std::ostream with `operator<<`.
+             *  If schema fingerprint is enabled (see `enable_schema_fingerprint`) and storage schema has not changed since
+             *  the last successful call introspection is skipped and every table is reported as `already_in_sync`.
              */
             std::map<std::string, sync_schema_result> sync_schema(bool preserve = false) {
+                internal::operation_scope operationScope("sync_schema");
                 auto connection = this->get_or_create_connection();
                 std::map<std::string, sync_schema_result> result;
-                auto db = connection->get_db();
-                this->impl.for_each([&result, db, preserve, this](auto impl){
-                    auto res = this->sync_table(impl, db, preserve);
+                if(this->schema_fingerprint_matches(*connection, result)) {
+                    return result;
+                }
+                auto tablesInfo = this->impl.get_tables_info(*connection);
+                auto indexesInfo = this->impl.get_indexes_info(*connection);
+                
+                //  excess indexes are dropped first so they don't slow down tables migration..
+                for(auto &indexName : this->excess_indexes(indexesInfo)) {
+                    this->drop_index_internal(indexName, connection->get_db());
+                    result.insert({indexName, sync_schema_result::index_dropped});
+                }
+                this->impl.for_each([&result, &connection, &tablesInfo, &indexesInfo, preserve, this](auto impl){
+                    auto res = this->sync_table(impl, *connection, tablesInfo, indexesInfo, preserve);
                     result.insert({impl->table.name, res});
                 });
+                if(this->useSchemaFingerprint) {
+                    this->store_schema_fingerprint(*connection, this->schema_fingerprint());
+                }
                 return result;
             }
             
@@ -3058,14 +4789,66 @@ namespace sqlite_orm {
             std::map<std::string, sync_schema_result> sync_schema_simulate(bool preserve = false) {
                 auto connection = this->get_or_create_connection();
                 std::map<std::string, sync_schema_result> result;
-                auto db = connection->get_db();
-                this->impl.for_each([&result, db, preserve](auto impl){
-                    result.insert({impl->table.name, impl->schema_status(db, preserve)});
+                if(this->schema_fingerprint_matches(*connection, result)) {
+                    return result;
+                }
+                auto tablesInfo = this->impl.get_tables_info(*connection);
+                auto indexesInfo = this->impl.get_indexes_info(*connection);
+                for(auto &indexName : this->excess_indexes(indexesInfo)) {
+                    result.insert({indexName, sync_schema_result::index_dropped});
+                }
+                this->impl.for_each([&result, &tablesInfo, &indexesInfo, preserve, this](auto impl){
+                    result.insert({impl->table.name, this->schema_status(impl, tablesInfo, indexesInfo, preserve)});
                 });
                 return result;
             }
             
+            /**
+             *  Returns stable hash of storage schema: tables, columns, types, constraints and indexes
+             *  specified in `make_storage` call. It is a 16 hex digits string (64-bit FNV-1a of schema
+             *  definition) which doesn't depend on platform or process.
+             */
+            std::string schema_fingerprint() {
+                uint64 hash = 14695981039346656037ULL;
+                this->impl.for_each([&hash, this](auto impl){
+                    auto definition = this->schema_definition(impl);
+                    definition += ';';
+                    for(auto c : definition) {
+                        hash ^= static_cast<unsigned char>(c);
+                        hash *= 1099511628211ULL;
+                    }
+                });
+                std::stringstream ss;
+                ss << std::hex << std::setw(16) << std::setfill('0') << hash;
+                return ss.str();
+            }
+            
+            /**
+             *  Enables storing schema fingerprint in db during `sync_schema` call. Once enabled `sync_schema` and
+             *  `sync_schema_simulate` compare stored fingerprint with `schema_fingerprint()` first and skip table
+             *  introspection if they are equal. Use it only if db schema is changed by this storage exclusively:
+             *  changes made outside of `sync_schema` are not detected while fingerprint matches.
+             */
+            void enable_schema_fingerprint(bool value = true) {
+                this->useSchemaFingerprint = value;
+            }
+            
+            /**
+             *  Enables online mode for table rebuilds performed by `sync_schema` (when a column cannot be removed
+             *  in place). Rows are copied in rowid order by chunks of `chunkSize` rows each one within a short
+             *  transaction so other connections can use the table during migration, and source table is replaced
+             *  with the copy atomically. Online mode is not used if `sync_schema` is called inside a transaction.
+             *  @param chunkSize rows count copied per transaction. Pass 0 to disable online mode.
+             *  @param onProgress optional callback fired after every copied chunk.
+             */
+            void enable_online_migration(int chunkSize, std::function<void(const migration_progress&)> onProgress = {}) {
+                this->migrationChunkSize = chunkSize;
+                this->onMigrationProgress = std::move(onProgress);
+            }
+            
             bool transaction(std::function<bool()> f) {
+                measurement_type measurement(this->instrumentationPolicy, "transaction");
+                measurement.phase(instrumentation_phase::step);
                 this->begin_transaction();
                 auto db = this->currentTransaction->get_db();
                 auto shouldCommit = f();
@@ -3116,7 +4899,7 @@ namespace sqlite_orm {
             
             std::string current_timestamp() {
                 auto connection = this->get_or_create_connection();
-                return this->impl.current_timestamp(connection->get_db());
+                return this->impl.current_timestamp(*connection);
             }
             
         protected:
@@ -3168,6 +4951,29 @@ namespace sqlite_orm {
             }
 #endif
             
+            /**
+             *  @return instrumentation policy passed to `make_instrumented_storage`. `no_instrumentation`
+             *  for storages created with `make_storage`.
+             */
+            instrumentation_type& instrumentation() {
+                return this->instrumentationPolicy;
+            }
+            
+            /**
+             *  Returns `sqlite3_db_status` values of connections kept open by storage and process wide
+             *  `sqlite3_status64` memory values. Is useful for `cache_size` and lookaside sizing.
+             *  @param reset resets highwater marks and cache counters after reading if true so every call
+             *  reports values collected since the previous one.
+             */
+            storage_stats stats(bool reset = false) {
+                storage_stats res;
+                if(this->currentTransaction) {
+                    res.connections.push_back(internal::get_connection_stats(this->currentTransaction->get_db(), reset));
+                }
+                internal::get_global_stats(res, reset);
+                return res;
+            }
+            
             /**
              *  Checks whether table exists in db. Doesn't check storage itself - works only with actual database.
              *  Note: table can be not mapped to a storage
@@ -3175,7 +4981,7 @@ namespace sqlite_orm {
              */
             bool table_exists(const std::string &tableName) {
                 auto connection = this->get_or_create_connection();
-                return this->impl.table_exists(tableName, connection->get_db());
+                return this->impl.table_exists(tableName, *connection);
             }
             
             /**
@@ -3184,24 +4990,7 @@ namespace sqlite_orm {
              */
             std::vector<std::string> table_names() {
                 auto connection = this->get_or_create_connection();
-                std::vector<std::string> tableNames;
-                std::string sql = "SELECT name FROM sqlite_master WHERE type='table'";
-                using Data = std::vector<std::string>;
-                int res = sqlite3_exec(connection->get_db(), sql.c_str(),
-                                       [] (void *data, int argc, char **argv, char ** /*columnName*/) -> int {
-                                           auto& tableNames = *(Data*)data;
-                                           for(int i = 0; i < argc; i++) {
-                                               if(argv[i]){
-                                                   tableNames.push_back(argv[i]);
-                                               }
-                                           }
-                                           return 0;
-                                       }, &tableNames,nullptr);
-                
-                if(res != SQLITE_OK) {
-                    throw std::system_error(std::error_code(sqlite3_errcode(connection->db()), get_sqlite_error_category()));
-                }
-                return tableNames;
+                return this->impl.table_names(*connection);
             }
             
             void open_forever() {
@@ -3216,10 +5005,22 @@ namespace sqlite_orm {
             pragma_t pragma;
             limit_accesor limit;
         };
+        
+        template<class ...Ts>
+        using storage_t = basic_storage<no_instrumentation, Ts...>;
     }
     
     template<class ...Ts>
     internal::storage_t<Ts...> make_storage(const std::string &filename, Ts ...tables) {
         return {filename, internal::storage_impl<Ts...>(tables...)};
     }
+    
+    /**
+     *  Creates a storage with instrumentation policy `P` e.g.
+     *  `make_instrumented_storage<latency_instrumentation>("db.sqlite", make_table(...))`.
+     */
+    template<class P, class ...Ts>
+    internal::basic_storage<P, Ts...> make_instrumented_storage(const std::string &filename, Ts ...tables) {
+        return {filename, internal::storage_impl<Ts...>(tables...)};
+    }
 }
@@ -5,14 +5,17 @@
 #include <cstddef>  //  std::nullptr_t
 #include <system_error> //  std::system_error, std::error_code
 #include <sstream>  //  std::stringstream
-#include <cstdlib>  //  std::atoi
 #include <type_traits>  //  std::forward, std::enable_if, std::is_same, std::remove_reference
 #include <utility>  //  std::pair, std::make_pair
 #include <vector>   //  std::vector
 #include <algorithm>    //  std::find_if
+#include <map>  //  std::map
 
 #include "error_code.h"
+#include "database_connection.h"
 #include "statement_finalizer.h"
+#include "statement_resetter.h"
+#include "statement_binder.h"
 #include "row_extractor.h"
 #include "constraints.h"
 #include "select_constraints.h"
@@ -25,6 +28,39 @@ namespace sqlite_orm {
     
     namespace internal {
         
+        /**
+         *  Columns info of db tables. Key is a table name.
+         */
+        using tables_info = std::map<std::string, std::vector<table_info>>;
+        
+        /**
+         *  Index stored in `sqlite_master`. `sql` is `CREATE INDEX` statement the index was created with.
+         */
+        struct index_info {
+            std::string table_name;
+            std::string sql;
+        };
+        
+        /**
+         *  Explicitly created indexes of db. Key is an index name.
+         */
+        using indexes_info = std::map<std::string, index_info>;
+        
+        /**
+         *  Empty base of every storage_impl which table is mapped to O. Is used to find storage_impl
+         *  of a type without recursive lookup through the inheritance chain.
+         */
+        template<class O, class S>
+        struct storage_impl_tag {};
+        
+        /**
+         *  @return storage_impl S of type O deduced from its unique storage_impl_tag base.
+         */
+        template<class O, class S>
+        S& find_storage_impl(storage_impl_tag<O, S> &tag) {
+            return static_cast<S&>(tag);
+        }
+        
         /**
          *  This is a generic implementation. Used as a tail in storage_impl inheritance chain
          */
@@ -43,23 +79,150 @@ namespace sqlite_orm {
                 throw std::system_error(std::make_error_code(orm_error_code::type_is_not_mapped_to_storage));
             }
             
-            bool table_exists(const std::string &tableName, sqlite3 *db) {
-                auto res = false;
+            bool table_exists(const std::string &tableName, database_connection &connection) {
+                auto db = connection.get_db();
+                auto stmt = connection.get_statement("SELECT COUNT(*) FROM sqlite_master WHERE type = 'table' AND name = ?");
+                statement_resetter resetter{stmt};
+                statement_binder<std::string>().bind(stmt, 1, tableName);
+                if(sqlite3_step(stmt) == SQLITE_ROW) {
+                    return !!row_extractor<int>().extract(stmt, 0);
+                }else{
+                    throw std::system_error(std::error_code(sqlite3_errcode(db), get_sqlite_error_category()));
+                }
+            }
+            
+            std::vector<std::string> table_names(database_connection &connection) {
+                auto db = connection.get_db();
+                std::vector<std::string> res;
+                auto stmt = connection.get_statement("SELECT name FROM sqlite_master WHERE type = 'table'");
+                statement_resetter resetter{stmt};
+                int stepRes;
+                do{
+                    stepRes = sqlite3_step(stmt);
+                    switch(stepRes){
+                        case SQLITE_ROW:{
+                            res.push_back(row_extractor<std::string>().extract(stmt, 0));
+                        }break;
+                        case SQLITE_DONE: break;
+                        default:{
+                            throw std::system_error(std::error_code(sqlite3_errcode(db), get_sqlite_error_category()));
+                        }
+                    }
+                }while(stepRes != SQLITE_DONE);
+                return res;
+            }
+            
+            std::vector<table_info> get_table_info(const std::string &tableName, database_connection &connection) {
+                auto db = connection.get_db();
+                std::vector<table_info> res;
+#if SQLITE_VERSION_NUMBER >= 3016000
+                auto stmt = connection.get_statement("SELECT cid, name, type, \"notnull\", dflt_value, pk FROM pragma_table_info(?)");
+                statement_resetter resetter{stmt};
+                statement_binder<std::string>().bind(stmt, 1, tableName);
+#else
+                //  PRAGMA statement cannot have bound parameters so table name is escaped and query is not cached
                 std::stringstream ss;
-                ss << "SELECT COUNT(*) FROM sqlite_master WHERE type = '" << "table" << "' AND name = '" << tableName << "'";
+                ss << "PRAGMA table_info('";
+                for(auto c : tableName) {
+                    if(c == '\''){
+                        ss << c;
+                    }
+                    ss << c;
+                }
+                ss << "')";
                 auto query = ss.str();
-                auto rc = sqlite3_exec(db,
-                                       query.c_str(),
-                                       [](void *data, int argc, char **argv,char ** /*azColName*/) -> int {
-                                           auto &res = *(bool*)data;
-                                           if(argc){
-                                               res = !!std::atoi(argv[0]);
-                                           }
-                                           return 0;
-                                       }, &res, nullptr);
-                if(rc != SQLITE_OK) {
+                sqlite3_stmt *stmt;
+                if(sqlite3_prepare_v2(db, query.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
                     throw std::system_error(std::error_code(sqlite3_errcode(db), get_sqlite_error_category()));
                 }
+                statement_finalizer finalizer{stmt};
+#endif
+                int stepRes;
+                do{
+                    stepRes = sqlite3_step(stmt);
+                    switch(stepRes){
+                        case SQLITE_ROW:{
+                            auto cid = row_extractor<int>().extract(stmt, 0);
+                            auto name = row_extractor<std::string>().extract(stmt, 1);
+                            auto type = row_extractor<std::string>().extract(stmt, 2);
+                            auto notnull = row_extractor<bool>().extract(stmt, 3);
+                            auto dflt_value = row_extractor<std::string>().extract(stmt, 4);
+                            auto pk = row_extractor<int>().extract(stmt, 5);
+                            res.push_back(table_info{cid, std::move(name), std::move(type), notnull, std::move(dflt_value), pk});
+                        }break;
+                        case SQLITE_DONE: break;
+                        default:{
+                            throw std::system_error(std::error_code(sqlite3_errcode(db), get_sqlite_error_category()));
+                        }
+                    }
+                }while(stepRes != SQLITE_DONE);
+                return res;
+            }
+            
+            /**
+             *  Loads explicitly created indexes. Indexes created automatically for UNIQUE and PRIMARY KEY
+             *  constraints have no sql and are skipped.
+             */
+            indexes_info get_indexes_info(database_connection &connection) {
+                auto db = connection.get_db();
+                indexes_info res;
+                auto stmt = connection.get_statement("SELECT name, tbl_name, sql FROM sqlite_master WHERE type = 'index' AND sql IS NOT NULL");
+                statement_resetter resetter{stmt};
+                int stepRes;
+                do{
+                    stepRes = sqlite3_step(stmt);
+                    switch(stepRes){
+                        case SQLITE_ROW:{
+                            auto name = row_extractor<std::string>().extract(stmt, 0);
+                            auto tableName = row_extractor<std::string>().extract(stmt, 1);
+                            auto sql = row_extractor<std::string>().extract(stmt, 2);
+                            res.insert({std::move(name), index_info{std::move(tableName), std::move(sql)}});
+                        }break;
+                        case SQLITE_DONE: break;
+                        default:{
+                            throw std::system_error(std::error_code(sqlite3_errcode(db), get_sqlite_error_category()));
+                        }
+                    }
+                }while(stepRes != SQLITE_DONE);
+                return res;
+            }
+            
+            /**
+             *  Loads columns info of every table in db. Uses single `sqlite_master` join with `pragma_table_info`
+             *  query if available so `sync_schema` needs one catalog round trip instead of two per table.
+             *  @return map with table name as key and `PRAGMA table_info` rows as value.
+             */
+            tables_info get_tables_info(database_connection &connection) {
+                tables_info res;
+#if SQLITE_VERSION_NUMBER >= 3016000
+                auto db = connection.get_db();
+                auto stmt = connection.get_statement("SELECT m.name, p.cid, p.name, p.type, p.\"notnull\", p.dflt_value, p.pk FROM sqlite_master AS m JOIN pragma_table_info(m.name) AS p WHERE m.type = 'table' ORDER BY m.name, p.cid");
+                statement_resetter resetter{stmt};
+                int stepRes;
+                do{
+                    stepRes = sqlite3_step(stmt);
+                    switch(stepRes){
+                        case SQLITE_ROW:{
+                            auto tableName = row_extractor<std::string>().extract(stmt, 0);
+                            auto cid = row_extractor<int>().extract(stmt, 1);
+                            auto name = row_extractor<std::string>().extract(stmt, 2);
+                            auto type = row_extractor<std::string>().extract(stmt, 3);
+                            auto notnull = row_extractor<bool>().extract(stmt, 4);
+                            auto dflt_value = row_extractor<std::string>().extract(stmt, 5);
+                            auto pk = row_extractor<int>().extract(stmt, 6);
+                            res[tableName].push_back(table_info{cid, std::move(name), std::move(type), notnull, std::move(dflt_value), pk});
+                        }break;
+                        case SQLITE_DONE: break;
+                        default:{
+                            throw std::system_error(std::error_code(sqlite3_errcode(db), get_sqlite_error_category()));
+                        }
+                    }
+                }while(stepRes != SQLITE_DONE);
+#else
+                for(auto &tableName : this->table_names(connection)) {
+                    res.insert({tableName, this->get_table_info(tableName, connection)});
+                }
+#endif
                 return res;
             }
             
@@ -131,31 +294,20 @@ namespace sqlite_orm {
                 }
             }
             
-            std::string current_timestamp(sqlite3 *db) {
-                std::string res;
-                std::stringstream ss;
-                ss << "SELECT CURRENT_TIMESTAMP";
-                auto query = ss.str();
-                auto rc = sqlite3_exec(db,
-                                       query.c_str(),
-                                       [](void *data, int argc, char **argv, char **) -> int {
-                                           auto &res = *(std::string*)data;
-                                           if(argc){
-                                               if(argv[0]){
-                                                   res = row_extractor<std::string>().extract(argv[0]);
-                                               }
-                                           }
-                                           return 0;
-                                       }, &res, nullptr);
-                if(rc != SQLITE_OK) {
+            std::string current_timestamp(database_connection &connection) {
+                auto db = connection.get_db();
+                auto stmt = connection.get_statement("SELECT CURRENT_TIMESTAMP");
+                statement_resetter resetter{stmt};
+                if(sqlite3_step(stmt) == SQLITE_ROW) {
+                    return row_extractor<std::string>().extract(stmt, 0);
+                }else{
                     throw std::system_error(std::error_code(sqlite3_errcode(db), get_sqlite_error_category()));
                 }
-                return res;
             }
         };
         
         template<class H, class ...Ts>
-        struct storage_impl<H, Ts...> : public storage_impl<Ts...> {
+        struct storage_impl<H, Ts...> : public storage_impl<Ts...>, public storage_impl_tag<typename H::object_type, storage_impl<H, Ts...>> {
             using table_type = H;
             
             storage_impl(H h, Ts ...ts) : super(std::forward<Ts>(ts)...), table(std::move(h)) {}
@@ -212,84 +364,42 @@ namespace sqlite_orm {
             }
             
             /**
-             *  Cute function used to find column name by its type and member pointer. Uses SFINAE to
-             *  skip inequal type O.
-             */
-            template<class O, class F, class HH = typename H::object_type>
-            std::string column_name(F O::*m, typename std::enable_if<std::is_same<O, HH>::value>::type * = nullptr) {
-                return this->table.find_column_name(m);
-            }
-            
-            /**
-             *  Opposite version of function defined above. Just calls same function in superclass.
-             */
-            template<class O, class F, class HH = typename H::object_type>
-            std::string column_name(F O::*m, typename std::enable_if<!std::is_same<O, HH>::value>::type * = nullptr) {
-                return this->super::column_name(m);
-            }
-            
-            /**
-             *  Cute function used to find column name by its type and getter pointer. Uses SFINAE to
-             *  skip inequal type O.
+             *  Finds column name by its type and member pointer in table mapped to O.
              */
-            template<class O, class F, class HH = typename H::object_type>
-            std::string column_name(const F& (O::*g)() const, typename std::enable_if<std::is_same<O, HH>::value>::type * = nullptr) {
-                return this->table.find_column_name(g);
-            }
-            
-            /**
-             *  Opposite version of function defined above. Just calls same function in superclass.
-             */
-            template<class O, class F, class HH = typename H::object_type>
-            std::string column_name(const F& (O::*g)() const, typename std::enable_if<!std::is_same<O, HH>::value>::type * = nullptr) {
-                return this->super::column_name(g);
+            template<class O, class F>
+            std::string column_name(F O::*m) {
+                return this->template get_impl<O>().table.find_column_name(m);
             }
             
             /**
-             *  Cute function used to find column name by its type and setter pointer. Uses SFINAE to
-             *  skip inequal type O.
+             *  Same thing as above for getter.
              */
-            template<class O, class F, class HH = typename H::object_type>
-            std::string column_name(void (O::*s)(F), typename std::enable_if<std::is_same<O, HH>::value>::type * = nullptr) {
-                return this->table.find_column_name(s);
+            template<class O, class F>
+            std::string column_name(const F& (O::*g)() const) {
+                return this->template get_impl<O>().table.find_column_name(g);
             }
             
             /**
-             *  Opposite version of function defined above. Just calls same function in superclass.
+             *  Same thing as above for setter.
              */
-            template<class O, class F, class HH = typename H::object_type>
-            std::string column_name(void (O::*s)(F), typename std::enable_if<!std::is_same<O, HH>::value>::type * = nullptr) {
-                return this->super::column_name(s);
-            }
-            
-            template<class T, class F, class HH = typename H::object_type>
-            std::string column_name(const column_pointer<T, F> &c, typename std::enable_if<std::is_same<T, HH>::value>::type * = nullptr) {
-                return this->column_name_simple(c.field);
-            }
-            
-            template<class T, class F, class HH = typename H::object_type>
-            std::string column_name(const column_pointer<T, F> &c, typename std::enable_if<!std::is_same<T, HH>::value>::type * = nullptr) {
-                return this->super::column_name(c);
-            }
-            
-            template<class O, class HH = typename H::object_type>
-            auto& get_impl(typename std::enable_if<std::is_same<O, HH>::value>::type * = nullptr) {
-                return *this;
+            template<class O, class F>
+            std::string column_name(void (O::*s)(F)) {
+                return this->template get_impl<O>().table.find_column_name(s);
             }
             
-            template<class O, class HH = typename H::object_type>
-            auto& get_impl(typename std::enable_if<!std::is_same<O, HH>::value>::type * = nullptr) {
-                return this->super::template get_impl<O>();
+            template<class T, class F>
+            std::string column_name(const column_pointer<T, F> &c) {
+                return this->template get_impl<T>().column_name_simple(c.field);
             }
             
-            template<class O, class HH = typename H::object_type>
-            std::string find_table_name(typename std::enable_if<std::is_same<O, HH>::value>::type * = nullptr) {
-                return this->table.name;
+            template<class O>
+            auto& get_impl() {
+                return find_storage_impl<O>(*this);
             }
             
-            template<class O, class HH = typename H::object_type>
-            std::string find_table_name(typename std::enable_if<!std::is_same<O, HH>::value>::type * = nullptr) {
-                return this->super::template find_table_name<O>();
+            template<class O>
+            std::string find_table_name() {
+                return this->template get_impl<O>().table.name;
             }
             
             template<class O, class HH = typename H::object_type>
@@ -324,32 +434,6 @@ namespace sqlite_orm {
                 return ss.str();
             }
             
-            std::vector<table_info> get_table_info(const std::string &tableName, sqlite3 *db) {
-                std::vector<table_info> res;
-                auto query = "PRAGMA table_info('" + tableName + "')";
-                auto rc = sqlite3_exec(db,
-                                       query.c_str(),
-                                       [](void *data, int argc, char **argv,char **) -> int {
-                                           auto &res = *(std::vector<table_info>*)data;
-                                           if(argc){
-                                               auto index = 0;
-                                               auto cid = std::atoi(argv[index++]);
-                                               std::string name = argv[index++];
-                                               std::string type = argv[index++];
-                                               bool notnull = !!std::atoi(argv[index++]);
-                                               std::string dflt_value = argv[index] ? argv[index] : "";
-                                               index++;
-                                               auto pk = std::atoi(argv[index++]);
-                                               res.push_back(table_info{cid, name, type, notnull, dflt_value, pk});
-                                           }
-                                           return 0;
-                                       }, &res, nullptr);
-                if(rc != SQLITE_OK) {
-                    throw std::system_error(std::error_code(sqlite3_errcode(db), get_sqlite_error_category()));
-                }
-                return res;
-            }
-            
             void add_column(const table_info &ti, sqlite3 *db) {
                 std::stringstream ss;
                 ss << "ALTER TABLE " << this->table.name << " ADD COLUMN " << ti.name << " ";
@@ -378,6 +462,38 @@ namespace sqlite_orm {
                 }
             }
             
+            /**
+             *  Drops column in place using `ALTER TABLE ... DROP COLUMN` available since SQLite 3.35.0.
+             *  @return false if column cannot be dropped in place (older SQLite or column is a part of
+             *  primary key, unique constraint, index, foreign key etc) so table has to be copied instead.
+             */
+            bool drop_column(const std::string &columnName, sqlite3 *db) {
+#if SQLITE_VERSION_NUMBER >= 3035000
+                std::stringstream ss;
+                ss << "ALTER TABLE '" << this->table.name << "' DROP COLUMN \"" << columnName << "\"";
+                auto query = ss.str();
+                sqlite3_stmt *stmt;
+                if (sqlite3_prepare_v2(db, query.c_str(), -1, &stmt, nullptr) == SQLITE_OK) {
+                    statement_finalizer finalizer{stmt};
+                    
+                    //  references from indexes, views and triggers are checked during the step
+                    switch(sqlite3_step(stmt)){
+                        case SQLITE_DONE: return true;
+                        case SQLITE_ERROR: return false;
+                        default:{
+                            throw std::system_error(std::error_code(sqlite3_errcode(db), get_sqlite_error_category()));
+                        }
+                    }
+                }else{
+                    return false;
+                }
+#else
+                (void)columnName;
+                (void)db;
+                return false;
+#endif
+            }
+            
             /**
              *  Copies current table to another table with a given **name**.
              *  Performs CREATE TABLE %name% AS SELECT %this->table.columns_names()% FROM &this->table.name%;
@@ -423,19 +539,23 @@ namespace sqlite_orm {
                 }
             }
             
-            sync_schema_result schema_status(sqlite3 *db, bool preserve) {
+            /**
+             *  Compares storage table with its db analog using columns info loaded by `get_tables_info`.
+             */
+            sync_schema_result schema_status(const tables_info &tablesInfo, bool preserve) {
                 
                 auto res = sync_schema_result::already_in_sync;
                 
                 //  first let's see if table with such name exists..
-                auto gottaCreateTable = !this->table_exists(this->table.name, db);
+                auto tableInfoIt = tablesInfo.find(this->table.name);
+                auto gottaCreateTable = tableInfoIt == tablesInfo.end();
                 if(!gottaCreateTable){
                     
                     //  get table info provided in `make_table` call..
                     auto storageTableInfo = this->table.get_table_info();
                     
-                    //  now get current table info from db using `PRAGMA table_info` query..
-                    auto dbTableInfo = get_table_info(this->table.name, db);
+                    //  now get current table info from db loaded by `get_tables_info`..
+                    auto dbTableInfo = tableInfoIt->second;
                     
                     //  this vector will contain pointers to columns that gotta be added..
                     std::vector<table_info*> columnsToAdd;
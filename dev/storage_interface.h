@@ -0,0 +1,89 @@
+#pragma once
+
+#ifndef SQLITE_ORM_STORAGE_INTERFACE_H
+#define SQLITE_ORM_STORAGE_INTERFACE_H
+
+#include <string>   //  std::string
+#include <vector>   //  std::vector
+#include <memory>   //  std::shared_ptr
+#include <functional>   //  std::function
+#include <map>  //  std::map
+
+#include "sync_schema_result.h"
+
+namespace sqlite_orm {
+    
+    /**
+     *  Non-template interface of storage operations which don't depend on a mapped type.
+     *  It is available as a standalone light header `sqlite_orm/storage_interface.h` which includes
+     *  only standard headers. So a storage can be defined and instantiated in a single translation unit
+     *  and other translation units work with it through this interface without including `sqlite_orm.h`.
+     *  Implementation is created with `make_storage_interface(storage)`.
+     */
+    struct storage_interface {
+        
+        virtual ~storage_interface() = default;
+        
+        /**
+         *  Calls `storage.sync_schema(preserve)`.
+         *  @return result of every table and index of the storage like `storage.sync_schema` does.
+         */
+        virtual std::map<std::string, sync_schema_result> sync_schema(bool preserve = false) = 0;
+        
+        virtual bool transaction(std::function<bool()> f) = 0;
+        
+        virtual void begin_transaction() = 0;
+        
+        virtual void commit() = 0;
+        
+        virtual void rollback() = 0;
+        
+        virtual bool table_exists(const std::string &tableName) = 0;
+        
+        virtual void drop_table(const std::string &tableName) = 0;
+        
+        virtual void vacuum() = 0;
+    };
+    
+    /**
+     *  Non-template interface of storage operations with mapped type O which primary key has type Id.
+     *  Is a part of the light header like `storage_interface`. Implementation is created with
+     *  `make_repository<O>(storage)`. Every function calls storage function with the same name.
+     */
+    template<class O, class Id = int>
+    struct repository {
+        
+        virtual ~repository() = default;
+        
+        /**
+         *  @return id of inserted object
+         */
+        virtual int insert(const O &o) = 0;
+        
+        virtual void insert_range(const std::vector<O> &objects) = 0;
+        
+        virtual void replace(const O &o) = 0;
+        
+        virtual void update(const O &o) = 0;
+        
+        virtual void remove(const Id &id) = 0;
+        
+        virtual void remove_all() = 0;
+        
+        /**
+         *  throws std::system_error(orm_error_code::not_found, orm_error_category) if object is not found.
+         */
+        virtual O get(const Id &id) = 0;
+        
+        /**
+         *  @return nullptr if object is not found.
+         */
+        virtual std::shared_ptr<O> get_no_throw(const Id &id) = 0;
+        
+        virtual std::vector<O> get_all() = 0;
+        
+        virtual int count() = 0;
+    };
+}
+
+#endif  //  SQLITE_ORM_STORAGE_INTERFACE_H
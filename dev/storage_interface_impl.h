@@ -0,0 +1,134 @@
+#pragma once
+
+#include <string>   //  std::string
+#include <vector>   //  std::vector
+#include <memory>   //  std::shared_ptr, std::unique_ptr
+#include <functional>   //  std::function
+#include <map>  //  std::map
+#include <utility>  //  std::move
+
+#include "storage_interface.h"
+
+namespace sqlite_orm {
+    
+    namespace internal {
+        
+        /**
+         *  storage_interface implementation which forwards calls to storage S. Keeps a reference so
+         *  storage must outlive it.
+         */
+        template<class S>
+        struct storage_interface_impl : public storage_interface {
+            
+            storage_interface_impl(S &storage_): storage(storage_) {}
+            
+            std::map<std::string, sync_schema_result> sync_schema(bool preserve) override {
+                return this->storage.sync_schema(preserve);
+            }
+            
+            bool transaction(std::function<bool()> f) override {
+                return this->storage.transaction(std::move(f));
+            }
+            
+            void begin_transaction() override {
+                this->storage.begin_transaction();
+            }
+            
+            void commit() override {
+                this->storage.commit();
+            }
+            
+            void rollback() override {
+                this->storage.rollback();
+            }
+            
+            bool table_exists(const std::string &tableName) override {
+                return this->storage.table_exists(tableName);
+            }
+            
+            void drop_table(const std::string &tableName) override {
+                this->storage.drop_table(tableName);
+            }
+            
+            void vacuum() override {
+                this->storage.vacuum();
+            }
+            
+        protected:
+            S &storage;
+        };
+        
+        /**
+         *  repository implementation which forwards calls to storage S. Keeps a reference so
+         *  storage must outlive it.
+         */
+        template<class S, class O, class Id>
+        struct repository_impl : public repository<O, Id> {
+            
+            repository_impl(S &storage_): storage(storage_) {}
+            
+            int insert(const O &o) override {
+                return this->storage.insert(o);
+            }
+            
+            void insert_range(const std::vector<O> &objects) override {
+                this->storage.insert_range(objects.begin(), objects.end());
+            }
+            
+            void replace(const O &o) override {
+                this->storage.replace(o);
+            }
+            
+            void update(const O &o) override {
+                this->storage.update(o);
+            }
+            
+            void remove(const Id &id) override {
+                this->storage.template remove<O>(id);
+            }
+            
+            void remove_all() override {
+                this->storage.template remove_all<O>();
+            }
+            
+            O get(const Id &id) override {
+                return this->storage.template get<O>(id);
+            }
+            
+            std::shared_ptr<O> get_no_throw(const Id &id) override {
+                return this->storage.template get_no_throw<O>(id);
+            }
+            
+            std::vector<O> get_all() override {
+                return this->storage.template get_all<O>();
+            }
+            
+            int count() override {
+                return this->storage.template count<O>();
+            }
+            
+        protected:
+            S &storage;
+        };
+    }
+    
+    /**
+     *  Creates `storage_interface` implementation for a storage. Storage must outlive the result.
+     *  Call it in the translation unit which defines the storage. Explicit instantiation of
+     *  `internal::storage_interface_impl<Storage>` in that unit makes sure all storage functions used by
+     *  the interface are instantiated there once.
+     */
+    template<class S>
+    std::unique_ptr<storage_interface> make_storage_interface(S &storage) {
+        return std::make_unique<internal::storage_interface_impl<S>>(storage);
+    }
+    
+    /**
+     *  Creates `repository<O, Id>` implementation for a storage. Storage must outlive the result.
+     *  O is a mapped type and must be specified explicitly.
+     */
+    template<class O, class Id = int, class S>
+    std::unique_ptr<repository<O, Id>> make_repository(S &storage) {
+        return std::make_unique<internal::repository_impl<S, O, Id>>(storage);
+    }
+}
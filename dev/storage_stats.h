@@ -0,0 +1,155 @@
+#pragma once
+
+#include <sqlite3.h>
+#include <vector>   //  std::vector
+
+#include "sqlite_type.h"
+
+namespace sqlite_orm {
+    
+    /**
+     *  `sqlite3_db_status` values of a database connection. Sizes are in bytes.
+     *  Values which SQLite version doesn't support are zero.
+     */
+    struct connection_stats {
+        
+        /**
+         *  SQLITE_DBSTATUS_CACHE_USED: heap memory used by pager caches
+         */
+        int64 cache_used = 0;
+        int64 cache_hit = 0;
+        int64 cache_miss = 0;
+        int64 cache_write = 0;
+        
+        /**
+         *  SQLITE_DBSTATUS_SCHEMA_USED: heap memory used to store schema of all attached databases
+         */
+        int64 schema_used = 0;
+        
+        /**
+         *  SQLITE_DBSTATUS_STMT_USED: heap memory used by all prepared statements of the connection
+         */
+        int64 stmt_used = 0;
+        
+        /**
+         *  SQLITE_DBSTATUS_LOOKASIDE_USED: lookaside slots used now and at most
+         */
+        int64 lookaside_used = 0;
+        int64 lookaside_used_highwater = 0;
+        
+        /**
+         *  Allocations served by lookaside and allocations which could not be served cause requested
+         *  size was too big or all slots were used
+         */
+        int64 lookaside_hit = 0;
+        int64 lookaside_miss_size = 0;
+        int64 lookaside_miss_full = 0;
+    };
+    
+    /**
+     *  Memory statistics returned by `storage_t::stats`.
+     */
+    struct storage_stats {
+        
+        /**
+         *  Stats of connections kept open by storage (the one opened by `open_forever`, in-memory database or
+         *  a transaction). Empty if storage opens a connection per call.
+         */
+        std::vector<connection_stats> connections;
+        
+        /**
+         *  SQLITE_STATUS_MEMORY_USED: process wide heap memory used by SQLite now and at most
+         */
+        int64 memory_used = 0;
+        int64 memory_highwater = 0;
+        
+        /**
+         *  SQLITE_STATUS_MALLOC_SIZE: the biggest allocation requested
+         */
+        int64 malloc_size_highwater = 0;
+        
+        /**
+         *  SQLITE_STATUS_MALLOC_COUNT: current allocations count
+         */
+        int64 malloc_count = 0;
+        
+        /**
+         *  SQLITE_STATUS_PAGECACHE_OVERFLOW: page cache allocations which didn't fit in SQLITE_CONFIG_PAGECACHE
+         *  memory and were served by heap. Non zero value means page cache buffer is too small.
+         */
+        int64 page_cache_overflow = 0;
+        int64 page_cache_overflow_highwater = 0;
+    };
+    
+    namespace internal {
+        
+        /**
+         *  @param reset resets highwater marks and cache hit/miss/write counters if true
+         */
+        inline connection_stats get_connection_stats(sqlite3 *db, bool reset) {
+            connection_stats res;
+            auto resetFlag = reset ? 1 : 0;
+            int current = 0;
+            int highwater = 0;
+            sqlite3_db_status(db, SQLITE_DBSTATUS_CACHE_USED, &current, &highwater, 0);
+            res.cache_used = current;
+#if SQLITE_VERSION_NUMBER >= 3007009
+            sqlite3_db_status(db, SQLITE_DBSTATUS_CACHE_HIT, &current, &highwater, resetFlag);
+            res.cache_hit = current;
+            sqlite3_db_status(db, SQLITE_DBSTATUS_CACHE_MISS, &current, &highwater, resetFlag);
+            res.cache_miss = current;
+#endif
+#if SQLITE_VERSION_NUMBER >= 3007012
+            sqlite3_db_status(db, SQLITE_DBSTATUS_CACHE_WRITE, &current, &highwater, resetFlag);
+            res.cache_write = current;
+#endif
+            sqlite3_db_status(db, SQLITE_DBSTATUS_SCHEMA_USED, &current, &highwater, 0);
+            res.schema_used = current;
+            sqlite3_db_status(db, SQLITE_DBSTATUS_STMT_USED, &current, &highwater, 0);
+            res.stmt_used = current;
+            sqlite3_db_status(db, SQLITE_DBSTATUS_LOOKASIDE_USED, &current, &highwater, resetFlag);
+            res.lookaside_used = current;
+            res.lookaside_used_highwater = highwater;
+            
+            //  lookaside hit and miss counters are reported as highwater values
+            sqlite3_db_status(db, SQLITE_DBSTATUS_LOOKASIDE_HIT, &current, &highwater, resetFlag);
+            res.lookaside_hit = highwater;
+            sqlite3_db_status(db, SQLITE_DBSTATUS_LOOKASIDE_MISS_SIZE, &current, &highwater, resetFlag);
+            res.lookaside_miss_size = highwater;
+            sqlite3_db_status(db, SQLITE_DBSTATUS_LOOKASIDE_MISS_FULL, &current, &highwater, resetFlag);
+            res.lookaside_miss_full = highwater;
+            return res;
+        }
+        
+        /**
+         *  Fills process wide `sqlite3_status64` values of `stats`.
+         *  @param reset resets highwater marks if true
+         */
+        inline void get_global_stats(storage_stats &stats, bool reset) {
+            auto resetFlag = reset ? 1 : 0;
+#if SQLITE_VERSION_NUMBER >= 3010000
+            sqlite3_int64 current = 0;
+            sqlite3_int64 highwater = 0;
+            auto status = [&current, &highwater, resetFlag](int op) {
+                sqlite3_status64(op, &current, &highwater, resetFlag);
+            };
+#else
+            int current = 0;
+            int highwater = 0;
+            auto status = [&current, &highwater, resetFlag](int op) {
+                sqlite3_status(op, &current, &highwater, resetFlag);
+            };
+#endif
+            status(SQLITE_STATUS_MEMORY_USED);
+            stats.memory_used = current;
+            stats.memory_highwater = highwater;
+            status(SQLITE_STATUS_MALLOC_SIZE);
+            stats.malloc_size_highwater = highwater;
+            status(SQLITE_STATUS_MALLOC_COUNT);
+            stats.malloc_count = current;
+            status(SQLITE_STATUS_PAGECACHE_OVERFLOW);
+            stats.page_cache_overflow = current;
+            stats.page_cache_overflow_highwater = highwater;
+        }
+    }
+}
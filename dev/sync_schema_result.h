@@ -1,5 +1,8 @@
 #pragma once
 
+#ifndef SQLITE_ORM_SYNC_SCHEMA_RESULT_H
+#define SQLITE_ORM_SYNC_SCHEMA_RESULT_H
+
 #include <ostream>
 
 namespace sqlite_orm {
@@ -39,6 +42,22 @@ namespace sqlite_orm {
          *      4. data_type mismatch between table and storage.
          */
         dropped_and_recreated,
+        
+        /**
+         *  index from storage did not exist in db and was created
+         */
+        new_index_created,
+        
+        /**
+         *  index definition (columns, uniqueness, collation, order or condition) differs from storage
+         *  so index was dropped and created again
+         */
+        index_recreated,
+        
+        /**
+         *  index of a storage table exists in db but not in storage so it was dropped
+         */
+        index_dropped,
     };
     
     
@@ -50,6 +69,11 @@ namespace sqlite_orm {
             case sync_schema_result::new_columns_added: return os << "new columns added";
             case sync_schema_result::new_columns_added_and_old_columns_removed: return os << "old excess columns removed and new columns added";
             case sync_schema_result::dropped_and_recreated: return os << "old table dropped and recreated";
+            case sync_schema_result::new_index_created: return os << "new index created";
+            case sync_schema_result::index_recreated: return os << "index dropped and recreated";
+            case sync_schema_result::index_dropped: return os << "excess index dropped";
         }
     }
 }
+
+#endif  //  SQLITE_ORM_SYNC_SCHEMA_RESULT_H
@@ -4,7 +4,7 @@
 #include <type_traits>  //  std::remove_reference, std::is_same, std::is_base_of
 #include <vector>   //  std::vector
 #include <tuple>    //  std::tuple_size, std::tuple_element
-#include <algorithm>    //  std::reverse, std::find_if
+#include <algorithm>    //  std::find_if
 
 #include "table_impl.h"
 #include "column_result.h"
@@ -186,10 +186,7 @@ namespace sqlite_orm {
              */
             template<class ...Op>
             std::vector<std::string> column_names_with() {
-                auto res = this->impl.template column_names_with<Op...>();
-                std::reverse(res.begin(),
-                             res.end());
-                return res;
+                return this->impl.template column_names_with<Op...>();
             }
             
             /**
@@ -2,8 +2,9 @@
 
 #include <vector>   //  std::vector
 #include <string>   //  std::string
-#include <tuple>    //  std::tuple
+#include <tuple>    //  std::tuple, std::get
 #include <type_traits>  //  std::is_same, std::integral_constant, std::true_type, std::false_type
+#include <utility>  //  std::index_sequence, std::index_sequence_for
 
 #include "column.h"
 #include "tuple_helper.h"
@@ -14,140 +15,99 @@ namespace sqlite_orm {
     namespace internal {
         
         /**
-         *  Common case for table_impl class.
+         *  Stores table columns and constraints in a flat tuple. Every iteration is expanded with
+         *  `std::index_sequence` in a single function instead of a recursive inheritance chain so
+         *  instantiations count doesn't grow with columns count squared.
          */
-        template<typename... Args>
+        template<class ...Cs>
         struct table_impl {
             
-            std::vector<std::string> column_names() {
-                return {};
-            }
+            std::tuple<Cs...> columns;
             
-            template<class ...Op>
-            std::vector<std::string> column_names_exept() {
-                return {};
-            }
-            
-            template<class ...Op>
-            std::vector<std::string> column_names_with() {
-                return {};
-            }
-            
-            template<class L>
-            void for_each_column(L) {}
-            
-            template<class L>
-            void for_each_column_with_constraints(L) {}
-            
-            template<class F, class L>
-            void for_each_column_with_field_type(L) {}
-            
-            template<class Op, class L>
-            void for_each_column_exept(L) {}
-            
-            template<class Op, class L>
-            void for_each_column_with(L) {}
-            
-            template<class L>
-            void for_each_primary_key(L) {}
-            
-            int columns_count() const {
-                return 0;
-            }
-            
-        };
-        
-        template<typename H, typename... T>
-        struct table_impl<H, T...> : private table_impl<T...> {
-            using column_type = H;
-            using tail_types = std::tuple<T...>;
-            
-            table_impl(H h, T ...t) : super(t...), col(h) {}
-            
-            column_type col;
+            table_impl(Cs ...cs) : columns(std::move(cs)...) {}
             
             int columns_count() const {
-                return 1 + this->super::columns_count();
+                return static_cast<int>(sizeof...(Cs));
             }
             
             /**
-             *  column_names_with implementation. Notice that result will be reversed.
-             *  It is reversed back in `table` class.
              *  @return vector of column names that have specified Op... conditions.
              */
             template<class ...Op>
             std::vector<std::string> column_names_with() {
-                auto res = this->super::template column_names_with<Op...>();
-                if(this->col.template has_every<Op...>()) {
-                    res.emplace_back(this->col.name);
-                }
+                std::vector<std::string> res;
+                this->for_each_column_with_constraints([&res](auto &c){
+                    if(c.template has_every<Op...>()) {
+                        res.emplace_back(c.name);
+                    }
+                });
                 return res;
             }
             
             /**
-             *  For each implementation. Calls templated lambda with its column
-             *  and passed call to superclass.
+             *  Calls templated lambda with every column. Table constraints are skipped.
              */
             template<class L>
             void for_each_column(L l){
-                this->apply_to_col_if(l, internal::is_column<column_type>{});
-                this->super::for_each_column(l);
+                this->template for_each_if<internal::is_column<Cs>...>(l, std::index_sequence_for<Cs...>{});
             }
             
             /**
-             *  For each implementation. Calls templated lambda with its column
-             *  and passed call to superclass.
+             *  Calls templated lambda with every column and table constraint.
              */
             template<class L>
             void for_each_column_with_constraints(L l){
-                l(this->col);
-                this->super::for_each_column_with_constraints(l);
+                this->template for_each_if<std::is_same<Cs, Cs>...>(l, std::index_sequence_for<Cs...>{});
             }
             
             template<class F, class L>
             void for_each_column_with_field_type(L l) {
-                this->apply_to_col_if(l, std::is_same<F, typename column_type::field_type>{});
-                this->super::template for_each_column_with_field_type<F, L>(l);
+                this->template for_each_if<std::is_same<F, typename Cs::field_type>...>(l, std::index_sequence_for<Cs...>{});
             }
             
             /**
-             *  Working version of `for_each_column_exept`. Calls lambda if column has no option and fire super's function.
+             *  Calls lambda with every column that has no Op option.
              */
             template<class Op, class L>
             void for_each_column_exept(L l) {
-                using has_opt = tuple_helper::tuple_contains_type<Op, typename column_type::constraints_type>;
-                this->apply_to_col_if(l, std::integral_constant<bool, !has_opt::value>{});
-                this->super::template for_each_column_exept<Op, L>(l);
+                this->template for_each_if<std::integral_constant<bool, !tuple_helper::tuple_contains_type<Op, typename Cs::constraints_type>::value>...>(l, std::index_sequence_for<Cs...>{});
             }
             
             /**
-             *  Working version of `for_each_column_with`. Calls lambda if column has option and fire super's function.
+             *  Calls lambda with every column that has Op option.
              */
             template<class Op, class L>
             void for_each_column_with(L l) {
-                this->apply_to_col_if(l, tuple_helper::tuple_contains_type<Op, typename column_type::constraints_type>{});
-                this->super::template for_each_column_with<Op, L>(l);
+                this->template for_each_if<tuple_helper::tuple_contains_type<Op, typename Cs::constraints_type>...>(l, std::index_sequence_for<Cs...>{});
             }
             
             /**
-             *  Calls l(this->col) if H is primary_key_t
+             *  Calls lambda with every primary_key_t table constraint.
              */
             template<class L>
             void for_each_primary_key(L l) {
-                this->apply_to_col_if(l, internal::is_primary_key<H>{});
-                this->super::for_each_primary_key(l);
+                this->template for_each_if<internal::is_primary_key<Cs>...>(l, std::index_sequence_for<Cs...>{});
             }
             
-            template<class L>
-            void apply_to_col_if(L& l, std::true_type) {
-                l(this->col);
+        protected:
+            
+            /**
+             *  Calls l(std::get<I>(this->columns)) for every I which Conditions value is true.
+             *  Conditions and I must be of the same size.
+             */
+            template<class ...Conditions, class L, size_t ...I>
+            void for_each_if(L &l, std::index_sequence<I...>) {
+                int _[] = {0, (this->apply_to_col_if(l, std::get<I>(this->columns), Conditions{}), int{})...};
+                (void)_;
             }
             
-            template<class L>
-            void apply_to_col_if(L&, std::false_type) {}
+            template<class L, class C>
+            void apply_to_col_if(L& l, C &c, std::true_type) {
+                l(c);
+            }
             
-        private:
-            using super = table_impl<T...>;
+            template<class L, class C>
+            void apply_to_col_if(L&, C &, std::false_type) {}
         };
     }
 }
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <sqlite3.h>
+#include <atomic>   //  std::atomic
+
+#include "sqlite_type.h"
+#include "profiler.h"
+#include "slow_query_log.h"
+#include "statement_stats.h"
+#include "workload_recorder.h"
+
+namespace sqlite_orm {
+    
+    namespace internal {
+        
+        /**
+         *  Context of `sqlite3_trace_v2` callback registered on every storage connection. SQLite allows
+         *  one trace callback per connection so all tracing consumers live here. Is shared between storage
+         *  copies and connections keep raw pointer to it.
+         */
+        struct tracer {
+            profiler queryProfiler;
+            std::atomic<bool> isProfilingEnabled{false};
+            
+            slow_query_log slowQueryLog;
+            std::atomic<bool> isSlowQueryLogEnabled{false};
+            
+            statement_stats_collector statementStats;
+            std::atomic<bool> isStatementStatsEnabled{false};
+            
+            workload_recorder workloadRecorder;
+            std::atomic<bool> isRecording{false};
+            
+            /**
+             *  @return trace events mask required by enabled consumers. 0 if tracing is not needed.
+             */
+            unsigned mask() const {
+                unsigned res = 0;
+#if SQLITE_VERSION_NUMBER >= 3014000
+                if(this->isProfilingEnabled){
+                    res |= SQLITE_TRACE_PROFILE | SQLITE_TRACE_ROW;
+                }
+                if(this->isSlowQueryLogEnabled || this->isStatementStatsEnabled || this->isRecording){
+                    res |= SQLITE_TRACE_PROFILE;
+                }
+#endif
+                return res;
+            }
+            
+            /**
+             *  Registers or unregisters trace callback according to enabled consumers.
+             */
+            void register_on(sqlite3 *db) {
+#if SQLITE_VERSION_NUMBER >= 3014000
+                if(auto m = this->mask()){
+                    sqlite3_trace_v2(db, m, callback, this);
+                }else{
+                    sqlite3_trace_v2(db, 0, nullptr, nullptr);
+                }
+#else
+                (void)db;
+#endif
+            }
+            
+#if SQLITE_VERSION_NUMBER >= 3014000
+            static int callback(unsigned type, void *context, void *p, void *x) {
+                auto &t = *(tracer*)context;
+                auto stmt = (sqlite3_stmt*)p;
+                switch(type){
+                    case SQLITE_TRACE_ROW:{
+                        if(t.isProfilingEnabled){
+                            t.queryProfiler.on_row(stmt);
+                        }
+                    }break;
+                    case SQLITE_TRACE_PROFILE:{
+                        auto nanoseconds = static_cast<uint64>(*(sqlite3_int64*)x);
+                        if(t.isProfilingEnabled){
+                            t.queryProfiler.on_profile(stmt, nanoseconds);
+                        }
+                        if(t.isSlowQueryLogEnabled){
+                            t.slowQueryLog.on_profile(stmt, nanoseconds);
+                        }
+                        if(t.isStatementStatsEnabled){
+                            t.statementStats.on_profile(stmt);
+                        }
+                        if(t.isRecording){
+                            t.workloadRecorder.on_profile(stmt, nanoseconds);
+                        }
+                    }break;
+                }
+                return 0;
+            }
+#endif
+        };
+    }
+}
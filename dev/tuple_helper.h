@@ -1,71 +1,60 @@
 #pragma once
 
 #include <tuple>    //  std::tuple
-#include <type_traits>  //  std::false_type, std::true_type
-#include <utility>  //  std::index_sequence, std::index_sequence_for
+#include <type_traits>  //  std::integral_constant, std::is_same
+#include <utility>  //  std::index_sequence, std::index_sequence_for, std::integer_sequence
 
 namespace sqlite_orm {
     
-    //  got from here http://stackoverflow.com/questions/25958259/how-do-i-find-out-if-a-tuple-contains-a-type
     namespace tuple_helper {
         
         template <typename T, typename Tuple>
         struct has_type;
         
-        template <typename T>
-        struct has_type<T, std::tuple<>> : std::false_type {};
-        
-        template <typename T, typename U, typename... Ts>
-        struct has_type<T, std::tuple<U, Ts...>> : has_type<T, std::tuple<Ts...>> {};
-        
+        /**
+         *  Is true if T is one of Ts. Compares two bool sequences shifted by one element instead of
+         *  recursive instantiation per tuple element.
+         */
         template <typename T, typename... Ts>
-        struct has_type<T, std::tuple<T, Ts...>> : std::true_type {};
+        struct has_type<T, std::tuple<Ts...>> : std::integral_constant<bool, !std::is_same<std::integer_sequence<bool, false, std::is_same<T, Ts>::value...>, std::integer_sequence<bool, std::is_same<T, Ts>::value..., false>>::value> {};
         
         template <typename T, typename Tuple>
         using tuple_contains_type = typename has_type<T, Tuple>::type;
         
+        template <class F, typename T, std::size_t... I>
+        void tuple_for_each_impl(F&& f, const T& t, std::index_sequence<I...>){
+            int _[] = { 0, (f(std::get<I>(t)), int{}) ... };
+            (void)_;
+        }
+        
+        template <typename F, typename ...Args>
+        void tuple_for_each(const std::tuple<Args...>& t, F&& f){
+            tuple_for_each_impl(std::forward<F>(f), t, std::index_sequence_for<Args...>{});
+        }
+        
+        /**
+         *  Calls lambda with every element of a tuple. Elements are visited from the last one to the first one
+         *  if `reverse` is true (default) and from the first one to the last one otherwise. N is index of the
+         *  last element and is kept for compatibility.
+         */
         template<size_t N, class ...Args>
         struct iterator {
             
             template<class L>
             void operator()(const std::tuple<Args...> &t, L l, bool reverse = true) {
                 if(reverse){
-                    l(std::get<N>(t));
-                    iterator<N - 1, Args...>()(t, l, reverse);
+                    this->reversed(t, l, std::index_sequence_for<Args...>{});
                 }else{
-                    iterator<N - 1, Args...>()(t, l, reverse);
-                    l(std::get<N>(t));
+                    tuple_for_each(t, l);
                 }
             }
-        };
-        
-        template<class ...Args>
-        struct iterator<0, Args...>{
-            
-            template<class L>
-            void operator()(const std::tuple<Args...> &t, L l, bool /*reverse*/ = true) {
-                l(std::get<0>(t));
-            }
-        };
-        
-        template<size_t N>
-        struct iterator<N> {
             
-            template<class L>
-            void operator()(const std::tuple<> &, L, bool /*reverse*/ = true) {
-                //..
+        protected:
+            template<class L, size_t ...I>
+            void reversed(const std::tuple<Args...> &t, L &l, std::index_sequence<I...>) {
+                int _[] = { 0, (l(std::get<sizeof...(Args) - 1 - I>(t)), int{}) ... };
+                (void)_;
             }
         };
-        
-        template <class F, typename T, std::size_t... I>
-        void tuple_for_each_impl(F&& f, const T& t, std::index_sequence<I...>){
-            int _[] = { (f(std::get<I>(t)), int{}) ... };
-            (void)_;
-        }
-        
-        template <typename F, typename ...Args>
-        void tuple_for_each(const std::tuple<Args...>& t, F&& f){
-            tuple_for_each_impl(std::forward<F>(f), t, std::index_sequence_for<Args...>{});
-        }
     }
 }
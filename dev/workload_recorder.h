@@ -0,0 +1,233 @@
+#pragma once
+
+#include <sqlite3.h>
+#include <string>   //  std::string
+#include <vector>   //  std::vector
+#include <unordered_map>    //  std::unordered_map
+#include <fstream>  //  std::ofstream, std::ifstream
+#include <mutex>    //  std::mutex, std::lock_guard
+#include <chrono>   //  std::chrono::steady_clock, std::chrono::nanoseconds
+#include <system_error> //  std::system_error, std::error_code, std::generic_category
+#include <cerrno>   //  errno
+#include <cstring>  //  std::memcmp
+
+#include "sqlite_type.h"
+#include "error_code.h"
+
+namespace sqlite_orm {
+    
+    /**
+     *  Statement recorded by `storage_t::start_recording`.
+     */
+    struct workload_record {
+        
+        /**
+         *  Time since recording started when statement began
+         */
+        std::chrono::nanoseconds offset;
+        
+        /**
+         *  Statement execution time
+         */
+        std::chrono::nanoseconds elapsed;
+        
+        /**
+         *  Statement text with bound values (`sqlite3_expanded_sql`)
+         */
+        std::string sql;
+        
+        /**
+         *  Statement text as it was prepared (`sqlite3_sql`)
+         */
+        std::string prepared_sql;
+    };
+    
+    namespace internal {
+        
+        /**
+         *  Workload log format: 8 bytes signature followed by records. Every record starts with a varint kind:
+         *  0 - prepared statement text: varint text id, varint length, text bytes. Text is written once before
+         *  its first use.
+         *  1 - statement execution: varint text id, varint offset in nanoseconds, varint elapsed nanoseconds,
+         *  varint length and bytes of the text with bound values. Length is 0 if the text equals prepared one.
+         */
+        struct workload_log_format {
+            static const char* signature() {
+                return "SQLORMW2";
+            }
+            
+            static const size_t signature_size = 8;
+            
+            enum : uint64 {
+                text_record = 0,
+                statement_record = 1,
+            };
+            
+            static void write_varint(std::ostream &os, uint64 value) {
+                while(value >= 0x80) {
+                    os.put(static_cast<char>((value & 0x7f) | 0x80));
+                    value >>= 7;
+                }
+                os.put(static_cast<char>(value));
+            }
+            
+            static bool read_varint(std::istream &is, uint64 &value) {
+                value = 0;
+                for(auto shift = 0; shift < 64; shift += 7) {
+                    auto c = is.get();
+                    if(c == std::char_traits<char>::eof()) {
+                        return false;
+                    }
+                    value |= static_cast<uint64>(c & 0x7f) << shift;
+                    if(!(c & 0x80)) {
+                        return true;
+                    }
+                }
+                return false;
+            }
+        };
+        
+        /**
+         *  Writes statements finished by storage connections into a workload log. Is fed by `sqlite3_trace_v2`
+         *  callback so it must be thread safe.
+         */
+        struct workload_recorder {
+            
+            void start(const std::string &path) {
+                std::lock_guard<std::mutex> lock(this->mutex);
+                this->file.close();
+                this->file.clear();
+                this->file.open(path, std::ios::binary | std::ios::trunc);
+                if(!this->file) {
+                    throw std::system_error(std::error_code(errno, std::generic_category()), path);
+                }
+                this->file.write(workload_log_format::signature(), workload_log_format::signature_size);
+                this->textIds.clear();
+                this->startTime = std::chrono::steady_clock::now();
+            }
+            
+            void stop() {
+                std::lock_guard<std::mutex> lock(this->mutex);
+                this->file.close();
+                this->textIds.clear();
+            }
+            
+            /**
+             *  SQLITE_TRACE_PROFILE event
+             */
+            void on_profile(sqlite3_stmt *stmt, uint64 nanoseconds) {
+                std::string preparedSql;
+                if(auto rawSql = sqlite3_sql(stmt)) {
+                    preparedSql = rawSql;
+                }
+                std::string sql;
+#if SQLITE_VERSION_NUMBER >= 3014000
+                if(sqlite3_bind_parameter_count(stmt)) {
+                    if(auto expandedSql = sqlite3_expanded_sql(stmt)) {
+                        sql = expandedSql;
+                        sqlite3_free(expandedSql);
+                    }
+                }
+#endif
+                auto now = std::chrono::steady_clock::now();
+                std::lock_guard<std::mutex> lock(this->mutex);
+                if(!this->file.is_open()) {
+                    return;
+                }
+                auto sinceStart = static_cast<uint64>(std::chrono::duration_cast<std::chrono::nanoseconds>(now - this->startTime).count());
+                auto offset = sinceStart > nanoseconds ? sinceStart - nanoseconds : 0;
+                auto it = this->textIds.find(preparedSql);
+                if(it == this->textIds.end()) {
+                    auto id = static_cast<uint64>(this->textIds.size());
+                    it = this->textIds.insert({std::move(preparedSql), id}).first;
+                    workload_log_format::write_varint(this->file, workload_log_format::text_record);
+                    workload_log_format::write_varint(this->file, id);
+                    workload_log_format::write_varint(this->file, it->first.length());
+                    this->file.write(it->first.data(), it->first.length());
+                }
+                if(sql == it->first) {
+                    sql.clear();
+                }
+                workload_log_format::write_varint(this->file, workload_log_format::statement_record);
+                workload_log_format::write_varint(this->file, it->second);
+                workload_log_format::write_varint(this->file, offset);
+                workload_log_format::write_varint(this->file, nanoseconds);
+                workload_log_format::write_varint(this->file, sql.length());
+                this->file.write(sql.data(), sql.length());
+            }
+            
+        protected:
+            std::mutex mutex;
+            std::ofstream file;
+            
+            /**
+             *  Ids of prepared statements texts. Bound values are not a part of a key so the map size is limited
+             *  by the count of different statements the application prepares.
+             */
+            std::unordered_map<std::string, uint64> textIds;
+            std::chrono::steady_clock::time_point startTime;
+        };
+    }
+    
+    /**
+     *  Reads a workload log written by `storage_t::start_recording`.
+     *  throws std::system_error with std::generic_category if file cannot be opened and
+     *  with orm_error_category if file is not a workload log or is corrupted.
+     */
+    inline std::vector<workload_record> read_workload(const std::string &path) {
+        using format = internal::workload_log_format;
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        if(!file) {
+            throw std::system_error(std::error_code(errno, std::generic_category()), path);
+        }
+        auto fileSize = static_cast<uint64>(file.tellg());
+        file.seekg(0);
+        char signature[format::signature_size];
+        if(!file.read(signature, format::signature_size) || std::memcmp(signature, format::signature(), format::signature_size)) {
+            throw std::system_error(std::make_error_code(orm_error_code::incorrect_workload_log));
+        }
+        std::vector<workload_record> res;
+        std::vector<std::string> texts;
+        uint64 kind;
+        while(format::read_varint(file, kind)) {
+            uint64 id;
+            if(!format::read_varint(file, id)) {
+                throw std::system_error(std::make_error_code(orm_error_code::incorrect_workload_log));
+            }
+            if(kind == format::text_record) {
+                uint64 length;
+                
+                //  length is checked before allocation cause it is read from a possibly corrupted file
+                if(!format::read_varint(file, length) || id != texts.size() || length > fileSize - static_cast<uint64>(file.tellg())) {
+                    throw std::system_error(std::make_error_code(orm_error_code::incorrect_workload_log));
+                }
+                std::string text(static_cast<size_t>(length), '\0');
+                if(!file.read(&text[0], static_cast<std::streamsize>(length))) {
+                    throw std::system_error(std::make_error_code(orm_error_code::incorrect_workload_log));
+                }
+                texts.push_back(std::move(text));
+            }else if(kind == format::statement_record) {
+                uint64 offset;
+                uint64 elapsed;
+                uint64 length;
+                if(id >= texts.size() || !format::read_varint(file, offset) || !format::read_varint(file, elapsed) || !format::read_varint(file, length) || length > fileSize - static_cast<uint64>(file.tellg())) {
+                    throw std::system_error(std::make_error_code(orm_error_code::incorrect_workload_log));
+                }
+                auto &preparedSql = texts[static_cast<size_t>(id)];
+                std::string sql;
+                if(length) {
+                    sql.resize(static_cast<size_t>(length));
+                    if(!file.read(&sql[0], static_cast<std::streamsize>(length))) {
+                        throw std::system_error(std::make_error_code(orm_error_code::incorrect_workload_log));
+                    }
+                }else{
+                    sql = preparedSql;
+                }
+                res.push_back({std::chrono::nanoseconds(offset), std::chrono::nanoseconds(elapsed), std::move(sql), preparedSql});
+            }else{
+                throw std::system_error(std::make_error_code(orm_error_code::incorrect_workload_log));
+            }
+        }
+        return res;
+    }
+}
@@ -32,6 +32,8 @@ namespace sqlite_orm {
         table_has_no_primary_key_column,
         cannot_start_a_transaction_within_a_transaction,
         no_active_transaction,
+        incorrect_workload_log,
+        incorrect_page_token,
     };
     
 }
@@ -65,6 +67,10 @@ namespace sqlite_orm {
                     return "Cannot start a transaction within a transaction";
                 case orm_error_code::no_active_transaction:
                     return "No active transaction";
+                case orm_error_code::incorrect_workload_log:
+                    return "Incorrect workload log";
+                case orm_error_code::incorrect_page_token:
+                    return "Incorrect page token";
                 default:
                     return "unknown error";
             }
@@ -186,72 +192,61 @@ namespace sqlite_orm {
 #pragma once
 
 #include <tuple>    //  std::tuple
-#include <type_traits>  //  std::false_type, std::true_type
-#include <utility>  //  std::index_sequence, std::index_sequence_for
+#include <type_traits>  //  std::integral_constant, std::is_same
+#include <utility>  //  std::index_sequence, std::index_sequence_for, std::integer_sequence
 
 namespace sqlite_orm {
     
-    //  got from here http://stackoverflow.com/questions/25958259/how-do-i-find-out-if-a-tuple-contains-a-type
     namespace tuple_helper {
         
         template <typename T, typename Tuple>
         struct has_type;
         
-        template <typename T>
-        struct has_type<T, std::tuple<>> : std::false_type {};
-        
-        template <typename T, typename U, typename... Ts>
-        struct has_type<T, std::tuple<U, Ts...>> : has_type<T, std::tuple<Ts...>> {};
-        
+        /**
+         *  Is true if T is one of Ts. Compares two bool sequences shifted by one element instead of
+         *  recursive instantiation per tuple element.
+         */
         template <typename T, typename... Ts>
-        struct has_type<T, std::tuple<T, Ts...>> : std::true_type {};
+        struct has_type<T, std::tuple<Ts...>> : std::integral_constant<bool, !std::is_same<std::integer_sequence<bool, false, std::is_same<T, Ts>::value...>, std::integer_sequence<bool, std::is_same<T, Ts>::value..., false>>::value> {};
         
         template <typename T, typename Tuple>
         using tuple_contains_type = typename has_type<T, Tuple>::type;
         
+        template <class F, typename T, std::size_t... I>
+        void tuple_for_each_impl(F&& f, const T& t, std::index_sequence<I...>){
+            int _[] = { 0, (f(std::get<I>(t)), int{}) ... };
+            (void)_;
+        }
+        
+        template <typename F, typename ...Args>
+        void tuple_for_each(const std::tuple<Args...>& t, F&& f){
+            tuple_for_each_impl(std::forward<F>(f), t, std::index_sequence_for<Args...>{});
+        }
+        
+        /**
+         *  Calls lambda with every element of a tuple. Elements are visited from the last one to the first one
+         *  if `reverse` is true (default) and from the first one to the last one otherwise. N is index of the
+         *  last element and is kept for compatibility.
+         */
         template<size_t N, class ...Args>
         struct iterator {
             
             template<class L>
             void operator()(const std::tuple<Args...> &t, L l, bool reverse = true) {
                 if(reverse){
-                    l(std::get<N>(t));
-                    iterator<N - 1, Args...>()(t, l, reverse);
+                    this->reversed(t, l, std::index_sequence_for<Args...>{});
                 }else{
-                    iterator<N - 1, Args...>()(t, l, reverse);
-                    l(std::get<N>(t));
+                    tuple_for_each(t, l);
                 }
             }
-        };
-        
-        template<class ...Args>
-        struct iterator<0, Args...>{
-            
-            template<class L>
-            void operator()(const std::tuple<Args...> &t, L l, bool /*reverse*/ = true) {
-                l(std::get<0>(t));
-            }
-        };
-        
-        template<size_t N>
-        struct iterator<N> {
             
-            template<class L>
-            void operator()(const std::tuple<> &, L, bool /*reverse*/ = true) {
-                //..
+        protected:
+            template<class L, size_t ...I>
+            void reversed(const std::tuple<Args...> &t, L &l, std::index_sequence<I...>) {
+                int _[] = { 0, (l(std::get<sizeof...(Args) - 1 - I>(t)), int{}) ... };
+                (void)_;
             }
         };
-        
-        template <class F, typename T, std::size_t... I>
-        void tuple_for_each_impl(F&& f, const T& t, std::index_sequence<I...>){
-            int _[] = { (f(std::get<I>(t)), int{}) ... };
-            (void)_;
-        }
-        
-        template <typename F, typename ...Args>
-        void tuple_for_each(const std::tuple<Args...>& t, F&& f){
-            tuple_for_each_impl(std::forward<F>(f), t, std::index_sequence_for<Args...>{});
-        }
     }
 }
 #pragma once
@@ -1321,6 +1316,49 @@ namespace sqlite_orm {
 }
 #pragma once
 
+#include <memory>   //  std::shared_ptr, std::unique_ptr
+
+namespace sqlite_orm {
+    
+    /**
+     *  Is used to compare members mapped to objects in storage_t::update(o, original) member function
+     *  to find out which columns are changed. Other developers can create own specialization to compare
+     *  custom types which have no operator==
+     */
+    template<class T>
+    struct field_comparator {
+        bool operator()(const T &lhs, const T &rhs) const {
+            return lhs == rhs;
+        }
+    };
+    
+    /**
+     *  Pointers are compared by pointed values cause they are stored as values
+     */
+    template<class T>
+    struct field_comparator<std::shared_ptr<T>> {
+        bool operator()(const std::shared_ptr<T> &lhs, const std::shared_ptr<T> &rhs) const {
+            if(lhs && rhs){
+                return field_comparator<T>()(*lhs, *rhs);
+            }else{
+                return !lhs && !rhs;
+            }
+        }
+    };
+    
+    template<class T>
+    struct field_comparator<std::unique_ptr<T>> {
+        bool operator()(const std::unique_ptr<T> &lhs, const std::unique_ptr<T> &rhs) const {
+            if(lhs && rhs){
+                return field_comparator<T>()(*lhs, *rhs);
+            }else{
+                return !lhs && !rhs;
+            }
+        }
+    };
+}
+#pragma once
+
 #include <string>   //  std::string
 
 // #include "collate_argument.h"
@@ -2315,6 +2353,8 @@ namespace sqlite_orm {
 }
 #pragma once
 
+#include <type_traits>  //  std::true_type, std::false_type
+
 // #include "conditions.h"
 
 
@@ -2322,113 +2362,52 @@ namespace sqlite_orm {
     
     namespace internal {
         
-        template<class ...Args>
-        struct join_iterator {
-            
-            template<class L>
-            void operator()(L) {
-                //..
-            }
-        };
+        /**
+         *  Join traits. Common case.
+         */
+        template<class T>
+        struct is_join : std::false_type {};
         
-        template<>
-        struct join_iterator<> {
-            
-            template<class L>
-            void operator()(L) {
-                //..
-            }
-        };
+        template<class T>
+        struct is_join<conditions::cross_join_t<T>> : std::true_type {};
         
-        template<class H, class ...Tail>
-        struct join_iterator<H, Tail...> : public join_iterator<Tail...>{
-            using super = join_iterator<Tail...>;
-            
-            H h;
-            
-            template<class L>
-            void operator()(L l) {
-                this->super::operator()(l);
-            }
-            
-        };
+        template<class T>
+        struct is_join<conditions::natural_join_t<T>> : std::true_type {};
         
-        template<class T, class ...Tail>
-        struct join_iterator<conditions::cross_join_t<T>, Tail...> : public join_iterator<Tail...>{
-            using super = join_iterator<Tail...>;
-            
-            conditions::cross_join_t<T> h;
-            
-            template<class L>
-            void operator()(L l) {
-                l(h);
-                this->super::operator()(l);
-            }
-        };
+        template<class T, class O>
+        struct is_join<conditions::left_join_t<T, O>> : std::true_type {};
         
-        template<class T, class ...Tail>
-        struct join_iterator<conditions::natural_join_t<T>, Tail...> : public join_iterator<Tail...>{
-            using super = join_iterator<Tail...>;
-            
-            conditions::natural_join_t<T> h;
-            
-            template<class L>
-            void operator()(L l) {
-                l(h);
-                this->super::operator()(l);
-            }
-        };
+        template<class T, class O>
+        struct is_join<conditions::join_t<T, O>> : std::true_type {};
         
-        template<class T, class O, class ...Tail>
-        struct join_iterator<conditions::left_join_t<T, O>, Tail...> : public join_iterator<Tail...> {
-            using super = join_iterator<Tail...>;
-            
-            conditions::left_join_t<T, O> h;
-            
-            template<class L>
-            void operator()(L l) {
-                l(h);
-                this->super::operator()(l);
-            }
-        };
+        template<class T, class O>
+        struct is_join<conditions::left_outer_join_t<T, O>> : std::true_type {};
         
-        template<class T, class O, class ...Tail>
-        struct join_iterator<conditions::join_t<T, O>, Tail...> : public join_iterator<Tail...> {
-            using super = join_iterator<Tail...>;
-            
-            conditions::join_t<T, O> h;
-            
-            template<class L>
-            void operator()(L l) {
-                l(h);
-                this->super::operator()(l);
-            }
-        };
+        template<class T, class O>
+        struct is_join<conditions::inner_join_t<T, O>> : std::true_type {};
         
-        template<class T, class O, class ...Tail>
-        struct join_iterator<conditions::left_outer_join_t<T, O>, Tail...> : public join_iterator<Tail...> {
-            using super = join_iterator<Tail...>;
-            
-            conditions::left_outer_join_t<T, O> h;
+        /**
+         *  Calls lambda with a value of every join type from Args. Other arguments are skipped.
+         */
+        template<class ...Args>
+        struct join_iterator {
             
             template<class L>
             void operator()(L l) {
-                l(h);
-                this->super::operator()(l);
+                int _[] = {0, (this->template apply_if<Args>(l, is_join<Args>{}), int{})...};
+                (void)_;
+                (void)l;
             }
-        };
-        
-        template<class T, class O, class ...Tail>
-        struct join_iterator<conditions::inner_join_t<T, O>, Tail...> : public join_iterator<Tail...> {
-            using super = join_iterator<Tail...>;
             
-            conditions::inner_join_t<T, O> h;
-            
-            template<class L>
-            void operator()(L l) {
-                l(h);
-                this->super::operator()(l);
+        protected:
+            template<class J, class L>
+            void apply_if(L &l, std::true_type) {
+                J j{};
+                l(j);
             }
+            
+            template<class J, class L>
+            void apply_if(L &, std::false_type) {}
         };
     }
 }
@@ -3100,6 +3079,30 @@ namespace sqlite_orm {
             conditions_type conditions;
         };
         
+        /**
+         *  `SELECT * FROM T` expression object. Is not executed by itself: is used with
+         *  `storage_t::sql` and `storage_t::explain`.
+         */
+        template<class T, class ...Args>
+        struct get_all_t {
+            using type = T;
+            using conditions_type = std::tuple<Args...>;
+            
+            conditions_type conditions;
+        };
+        
+        /**
+         *  `SELECT COUNT(*) FROM T` expression object. Is not executed by itself: is used with
+         *  `storage_t::sql` and `storage_t::explain`.
+         */
+        template<class T, class ...Args>
+        struct count_all_t {
+            using type = T;
+            using conditions_type = std::tuple<Args...>;
+            
+            conditions_type conditions;
+        };
+        
         /**
          *  Union object type.
          */
@@ -3115,7 +3118,7 @@ namespace sqlite_orm {
             union_t(left_type l, right_type r, decltype(all) all_): left(std::move(l)), right(std::move(r)), all(all_) {}
             
             union_t(left_type l, right_type r): left(std::move(l)), right(std::move(r)) {}
-
+            
             operator std::string() const {
                 if(!this->all){
                     return "UNION";
@@ -3187,6 +3190,24 @@ namespace sqlite_orm {
         return {std::move(t), std::make_tuple<Args...>(std::forward<Args>(args)...)};
     }
     
+    /**
+     *  Public function for `storage.get_all<T>(args...)` expression preview.
+     *  Example: storage.explain(get_all<User>(where(c(&User::name) == "Bob")));
+     */
+    template<class T, class ...Args>
+    internal::get_all_t<T, Args...> get_all(Args ...args) {
+        return {std::make_tuple<Args...>(std::forward<Args>(args)...)};
+    }
+    
+    /**
+     *  Public function for `storage.count<T>(args...)` expression preview.
+     *  Example: storage.sql(count<User>(where(is_null(&User::email))));
+     */
+    template<class T, class ...Args>
+    internal::count_all_t<T, Args...> count(Args ...args) {
+        return {std::make_tuple<Args...>(std::forward<Args>(args)...)};
+    }
+    
     /**
      *  Public function for UNION operator.
      *  lhs and rhs are subselect objects.
@@ -3210,8 +3231,13 @@ namespace sqlite_orm {
 #pragma once
 
 #include <string>   //  std::string
+#include <memory>   //  std::shared_ptr
+#include <vector>   //  std::vector
 #include <sqlite3.h>
 #include <system_error> //  std::error_code, std::system_error
+#include <map>  //  std::map
+#include <set>  //  std::set
+#include <utility>  //  std::move
 
 // #include "error_code.h"
 
@@ -3229,7 +3255,15 @@ namespace sqlite_orm {
                 }
             }
             
+            database_connection(const database_connection &) = delete;
+            
             ~database_connection() {
+                for(auto &p : this->statements) {
+                    sqlite3_finalize(p.second);
+                }
+                for(auto &p : this->keyedStatements) {
+                    sqlite3_finalize(p.second);
+                }
                 sqlite3_close(this->db);
             }
             
@@ -3237,8 +3271,108 @@ namespace sqlite_orm {
                 return this->db;
             }
             
+            /**
+             *  Returns prepared statement for a given query. Statement is prepared once per connection
+             *  and is reused by subsequent calls with the same query text so query must not contain any
+             *  values - bind them instead. Statement is owned by connection: do not finalize it, reset it
+             *  after usage with `statement_resetter` instead.
+             */
+            sqlite3_stmt* get_statement(const std::string &query) {
+                auto it = this->statements.find(query);
+                if(it != this->statements.end()){
+                    return it->second;
+                }
+                sqlite3_stmt *stmt = nullptr;
+                if(sqlite3_prepare_v2(this->db, query.c_str(), -1, &stmt, nullptr) == SQLITE_OK) {
+                    this->statements.insert({query, stmt});
+                    return stmt;
+                }else{
+                    throw std::system_error(std::error_code(sqlite3_errcode(this->db), get_sqlite_error_category()));
+                }
+            }
+            
+            /**
+             *  The same as `get_statement` but statement is looked up by `key` so `makeQuery` building
+             *  query text is called only once per connection and key.
+             */
+            template<class F>
+            sqlite3_stmt* get_statement(const std::string &key, const F &makeQuery) {
+                auto it = this->keyedStatements.find(key);
+                if(it != this->keyedStatements.end()){
+                    return it->second;
+                }
+                auto query = makeQuery();
+                sqlite3_stmt *stmt = nullptr;
+                if(sqlite3_prepare_v2(this->db, query.c_str(), -1, &stmt, nullptr) == SQLITE_OK) {
+                    this->keyedStatements.insert({key, stmt});
+                    return stmt;
+                }else{
+                    throw std::system_error(std::error_code(sqlite3_errcode(this->db), get_sqlite_error_category()));
+                }
+            }
+            
+            /**
+             *  Returns id of a temp table for `in` condition values which is not used by any alive statement
+             *  of this connection. Released ids are reused starting from the smallest one so query texts
+             *  stay the same from call to call.
+             */
+            int acquire_in_table() {
+                if(!this->freeInTables.empty()){
+                    auto it = this->freeInTables.begin();
+                    auto id = *it;
+                    this->freeInTables.erase(it);
+                    return id;
+                }
+                return this->inTablesCount++;
+            }
+            
+            /**
+             *  Marks temp table with id `id` as free. Must be called once statement using it is finished.
+             */
+            void release_in_table(int id) {
+                this->freeInTables.insert(id);
+            }
+            
         protected:
             sqlite3 *db = nullptr;
+            
+            /**
+             *  Cached statements. Key is a query text.
+             */
+            std::map<std::string, sqlite3_stmt*> statements;
+            
+            /**
+             *  Cached statements looked up by a key. See `get_statement(key, makeQuery)`.
+             */
+            std::map<std::string, sqlite3_stmt*> keyedStatements;
+            
+            /**
+             *  Count of temp tables created for `in` conditions and ids of ones not used right now.
+             */
+            int inTablesCount = 0;
+            std::set<int> freeInTables;
+        };
+        
+        /**
+         *  Is passed down while a query is built. `in` conditions put their values into temp tables of
+         *  `connection` and keep their ids here so tables are released when the statement is finished: keep
+         *  context alive as long as the statement. If `connection` is null values are written into query text.
+         */
+        struct query_context {
+            std::shared_ptr<database_connection> connection;
+            std::vector<int> inTables;
+            
+            query_context(std::shared_ptr<database_connection> connection_): connection(std::move(connection_)) {}
+            
+            query_context(const query_context &) = delete;
+            
+            query_context(query_context &&) = default;
+            
+            ~query_context() {
+                for(auto id : this->inTables) {
+                    this->connection->release_in_table(id);
+                }
+            }
         };
     }
 }
@@ -3319,6 +3453,27 @@ namespace sqlite_orm {
 }
 #pragma once
 
+#include <sqlite3.h>
+
+namespace sqlite_orm {
+    
+    /**
+     *  Guard class which resets and clears bindings of a cached `sqlite3_stmt` in dtor.
+     *  Is used instead of `statement_finalizer` with statements owned by `database_connection`.
+     */
+    struct statement_resetter {
+        sqlite3_stmt *stmt = nullptr;
+        
+        statement_resetter(decltype(stmt) stmt_): stmt(stmt_) {}
+        
+        inline ~statement_resetter() {
+            sqlite3_reset(this->stmt);
+            sqlite3_clear_bindings(this->stmt);
+        }
+    };
+}
+#pragma once
+
 namespace sqlite_orm {
     
     /**
@@ -3799,6 +3954,9 @@ namespace sqlite_orm {
 }
 #pragma once
 
+#ifndef SQLITE_ORM_SYNC_SCHEMA_RESULT_H
+#define SQLITE_ORM_SYNC_SCHEMA_RESULT_H
+
 #include <ostream>
 
 namespace sqlite_orm {
@@ -3838,6 +3996,22 @@ namespace sqlite_orm {
          *      4. data_type mismatch between table and storage.
          */
         dropped_and_recreated,
+        
+        /**
+         *  index from storage did not exist in db and was created
+         */
+        new_index_created,
+        
+        /**
+         *  index definition (columns, uniqueness, collation, order or condition) differs from storage
+         *  so index was dropped and created again
+         */
+        index_recreated,
+        
+        /**
+         *  index of a storage table exists in db but not in storage so it was dropped
+         */
+        index_dropped,
     };
     
     
@@ -3849,32 +4023,1479 @@ namespace sqlite_orm {
             case sync_schema_result::new_columns_added: return os << "new columns added";
             case sync_schema_result::new_columns_added_and_old_columns_removed: return os << "old excess columns removed and new columns added";
             case sync_schema_result::dropped_and_recreated: return os << "old table dropped and recreated";
+            case sync_schema_result::new_index_created: return os << "new index created";
+            case sync_schema_result::index_recreated: return os << "index dropped and recreated";
+            case sync_schema_result::index_dropped: return os << "excess index dropped";
         }
     }
 }
+
+#endif  //  SQLITE_ORM_SYNC_SCHEMA_RESULT_H
 #pragma once
 
-#include <tuple>    //  std::tuple, std::make_tuple
 #include <string>   //  std::string
+#include <chrono>   //  std::chrono::milliseconds
+
+// #include "sqlite_type.h"
+
 
 namespace sqlite_orm {
     
-    namespace internal {
+    /**
+     *  Online table migration state passed to a progress callback after every copied chunk.
+     *  See `storage_t::enable_online_migration`.
+     */
+    struct migration_progress {
         
-        template<class ...Cols>
-        struct index_t {
-            using columns_type = std::tuple<Cols...>;
-            using object_type = void;
-            
-            std::string name;
-            bool unique;
-            columns_type columns;
-            
-            template<class L>
-            void for_each_column_with_constraints(L) {}
-        };
-    }
+        /**
+         *  Name of table being migrated
+         */
+        std::string table_name;
+        
+        /**
+         *  Rows copied so far
+         */
+        int64 rows_copied;
+        
+        /**
+         *  Rows count at the moment migration started. Rows inserted later are copied too so
+         *  `rows_copied` may exceed it.
+         */
+        int64 rows_total;
+        
+        std::chrono::milliseconds elapsed;
+        
+        /**
+         *  Estimated time left based on average speed of copied chunks
+         */
+        std::chrono::milliseconds eta;
+    };
+}
+#pragma once
+
+#include <sqlite3.h>
+#include <string>   //  std::string
+#include <vector>   //  std::vector
+#include <map>  //  std::map
+#include <array>    //  std::array
+#include <mutex>    //  std::mutex, std::lock_guard
+#include <chrono>   //  std::chrono::nanoseconds
+#include <algorithm>    //  std::sort, std::max, std::min
+#include <cctype>   //  std::isdigit, std::isalpha, std::isalnum, std::isspace, std::toupper
+
+// #include "sqlite_type.h"
+
+
+namespace sqlite_orm {
+    
+    /**
+     *  Aggregated statistics of a normalized SQL statement collected by storage profiler.
+     *  See `storage_t::enable_profiling`.
+     */
+    struct query_profile {
+        
+        /**
+         *  Statement text with literals replaced with `?`
+         */
+        std::string sql;
+        
+        /**
+         *  How many times statement was executed
+         */
+        int64 calls;
+        
+        /**
+         *  Rows returned by all executions
+         */
+        int64 rows;
+        
+        std::chrono::nanoseconds total;
+        
+        /**
+         *  Median and 99th percentile latencies. Histogram based so precision is about 25%.
+         */
+        std::chrono::nanoseconds p50;
+        std::chrono::nanoseconds p99;
+        
+        std::chrono::nanoseconds max;
+    };
+    
+    namespace internal {
+        
+        /**
+         *  Logarithmic latency histogram: every power of two is split into 4 buckets.
+         */
+        struct latency_histogram {
+            
+            void add(uint64 value) {
+                ++this->buckets[index(value)];
+                ++this->count;
+            }
+            
+            /**
+             *  Returns upper bound of a bucket containing a given percentile (0 - 1).
+             */
+            uint64 percentile(double p) const {
+                if(!this->count){
+                    return 0;
+                }
+                auto rank = static_cast<uint64>(p * static_cast<double>(this->count - 1)) + 1;
+                uint64 seen = 0;
+                for(size_t i = 0; i < this->buckets.size(); ++i) {
+                    seen += this->buckets[i];
+                    if(seen >= rank) {
+                        return upper_bound(i);
+                    }
+                }
+                return upper_bound(this->buckets.size() - 1);
+            }
+            
+        protected:
+            std::array<uint64, 256> buckets{};
+            uint64 count = 0;
+            
+            static size_t index(uint64 value) {
+                if(value < 4){
+                    return static_cast<size_t>(value);
+                }
+                size_t msb = 0;
+                for(auto v = value; v > 1; v >>= 1) {
+                    ++msb;
+                }
+                auto sub = static_cast<size_t>((value >> (msb - 2)) & 3);
+                return msb * 4 + sub;
+            }
+            
+            static uint64 upper_bound(size_t index) {
+                if(index < 4){
+                    return index;
+                }
+                auto msb = index / 4;
+                auto sub = index % 4;
+                return ((4 + sub + 1) << (msb - 2)) - 1;
+            }
+        };
+        
+        /**
+         *  Collects statistics of statements executed by storage connections. Is fed by
+         *  `sqlite3_trace_v2` callback so it must be thread safe: storage may use several
+         *  connections from different threads.
+         */
+        struct profiler {
+            
+            /**
+             *  SQLITE_TRACE_ROW event
+             */
+            void on_row(sqlite3_stmt *stmt) {
+                std::lock_guard<std::mutex> lock(this->mutex);
+                ++this->rowsInProgress[stmt];
+            }
+            
+            /**
+             *  SQLITE_TRACE_PROFILE event. Fired once statement is finished.
+             */
+            void on_profile(sqlite3_stmt *stmt, uint64 nanoseconds) {
+                auto rawSql = sqlite3_sql(stmt);
+                auto sql = normalize_sql(rawSql ? rawSql : "");
+                std::lock_guard<std::mutex> lock(this->mutex);
+                auto &entry = this->entries[sql];
+                ++entry.calls;
+                entry.total += nanoseconds;
+                entry.max = std::max(entry.max, nanoseconds);
+                entry.histogram.add(nanoseconds);
+                auto rowsIt = this->rowsInProgress.find(stmt);
+                if(rowsIt != this->rowsInProgress.end()) {
+                    entry.rows += rowsIt->second;
+                    this->rowsInProgress.erase(rowsIt);
+                }
+            }
+            
+            /**
+             *  @return statistics of at most `topN` statements with the biggest total time.
+             */
+            std::vector<query_profile> snapshot(size_t topN) {
+                std::vector<query_profile> res;
+                {
+                    std::lock_guard<std::mutex> lock(this->mutex);
+                    res.reserve(this->entries.size());
+                    for(auto &p : this->entries) {
+                        auto &entry = p.second;
+                        
+                        //  bucket upper bounds may exceed the slowest call for a few samples
+                        res.push_back({
+                            p.first,
+                            entry.calls,
+                            entry.rows,
+                            std::chrono::nanoseconds(entry.total),
+                            std::chrono::nanoseconds(std::min(entry.histogram.percentile(0.5), entry.max)),
+                            std::chrono::nanoseconds(std::min(entry.histogram.percentile(0.99), entry.max)),
+                            std::chrono::nanoseconds(entry.max),
+                        });
+                    }
+                }
+                std::sort(res.begin(), res.end(), [](const query_profile &lhs, const query_profile &rhs) {
+                    return lhs.total > rhs.total;
+                });
+                if(res.size() > topN) {
+                    res.resize(topN);
+                }
+                return res;
+            }
+            
+            void reset() {
+                std::lock_guard<std::mutex> lock(this->mutex);
+                this->entries.clear();
+                this->rowsInProgress.clear();
+            }
+            
+            /**
+             *  Replaces numeric and string literals with `?` and collapses whitespaces so statements
+             *  which differ by inlined values only are aggregated together. Single quoted strings used
+             *  as identifiers (followed by `.` or preceded by FROM, INTO, JOIN, UPDATE, TABLE, ON) are kept.
+             *  Lists of literals like `IN (1, 2, 3)` are collapsed into a single `?`.
+             */
+            static std::string normalize_sql(const std::string &sql) {
+                std::string res;
+                res.reserve(sql.length());
+                
+                //  true after FROM, INTO etc keyword and inside comma separated list after it
+                auto identifierContext = false;
+                auto appendPlaceholder = [&res] {
+                    
+                    //  `?, ?` -> `?`
+                    auto end = res.find_last_not_of(' ');
+                    if(end != std::string::npos && res[end] == ',' && end > 0) {
+                        auto previous = res.find_last_not_of(' ', end - 1);
+                        if(previous != std::string::npos && res[previous] == '?') {
+                            res.resize(previous + 1);
+                            return;
+                        }
+                    }
+                    res += '?';
+                };
+                for(size_t i = 0; i < sql.length(); ) {
+                    auto c = sql[i];
+                    if(std::isspace(static_cast<unsigned char>(c))) {
+                        if(!res.empty() && res.back() != ' ') {
+                            res += ' ';
+                        }
+                        ++i;
+                    }else if(c == '\'') {
+                        auto end = i + 1;
+                        while(end < sql.length()) {
+                            if(sql[end] == '\'') {
+                                if(end + 1 < sql.length() && sql[end + 1] == '\'') {
+                                    end += 2;
+                                    continue;
+                                }
+                                break;
+                            }
+                            ++end;
+                        }
+                        auto next = end + 1;
+                        if(identifierContext || (next < sql.length() && sql[next] == '.')) {
+                            res.append(sql, i, next - i);
+                        }else{
+                            appendPlaceholder();
+                        }
+                        i = next;
+                    }else if(c == '"' || c == '`' || c == '[') {
+                        auto closing = c == '[' ? ']' : c;
+                        auto end = sql.find(closing, i + 1);
+                        if(end == std::string::npos) {
+                            end = sql.length() - 1;
+                        }
+                        res.append(sql, i, end - i + 1);
+                        i = end + 1;
+                    }else if(std::isalpha(static_cast<unsigned char>(c)) || c == '_') {
+                        auto end = i;
+                        std::string word;
+                        while(end < sql.length() && (std::isalnum(static_cast<unsigned char>(sql[end])) || sql[end] == '_' || sql[end] == '$')) {
+                            word += static_cast<char>(std::toupper(static_cast<unsigned char>(sql[end])));
+                            ++end;
+                        }
+                        identifierContext = word == "FROM" || word == "INTO" || word == "JOIN" || word == "UPDATE" || word == "TABLE" || word == "ON";
+                        res.append(sql, i, end - i);
+                        i = end;
+                    }else if(std::isdigit(static_cast<unsigned char>(c))) {
+                        auto end = i + 1;
+                        while(end < sql.length() && (std::isalnum(static_cast<unsigned char>(sql[end])) || sql[end] == '.')) {
+                            ++end;
+                        }
+                        appendPlaceholder();
+                        identifierContext = false;
+                        i = end;
+                    }else{
+                        if(c != ','){
+                            identifierContext = false;
+                        }
+                        res += c;
+                        ++i;
+                    }
+                }
+                while(!res.empty() && res.back() == ' ') {
+                    res.pop_back();
+                }
+                return res;
+            }
+            
+        protected:
+            struct entry {
+                int64 calls = 0;
+                int64 rows = 0;
+                uint64 total = 0;
+                uint64 max = 0;
+                latency_histogram histogram;
+            };
+            
+            std::mutex mutex;
+            std::map<std::string, entry> entries;
+            std::map<sqlite3_stmt*, int64> rowsInProgress;
+        };
+    }
+}
+#pragma once
+
+#include <sqlite3.h>
+#include <string>   //  std::string
+#include <vector>   //  std::vector
+#include <deque>    //  std::deque
+#include <mutex>    //  std::mutex, std::lock_guard
+#include <chrono>   //  std::chrono::nanoseconds
+#include <functional>   //  std::function
+
+// #include "sqlite_type.h"
+
+
+namespace sqlite_orm {
+    
+    /**
+     *  Statement which took longer than slow query log threshold.
+     *  See `storage_t::enable_slow_query_log`.
+     */
+    struct slow_query {
+        
+        /**
+         *  Statement text as it was prepared
+         */
+        std::string sql;
+        
+        /**
+         *  Statement text with bound parameters values (`sqlite3_expanded_sql`)
+         */
+        std::string expanded_sql;
+        
+        /**
+         *  Name of the table mapped to a type storage operation was called for. Empty if operation
+         *  is not bound to a single mapped type (e.g. `select`).
+         */
+        std::string table_name;
+        
+        /**
+         *  Storage function name e.g. `get_all` or `update_all`. Empty for statements executed
+         *  outside of storage operations (e.g. by iterator of `iterate`).
+         */
+        std::string operation;
+        
+        std::chrono::nanoseconds elapsed;
+    };
+    
+    namespace internal {
+        
+        /**
+         *  Storage operation being performed by current thread. Operations form a stack cause
+         *  one operation may call another one.
+         */
+        struct operation_context {
+            const char *operation;
+            const std::string *table_name;
+            operation_context *previous;
+            
+            static operation_context*& current() {
+                static thread_local operation_context *res = nullptr;
+                return res;
+            }
+        };
+        
+        /**
+         *  RAII object which marks storage operation for trace callbacks fired within it.
+         */
+        struct operation_scope {
+            
+            operation_scope(const char *operation, const std::string *tableName = nullptr): context{operation, tableName, operation_context::current()} {
+                operation_context::current() = &this->context;
+            }
+            
+            operation_scope(const operation_scope &) = delete;
+            
+            ~operation_scope() {
+                operation_context::current() = this->context.previous;
+            }
+            
+        protected:
+            operation_context context;
+        };
+        
+        /**
+         *  Keeps statements slower than threshold. Records are passed to sink if it is set or
+         *  are kept in a ring buffer otherwise. Is fed by `sqlite3_trace_v2` callback so it must be thread safe.
+         */
+        struct slow_query_log {
+            
+            void configure(std::chrono::nanoseconds threshold_, std::function<void(const slow_query&)> sink_, size_t capacity_) {
+                std::lock_guard<std::mutex> lock(this->mutex);
+                this->threshold = threshold_;
+                this->sink = std::move(sink_);
+                this->capacity = capacity_;
+                while(this->records.size() > this->capacity) {
+                    this->records.pop_front();
+                }
+            }
+            
+            /**
+             *  SQLITE_TRACE_PROFILE event. Statement is still valid so bound values can be extracted.
+             */
+            void on_profile(sqlite3_stmt *stmt, uint64 nanoseconds) {
+                std::function<void(const slow_query&)> sinkCopy;
+                {
+                    std::lock_guard<std::mutex> lock(this->mutex);
+                    if(std::chrono::nanoseconds(nanoseconds) < this->threshold) {
+                        return;
+                    }
+                    sinkCopy = this->sink;
+                }
+                slow_query record;
+                if(auto sql = sqlite3_sql(stmt)) {
+                    record.sql = sql;
+                }
+#if SQLITE_VERSION_NUMBER >= 3014000
+                if(auto expandedSql = sqlite3_expanded_sql(stmt)) {
+                    record.expanded_sql = expandedSql;
+                    sqlite3_free(expandedSql);
+                }
+#endif
+                if(auto context = operation_context::current()) {
+                    record.operation = context->operation;
+                    if(context->table_name) {
+                        record.table_name = *context->table_name;
+                    }
+                }
+                record.elapsed = std::chrono::nanoseconds(nanoseconds);
+                
+                //  sink is called without lock so it is able to use storage
+                if(sinkCopy) {
+                    sinkCopy(record);
+                }else{
+                    std::lock_guard<std::mutex> lock(this->mutex);
+                    if(this->capacity) {
+                        if(this->records.size() == this->capacity) {
+                            this->records.pop_front();
+                        }
+                        this->records.push_back(std::move(record));
+                    }
+                }
+            }
+            
+            /**
+             *  @return records kept in ring buffer from oldest to newest.
+             */
+            std::vector<slow_query> get_records() {
+                std::lock_guard<std::mutex> lock(this->mutex);
+                return {this->records.begin(), this->records.end()};
+            }
+            
+            void clear() {
+                std::lock_guard<std::mutex> lock(this->mutex);
+                this->records.clear();
+            }
+            
+        protected:
+            std::mutex mutex;
+            std::chrono::nanoseconds threshold = std::chrono::nanoseconds::zero();
+            std::function<void(const slow_query&)> sink;
+            size_t capacity = 0;
+            std::deque<slow_query> records;
+        };
+    }
+}
+#pragma once
+
+#include <sqlite3.h>
+#include <string>   //  std::string
+#include <map>  //  std::map
+#include <utility>  //  std::pair, std::make_pair
+#include <mutex>    //  std::mutex, std::lock_guard
+#include <algorithm>    //  std::max
+
+// #include "sqlite_type.h"
+
+// #include "slow_query_log.h"
+
+
+namespace sqlite_orm {
+    
+    /**
+     *  `sqlite3_stmt_status` counters summed over statements executed by storage operations.
+     *  See `storage_t::enable_statement_stats`.
+     */
+    struct statement_counters {
+        
+        /**
+         *  Statements executed
+         */
+        int64 calls = 0;
+        
+        /**
+         *  SQLITE_STMTSTATUS_FULLSCAN_STEP: steps of full table scans. Non zero value usually means
+         *  that an index is missing.
+         */
+        int64 fullscan_steps = 0;
+        
+        /**
+         *  SQLITE_STMTSTATUS_SORT: sort operations which could not be served by an index
+         */
+        int64 sorts = 0;
+        
+        /**
+         *  SQLITE_STMTSTATUS_AUTOINDEX: rows inserted into transient automatic indexes
+         */
+        int64 autoindexes = 0;
+        
+        /**
+         *  SQLITE_STMTSTATUS_VM_STEP: virtual machine operations executed
+         */
+        int64 vm_steps = 0;
+        
+        /**
+         *  SQLITE_STMTSTATUS_REPREPARE: automatic statement regenerations caused by schema changes
+         */
+        int64 reprepares = 0;
+        
+        /**
+         *  SQLITE_STMTSTATUS_MEMUSED: the biggest heap usage of a single statement in bytes
+         */
+        int64 max_memused = 0;
+        
+        statement_counters& operator+=(const statement_counters &other) {
+            this->calls += other.calls;
+            this->fullscan_steps += other.fullscan_steps;
+            this->sorts += other.sorts;
+            this->autoindexes += other.autoindexes;
+            this->vm_steps += other.vm_steps;
+            this->reprepares += other.reprepares;
+            this->max_memused = std::max(this->max_memused, other.max_memused);
+            return *this;
+        }
+    };
+    
+    /**
+     *  Statement counters grouped by mapped table name and storage operation name (e.g. `get_all`).
+     *  Statements executed outside of storage operations are stored with empty table and operation names.
+     */
+    struct statement_stats {
+        using key_type = std::pair<std::string, std::string>;
+        
+        std::map<key_type, statement_counters> entries;
+        
+        /**
+         *  @return counters of `operation` called for table `tableName`. Counters of all operations called for
+         *  the table are summed if `operation` is empty.
+         */
+        statement_counters get(const std::string &tableName, const std::string &operation = {}) const {
+            statement_counters res;
+            if(!operation.empty()) {
+                auto it = this->entries.find(std::make_pair(tableName, operation));
+                if(it != this->entries.end()) {
+                    res = it->second;
+                }
+            }else{
+                for(auto &p : this->entries) {
+                    if(p.first.first == tableName) {
+                        res += p.second;
+                    }
+                }
+            }
+            return res;
+        }
+        
+        /**
+         *  @return counters of all statements
+         */
+        statement_counters total() const {
+            statement_counters res;
+            for(auto &p : this->entries) {
+                res += p.second;
+            }
+            return res;
+        }
+    };
+    
+    namespace internal {
+        
+        /**
+         *  Accumulates `sqlite3_stmt_status` counters of finished statements. Counters are reset after reading
+         *  cause cached statements are reused. Is fed by `sqlite3_trace_v2` callback so it must be thread safe.
+         */
+        struct statement_stats_collector {
+            
+            /**
+             *  SQLITE_TRACE_PROFILE event
+             */
+            void on_profile(sqlite3_stmt *stmt) {
+                statement_counters counters;
+                counters.calls = 1;
+                counters.fullscan_steps = sqlite3_stmt_status(stmt, SQLITE_STMTSTATUS_FULLSCAN_STEP, 1);
+                counters.sorts = sqlite3_stmt_status(stmt, SQLITE_STMTSTATUS_SORT, 1);
+                counters.autoindexes = sqlite3_stmt_status(stmt, SQLITE_STMTSTATUS_AUTOINDEX, 1);
+#if SQLITE_VERSION_NUMBER >= 3010000
+                counters.vm_steps = sqlite3_stmt_status(stmt, SQLITE_STMTSTATUS_VM_STEP, 1);
+#endif
+#if SQLITE_VERSION_NUMBER >= 3020000
+                counters.reprepares = sqlite3_stmt_status(stmt, SQLITE_STMTSTATUS_REPREPARE, 1);
+                counters.max_memused = sqlite3_stmt_status(stmt, SQLITE_STMTSTATUS_MEMUSED, 0);
+#endif
+                statement_stats::key_type key;
+                if(auto context = operation_context::current()) {
+                    key.second = context->operation;
+                    if(context->table_name) {
+                        key.first = *context->table_name;
+                    }
+                }
+                std::lock_guard<std::mutex> lock(this->mutex);
+                this->stats.entries[key] += counters;
+            }
+            
+            statement_stats snapshot() {
+                std::lock_guard<std::mutex> lock(this->mutex);
+                return this->stats;
+            }
+            
+            void reset() {
+                std::lock_guard<std::mutex> lock(this->mutex);
+                this->stats.entries.clear();
+            }
+            
+        protected:
+            std::mutex mutex;
+            statement_stats stats;
+        };
+    }
+}
+#pragma once
+
+#include <sqlite3.h>
+#include <string>   //  std::string
+#include <vector>   //  std::vector
+#include <unordered_map>    //  std::unordered_map
+#include <fstream>  //  std::ofstream, std::ifstream
+#include <mutex>    //  std::mutex, std::lock_guard
+#include <chrono>   //  std::chrono::steady_clock, std::chrono::nanoseconds
+#include <system_error> //  std::system_error, std::error_code, std::generic_category
+#include <cerrno>   //  errno
+#include <cstring>  //  std::memcmp
+
+// #include "sqlite_type.h"
+
+// #include "error_code.h"
+
+
+namespace sqlite_orm {
+    
+    /**
+     *  Statement recorded by `storage_t::start_recording`.
+     */
+    struct workload_record {
+        
+        /**
+         *  Time since recording started when statement began
+         */
+        std::chrono::nanoseconds offset;
+        
+        /**
+         *  Statement execution time
+         */
+        std::chrono::nanoseconds elapsed;
+        
+        /**
+         *  Statement text with bound values (`sqlite3_expanded_sql`)
+         */
+        std::string sql;
+        
+        /**
+         *  Statement text as it was prepared (`sqlite3_sql`)
+         */
+        std::string prepared_sql;
+    };
+    
+    namespace internal {
+        
+        /**
+         *  Workload log format: 8 bytes signature followed by records. Every record starts with a varint kind:
+         *  0 - prepared statement text: varint text id, varint length, text bytes. Text is written once before
+         *  its first use.
+         *  1 - statement execution: varint text id, varint offset in nanoseconds, varint elapsed nanoseconds,
+         *  varint length and bytes of the text with bound values. Length is 0 if the text equals prepared one.
+         */
+        struct workload_log_format {
+            static const char* signature() {
+                return "SQLORMW2";
+            }
+            
+            static const size_t signature_size = 8;
+            
+            enum : uint64 {
+                text_record = 0,
+                statement_record = 1,
+            };
+            
+            static void write_varint(std::ostream &os, uint64 value) {
+                while(value >= 0x80) {
+                    os.put(static_cast<char>((value & 0x7f) | 0x80));
+                    value >>= 7;
+                }
+                os.put(static_cast<char>(value));
+            }
+            
+            static bool read_varint(std::istream &is, uint64 &value) {
+                value = 0;
+                for(auto shift = 0; shift < 64; shift += 7) {
+                    auto c = is.get();
+                    if(c == std::char_traits<char>::eof()) {
+                        return false;
+                    }
+                    value |= static_cast<uint64>(c & 0x7f) << shift;
+                    if(!(c & 0x80)) {
+                        return true;
+                    }
+                }
+                return false;
+            }
+        };
+        
+        /**
+         *  Writes statements finished by storage connections into a workload log. Is fed by `sqlite3_trace_v2`
+         *  callback so it must be thread safe.
+         */
+        struct workload_recorder {
+            
+            void start(const std::string &path) {
+                std::lock_guard<std::mutex> lock(this->mutex);
+                this->file.close();
+                this->file.clear();
+                this->file.open(path, std::ios::binary | std::ios::trunc);
+                if(!this->file) {
+                    throw std::system_error(std::error_code(errno, std::generic_category()), path);
+                }
+                this->file.write(workload_log_format::signature(), workload_log_format::signature_size);
+                this->textIds.clear();
+                this->startTime = std::chrono::steady_clock::now();
+            }
+            
+            void stop() {
+                std::lock_guard<std::mutex> lock(this->mutex);
+                this->file.close();
+                this->textIds.clear();
+            }
+            
+            /**
+             *  SQLITE_TRACE_PROFILE event
+             */
+            void on_profile(sqlite3_stmt *stmt, uint64 nanoseconds) {
+                std::string preparedSql;
+                if(auto rawSql = sqlite3_sql(stmt)) {
+                    preparedSql = rawSql;
+                }
+                std::string sql;
+#if SQLITE_VERSION_NUMBER >= 3014000
+                if(sqlite3_bind_parameter_count(stmt)) {
+                    if(auto expandedSql = sqlite3_expanded_sql(stmt)) {
+                        sql = expandedSql;
+                        sqlite3_free(expandedSql);
+                    }
+                }
+#endif
+                auto now = std::chrono::steady_clock::now();
+                std::lock_guard<std::mutex> lock(this->mutex);
+                if(!this->file.is_open()) {
+                    return;
+                }
+                auto sinceStart = static_cast<uint64>(std::chrono::duration_cast<std::chrono::nanoseconds>(now - this->startTime).count());
+                auto offset = sinceStart > nanoseconds ? sinceStart - nanoseconds : 0;
+                auto it = this->textIds.find(preparedSql);
+                if(it == this->textIds.end()) {
+                    auto id = static_cast<uint64>(this->textIds.size());
+                    it = this->textIds.insert({std::move(preparedSql), id}).first;
+                    workload_log_format::write_varint(this->file, workload_log_format::text_record);
+                    workload_log_format::write_varint(this->file, id);
+                    workload_log_format::write_varint(this->file, it->first.length());
+                    this->file.write(it->first.data(), it->first.length());
+                }
+                if(sql == it->first) {
+                    sql.clear();
+                }
+                workload_log_format::write_varint(this->file, workload_log_format::statement_record);
+                workload_log_format::write_varint(this->file, it->second);
+                workload_log_format::write_varint(this->file, offset);
+                workload_log_format::write_varint(this->file, nanoseconds);
+                workload_log_format::write_varint(this->file, sql.length());
+                this->file.write(sql.data(), sql.length());
+            }
+            
+        protected:
+            std::mutex mutex;
+            std::ofstream file;
+            
+            /**
+             *  Ids of prepared statements texts. Bound values are not a part of a key so the map size is limited
+             *  by the count of different statements the application prepares.
+             */
+            std::unordered_map<std::string, uint64> textIds;
+            std::chrono::steady_clock::time_point startTime;
+        };
+    }
+    
+    /**
+     *  Reads a workload log written by `storage_t::start_recording`.
+     *  throws std::system_error with std::generic_category if file cannot be opened and
+     *  with orm_error_category if file is not a workload log or is corrupted.
+     */
+    inline std::vector<workload_record> read_workload(const std::string &path) {
+        using format = internal::workload_log_format;
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        if(!file) {
+            throw std::system_error(std::error_code(errno, std::generic_category()), path);
+        }
+        auto fileSize = static_cast<uint64>(file.tellg());
+        file.seekg(0);
+        char signature[format::signature_size];
+        if(!file.read(signature, format::signature_size) || std::memcmp(signature, format::signature(), format::signature_size)) {
+            throw std::system_error(std::make_error_code(orm_error_code::incorrect_workload_log));
+        }
+        std::vector<workload_record> res;
+        std::vector<std::string> texts;
+        uint64 kind;
+        while(format::read_varint(file, kind)) {
+            uint64 id;
+            if(!format::read_varint(file, id)) {
+                throw std::system_error(std::make_error_code(orm_error_code::incorrect_workload_log));
+            }
+            if(kind == format::text_record) {
+                uint64 length;
+                
+                //  length is checked before allocation cause it is read from a possibly corrupted file
+                if(!format::read_varint(file, length) || id != texts.size() || length > fileSize - static_cast<uint64>(file.tellg())) {
+                    throw std::system_error(std::make_error_code(orm_error_code::incorrect_workload_log));
+                }
+                std::string text(static_cast<size_t>(length), '\0');
+                if(!file.read(&text[0], static_cast<std::streamsize>(length))) {
+                    throw std::system_error(std::make_error_code(orm_error_code::incorrect_workload_log));
+                }
+                texts.push_back(std::move(text));
+            }else if(kind == format::statement_record) {
+                uint64 offset;
+                uint64 elapsed;
+                uint64 length;
+                if(id >= texts.size() || !format::read_varint(file, offset) || !format::read_varint(file, elapsed) || !format::read_varint(file, length) || length > fileSize - static_cast<uint64>(file.tellg())) {
+                    throw std::system_error(std::make_error_code(orm_error_code::incorrect_workload_log));
+                }
+                auto &preparedSql = texts[static_cast<size_t>(id)];
+                std::string sql;
+                if(length) {
+                    sql.resize(static_cast<size_t>(length));
+                    if(!file.read(&sql[0], static_cast<std::streamsize>(length))) {
+                        throw std::system_error(std::make_error_code(orm_error_code::incorrect_workload_log));
+                    }
+                }else{
+                    sql = preparedSql;
+                }
+                res.push_back({std::chrono::nanoseconds(offset), std::chrono::nanoseconds(elapsed), std::move(sql), preparedSql});
+            }else{
+                throw std::system_error(std::make_error_code(orm_error_code::incorrect_workload_log));
+            }
+        }
+        return res;
+    }
+}
+#pragma once
+
+#include <sqlite3.h>
+#include <atomic>   //  std::atomic
+
+// #include "sqlite_type.h"
+
+// #include "profiler.h"
+
+// #include "slow_query_log.h"
+
+// #include "statement_stats.h"
+
+// #include "workload_recorder.h"
+
+
+namespace sqlite_orm {
+    
+    namespace internal {
+        
+        /**
+         *  Context of `sqlite3_trace_v2` callback registered on every storage connection. SQLite allows
+         *  one trace callback per connection so all tracing consumers live here. Is shared between storage
+         *  copies and connections keep raw pointer to it.
+         */
+        struct tracer {
+            profiler queryProfiler;
+            std::atomic<bool> isProfilingEnabled{false};
+            
+            slow_query_log slowQueryLog;
+            std::atomic<bool> isSlowQueryLogEnabled{false};
+            
+            statement_stats_collector statementStats;
+            std::atomic<bool> isStatementStatsEnabled{false};
+            
+            workload_recorder workloadRecorder;
+            std::atomic<bool> isRecording{false};
+            
+            /**
+             *  @return trace events mask required by enabled consumers. 0 if tracing is not needed.
+             */
+            unsigned mask() const {
+                unsigned res = 0;
+#if SQLITE_VERSION_NUMBER >= 3014000
+                if(this->isProfilingEnabled){
+                    res |= SQLITE_TRACE_PROFILE | SQLITE_TRACE_ROW;
+                }
+                if(this->isSlowQueryLogEnabled || this->isStatementStatsEnabled || this->isRecording){
+                    res |= SQLITE_TRACE_PROFILE;
+                }
+#endif
+                return res;
+            }
+            
+            /**
+             *  Registers or unregisters trace callback according to enabled consumers.
+             */
+            void register_on(sqlite3 *db) {
+#if SQLITE_VERSION_NUMBER >= 3014000
+                if(auto m = this->mask()){
+                    sqlite3_trace_v2(db, m, callback, this);
+                }else{
+                    sqlite3_trace_v2(db, 0, nullptr, nullptr);
+                }
+#else
+                (void)db;
+#endif
+            }
+            
+#if SQLITE_VERSION_NUMBER >= 3014000
+            static int callback(unsigned type, void *context, void *p, void *x) {
+                auto &t = *(tracer*)context;
+                auto stmt = (sqlite3_stmt*)p;
+                switch(type){
+                    case SQLITE_TRACE_ROW:{
+                        if(t.isProfilingEnabled){
+                            t.queryProfiler.on_row(stmt);
+                        }
+                    }break;
+                    case SQLITE_TRACE_PROFILE:{
+                        auto nanoseconds = static_cast<uint64>(*(sqlite3_int64*)x);
+                        if(t.isProfilingEnabled){
+                            t.queryProfiler.on_profile(stmt, nanoseconds);
+                        }
+                        if(t.isSlowQueryLogEnabled){
+                            t.slowQueryLog.on_profile(stmt, nanoseconds);
+                        }
+                        if(t.isStatementStatsEnabled){
+                            t.statementStats.on_profile(stmt);
+                        }
+                        if(t.isRecording){
+                            t.workloadRecorder.on_profile(stmt, nanoseconds);
+                        }
+                    }break;
+                }
+                return 0;
+            }
+#endif
+        };
+    }
+}
+#pragma once
+
+#include <string>   //  std::string
+#include <vector>   //  std::vector
+#include <sstream>  //  std::stringstream
+
+namespace sqlite_orm {
+    
+    /**
+     *  Single row of `EXPLAIN QUERY PLAN` output e.g. `SCAN users` or
+     *  `SEARCH users USING INTEGER PRIMARY KEY (rowid=?)`.
+     */
+    struct query_plan_node {
+        int id;
+        int parent;
+        std::string detail;
+        std::vector<query_plan_node> children;
+    };
+    
+    /**
+     *  `EXPLAIN QUERY PLAN` result returned by `storage_t::explain`. SQLite older than 3.24.0 doesn't
+     *  report nodes hierarchy so all nodes are roots there.
+     */
+    struct query_plan {
+        
+        /**
+         *  Explained query
+         */
+        std::string sql;
+        
+        /**
+         *  Top level nodes
+         */
+        std::vector<query_plan_node> nodes;
+        
+        /**
+         *  @return true if plan contains full scan of a table with name `tableName`
+         *  (`SCAN TABLE tableName` or `SCAN tableName` for SQLite 3.36.0 and newer).
+         */
+        bool scans(const std::string &tableName) const {
+            return scans(this->nodes, tableName);
+        }
+        
+        /**
+         *  @return plan as text with a node per line. Children are indented.
+         */
+        std::string to_string() const {
+            std::stringstream ss;
+            print(ss, this->nodes, 0);
+            return ss.str();
+        }
+        
+    protected:
+        static bool scans(const std::vector<query_plan_node> &nodes, const std::string &tableName) {
+            for(auto &node : nodes) {
+                std::string prefix = "SCAN ";
+                if(node.detail.compare(0, prefix.length(), prefix) == 0) {
+                    auto rest = node.detail.substr(prefix.length());
+                    std::string tablePrefix = "TABLE ";
+                    if(rest.compare(0, tablePrefix.length(), tablePrefix) == 0) {
+                        rest = rest.substr(tablePrefix.length());
+                    }
+                    if(rest.substr(0, rest.find(' ')) == tableName) {
+                        return true;
+                    }
+                }
+                if(scans(node.children, tableName)) {
+                    return true;
+                }
+            }
+            return false;
+        }
+        
+        static void print(std::stringstream &ss, const std::vector<query_plan_node> &nodes, size_t depth) {
+            for(auto &node : nodes) {
+                ss << std::string(depth * 2, ' ') << node.detail << std::endl;
+                print(ss, node.children, depth + 1);
+            }
+        }
+    };
+}
+#pragma once
+
+#include <sqlite3.h>
+#include <vector>   //  std::vector
+
+// #include "sqlite_type.h"
+
+
+namespace sqlite_orm {
+    
+    /**
+     *  `sqlite3_db_status` values of a database connection. Sizes are in bytes.
+     *  Values which SQLite version doesn't support are zero.
+     */
+    struct connection_stats {
+        
+        /**
+         *  SQLITE_DBSTATUS_CACHE_USED: heap memory used by pager caches
+         */
+        int64 cache_used = 0;
+        int64 cache_hit = 0;
+        int64 cache_miss = 0;
+        int64 cache_write = 0;
+        
+        /**
+         *  SQLITE_DBSTATUS_SCHEMA_USED: heap memory used to store schema of all attached databases
+         */
+        int64 schema_used = 0;
+        
+        /**
+         *  SQLITE_DBSTATUS_STMT_USED: heap memory used by all prepared statements of the connection
+         */
+        int64 stmt_used = 0;
+        
+        /**
+         *  SQLITE_DBSTATUS_LOOKASIDE_USED: lookaside slots used now and at most
+         */
+        int64 lookaside_used = 0;
+        int64 lookaside_used_highwater = 0;
+        
+        /**
+         *  Allocations served by lookaside and allocations which could not be served cause requested
+         *  size was too big or all slots were used
+         */
+        int64 lookaside_hit = 0;
+        int64 lookaside_miss_size = 0;
+        int64 lookaside_miss_full = 0;
+    };
+    
+    /**
+     *  Memory statistics returned by `storage_t::stats`.
+     */
+    struct storage_stats {
+        
+        /**
+         *  Stats of connections kept open by storage (the one opened by `open_forever`, in-memory database or
+         *  a transaction). Empty if storage opens a connection per call.
+         */
+        std::vector<connection_stats> connections;
+        
+        /**
+         *  SQLITE_STATUS_MEMORY_USED: process wide heap memory used by SQLite now and at most
+         */
+        int64 memory_used = 0;
+        int64 memory_highwater = 0;
+        
+        /**
+         *  SQLITE_STATUS_MALLOC_SIZE: the biggest allocation requested
+         */
+        int64 malloc_size_highwater = 0;
+        
+        /**
+         *  SQLITE_STATUS_MALLOC_COUNT: current allocations count
+         */
+        int64 malloc_count = 0;
+        
+        /**
+         *  SQLITE_STATUS_PAGECACHE_OVERFLOW: page cache allocations which didn't fit in SQLITE_CONFIG_PAGECACHE
+         *  memory and were served by heap. Non zero value means page cache buffer is too small.
+         */
+        int64 page_cache_overflow = 0;
+        int64 page_cache_overflow_highwater = 0;
+    };
+    
+    namespace internal {
+        
+        /**
+         *  @param reset resets highwater marks and cache hit/miss/write counters if true
+         */
+        inline connection_stats get_connection_stats(sqlite3 *db, bool reset) {
+            connection_stats res;
+            auto resetFlag = reset ? 1 : 0;
+            int current = 0;
+            int highwater = 0;
+            sqlite3_db_status(db, SQLITE_DBSTATUS_CACHE_USED, &current, &highwater, 0);
+            res.cache_used = current;
+#if SQLITE_VERSION_NUMBER >= 3007009
+            sqlite3_db_status(db, SQLITE_DBSTATUS_CACHE_HIT, &current, &highwater, resetFlag);
+            res.cache_hit = current;
+            sqlite3_db_status(db, SQLITE_DBSTATUS_CACHE_MISS, &current, &highwater, resetFlag);
+            res.cache_miss = current;
+#endif
+#if SQLITE_VERSION_NUMBER >= 3007012
+            sqlite3_db_status(db, SQLITE_DBSTATUS_CACHE_WRITE, &current, &highwater, resetFlag);
+            res.cache_write = current;
+#endif
+            sqlite3_db_status(db, SQLITE_DBSTATUS_SCHEMA_USED, &current, &highwater, 0);
+            res.schema_used = current;
+            sqlite3_db_status(db, SQLITE_DBSTATUS_STMT_USED, &current, &highwater, 0);
+            res.stmt_used = current;
+            sqlite3_db_status(db, SQLITE_DBSTATUS_LOOKASIDE_USED, &current, &highwater, resetFlag);
+            res.lookaside_used = current;
+            res.lookaside_used_highwater = highwater;
+            
+            //  lookaside hit and miss counters are reported as highwater values
+            sqlite3_db_status(db, SQLITE_DBSTATUS_LOOKASIDE_HIT, &current, &highwater, resetFlag);
+            res.lookaside_hit = highwater;
+            sqlite3_db_status(db, SQLITE_DBSTATUS_LOOKASIDE_MISS_SIZE, &current, &highwater, resetFlag);
+            res.lookaside_miss_size = highwater;
+            sqlite3_db_status(db, SQLITE_DBSTATUS_LOOKASIDE_MISS_FULL, &current, &highwater, resetFlag);
+            res.lookaside_miss_full = highwater;
+            return res;
+        }
+        
+        /**
+         *  Fills process wide `sqlite3_status64` values of `stats`.
+         *  @param reset resets highwater marks if true
+         */
+        inline void get_global_stats(storage_stats &stats, bool reset) {
+            auto resetFlag = reset ? 1 : 0;
+#if SQLITE_VERSION_NUMBER >= 3010000
+            sqlite3_int64 current = 0;
+            sqlite3_int64 highwater = 0;
+            auto status = [&current, &highwater, resetFlag](int op) {
+                sqlite3_status64(op, &current, &highwater, resetFlag);
+            };
+#else
+            int current = 0;
+            int highwater = 0;
+            auto status = [&current, &highwater, resetFlag](int op) {
+                sqlite3_status(op, &current, &highwater, resetFlag);
+            };
+#endif
+            status(SQLITE_STATUS_MEMORY_USED);
+            stats.memory_used = current;
+            stats.memory_highwater = highwater;
+            status(SQLITE_STATUS_MALLOC_SIZE);
+            stats.malloc_size_highwater = highwater;
+            status(SQLITE_STATUS_MALLOC_COUNT);
+            stats.malloc_count = current;
+            status(SQLITE_STATUS_PAGECACHE_OVERFLOW);
+            stats.page_cache_overflow = current;
+            stats.page_cache_overflow_highwater = highwater;
+        }
+    }
+}
+#pragma once
+
+#include <string>   //  std::string
+#include <vector>   //  std::vector
+#include <map>  //  std::map
+#include <array>    //  std::array
+#include <mutex>    //  std::mutex, std::lock_guard
+#include <memory>   //  std::shared_ptr, std::make_shared
+#include <chrono>   //  std::chrono::steady_clock, std::chrono::nanoseconds
+#include <algorithm>    //  std::max, std::min
+
+// #include "sqlite_type.h"
+
+// #include "profiler.h"
+
+
+namespace sqlite_orm {
+    
+    /**
+     *  Parts of a storage operation measured by instrumentation policy.
+     *  build - ORM work before SQLite is called: query string building, table lookup
+     *  connect - opening a connection if storage doesn't keep one
+     *  prepare - `sqlite3_prepare_v2`
+     *  bind - binding values to a statement
+     *  step - `sqlite3_step` (and whole transaction lambda for `transaction`)
+     *  hydrate - extracting column values into objects
+     */
+    enum class instrumentation_phase {
+        build,
+        connect,
+        prepare,
+        bind,
+        step,
+        hydrate,
+    };
+    
+    /**
+     *  Default storage instrumentation policy. Does nothing and is optimized out completely.
+     *  A custom policy must have the same interface: `measurement` type constructible from policy reference
+     *  and operation name with `phase(instrumentation_phase)` function which is called every time operation
+     *  switches to another phase. Operation is finished when measurement is destroyed.
+     */
+    struct no_instrumentation {
+        
+        struct measurement {
+            
+            measurement(no_instrumentation &, const char * /*operation*/) {}
+            
+            void phase(instrumentation_phase) {}
+        };
+    };
+    
+    /**
+     *  Latency statistics of an operation or its phase.
+     */
+    struct latency_stats {
+        std::chrono::nanoseconds total;
+        std::chrono::nanoseconds p50;
+        std::chrono::nanoseconds p99;
+        std::chrono::nanoseconds max;
+    };
+    
+    /**
+     *  Latency statistics of a storage operation collected by `latency_instrumentation`.
+     */
+    struct operation_latency {
+        
+        /**
+         *  Storage function name e.g. `get_all`
+         */
+        std::string operation;
+        
+        int64 calls;
+        
+        /**
+         *  Whole operation latency
+         */
+        latency_stats latency;
+        
+        /**
+         *  Latency of every phase indexed with `instrumentation_phase`
+         */
+        std::array<latency_stats, 6> phases;
+        
+        const latency_stats& operator[](instrumentation_phase phase) const {
+            return this->phases[static_cast<size_t>(phase)];
+        }
+    };
+    
+    /**
+     *  Instrumentation policy which records latency histograms of every instrumented storage operation and
+     *  its phases. Storage copies share collected data. Thread safe. Usage:
+     *
+     *  auto storage = make_instrumented_storage<latency_instrumentation>("db.sqlite", make_table(...));
+     *  ...
+     *  for(auto &op : storage.instrumentation().snapshot()) {
+     *      cout << op.operation << " " << op[instrumentation_phase::step].p99.count() << endl;
+     *  }
+     */
+    struct latency_instrumentation {
+        static constexpr const size_t phases_count = 6;
+        
+        struct measurement {
+            
+            measurement(latency_instrumentation &instrumentation_, const char *operation_):
+            instrumentation(instrumentation_),
+            operation(operation_),
+            start(std::chrono::steady_clock::now()),
+            phaseStart(start)
+            {}
+            
+            measurement(const measurement &) = delete;
+            
+            void phase(instrumentation_phase value) {
+                auto now = std::chrono::steady_clock::now();
+                this->durations[static_cast<size_t>(this->currentPhase)] += now - this->phaseStart;
+                this->phaseStart = now;
+                this->currentPhase = value;
+            }
+            
+            ~measurement() {
+                this->phase(this->currentPhase);
+                this->instrumentation.add(this->operation, this->phaseStart - this->start, this->durations);
+            }
+            
+        protected:
+            latency_instrumentation &instrumentation;
+            const char *operation;
+            std::chrono::steady_clock::time_point start;
+            std::chrono::steady_clock::time_point phaseStart;
+            instrumentation_phase currentPhase = instrumentation_phase::build;
+            std::array<std::chrono::steady_clock::duration, phases_count> durations{};
+        };
+        
+        /**
+         *  @return statistics of every operation called at least once since creation or `reset`.
+         */
+        std::vector<operation_latency> snapshot() const {
+            std::vector<operation_latency> res;
+            std::lock_guard<std::mutex> lock(this->data->mutex);
+            res.reserve(this->data->entries.size());
+            for(auto &p : this->data->entries) {
+                auto &entry = p.second;
+                operation_latency value;
+                value.operation = p.first;
+                value.calls = entry.calls;
+                value.latency = entry.latency.stats();
+                for(size_t i = 0; i < phases_count; ++i) {
+                    value.phases[i] = entry.phases[i].stats();
+                }
+                res.push_back(std::move(value));
+            }
+            return res;
+        }
+        
+        void reset() {
+            std::lock_guard<std::mutex> lock(this->data->mutex);
+            this->data->entries.clear();
+        }
+        
+    protected:
+        struct recorder {
+            internal::latency_histogram histogram;
+            uint64 total = 0;
+            uint64 max = 0;
+            
+            void add(uint64 value) {
+                this->histogram.add(value);
+                this->total += value;
+                this->max = std::max(this->max, value);
+            }
+            
+            /**
+             *  Histogram percentiles are bucket bounds so they are clamped with the exact maximum.
+             */
+            latency_stats stats() const {
+                return {
+                    std::chrono::nanoseconds(this->total),
+                    std::chrono::nanoseconds(std::min(this->histogram.percentile(0.5), this->max)),
+                    std::chrono::nanoseconds(std::min(this->histogram.percentile(0.99), this->max)),
+                    std::chrono::nanoseconds(this->max),
+                };
+            }
+        };
+        
+        struct entry {
+            int64 calls = 0;
+            recorder latency;
+            std::array<recorder, phases_count> phases;
+        };
+        
+        struct storage_data {
+            std::mutex mutex;
+            std::map<std::string, entry> entries;
+        };
+        
+        std::shared_ptr<storage_data> data = std::make_shared<storage_data>();
+        
+        void add(const char *operation, std::chrono::steady_clock::duration elapsed, const std::array<std::chrono::steady_clock::duration, phases_count> &durations) {
+            auto toNanoseconds = [](std::chrono::steady_clock::duration d) {
+                return static_cast<uint64>(std::chrono::duration_cast<std::chrono::nanoseconds>(d).count());
+            };
+            std::lock_guard<std::mutex> lock(this->data->mutex);
+            auto &e = this->data->entries[operation];
+            ++e.calls;
+            e.latency.add(toNanoseconds(elapsed));
+            for(size_t i = 0; i < phases_count; ++i) {
+                e.phases[i].add(toNanoseconds(durations[i]));
+            }
+        }
+    };
+}
+#pragma once
+
+#include <tuple>    //  std::tuple, std::make_tuple
+#include <string>   //  std::string
+
+namespace sqlite_orm {
+    
+    namespace internal {
+        
+        template<class ...Cols>
+        struct index_t {
+            using columns_type = std::tuple<Cols...>;
+            using object_type = void;
+            
+            std::string name;
+            bool unique;
+            columns_type columns;
+            
+            template<class L>
+            void for_each_column_with_constraints(L) {}
+        };
+    }
     
+    /**
+     *  Index construction function. Every argument except name is one of:
+     *  * column member pointer or getter/setter - indexed column
+     *  * expression like `lower(&User::email)` - expression index
+     *  * `order_by(&User::name).collate_nocase().desc()` - indexed column with COLLATE and/or ASC/DESC
+     *  * `where(c(&User::status) == 1)` - makes partial index with a given condition
+     */
     template<class ...Cols>
     internal::index_t<Cols...> make_index(const std::string &name, Cols ...cols) {
         return {name, false, std::make_tuple(cols...)};
@@ -4257,8 +5878,9 @@ namespace sqlite_orm {
 
 #include <vector>   //  std::vector
 #include <string>   //  std::string
-#include <tuple>    //  std::tuple
+#include <tuple>    //  std::tuple, std::get
 #include <type_traits>  //  std::is_same, std::integral_constant, std::true_type, std::false_type
+#include <utility>  //  std::index_sequence, std::index_sequence_for
 
 // #include "column.h"
 
@@ -4272,140 +5894,99 @@ namespace sqlite_orm {
     namespace internal {
         
         /**
-         *  Common case for table_impl class.
+         *  Stores table columns and constraints in a flat tuple. Every iteration is expanded with
+         *  `std::index_sequence` in a single function instead of a recursive inheritance chain so
+         *  instantiations count doesn't grow with columns count squared.
          */
-        template<typename... Args>
+        template<class ...Cs>
         struct table_impl {
             
-            std::vector<std::string> column_names() {
-                return {};
-            }
-            
-            template<class ...Op>
-            std::vector<std::string> column_names_exept() {
-                return {};
-            }
-            
-            template<class ...Op>
-            std::vector<std::string> column_names_with() {
-                return {};
-            }
-            
-            template<class L>
-            void for_each_column(L) {}
-            
-            template<class L>
-            void for_each_column_with_constraints(L) {}
-            
-            template<class F, class L>
-            void for_each_column_with_field_type(L) {}
-            
-            template<class Op, class L>
-            void for_each_column_exept(L) {}
-            
-            template<class Op, class L>
-            void for_each_column_with(L) {}
-            
-            template<class L>
-            void for_each_primary_key(L) {}
-            
-            int columns_count() const {
-                return 0;
-            }
-            
-        };
-        
-        template<typename H, typename... T>
-        struct table_impl<H, T...> : private table_impl<T...> {
-            using column_type = H;
-            using tail_types = std::tuple<T...>;
-            
-            table_impl(H h, T ...t) : super(t...), col(h) {}
+            std::tuple<Cs...> columns;
             
-            column_type col;
+            table_impl(Cs ...cs) : columns(std::move(cs)...) {}
             
             int columns_count() const {
-                return 1 + this->super::columns_count();
+                return static_cast<int>(sizeof...(Cs));
             }
             
             /**
-             *  column_names_with implementation. Notice that result will be reversed.
-             *  It is reversed back in `table` class.
              *  @return vector of column names that have specified Op... conditions.
              */
             template<class ...Op>
             std::vector<std::string> column_names_with() {
-                auto res = this->super::template column_names_with<Op...>();
-                if(this->col.template has_every<Op...>()) {
-                    res.emplace_back(this->col.name);
-                }
+                std::vector<std::string> res;
+                this->for_each_column_with_constraints([&res](auto &c){
+                    if(c.template has_every<Op...>()) {
+                        res.emplace_back(c.name);
+                    }
+                });
                 return res;
             }
             
             /**
-             *  For each implementation. Calls templated lambda with its column
-             *  and passed call to superclass.
+             *  Calls templated lambda with every column. Table constraints are skipped.
              */
             template<class L>
             void for_each_column(L l){
-                this->apply_to_col_if(l, internal::is_column<column_type>{});
-                this->super::for_each_column(l);
+                this->template for_each_if<internal::is_column<Cs>...>(l, std::index_sequence_for<Cs...>{});
             }
             
             /**
-             *  For each implementation. Calls templated lambda with its column
-             *  and passed call to superclass.
+             *  Calls templated lambda with every column and table constraint.
              */
             template<class L>
             void for_each_column_with_constraints(L l){
-                l(this->col);
-                this->super::for_each_column_with_constraints(l);
+                this->template for_each_if<std::is_same<Cs, Cs>...>(l, std::index_sequence_for<Cs...>{});
             }
             
             template<class F, class L>
             void for_each_column_with_field_type(L l) {
-                this->apply_to_col_if(l, std::is_same<F, typename column_type::field_type>{});
-                this->super::template for_each_column_with_field_type<F, L>(l);
+                this->template for_each_if<std::is_same<F, typename Cs::field_type>...>(l, std::index_sequence_for<Cs...>{});
             }
             
             /**
-             *  Working version of `for_each_column_exept`. Calls lambda if column has no option and fire super's function.
+             *  Calls lambda with every column that has no Op option.
              */
             template<class Op, class L>
             void for_each_column_exept(L l) {
-                using has_opt = tuple_helper::tuple_contains_type<Op, typename column_type::constraints_type>;
-                this->apply_to_col_if(l, std::integral_constant<bool, !has_opt::value>{});
-                this->super::template for_each_column_exept<Op, L>(l);
+                this->template for_each_if<std::integral_constant<bool, !tuple_helper::tuple_contains_type<Op, typename Cs::constraints_type>::value>...>(l, std::index_sequence_for<Cs...>{});
             }
             
             /**
-             *  Working version of `for_each_column_with`. Calls lambda if column has option and fire super's function.
+             *  Calls lambda with every column that has Op option.
              */
             template<class Op, class L>
             void for_each_column_with(L l) {
-                this->apply_to_col_if(l, tuple_helper::tuple_contains_type<Op, typename column_type::constraints_type>{});
-                this->super::template for_each_column_with<Op, L>(l);
+                this->template for_each_if<tuple_helper::tuple_contains_type<Op, typename Cs::constraints_type>...>(l, std::index_sequence_for<Cs...>{});
             }
             
             /**
-             *  Calls l(this->col) if H is primary_key_t
+             *  Calls lambda with every primary_key_t table constraint.
              */
             template<class L>
             void for_each_primary_key(L l) {
-                this->apply_to_col_if(l, internal::is_primary_key<H>{});
-                this->super::for_each_primary_key(l);
+                this->template for_each_if<internal::is_primary_key<Cs>...>(l, std::index_sequence_for<Cs...>{});
             }
             
-            template<class L>
-            void apply_to_col_if(L& l, std::true_type) {
-                l(this->col);
+        protected:
+            
+            /**
+             *  Calls l(std::get<I>(this->columns)) for every I which Conditions value is true.
+             *  Conditions and I must be of the same size.
+             */
+            template<class ...Conditions, class L, size_t ...I>
+            void for_each_if(L &l, std::index_sequence<I...>) {
+                int _[] = {0, (this->apply_to_col_if(l, std::get<I>(this->columns), Conditions{}), int{})...};
+                (void)_;
             }
             
-            template<class L>
-            void apply_to_col_if(L&, std::false_type) {}
+            template<class L, class C>
+            void apply_to_col_if(L& l, C &c, std::true_type) {
+                l(c);
+            }
             
-        private:
-            using super = table_impl<T...>;
+            template<class L, class C>
+            void apply_to_col_if(L&, C &, std::false_type) {}
         };
     }
 }
@@ -4415,7 +5996,7 @@ namespace sqlite_orm {
 #include <type_traits>  //  std::remove_reference, std::is_same, std::is_base_of
 #include <vector>   //  std::vector
 #include <tuple>    //  std::tuple_size, std::tuple_element
-#include <algorithm>    //  std::reverse, std::find_if
+#include <algorithm>    //  std::find_if
 
 // #include "table_impl.h"
 
@@ -4606,10 +6187,7 @@ namespace sqlite_orm {
              */
             template<class ...Op>
             std::vector<std::string> column_names_with() {
-                auto res = this->impl.template column_names_with<Op...>();
-                std::reverse(res.begin(),
-                             res.end());
-                return res;
+                return this->impl.template column_names_with<Op...>();
             }
             
             /**
@@ -4717,21 +6295,291 @@ namespace sqlite_orm {
 }
 #pragma once
 
+#include <sqlite3.h>
+#include <tuple>    //  std::tuple, std::get
+#include <type_traits>  //  std::decay
+#include <utility>  //  std::index_sequence, std::index_sequence_for
+
+// #include "tuple_helper.h"
+
+// #include "statement_binder.h"
+
+// #include "row_extractor.h"
+
+
+namespace sqlite_orm {
+    
+    namespace internal {
+        
+        /**
+         *  Binds and extracts primary key values used by multi-get functions. Single column primary key
+         *  is a value of its field type. Composite primary key is `std::tuple` with values in the same order
+         *  as columns are passed to `primary_key()`. Its columns are bound in reversed order just like
+         *  `storage_t::get` binds ids and `table_t::primary_key_column_names` returns names.
+         */
+        template<class T>
+        struct primary_key_value {
+            static constexpr const int columns_count = 1;
+            
+            static void bind(sqlite3_stmt *stmt, int &index, const T &value) {
+                statement_binder<T>().bind(stmt, index++, value);
+            }
+            
+            static T extract(sqlite3_stmt *stmt, int &index) {
+                return row_extractor<T>().extract(stmt, index++);
+            }
+        };
+        
+        template<class ...Ts>
+        struct primary_key_value<std::tuple<Ts...>> {
+            static constexpr const int columns_count = static_cast<int>(sizeof...(Ts));
+            
+            static void bind(sqlite3_stmt *stmt, int &index, const std::tuple<Ts...> &value) {
+                tuple_helper::iterator<sizeof...(Ts) - 1, Ts...>()(value, [stmt, &index](auto &v){
+                    using field_type = typename std::decay<decltype(v)>::type;
+                    statement_binder<field_type>().bind(stmt, index++, v);
+                });
+            }
+            
+            static std::tuple<Ts...> extract(sqlite3_stmt *stmt, int &index) {
+                std::tuple<Ts...> res;
+                extract_reversed(res, stmt, index, std::index_sequence_for<Ts...>{});
+                return res;
+            }
+            
+        protected:
+            template<size_t ...I>
+            static void extract_reversed(std::tuple<Ts...> &res, sqlite3_stmt *stmt, int &index, std::index_sequence<I...>) {
+                int _[] = {0, (extract_element<sizeof...(Ts) - 1 - I>(res, stmt, index), int{})...};
+                (void)_;
+            }
+            
+            template<size_t N>
+            static void extract_element(std::tuple<Ts...> &res, sqlite3_stmt *stmt, int &index) {
+                using field_type = typename std::tuple_element<N, std::tuple<Ts...>>::type;
+                std::get<N>(res) = row_extractor<field_type>().extract(stmt, index++);
+            }
+        };
+    }
+}
+#pragma once
+
+#include <sqlite3.h>
+#include <string>   //  std::string
+#include <vector>   //  std::vector
+#include <cstring>  //  std::memcpy
+#include <cstdlib>  //  std::strtoll
+#include <system_error> //  std::system_error
+
+// #include "sqlite_type.h"
+
+// #include "error_code.h"
+
+
+namespace sqlite_orm {
+    
+    /**
+     *  Result of `storage_t::paginate`.
+     */
+    template<class O>
+    struct page {
+        
+        /**
+         *  Objects of the page. There are less objects than page size on the last page only.
+         */
+        std::vector<O> objects;
+        
+        /**
+         *  Token passed to `paginate` to fetch the next page. Is empty if this page is the last one.
+         */
+        std::string next_token;
+    };
+    
+    namespace internal {
+        
+        /**
+         *  Continuation token of keyset pagination. Keeps sort key values of the last row of a page with their
+         *  storage classes so they are compared exactly like stored values. Token is printable:
+         *  every value is a type letter followed by its payload - 'n' null, 'i' decimal integer, 'f' hex of
+         *  double bits, 't' hex of text bytes, 'b' hex of blob bytes. Payloads are terminated with ';'.
+         */
+        struct page_token {
+            
+            struct value {
+                int type = SQLITE_NULL;
+                int64 integer = 0;
+                double real = 0;
+                std::string bytes;
+            };
+            
+            /**
+             *  Encodes `count` result columns starting from `firstColumn`.
+             */
+            static std::string encode(sqlite3_stmt *stmt, int firstColumn, int count) {
+                std::string res;
+                for(auto column = firstColumn; column < firstColumn + count; ++column) {
+                    switch(sqlite3_column_type(stmt, column)) {
+                        case SQLITE_INTEGER:
+                            res += 'i';
+                            res += std::to_string(sqlite3_column_int64(stmt, column));
+                            break;
+                        case SQLITE_FLOAT:{
+                            auto real = sqlite3_column_double(stmt, column);
+                            uint64 bits;
+                            std::memcpy(&bits, &real, sizeof(bits));
+                            res += 'f';
+                            for(auto shift = 60; shift >= 0; shift -= 4) {
+                                res += hex_digit(static_cast<int>((bits >> shift) & 0xf));
+                            }
+                        }break;
+                        case SQLITE_TEXT:
+                        case SQLITE_BLOB:{
+                            auto isText = sqlite3_column_type(stmt, column) == SQLITE_TEXT;
+                            auto data = static_cast<const unsigned char*>(isText ? sqlite3_column_text(stmt, column) : sqlite3_column_blob(stmt, column));
+                            auto length = sqlite3_column_bytes(stmt, column);
+                            res += isText ? 't' : 'b';
+                            for(auto i = 0; i < length; ++i) {
+                                res += hex_digit(data[i] >> 4);
+                                res += hex_digit(data[i] & 0xf);
+                            }
+                        }break;
+                        default:
+                            res += 'n';
+                            break;
+                    }
+                    res += ';';
+                }
+                return res;
+            }
+            
+            /**
+             *  throws std::system_error with orm_error_code::incorrect_page_token if token is corrupted or
+             *  has a different values count.
+             */
+            static std::vector<value> decode(const std::string &token, size_t count) {
+                std::vector<value> res;
+                size_t position = 0;
+                while(position < token.length()) {
+                    auto end = token.find(';', position);
+                    if(end == std::string::npos) {
+                        throw std::system_error(std::make_error_code(orm_error_code::incorrect_page_token));
+                    }
+                    auto type = token[position];
+                    auto payload = token.substr(position + 1, end - position - 1);
+                    value v;
+                    switch(type) {
+                        case 'n':
+                            if(payload.length()) {
+                                throw std::system_error(std::make_error_code(orm_error_code::incorrect_page_token));
+                            }
+                            break;
+                        case 'i':{
+                            char *parsedEnd = nullptr;
+                            v.type = SQLITE_INTEGER;
+                            v.integer = std::strtoll(payload.c_str(), &parsedEnd, 10);
+                            if(payload.empty() || *parsedEnd) {
+                                throw std::system_error(std::make_error_code(orm_error_code::incorrect_page_token));
+                            }
+                        }break;
+                        case 'f':{
+                            auto bytes = from_hex(payload);
+                            if(bytes.length() != sizeof(uint64)) {
+                                throw std::system_error(std::make_error_code(orm_error_code::incorrect_page_token));
+                            }
+                            uint64 bits = 0;
+                            for(auto c : bytes) {
+                                bits = (bits << 8) | static_cast<unsigned char>(c);
+                            }
+                            v.type = SQLITE_FLOAT;
+                            std::memcpy(&v.real, &bits, sizeof(bits));
+                        }break;
+                        case 't':
+                            v.type = SQLITE_TEXT;
+                            v.bytes = from_hex(payload);
+                            break;
+                        case 'b':
+                            v.type = SQLITE_BLOB;
+                            v.bytes = from_hex(payload);
+                            break;
+                        default:
+                            throw std::system_error(std::make_error_code(orm_error_code::incorrect_page_token));
+                    }
+                    res.push_back(std::move(v));
+                    position = end + 1;
+                }
+                if(res.size() != count) {
+                    throw std::system_error(std::make_error_code(orm_error_code::incorrect_page_token));
+                }
+                return res;
+            }
+            
+            static int bind(sqlite3_stmt *stmt, int index, const value &v) {
+                switch(v.type) {
+                    case SQLITE_INTEGER:
+                        return sqlite3_bind_int64(stmt, index, v.integer);
+                    case SQLITE_FLOAT:
+                        return sqlite3_bind_double(stmt, index, v.real);
+                    case SQLITE_TEXT:
+                        return sqlite3_bind_text(stmt, index, v.bytes.c_str(), static_cast<int>(v.bytes.length()), SQLITE_TRANSIENT);
+                    case SQLITE_BLOB:
+                        return sqlite3_bind_blob(stmt, index, v.bytes.data(), static_cast<int>(v.bytes.length()), SQLITE_TRANSIENT);
+                    default:
+                        return sqlite3_bind_null(stmt, index);
+                }
+            }
+            
+        protected:
+            static char hex_digit(int value) {
+                return "0123456789abcdef"[value];
+            }
+            
+            static std::string from_hex(const std::string &hex) {
+                if(hex.length() % 2) {
+                    throw std::system_error(std::make_error_code(orm_error_code::incorrect_page_token));
+                }
+                std::string res;
+                res.reserve(hex.length() / 2);
+                for(size_t i = 0; i < hex.length(); i += 2) {
+                    res += static_cast<char>(hex_value(hex[i]) * 16 + hex_value(hex[i + 1]));
+                }
+                return res;
+            }
+            
+            static int hex_value(char c) {
+                if(c >= '0' && c <= '9') {
+                    return c - '0';
+                }else if(c >= 'a' && c <= 'f') {
+                    return c - 'a' + 10;
+                }else{
+                    throw std::system_error(std::make_error_code(orm_error_code::incorrect_page_token));
+                }
+            }
+        };
+    }
+}
+#pragma once
+
 #include <string>   //  std::string
 #include <sqlite3.h>    
 #include <cstddef>  //  std::nullptr_t
 #include <system_error> //  std::system_error, std::error_code
 #include <sstream>  //  std::stringstream
-#include <cstdlib>  //  std::atoi
 #include <type_traits>  //  std::forward, std::enable_if, std::is_same, std::remove_reference
 #include <utility>  //  std::pair, std::make_pair
 #include <vector>   //  std::vector
 #include <algorithm>    //  std::find_if
+#include <map>  //  std::map
 
 // #include "error_code.h"
 
+// #include "database_connection.h"
+
 // #include "statement_finalizer.h"
 
+// #include "statement_resetter.h"
+
+// #include "statement_binder.h"
+
 // #include "row_extractor.h"
 
 // #include "constraints.h"
@@ -4751,6 +6599,39 @@ namespace sqlite_orm {
     
     namespace internal {
         
+        /**
+         *  Columns info of db tables. Key is a table name.
+         */
+        using tables_info = std::map<std::string, std::vector<table_info>>;
+        
+        /**
+         *  Index stored in `sqlite_master`. `sql` is `CREATE INDEX` statement the index was created with.
+         */
+        struct index_info {
+            std::string table_name;
+            std::string sql;
+        };
+        
+        /**
+         *  Explicitly created indexes of db. Key is an index name.
+         */
+        using indexes_info = std::map<std::string, index_info>;
+        
+        /**
+         *  Empty base of every storage_impl which table is mapped to O. Is used to find storage_impl
+         *  of a type without recursive lookup through the inheritance chain.
+         */
+        template<class O, class S>
+        struct storage_impl_tag {};
+        
+        /**
+         *  @return storage_impl S of type O deduced from its unique storage_impl_tag base.
+         */
+        template<class O, class S>
+        S& find_storage_impl(storage_impl_tag<O, S> &tag) {
+            return static_cast<S&>(tag);
+        }
+        
         /**
          *  This is a generic implementation. Used as a tail in storage_impl inheritance chain
          */
@@ -4764,28 +6645,155 @@ namespace sqlite_orm {
                 return 0;
             }
             
-            template<class O>
-            std::string dump(const O &, sqlite3 *, std::nullptr_t) {
-                throw std::system_error(std::make_error_code(orm_error_code::type_is_not_mapped_to_storage));
+            template<class O>
+            std::string dump(const O &, sqlite3 *, std::nullptr_t) {
+                throw std::system_error(std::make_error_code(orm_error_code::type_is_not_mapped_to_storage));
+            }
+            
+            bool table_exists(const std::string &tableName, database_connection &connection) {
+                auto db = connection.get_db();
+                auto stmt = connection.get_statement("SELECT COUNT(*) FROM sqlite_master WHERE type = 'table' AND name = ?");
+                statement_resetter resetter{stmt};
+                statement_binder<std::string>().bind(stmt, 1, tableName);
+                if(sqlite3_step(stmt) == SQLITE_ROW) {
+                    return !!row_extractor<int>().extract(stmt, 0);
+                }else{
+                    throw std::system_error(std::error_code(sqlite3_errcode(db), get_sqlite_error_category()));
+                }
+            }
+            
+            std::vector<std::string> table_names(database_connection &connection) {
+                auto db = connection.get_db();
+                std::vector<std::string> res;
+                auto stmt = connection.get_statement("SELECT name FROM sqlite_master WHERE type = 'table'");
+                statement_resetter resetter{stmt};
+                int stepRes;
+                do{
+                    stepRes = sqlite3_step(stmt);
+                    switch(stepRes){
+                        case SQLITE_ROW:{
+                            res.push_back(row_extractor<std::string>().extract(stmt, 0));
+                        }break;
+                        case SQLITE_DONE: break;
+                        default:{
+                            throw std::system_error(std::error_code(sqlite3_errcode(db), get_sqlite_error_category()));
+                        }
+                    }
+                }while(stepRes != SQLITE_DONE);
+                return res;
             }
             
-            bool table_exists(const std::string &tableName, sqlite3 *db) {
-                auto res = false;
+            std::vector<table_info> get_table_info(const std::string &tableName, database_connection &connection) {
+                auto db = connection.get_db();
+                std::vector<table_info> res;
+#if SQLITE_VERSION_NUMBER >= 3016000
+                auto stmt = connection.get_statement("SELECT cid, name, type, \"notnull\", dflt_value, pk FROM pragma_table_info(?)");
+                statement_resetter resetter{stmt};
+                statement_binder<std::string>().bind(stmt, 1, tableName);
+#else
+                //  PRAGMA statement cannot have bound parameters so table name is escaped and query is not cached
                 std::stringstream ss;
-                ss << "SELECT COUNT(*) FROM sqlite_master WHERE type = '" << "table" << "' AND name = '" << tableName << "'";
+                ss << "PRAGMA table_info('";
+                for(auto c : tableName) {
+                    if(c == '\''){
+                        ss << c;
+                    }
+                    ss << c;
+                }
+                ss << "')";
                 auto query = ss.str();
-                auto rc = sqlite3_exec(db,
-                                       query.c_str(),
-                                       [](void *data, int argc, char **argv,char ** /*azColName*/) -> int {
-                                           auto &res = *(bool*)data;
-                                           if(argc){
-                                               res = !!std::atoi(argv[0]);
-                                           }
-                                           return 0;
-                                       }, &res, nullptr);
-                if(rc != SQLITE_OK) {
+                sqlite3_stmt *stmt;
+                if(sqlite3_prepare_v2(db, query.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
                     throw std::system_error(std::error_code(sqlite3_errcode(db), get_sqlite_error_category()));
                 }
+                statement_finalizer finalizer{stmt};
+#endif
+                int stepRes;
+                do{
+                    stepRes = sqlite3_step(stmt);
+                    switch(stepRes){
+                        case SQLITE_ROW:{
+                            auto cid = row_extractor<int>().extract(stmt, 0);
+                            auto name = row_extractor<std::string>().extract(stmt, 1);
+                            auto type = row_extractor<std::string>().extract(stmt, 2);
+                            auto notnull = row_extractor<bool>().extract(stmt, 3);
+                            auto dflt_value = row_extractor<std::string>().extract(stmt, 4);
+                            auto pk = row_extractor<int>().extract(stmt, 5);
+                            res.push_back(table_info{cid, std::move(name), std::move(type), notnull, std::move(dflt_value), pk});
+                        }break;
+                        case SQLITE_DONE: break;
+                        default:{
+                            throw std::system_error(std::error_code(sqlite3_errcode(db), get_sqlite_error_category()));
+                        }
+                    }
+                }while(stepRes != SQLITE_DONE);
+                return res;
+            }
+            
+            /**
+             *  Loads explicitly created indexes. Indexes created automatically for UNIQUE and PRIMARY KEY
+             *  constraints have no sql and are skipped.
+             */
+            indexes_info get_indexes_info(database_connection &connection) {
+                auto db = connection.get_db();
+                indexes_info res;
+                auto stmt = connection.get_statement("SELECT name, tbl_name, sql FROM sqlite_master WHERE type = 'index' AND sql IS NOT NULL");
+                statement_resetter resetter{stmt};
+                int stepRes;
+                do{
+                    stepRes = sqlite3_step(stmt);
+                    switch(stepRes){
+                        case SQLITE_ROW:{
+                            auto name = row_extractor<std::string>().extract(stmt, 0);
+                            auto tableName = row_extractor<std::string>().extract(stmt, 1);
+                            auto sql = row_extractor<std::string>().extract(stmt, 2);
+                            res.insert({std::move(name), index_info{std::move(tableName), std::move(sql)}});
+                        }break;
+                        case SQLITE_DONE: break;
+                        default:{
+                            throw std::system_error(std::error_code(sqlite3_errcode(db), get_sqlite_error_category()));
+                        }
+                    }
+                }while(stepRes != SQLITE_DONE);
+                return res;
+            }
+            
+            /**
+             *  Loads columns info of every table in db. Uses single `sqlite_master` join with `pragma_table_info`
+             *  query if available so `sync_schema` needs one catalog round trip instead of two per table.
+             *  @return map with table name as key and `PRAGMA table_info` rows as value.
+             */
+            tables_info get_tables_info(database_connection &connection) {
+                tables_info res;
+#if SQLITE_VERSION_NUMBER >= 3016000
+                auto db = connection.get_db();
+                auto stmt = connection.get_statement("SELECT m.name, p.cid, p.name, p.type, p.\"notnull\", p.dflt_value, p.pk FROM sqlite_master AS m JOIN pragma_table_info(m.name) AS p WHERE m.type = 'table' ORDER BY m.name, p.cid");
+                statement_resetter resetter{stmt};
+                int stepRes;
+                do{
+                    stepRes = sqlite3_step(stmt);
+                    switch(stepRes){
+                        case SQLITE_ROW:{
+                            auto tableName = row_extractor<std::string>().extract(stmt, 0);
+                            auto cid = row_extractor<int>().extract(stmt, 1);
+                            auto name = row_extractor<std::string>().extract(stmt, 2);
+                            auto type = row_extractor<std::string>().extract(stmt, 3);
+                            auto notnull = row_extractor<bool>().extract(stmt, 4);
+                            auto dflt_value = row_extractor<std::string>().extract(stmt, 5);
+                            auto pk = row_extractor<int>().extract(stmt, 6);
+                            res[tableName].push_back(table_info{cid, std::move(name), std::move(type), notnull, std::move(dflt_value), pk});
+                        }break;
+                        case SQLITE_DONE: break;
+                        default:{
+                            throw std::system_error(std::error_code(sqlite3_errcode(db), get_sqlite_error_category()));
+                        }
+                    }
+                }while(stepRes != SQLITE_DONE);
+#else
+                for(auto &tableName : this->table_names(connection)) {
+                    res.insert({tableName, this->get_table_info(tableName, connection)});
+                }
+#endif
                 return res;
             }
             
@@ -4857,31 +6865,20 @@ namespace sqlite_orm {
                 }
             }
             
-            std::string current_timestamp(sqlite3 *db) {
-                std::string res;
-                std::stringstream ss;
-                ss << "SELECT CURRENT_TIMESTAMP";
-                auto query = ss.str();
-                auto rc = sqlite3_exec(db,
-                                       query.c_str(),
-                                       [](void *data, int argc, char **argv, char **) -> int {
-                                           auto &res = *(std::string*)data;
-                                           if(argc){
-                                               if(argv[0]){
-                                                   res = row_extractor<std::string>().extract(argv[0]);
-                                               }
-                                           }
-                                           return 0;
-                                       }, &res, nullptr);
-                if(rc != SQLITE_OK) {
+            std::string current_timestamp(database_connection &connection) {
+                auto db = connection.get_db();
+                auto stmt = connection.get_statement("SELECT CURRENT_TIMESTAMP");
+                statement_resetter resetter{stmt};
+                if(sqlite3_step(stmt) == SQLITE_ROW) {
+                    return row_extractor<std::string>().extract(stmt, 0);
+                }else{
                     throw std::system_error(std::error_code(sqlite3_errcode(db), get_sqlite_error_category()));
                 }
-                return res;
             }
         };
         
         template<class H, class ...Ts>
-        struct storage_impl<H, Ts...> : public storage_impl<Ts...> {
+        struct storage_impl<H, Ts...> : public storage_impl<Ts...>, public storage_impl_tag<typename H::object_type, storage_impl<H, Ts...>> {
             using table_type = H;
             
             storage_impl(H h, Ts ...ts) : super(std::forward<Ts>(ts)...), table(std::move(h)) {}
@@ -4938,84 +6935,42 @@ namespace sqlite_orm {
             }
             
             /**
-             *  Cute function used to find column name by its type and member pointer. Uses SFINAE to
-             *  skip inequal type O.
-             */
-            template<class O, class F, class HH = typename H::object_type>
-            std::string column_name(F O::*m, typename std::enable_if<std::is_same<O, HH>::value>::type * = nullptr) {
-                return this->table.find_column_name(m);
-            }
-            
-            /**
-             *  Opposite version of function defined above. Just calls same function in superclass.
-             */
-            template<class O, class F, class HH = typename H::object_type>
-            std::string column_name(F O::*m, typename std::enable_if<!std::is_same<O, HH>::value>::type * = nullptr) {
-                return this->super::column_name(m);
-            }
-            
-            /**
-             *  Cute function used to find column name by its type and getter pointer. Uses SFINAE to
-             *  skip inequal type O.
-             */
-            template<class O, class F, class HH = typename H::object_type>
-            std::string column_name(const F& (O::*g)() const, typename std::enable_if<std::is_same<O, HH>::value>::type * = nullptr) {
-                return this->table.find_column_name(g);
-            }
-            
-            /**
-             *  Opposite version of function defined above. Just calls same function in superclass.
+             *  Finds column name by its type and member pointer in table mapped to O.
              */
-            template<class O, class F, class HH = typename H::object_type>
-            std::string column_name(const F& (O::*g)() const, typename std::enable_if<!std::is_same<O, HH>::value>::type * = nullptr) {
-                return this->super::column_name(g);
+            template<class O, class F>
+            std::string column_name(F O::*m) {
+                return this->template get_impl<O>().table.find_column_name(m);
             }
             
             /**
-             *  Cute function used to find column name by its type and setter pointer. Uses SFINAE to
-             *  skip inequal type O.
+             *  Same thing as above for getter.
              */
-            template<class O, class F, class HH = typename H::object_type>
-            std::string column_name(void (O::*s)(F), typename std::enable_if<std::is_same<O, HH>::value>::type * = nullptr) {
-                return this->table.find_column_name(s);
+            template<class O, class F>
+            std::string column_name(const F& (O::*g)() const) {
+                return this->template get_impl<O>().table.find_column_name(g);
             }
             
             /**
-             *  Opposite version of function defined above. Just calls same function in superclass.
+             *  Same thing as above for setter.
              */
-            template<class O, class F, class HH = typename H::object_type>
-            std::string column_name(void (O::*s)(F), typename std::enable_if<!std::is_same<O, HH>::value>::type * = nullptr) {
-                return this->super::column_name(s);
-            }
-            
-            template<class T, class F, class HH = typename H::object_type>
-            std::string column_name(const column_pointer<T, F> &c, typename std::enable_if<std::is_same<T, HH>::value>::type * = nullptr) {
-                return this->column_name_simple(c.field);
-            }
-            
-            template<class T, class F, class HH = typename H::object_type>
-            std::string column_name(const column_pointer<T, F> &c, typename std::enable_if<!std::is_same<T, HH>::value>::type * = nullptr) {
-                return this->super::column_name(c);
-            }
-            
-            template<class O, class HH = typename H::object_type>
-            auto& get_impl(typename std::enable_if<std::is_same<O, HH>::value>::type * = nullptr) {
-                return *this;
+            template<class O, class F>
+            std::string column_name(void (O::*s)(F)) {
+                return this->template get_impl<O>().table.find_column_name(s);
             }
             
-            template<class O, class HH = typename H::object_type>
-            auto& get_impl(typename std::enable_if<!std::is_same<O, HH>::value>::type * = nullptr) {
-                return this->super::template get_impl<O>();
+            template<class T, class F>
+            std::string column_name(const column_pointer<T, F> &c) {
+                return this->template get_impl<T>().column_name_simple(c.field);
             }
             
-            template<class O, class HH = typename H::object_type>
-            std::string find_table_name(typename std::enable_if<std::is_same<O, HH>::value>::type * = nullptr) {
-                return this->table.name;
+            template<class O>
+            auto& get_impl() {
+                return find_storage_impl<O>(*this);
             }
             
-            template<class O, class HH = typename H::object_type>
-            std::string find_table_name(typename std::enable_if<!std::is_same<O, HH>::value>::type * = nullptr) {
-                return this->super::template find_table_name<O>();
+            template<class O>
+            std::string find_table_name() {
+                return this->template get_impl<O>().table.name;
             }
             
             template<class O, class HH = typename H::object_type>
@@ -5050,32 +7005,6 @@ namespace sqlite_orm {
                 return ss.str();
             }
             
-            std::vector<table_info> get_table_info(const std::string &tableName, sqlite3 *db) {
-                std::vector<table_info> res;
-                auto query = "PRAGMA table_info('" + tableName + "')";
-                auto rc = sqlite3_exec(db,
-                                       query.c_str(),
-                                       [](void *data, int argc, char **argv,char **) -> int {
-                                           auto &res = *(std::vector<table_info>*)data;
-                                           if(argc){
-                                               auto index = 0;
-                                               auto cid = std::atoi(argv[index++]);
-                                               std::string name = argv[index++];
-                                               std::string type = argv[index++];
-                                               bool notnull = !!std::atoi(argv[index++]);
-                                               std::string dflt_value = argv[index] ? argv[index] : "";
-                                               index++;
-                                               auto pk = std::atoi(argv[index++]);
-                                               res.push_back(table_info{cid, name, type, notnull, dflt_value, pk});
-                                           }
-                                           return 0;
-                                       }, &res, nullptr);
-                if(rc != SQLITE_OK) {
-                    throw std::system_error(std::error_code(sqlite3_errcode(db), get_sqlite_error_category()));
-                }
-                return res;
-            }
-            
             void add_column(const table_info &ti, sqlite3 *db) {
                 std::stringstream ss;
                 ss << "ALTER TABLE " << this->table.name << " ADD COLUMN " << ti.name << " ";
@@ -5104,6 +7033,38 @@ namespace sqlite_orm {
                 }
             }
             
+            /**
+             *  Drops column in place using `ALTER TABLE ... DROP COLUMN` available since SQLite 3.35.0.
+             *  @return false if column cannot be dropped in place (older SQLite or column is a part of
+             *  primary key, unique constraint, index, foreign key etc) so table has to be copied instead.
+             */
+            bool drop_column(const std::string &columnName, sqlite3 *db) {
+#if SQLITE_VERSION_NUMBER >= 3035000
+                std::stringstream ss;
+                ss << "ALTER TABLE '" << this->table.name << "' DROP COLUMN \"" << columnName << "\"";
+                auto query = ss.str();
+                sqlite3_stmt *stmt;
+                if (sqlite3_prepare_v2(db, query.c_str(), -1, &stmt, nullptr) == SQLITE_OK) {
+                    statement_finalizer finalizer{stmt};
+                    
+                    //  references from indexes, views and triggers are checked during the step
+                    switch(sqlite3_step(stmt)){
+                        case SQLITE_DONE: return true;
+                        case SQLITE_ERROR: return false;
+                        default:{
+                            throw std::system_error(std::error_code(sqlite3_errcode(db), get_sqlite_error_category()));
+                        }
+                    }
+                }else{
+                    return false;
+                }
+#else
+                (void)columnName;
+                (void)db;
+                return false;
+#endif
+            }
+            
             /**
              *  Copies current table to another table with a given **name**.
              *  Performs CREATE TABLE %name% AS SELECT %this->table.columns_names()% FROM &this->table.name%;
@@ -5149,19 +7110,23 @@ namespace sqlite_orm {
                 }
             }
             
-            sync_schema_result schema_status(sqlite3 *db, bool preserve) {
+            /**
+             *  Compares storage table with its db analog using columns info loaded by `get_tables_info`.
+             */
+            sync_schema_result schema_status(const tables_info &tablesInfo, bool preserve) {
                 
                 auto res = sync_schema_result::already_in_sync;
                 
                 //  first let's see if table with such name exists..
-                auto gottaCreateTable = !this->table_exists(this->table.name, db);
+                auto tableInfoIt = tablesInfo.find(this->table.name);
+                auto gottaCreateTable = tableInfoIt == tablesInfo.end();
                 if(!gottaCreateTable){
                     
                     //  get table info provided in `make_table` call..
                     auto storageTableInfo = this->table.get_table_info();
                     
-                    //  now get current table info from db using `PRAGMA table_info` query..
-                    auto dbTableInfo = get_table_info(this->table.name, db);
+                    //  now get current table info from db loaded by `get_tables_info`..
+                    auto dbTableInfo = tableInfoIt->second;
                     
                     //  this vector will contain pointers to columns that gotta be added..
                     std::vector<table_info*> columnsToAdd;
@@ -5275,7 +7240,7 @@ namespace sqlite_orm {
 #include <sqlite3.h>
 #include <type_traits>  //  std::remove_reference, std::is_base_of, std::decay
 #include <cstddef>  //  std::ptrdiff_t
-#include <iterator> //  std::input_iterator_tag, std::iterator_traits, std::distance
+#include <iterator> //  std::input_iterator_tag, std::iterator_traits, std::distance, std::back_inserter
 #include <system_error> //  std::system_error
 #include <functional>   //  std::function
 #include <sstream>  //  std::stringstream
@@ -5284,7 +7249,13 @@ namespace sqlite_orm {
 #include <tuple>    //  std::tuple_size, std::tuple
 #include <utility>  //  std::forward
 #include <set>  //  std::set
-#include <algorithm>    //  std::find
+#include <algorithm>    //  std::find, std::copy_if, std::min, std::max
+#include <cctype>   //  std::isspace
+#include <iomanip>  //  std::setw, std::setfill
+#include <chrono>   //  std::chrono::steady_clock, std::chrono::duration_cast
+#include <thread>   //  std::this_thread::yield
+#include <limits>   //  std::numeric_limits
+#include <cassert>  //  assert
 
 // #include "alias.h"
 
@@ -5294,6 +7265,8 @@ namespace sqlite_orm {
 
 // #include "statement_finalizer.h"
 
+// #include "statement_resetter.h"
+
 // #include "error_code.h"
 
 // #include "type_printer.h"
@@ -5308,6 +7281,8 @@ namespace sqlite_orm {
 
 // #include "field_printer.h"
 
+// #include "field_comparator.h"
+
 // #include "rowid.h"
 
 // #include "aggregate_functions.h"
@@ -5328,8 +7303,22 @@ namespace sqlite_orm {
 
 // #include "sync_schema_result.h"
 
+// #include "migration_progress.h"
+
+// #include "tracer.h"
+
+// #include "query_plan.h"
+
+// #include "storage_stats.h"
+
+// #include "instrumentation.h"
+
 // #include "table_info.h"
 
+// #include "primary_key_value.h"
+
+// #include "pagination.h"
+
 // #include "storage_impl.h"
 
 // #include "transaction_guard.h"
@@ -5402,27 +7391,35 @@ namespace sqlite_orm {
         
         /**
          *  Storage class itself. Create an instanse to use it as an interfacto to sqlite db by calling `make_storage` function.
+         *  P - instrumentation policy (see `no_instrumentation` and `latency_instrumentation`)
          */
-        template<class ...Ts>
-        struct storage_t {
-            using storage_type = storage_t<Ts...>;
+        template<class P, class ...Ts>
+        struct basic_storage {
+            using storage_type = basic_storage<P, Ts...>;
             using impl_type = storage_impl<Ts...>;
+            using instrumentation_type = P;
             
             template<class T, class ...Args>
             struct view_t {
                 using mapped_type = T;
                 
-                storage_t &storage;
+                basic_storage &storage;
                 std::shared_ptr<internal::database_connection> connection;
                 
+                /**
+                 *  Owns temp tables of `in` conditions used by `query`.
+                 */
+                internal::query_context context;
+                
                 const std::string query;
                 
-                view_t(storage_t &stor, decltype(connection) conn, Args&& ...args):
+                view_t(basic_storage &stor, decltype(connection) conn, Args&& ...args):
                 storage(stor),
                 connection(conn),
-                query([&args..., &stor]{
+                context(conn),
+                query([&args..., &stor, this]{
                     std::string q;
-                    stor.template generate_select_asterisk<T>(&q, args...);
+                    stor.template generate_select_asterisk<T>(this->context, &q, args...);
                     return q;
                 }()){}
                 
@@ -5586,7 +7583,7 @@ namespace sqlite_orm {
                     this->set_pragma("auto_vacuum", value);
                 }
                 
-                friend struct storage_t<Ts...>;
+                friend struct basic_storage<P, Ts...>;
                 
             protected:
                 storage_type &storage;
@@ -5595,28 +7592,22 @@ namespace sqlite_orm {
                 template<class T>
                 T get_pragma(const std::string &name) {
                     auto connection = this->storage.get_or_create_connection();
-                    std::string query = "PRAGMA " + name;
-                    int res = -1;
-                    auto rc = sqlite3_exec(connection->get_db(),
-                                           query.c_str(),
-                                           [](void *data, int argc, char **argv, char **) -> int {
-                                               auto &res = *(T*)data;
-                                               if(argc){
-                                                   res = row_extractor<T>().extract(argv[0]);
-                                               }
-                                               return 0;
-                                           }, &res, nullptr);
-                    if(rc != SQLITE_OK) {
-                        throw std::system_error(std::error_code(sqlite3_errcode(connection->get_db()), get_sqlite_error_category()));
+                    auto db = connection->get_db();
+                    auto stmt = connection->get_statement("PRAGMA " + name);
+                    statement_resetter resetter{stmt};
+                    if(sqlite3_step(stmt) == SQLITE_ROW) {
+                        return row_extractor<T>().extract(stmt, 0);
+                    }else{
+                        throw std::system_error(std::error_code(sqlite3_errcode(db), get_sqlite_error_category()));
                     }
-                    return res;
                 }
                 
                 template<class T>
                 void set_pragma(const std::string &name, const T &value) {
                     auto connection = this->storage.get_or_create_connection();
+                    internal::query_context context{nullptr};
                     std::stringstream ss;
-                    ss << "PRAGMA " << name << " = " << this->storage.string_from_expression(value);
+                    ss << "PRAGMA " << name << " = " << this->storage.string_from_expression(context, value);
                     auto query = ss.str();
                     auto rc = sqlite3_exec(connection->get_db(), query.c_str(), nullptr, nullptr, nullptr);
                     if(rc != SQLITE_OK) {
@@ -5731,7 +7722,7 @@ namespace sqlite_orm {
                  */
                 std::map<int, int> limits;
                 
-                friend struct storage_t<Ts...>;
+                friend struct basic_storage<P, Ts...>;
                 
                 limit_accesor(decltype(storage) storage_): storage(storage_) {}
                 
@@ -5750,7 +7741,7 @@ namespace sqlite_orm {
             /**
              *  @param filename_ database filename.
              */
-            storage_t(const std::string &filename_, impl_type impl_):
+            basic_storage(const std::string &filename_, impl_type impl_):
             filename(filename_),
             impl(impl_),
             inMemory(filename_.empty() || filename_ == ":memory:"),
@@ -5762,14 +7753,20 @@ namespace sqlite_orm {
                 }
             }
             
-            storage_t(const storage_t &other):
+            basic_storage(const basic_storage &other):
             filename(other.filename),
             impl(other.impl),
             inMemory(other.inMemory),
             pragma(*this),
             limit(*this),
             collatingFunctions(other.collatingFunctions),
-            currentTransaction(other.currentTransaction)
+            currentTransaction(other.currentTransaction),
+            useSchemaFingerprint(other.useSchemaFingerprint),
+            migrationChunkSize(other.migrationChunkSize),
+            onMigrationProgress(other.onMigrationProgress),
+            tracer(other.tracer),
+            largeTables(other.largeTables),
+            instrumentationPolicy(other.instrumentationPolicy)
             {}
             
         protected:
@@ -5780,6 +7777,23 @@ namespace sqlite_orm {
             std::shared_ptr<internal::database_connection> currentTransaction;
             const bool inMemory;
             bool isOpenedForever = false;
+            bool useSchemaFingerprint = false;
+            int migrationChunkSize = 0;
+            std::function<void(const migration_progress&)> onMigrationProgress;
+            
+            /**
+             *  Is shared between storage copies cause connections keep pointer to it as a trace context.
+             */
+            std::shared_ptr<internal::tracer> tracer = std::make_shared<internal::tracer>();
+            
+            /**
+             *  Tables which must not be scanned. See `mark_large_table`.
+             */
+            std::set<std::string> largeTables;
+            
+            instrumentation_type instrumentationPolicy;
+            
+            using measurement_type = typename instrumentation_type::measurement;
             std::map<std::string, collating_function> collatingFunctions;
             
             using collating_function_pair = typename decltype(collatingFunctions)::value_type;
@@ -5848,8 +7862,11 @@ namespace sqlite_orm {
             }
 #endif
             
+            /**
+             *  Returns `CREATE TABLE` query for a table with a given name and columns of impl's table.
+             */
             template<class I>
-            void create_table(sqlite3 *db, const std::string &tableName, I *impl) {
+            std::string create_table_query(const std::string &tableName, I *impl) {
                 std::stringstream ss;
                 ss << "CREATE TABLE '" << tableName << "' ( ";
                 auto columnsCount = impl->table.columns_count();
@@ -5865,7 +7882,12 @@ namespace sqlite_orm {
                 if(impl->table._without_rowid) {
                     ss << "WITHOUT ROWID ";
                 }
-                auto query = ss.str();
+                return ss.str();
+            }
+            
+            template<class I>
+            void create_table(sqlite3 *db, const std::string &tableName, I *impl) {
+                auto query = this->create_table_query(tableName, impl);
                 sqlite3_stmt *stmt;
                 if (sqlite3_prepare_v2(db, query.c_str(), -1, &stmt, nullptr) == SQLITE_OK) {
                     statement_finalizer finalizer{stmt};
@@ -5880,18 +7902,19 @@ namespace sqlite_orm {
             }
             
             template<class I>
-            void backup_table(sqlite3 *db, I *impl) {
+            void backup_table(database_connection &connection, I *impl) {
+                auto db = connection.get_db();
                 
                 //  here we copy source table to another with a name with '_backup' suffix, but in case table with such
                 //  a name already exists we append suffix 1, then 2, etc until we find a free name..
                 auto backupTableName = impl->table.name + "_backup";
-                if(impl->table_exists(backupTableName, db)){
+                if(impl->table_exists(backupTableName, connection)){
                     int suffix = 1;
                     do{
                         std::stringstream stream;
                         stream << suffix;
                         auto anotherBackupTableName = backupTableName + stream.str();
-                        if(!impl->table_exists(anotherBackupTableName, db)){
+                        if(!impl->table_exists(anotherBackupTableName, connection)){
                             backupTableName = anotherBackupTableName;
                             break;
                         }
@@ -5901,6 +7924,13 @@ namespace sqlite_orm {
                 
                 this->create_table(db, backupTableName, impl);
                 
+                //  chunks need their own transactions so online mode is not available inside user's transaction
+                //  and rows are copied in rowid order so WITHOUT ROWID tables are copied at once
+                if(this->migrationChunkSize > 0 && sqlite3_get_autocommit(db) && !impl->table._without_rowid) {
+                    this->copy_table_online(connection, impl, backupTableName);
+                    return;
+                }
+                
                 impl->copy_table(db, backupTableName);
                 
                 this->drop_table_internal(impl->table.name, db);
@@ -5908,6 +7938,143 @@ namespace sqlite_orm {
                 impl->rename_table(db, backupTableName, impl->table.name);
             }
             
+            /**
+             *  Online version of `copy_table` + `drop_table_internal` + `rename_table` sequence. Rows are copied
+             *  in rowid order by chunks of `migrationChunkSize` rows and every chunk is copied within its own short
+             *  transaction so other connections can read and write the table between chunks. Changes made to
+             *  the source table during copying are mirrored to the copy by triggers. Finally source table is
+             *  dropped and the copy is renamed within a single transaction.
+             */
+            template<class I>
+            void copy_table_online(database_connection &connection, I *impl, const std::string &backupTableName) {
+                auto db = connection.get_db();
+                auto &tableName = impl->table.name;
+                
+                //  only columns existing both in storage and in db can be copied..
+                auto dbTableInfo = impl->get_table_info(tableName, connection);
+                std::stringstream columnsStream;
+                std::stringstream newValuesStream;
+                impl->table.for_each_column([&columnsStream, &newValuesStream, &dbTableInfo](auto &c) {
+                    auto it = std::find_if(dbTableInfo.begin(),
+                                           dbTableInfo.end(),
+                                           [&c](const table_info &ti) {
+                                               return ti.name == c.name;
+                                           });
+                    if(it != dbTableInfo.end()) {
+                        columnsStream << ", \"" << c.name << "\"";
+                        newValuesStream << ", NEW.\"" << c.name << "\"";
+                    }
+                });
+                auto columns = columnsStream.str();
+                auto newValues = newValuesStream.str();
+                
+                std::stringstream ss;
+                ss << "CREATE TRIGGER '" << backupTableName << "_insert' AFTER INSERT ON '" << tableName << "' BEGIN ";
+                ss << "INSERT OR REPLACE INTO '" << backupTableName << "' (rowid" << columns << ") VALUES (NEW.rowid" << newValues << "); END; ";
+                ss << "CREATE TRIGGER '" << backupTableName << "_update' AFTER UPDATE ON '" << tableName << "' BEGIN ";
+                ss << "DELETE FROM '" << backupTableName << "' WHERE rowid = OLD.rowid; ";
+                ss << "INSERT OR REPLACE INTO '" << backupTableName << "' (rowid" << columns << ") VALUES (NEW.rowid" << newValues << "); END; ";
+                ss << "CREATE TRIGGER '" << backupTableName << "_delete' AFTER DELETE ON '" << tableName << "' BEGIN ";
+                ss << "DELETE FROM '" << backupTableName << "' WHERE rowid = OLD.rowid; END;";
+                
+                //  triggers write into the copy so on failure they are dropped together with the copy,
+                //  otherwise the source table stays unwritable
+                auto cleanup = [db, &backupTableName]{
+                    auto query = "DROP TRIGGER IF EXISTS '" + backupTableName + "_insert'; "
+                    "DROP TRIGGER IF EXISTS '" + backupTableName + "_update'; "
+                    "DROP TRIGGER IF EXISTS '" + backupTableName + "_delete'; "
+                    "DROP TABLE IF EXISTS '" + backupTableName + "';";
+                    sqlite3_exec(db, query.c_str(), nullptr, nullptr, nullptr);
+                };
+                try{
+                    auto query = ss.str();
+                    if(sqlite3_exec(db, query.c_str(), nullptr, nullptr, nullptr) != SQLITE_OK) {
+                        throw std::system_error(std::error_code(sqlite3_errcode(db), get_sqlite_error_category()));
+                    }
+                    
+                    migration_progress progress{tableName, 0, 0, std::chrono::milliseconds::zero(), std::chrono::milliseconds::zero()};
+                    {
+                        auto stmt = connection.get_statement("SELECT COUNT(*) FROM '" + tableName + "'");
+                        statement_resetter resetter{stmt};
+                        if(sqlite3_step(stmt) == SQLITE_ROW) {
+                            progress.rows_total = row_extractor<int64>().extract(stmt, 0);
+                        }else{
+                            throw std::system_error(std::error_code(sqlite3_errcode(db), get_sqlite_error_category()));
+                        }
+                    }
+                    
+                    auto boundsQuery = "SELECT MAX(rowid), COUNT(*) FROM (SELECT rowid FROM '" + tableName + "' WHERE rowid > ? ORDER BY rowid LIMIT ?)";
+                    auto copyQuery = "INSERT OR REPLACE INTO '" + backupTableName + "' (rowid" + columns + ") SELECT rowid" + columns + " FROM '" + tableName + "' WHERE rowid > ? AND rowid <= ?";
+                    auto startTime = std::chrono::steady_clock::now();
+                    auto lastRowid = std::numeric_limits<int64>::min();
+                    int64 chunkRowsCount;
+                    do{
+                        impl->begin_transaction(db);
+                        try{
+                            int64 chunkLastRowid = lastRowid;
+                            {
+                                auto stmt = connection.get_statement(boundsQuery);
+                                statement_resetter resetter{stmt};
+                                statement_binder<int64>().bind(stmt, 1, lastRowid);
+                                statement_binder<int>().bind(stmt, 2, this->migrationChunkSize);
+                                if(sqlite3_step(stmt) == SQLITE_ROW) {
+                                    chunkRowsCount = row_extractor<int64>().extract(stmt, 1);
+                                    if(chunkRowsCount) {
+                                        chunkLastRowid = row_extractor<int64>().extract(stmt, 0);
+                                    }
+                                }else{
+                                    throw std::system_error(std::error_code(sqlite3_errcode(db), get_sqlite_error_category()));
+                                }
+                            }
+                            if(chunkRowsCount) {
+                                auto stmt = connection.get_statement(copyQuery);
+                                statement_resetter resetter{stmt};
+                                statement_binder<int64>().bind(stmt, 1, lastRowid);
+                                statement_binder<int64>().bind(stmt, 2, chunkLastRowid);
+                                if(sqlite3_step(stmt) != SQLITE_DONE) {
+                                    throw std::system_error(std::error_code(sqlite3_errcode(db), get_sqlite_error_category()));
+                                }
+                            }
+                            impl->commit(db);
+                            lastRowid = chunkLastRowid;
+                        }catch(...){
+                            impl->rollback(db);
+                            throw;
+                        }
+                        if(chunkRowsCount) {
+                            progress.rows_copied += chunkRowsCount;
+                            progress.elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - startTime);
+                            auto rowsLeft = progress.rows_total - progress.rows_copied;
+                            if(rowsLeft > 0) {
+                                progress.eta = std::chrono::duration_cast<std::chrono::milliseconds>(progress.elapsed * rowsLeft / progress.rows_copied);
+                            }else{
+                                progress.eta = std::chrono::milliseconds::zero();
+                            }
+                            if(this->onMigrationProgress) {
+                                this->onMigrationProgress(progress);
+                            }
+                            
+                            //  let other threads take the lock before the next chunk..
+                            std::this_thread::yield();
+                        }
+                    }while(chunkRowsCount);
+                    
+                    //  triggers are dropped together with source table
+                    impl->begin_transaction(db);
+                    try{
+                        this->drop_table_internal(tableName, db);
+                        impl->rename_table(db, backupTableName, tableName);
+                        impl->commit(db);
+                    }catch(...){
+                        impl->rollback(db);
+                        throw;
+                    }
+                }catch(...){
+                    cleanup();
+                    throw;
+                }
+            }
+            
             template<class O>
             void assert_mapped_type() {
                 using mapped_types_tuples = std::tuple<typename Ts::object_type...>;
@@ -5932,7 +8099,7 @@ namespace sqlite_orm {
             }
             
             template<class T>
-            std::string string_from_expression(T t, bool /*noTableName*/ = false, bool escape = false) {
+            std::string string_from_expression(internal::query_context &/*context*/, T t, bool /*noTableName*/ = false, bool escape = false) {
                 auto isNullable = type_is_nullable<T>::value;
                 if(isNullable && !type_is_nullable<T>()(t)){
                     return "NULL";
@@ -5955,16 +8122,16 @@ namespace sqlite_orm {
             }
             
             template<class T, class C>
-            std::string string_from_expression(const alias_column_t<T, C> &als, bool noTableName = false, bool /*escape*/ = false) {
+            std::string string_from_expression(internal::query_context &context, const alias_column_t<T, C> &als, bool noTableName = false, bool /*escape*/ = false) {
                 std::stringstream ss;
                 if(!noTableName){
                     ss << "'" << T::get() << "'.";
                 }
-                ss << this->string_from_expression(als.column, true);
+                ss << this->string_from_expression(context, als.column, true);
                 return ss.str();
             }
             
-            std::string string_from_expression(const std::string &t, bool /*noTableName*/ = false, bool escape = false) {
+            std::string string_from_expression(internal::query_context &/*context*/, const std::string &t, bool /*noTableName*/ = false, bool escape = false) {
                 std::stringstream ss;
                 std::string text = t;
                 if(escape){
@@ -5974,7 +8141,7 @@ namespace sqlite_orm {
                 return ss.str();
             }
             
-            std::string string_from_expression(const char *t, bool /*noTableName*/ = false, bool escape = false) {
+            std::string string_from_expression(internal::query_context &/*context*/, const char *t, bool /*noTableName*/ = false, bool escape = false) {
                 std::stringstream ss;
                 std::string text = t;
                 if(escape){
@@ -5985,7 +8152,7 @@ namespace sqlite_orm {
             }
             
             template<class F, class O>
-            std::string string_from_expression(F O::*m, bool noTableName = false, bool /*escape*/ = false) {
+            std::string string_from_expression(internal::query_context &/*context*/, F O::*m, bool noTableName = false, bool /*escape*/ = false) {
                 std::stringstream ss;
                 if(!noTableName){
                     ss << "'" << this->impl.template find_table_name<O>() << "'.";
@@ -5994,20 +8161,20 @@ namespace sqlite_orm {
                 return ss.str();
             }
             
-            std::string string_from_expression(const rowid_t &rid, bool /*noTableName*/ = false, bool /*escape*/ = false) {
+            std::string string_from_expression(internal::query_context &/*context*/, const rowid_t &rid, bool /*noTableName*/ = false, bool /*escape*/ = false) {
                 return static_cast<std::string>(rid);
             }
             
-            std::string string_from_expression(const oid_t &rid, bool /*noTableName*/ = false, bool /*escape*/ = false) {
+            std::string string_from_expression(internal::query_context &/*context*/, const oid_t &rid, bool /*noTableName*/ = false, bool /*escape*/ = false) {
                 return static_cast<std::string>(rid);
             }
             
-            std::string string_from_expression(const _rowid_t &rid, bool /*noTableName*/ = false, bool /*escape*/ = false) {
+            std::string string_from_expression(internal::query_context &/*context*/, const _rowid_t &rid, bool /*noTableName*/ = false, bool /*escape*/ = false) {
                 return static_cast<std::string>(rid);
             }
             
             template<class O>
-            std::string string_from_expression(const table_rowid_t<O> &rid, bool noTableName = false, bool /*escape*/ = false) {
+            std::string string_from_expression(internal::query_context &/*context*/, const table_rowid_t<O> &rid, bool noTableName = false, bool /*escape*/ = false) {
                 std::stringstream ss;
                 if(!noTableName){
                     ss << "'" << this->impl.template find_table_name<O>() << "'.";
@@ -6017,7 +8184,7 @@ namespace sqlite_orm {
             }
             
             template<class O>
-            std::string string_from_expression(const table_oid_t<O> &rid, bool noTableName = false, bool /*escape*/ = false) {
+            std::string string_from_expression(internal::query_context &/*context*/, const table_oid_t<O> &rid, bool noTableName = false, bool /*escape*/ = false) {
                 std::stringstream ss;
                 if(!noTableName){
                     ss << "'" << this->impl.template find_table_name<O>() << "'.";
@@ -6027,7 +8194,7 @@ namespace sqlite_orm {
             }
             
             template<class O>
-            std::string string_from_expression(const table__rowid_t<O> &rid, bool noTableName = false, bool /*escape*/ = false) {
+            std::string string_from_expression(internal::query_context &/*context*/, const table__rowid_t<O> &rid, bool noTableName = false, bool /*escape*/ = false) {
                 std::stringstream ss;
                 if(!noTableName){
                     ss << "'" << this->impl.template find_table_name<O>() << "'.";
@@ -6037,236 +8204,236 @@ namespace sqlite_orm {
             }
             
             template<class T>
-            std::string string_from_expression(const aggregate_functions::group_concat_double_t<T> &f, bool /*noTableName*/ = false, bool /*escape*/ = false) {
+            std::string string_from_expression(internal::query_context &context, const aggregate_functions::group_concat_double_t<T> &f, bool /*noTableName*/ = false, bool /*escape*/ = false) {
                 std::stringstream ss;
-                auto expr = this->string_from_expression(f.t);
-                auto expr2 = this->string_from_expression(f.y);
+                auto expr = this->string_from_expression(context, f.t);
+                auto expr2 = this->string_from_expression(context, f.y);
                 ss << static_cast<std::string>(f) << "(" << expr << ", " << expr2 << ") ";
                 return ss.str();
             }
             
             template<class T>
-            std::string string_from_expression(const aggregate_functions::group_concat_single_t<T> &f, bool /*noTableName*/ = false, bool /*escape*/ = false) {
+            std::string string_from_expression(internal::query_context &context, const aggregate_functions::group_concat_single_t<T> &f, bool /*noTableName*/ = false, bool /*escape*/ = false) {
                 std::stringstream ss;
-                auto expr = this->string_from_expression(f.t);
+                auto expr = this->string_from_expression(context, f.t);
                 ss << static_cast<std::string>(f) << "(" << expr << ") ";
                 return ss.str();
             }
             
             template<class L, class R>
-            std::string string_from_expression(const conc_t<L, R> &f, bool /*noTableName*/ = false, bool /*escape*/ = false) {
+            std::string string_from_expression(internal::query_context &context, const conc_t<L, R> &f, bool noTableName = false, bool /*escape*/ = false) {
                 std::stringstream ss;
-                auto lhs = this->string_from_expression(f.l);
-                auto rhs = this->string_from_expression(f.r);
+                auto lhs = this->string_from_expression(context, f.l, noTableName);
+                auto rhs = this->string_from_expression(context, f.r, noTableName);
                 ss << "(" << lhs << " || " << rhs << ") ";
                 return ss.str();
             }
             
             template<class L, class R>
-            std::string string_from_expression(const add_t<L, R> &f, bool /*noTableName*/ = false, bool /*escape*/ = false) {
+            std::string string_from_expression(internal::query_context &context, const add_t<L, R> &f, bool noTableName = false, bool /*escape*/ = false) {
                 std::stringstream ss;
-                auto lhs = this->string_from_expression(f.l);
-                auto rhs = this->string_from_expression(f.r);
+                auto lhs = this->string_from_expression(context, f.l, noTableName);
+                auto rhs = this->string_from_expression(context, f.r, noTableName);
                 ss << "(" << lhs << " + " << rhs << ") ";
                 return ss.str();
             }
             
             template<class L, class R>
-            std::string string_from_expression(const sub_t<L, R> &f, bool /*noTableName*/ = false, bool /*escape*/ = false) {
+            std::string string_from_expression(internal::query_context &context, const sub_t<L, R> &f, bool noTableName = false, bool /*escape*/ = false) {
                 std::stringstream ss;
-                auto lhs = this->string_from_expression(f.l);
-                auto rhs = this->string_from_expression(f.r);
+                auto lhs = this->string_from_expression(context, f.l, noTableName);
+                auto rhs = this->string_from_expression(context, f.r, noTableName);
                 ss << "(" << lhs << " - " << rhs << ") ";
                 return ss.str();
             }
             
             template<class L, class R>
-            std::string string_from_expression(const mul_t<L, R> &f, bool /*noTableName*/ = false, bool /*escape*/ = false) {
+            std::string string_from_expression(internal::query_context &context, const mul_t<L, R> &f, bool noTableName = false, bool /*escape*/ = false) {
                 std::stringstream ss;
-                auto lhs = this->string_from_expression(f.l);
-                auto rhs = this->string_from_expression(f.r);
+                auto lhs = this->string_from_expression(context, f.l, noTableName);
+                auto rhs = this->string_from_expression(context, f.r, noTableName);
                 ss << "(" << lhs << " * " << rhs << ") ";
                 return ss.str();
             }
             
             template<class L, class R>
-            std::string string_from_expression(const div_t<L, R> &f, bool /*noTableName*/ = false, bool /*escape*/ = false) {
+            std::string string_from_expression(internal::query_context &context, const div_t<L, R> &f, bool noTableName = false, bool /*escape*/ = false) {
                 std::stringstream ss;
-                auto lhs = this->string_from_expression(f.l);
-                auto rhs = this->string_from_expression(f.r);
+                auto lhs = this->string_from_expression(context, f.l, noTableName);
+                auto rhs = this->string_from_expression(context, f.r, noTableName);
                 ss << "(" << lhs << " / " << rhs << ") ";
                 return ss.str();
             }
             
             template<class L, class R>
-            std::string string_from_expression(const mod_t<L, R> &f, bool /*noTableName*/ = false, bool /*escape*/ = false) {
+            std::string string_from_expression(internal::query_context &context, const mod_t<L, R> &f, bool noTableName = false, bool /*escape*/ = false) {
                 std::stringstream ss;
-                auto lhs = this->string_from_expression(f.l);
-                auto rhs = this->string_from_expression(f.r);
+                auto lhs = this->string_from_expression(context, f.l, noTableName);
+                auto rhs = this->string_from_expression(context, f.r, noTableName);
                 ss << "(" << lhs << " % " << rhs << ") ";
                 return ss.str();
             }
             
             template<class T>
-            std::string string_from_expression(const aggregate_functions::min_t<T> &f, bool /*noTableName*/ = false, bool /*escape*/ = false) {
+            std::string string_from_expression(internal::query_context &context, const aggregate_functions::min_t<T> &f, bool /*noTableName*/ = false, bool /*escape*/ = false) {
                 std::stringstream ss;
-                auto expr = this->string_from_expression(f.t);
+                auto expr = this->string_from_expression(context, f.t);
                 ss << static_cast<std::string>(f) << "(" << expr << ") ";
                 return ss.str();
             }
             
             template<class T>
-            std::string string_from_expression(const aggregate_functions::max_t<T> &f, bool /*noTableName*/ = false, bool /*escape*/ = false) {
+            std::string string_from_expression(internal::query_context &context, const aggregate_functions::max_t<T> &f, bool /*noTableName*/ = false, bool /*escape*/ = false) {
                 std::stringstream ss;
-                auto expr = this->string_from_expression(f.t);
+                auto expr = this->string_from_expression(context, f.t);
                 ss << static_cast<std::string>(f) << "(" << expr << ") ";
                 return ss.str();
             }
             
             template<class T>
-            std::string string_from_expression(const aggregate_functions::total_t<T> &f, bool /*noTableName*/ = false, bool /*escape*/ = false) {
+            std::string string_from_expression(internal::query_context &context, const aggregate_functions::total_t<T> &f, bool /*noTableName*/ = false, bool /*escape*/ = false) {
                 std::stringstream ss;
-                auto expr = this->string_from_expression(f.t);
+                auto expr = this->string_from_expression(context, f.t);
                 ss << static_cast<std::string>(f) << "(" << expr << ") ";
                 return ss.str();
             }
             
             template<class T>
-            std::string string_from_expression(const aggregate_functions::sum_t<T> &f, bool /*noTableName*/ = false, bool /*escape*/ = false) {
+            std::string string_from_expression(internal::query_context &context, const aggregate_functions::sum_t<T> &f, bool /*noTableName*/ = false, bool /*escape*/ = false) {
                 std::stringstream ss;
-                auto expr = this->string_from_expression(f.t);
+                auto expr = this->string_from_expression(context, f.t);
                 ss << static_cast<std::string>(f) << "(" << expr << ") ";
                 return ss.str();
             }
             
-            std::string string_from_expression(const aggregate_functions::count_asterisk_t &f, bool /*noTableName*/ = false, bool /*escape*/ = false) {
+            std::string string_from_expression(internal::query_context &/*context*/, const aggregate_functions::count_asterisk_t &f, bool /*noTableName*/ = false, bool /*escape*/ = false) {
                 std::stringstream ss;
                 ss << static_cast<std::string>(f) << "(*) ";
                 return ss.str();
             }
             
             template<class T>
-            std::string string_from_expression(const aggregate_functions::count_t<T> &f, bool /*noTableName*/ = false, bool /*escape*/ = false) {
+            std::string string_from_expression(internal::query_context &context, const aggregate_functions::count_t<T> &f, bool /*noTableName*/ = false, bool /*escape*/ = false) {
                 std::stringstream ss;
-                auto expr = this->string_from_expression(f.t);
+                auto expr = this->string_from_expression(context, f.t);
                 ss << static_cast<std::string>(f) << "(" << expr << ") ";
                 return ss.str();
             }
             
             template<class T>
-            std::string string_from_expression(const aggregate_functions::avg_t<T> &a, bool /*noTableName*/ = false, bool /*escape*/ = false) {
+            std::string string_from_expression(internal::query_context &context, const aggregate_functions::avg_t<T> &a, bool /*noTableName*/ = false, bool /*escape*/ = false) {
                 std::stringstream ss;
-                auto expr = this->string_from_expression(a.t);
+                auto expr = this->string_from_expression(context, a.t);
                 ss << static_cast<std::string>(a) << "(" << expr << ") ";
                 return ss.str();
             }
             
             template<class T>
-            std::string string_from_expression(const distinct_t<T> &f, bool /*noTableName*/ = false, bool /*escape*/ = false) {
+            std::string string_from_expression(internal::query_context &context, const distinct_t<T> &f, bool /*noTableName*/ = false, bool /*escape*/ = false) {
                 std::stringstream ss;
-                auto expr = this->string_from_expression(f.t);
+                auto expr = this->string_from_expression(context, f.t);
                 ss << static_cast<std::string>(f) << "(" << expr << ") ";
                 return ss.str();
             }
             
             template<class T>
-            std::string string_from_expression(const all_t<T> &f, bool /*noTableName*/ = false, bool /*escape*/ = false) {
+            std::string string_from_expression(internal::query_context &context, const all_t<T> &f, bool /*noTableName*/ = false, bool /*escape*/ = false) {
                 std::stringstream ss;
-                auto expr = this->string_from_expression(f.t);
+                auto expr = this->string_from_expression(context, f.t);
                 ss << static_cast<std::string>(f) << "(" << expr << ") ";
                 return ss.str();
             }
             
             template<class X, class Y>
-            std::string string_from_expression(const core_functions::rtrim_double_t<X, Y> &f, bool /*noTableName*/ = false, bool /*escape*/ = false) {
+            std::string string_from_expression(internal::query_context &context, const core_functions::rtrim_double_t<X, Y> &f, bool noTableName = false, bool /*escape*/ = false) {
                 std::stringstream ss;
-                auto expr = this->string_from_expression(f.x);
-                auto expr2 = this->string_from_expression(f.y);
+                auto expr = this->string_from_expression(context, f.x, noTableName);
+                auto expr2 = this->string_from_expression(context, f.y, noTableName);
                 ss << static_cast<std::string>(f) << "(" << expr << ", " << expr2 << ") ";
                 return ss.str();
             }
             
             template<class X>
-            std::string string_from_expression(const core_functions::rtrim_single_t<X> &f, bool /*noTableName*/ = false, bool /*escape*/ = false) {
+            std::string string_from_expression(internal::query_context &context, const core_functions::rtrim_single_t<X> &f, bool noTableName = false, bool /*escape*/ = false) {
                 std::stringstream ss;
-                auto expr = this->string_from_expression(f.x);
+                auto expr = this->string_from_expression(context, f.x, noTableName);
                 ss << static_cast<std::string>(f) << "(" << expr << ") ";
                 return ss.str();
             }
             
             template<class X, class Y>
-            std::string string_from_expression(const core_functions::ltrim_double_t<X, Y> &f, bool /*noTableName*/ = false, bool /*escape*/ = false) {
+            std::string string_from_expression(internal::query_context &context, const core_functions::ltrim_double_t<X, Y> &f, bool noTableName = false, bool /*escape*/ = false) {
                 std::stringstream ss;
-                auto expr = this->string_from_expression(f.x);
-                auto expr2 = this->string_from_expression(f.y);
+                auto expr = this->string_from_expression(context, f.x, noTableName);
+                auto expr2 = this->string_from_expression(context, f.y, noTableName);
                 ss << static_cast<std::string>(f) << "(" << expr << ", " << expr2 << ") ";
                 return ss.str();
             }
             
             template<class X>
-            std::string string_from_expression(const core_functions::ltrim_single_t<X> &f, bool /*noTableName*/ = false, bool /*escape*/ = false) {
+            std::string string_from_expression(internal::query_context &context, const core_functions::ltrim_single_t<X> &f, bool noTableName = false, bool /*escape*/ = false) {
                 std::stringstream ss;
-                auto expr = this->string_from_expression(f.x);
+                auto expr = this->string_from_expression(context, f.x, noTableName);
                 ss << static_cast<std::string>(f) << "(" << expr << ") ";
                 return ss.str();
             }
             
             template<class X, class Y>
-            std::string string_from_expression(const core_functions::trim_double_t<X, Y> &f, bool /*noTableName*/ = false, bool /*escape*/ = false) {
+            std::string string_from_expression(internal::query_context &context, const core_functions::trim_double_t<X, Y> &f, bool noTableName = false, bool /*escape*/ = false) {
                 std::stringstream ss;
-                auto expr = this->string_from_expression(f.x);
-                auto expr2 = this->string_from_expression(f.y);
+                auto expr = this->string_from_expression(context, f.x, noTableName);
+                auto expr2 = this->string_from_expression(context, f.y, noTableName);
                 ss << static_cast<std::string>(f) << "(" << expr << ", " << expr2 << ") ";
                 return ss.str();
             }
             
             template<class X>
-            std::string string_from_expression(const core_functions::trim_single_t<X> &f, bool /*noTableName*/ = false, bool /*escape*/ = false) {
+            std::string string_from_expression(internal::query_context &context, const core_functions::trim_single_t<X> &f, bool noTableName = false, bool /*escape*/ = false) {
                 std::stringstream ss;
-                auto expr = this->string_from_expression(f.x);
+                auto expr = this->string_from_expression(context, f.x, noTableName);
                 ss << static_cast<std::string>(f) << "(" << expr << ") ";
                 return ss.str();
             }
             
-            std::string string_from_expression(const core_functions::changes_t &ch, bool /*noTableName*/ = false, bool /*escape*/ = false) {
+            std::string string_from_expression(internal::query_context &/*context*/, const core_functions::changes_t &ch, bool /*noTableName*/ = false, bool /*escape*/ = false) {
                 std::stringstream ss;
                 ss << static_cast<std::string>(ch) << "() ";
                 return ss.str();
             }
             
             template<class T>
-            std::string string_from_expression(const core_functions::length_t<T> &len, bool /*noTableName*/ = false, bool /*escape*/ = false) {
+            std::string string_from_expression(internal::query_context &context, const core_functions::length_t<T> &len, bool noTableName = false, bool /*escape*/ = false) {
                 std::stringstream ss;
-                auto expr = this->string_from_expression(len.t);
+                auto expr = this->string_from_expression(context, len.t, noTableName);
                 ss << static_cast<std::string>(len) << "(" << expr << ") ";
                 return ss.str();
             }
             
             template<class T, class ...Args>
-            std::string string_from_expression(const core_functions::datetime_t<T, Args...> &f, bool /*noTableName*/ = false, bool /*escape*/ = false) {
+            std::string string_from_expression(internal::query_context &context, const core_functions::datetime_t<T, Args...> &f, bool /*noTableName*/ = false, bool /*escape*/ = false) {
                 std::stringstream ss;
-                ss << static_cast<std::string>(f) << "(" << this->string_from_expression(f.timestring);
+                ss << static_cast<std::string>(f) << "(" << this->string_from_expression(context, f.timestring);
                 using tuple_t = std::tuple<Args...>;
-                tuple_helper::iterator<std::tuple_size<tuple_t>::value - 1, Args...>()(f.modifiers, [&ss, this](auto &v){
-                    ss << ", " << this->string_from_expression(v);
+                tuple_helper::iterator<std::tuple_size<tuple_t>::value - 1, Args...>()(f.modifiers, [&context, &ss, this](auto &v){
+                    ss << ", " << this->string_from_expression(context, v);
                 });
                 ss << ") ";
                 return ss.str();
             }
             
             template<class T, class ...Args>
-            std::string string_from_expression(const core_functions::date_t<T, Args...> &f, bool /*noTableName*/ = false, bool /*escape*/ = false) {
+            std::string string_from_expression(internal::query_context &context, const core_functions::date_t<T, Args...> &f, bool /*noTableName*/ = false, bool /*escape*/ = false) {
                 std::stringstream ss;
-                ss << static_cast<std::string>(f) << "(" << this->string_from_expression(f.timestring);
+                ss << static_cast<std::string>(f) << "(" << this->string_from_expression(context, f.timestring);
                 using tuple_t = std::tuple<Args...>;
-                tuple_helper::iterator<std::tuple_size<tuple_t>::value - 1, Args...>()(f.modifiers, [&ss, this](auto &v){
-                    ss << ", " << this->string_from_expression(v);
+                tuple_helper::iterator<std::tuple_size<tuple_t>::value - 1, Args...>()(f.modifiers, [&context, &ss, this](auto &v){
+                    ss << ", " << this->string_from_expression(context, v);
                 });
                 ss << ") ";
                 return ss.str();
             }
             
-            std::string string_from_expression(const core_functions::random_t &f, bool /*noTableName*/ = false, bool /*escape*/ = false) {
+            std::string string_from_expression(internal::query_context &/*context*/, const core_functions::random_t &f, bool /*noTableName*/ = false, bool /*escape*/ = false) {
                 std::stringstream ss;
                 ss << static_cast<std::string>(f) << "() ";
                 return ss.str();
@@ -6275,13 +8442,13 @@ namespace sqlite_orm {
 #if SQLITE_VERSION_NUMBER >= 3007016
             
             template<class ...Args>
-            std::string string_from_expression(const core_functions::char_t_<Args...> &f, bool /*noTableName*/ = false, bool /*escape*/ = false) {
+            std::string string_from_expression(internal::query_context &context, const core_functions::char_t_<Args...> &f, bool /*noTableName*/ = false, bool /*escape*/ = false) {
                 std::stringstream ss;
                 using tuple_t = decltype(f.args);
                 std::vector<std::string> args;
                 args.reserve(std::tuple_size<tuple_t>::value);
-                tuple_helper::tuple_for_each(f.args, [&args, this](auto &v){
-                    auto expression = this->string_from_expression(v);
+                tuple_helper::tuple_for_each(f.args, [&context, &args, this](auto &v){
+                    auto expression = this->string_from_expression(context, v);
                     args.emplace_back(std::move(expression));
                 });
                 ss << static_cast<std::string>(f) << "(";
@@ -6300,31 +8467,31 @@ namespace sqlite_orm {
 #endif
             
             template<class T>
-            std::string string_from_expression(const core_functions::upper_t<T> &a, bool /*noTableName*/ = false, bool /*escape*/ = false) {
+            std::string string_from_expression(internal::query_context &context, const core_functions::upper_t<T> &a, bool noTableName = false, bool /*escape*/ = false) {
                 std::stringstream ss;
-                auto expr = this->string_from_expression(a.t);
+                auto expr = this->string_from_expression(context, a.t, noTableName);
                 ss << static_cast<std::string>(a) << "(" << expr << ") ";
                 return ss.str();
             }
             
             template<class T>
-            std::string string_from_expression(const core_functions::lower_t<T> &a, bool /*noTableName*/ = false, bool /*escape*/ = false) {
+            std::string string_from_expression(internal::query_context &context, const core_functions::lower_t<T> &a, bool noTableName = false, bool /*escape*/ = false) {
                 std::stringstream ss;
-                auto expr = this->string_from_expression(a.t);
+                auto expr = this->string_from_expression(context, a.t, noTableName);
                 ss << static_cast<std::string>(a) << "(" << expr << ") ";
                 return ss.str();
             }
             
             template<class T>
-            std::string string_from_expression(const core_functions::abs_t<T> &a, bool /*noTableName*/ = false, bool /*escape*/ = false) {
+            std::string string_from_expression(internal::query_context &context, const core_functions::abs_t<T> &a, bool noTableName = false, bool /*escape*/ = false) {
                 std::stringstream ss;
-                auto expr = this->string_from_expression(a.t);
+                auto expr = this->string_from_expression(context, a.t, noTableName);
                 ss << static_cast<std::string>(a) << "(" << expr << ") ";
                 return ss.str();
             }
             
             template<class T, class F>
-            std::string string_from_expression(const column_pointer<T, F> &c, bool noTableName = false, bool escape = false) {
+            std::string string_from_expression(internal::query_context &/*context*/, const column_pointer<T, F> &c, bool noTableName = false, bool escape = false) {
                 std::stringstream ss;
                 if(!noTableName){
                     ss << "'" << this->impl.template find_table_name<T>() << "'.";
@@ -6335,8 +8502,8 @@ namespace sqlite_orm {
             }
             
             template<class T>
-            std::vector<std::string> get_column_names(const T &t) {
-                auto columnName = this->string_from_expression(t);
+            std::vector<std::string> get_column_names(internal::query_context &context, const T &t) {
+                auto columnName = this->string_from_expression(context, t);
                 if(columnName.length()){
                     return {columnName};
                 }else{
@@ -6345,11 +8512,11 @@ namespace sqlite_orm {
             }
             
             template<class ...Args>
-            std::vector<std::string> get_column_names(const internal::columns_t<Args...> &cols) {
+            std::vector<std::string> get_column_names(internal::query_context &context, const internal::columns_t<Args...> &cols) {
                 std::vector<std::string> columnNames;
                 columnNames.reserve(cols.count());
-                cols.for_each([&columnNames, this](auto &m) {
-                    auto columnName = this->string_from_expression(m);
+                cols.for_each([&context, &columnNames, this](auto &m) {
+                    auto columnName = this->string_from_expression(context, m);
                     if(columnName.length()){
                         columnNames.push_back(columnName);
                     }else{
@@ -6363,13 +8530,13 @@ namespace sqlite_orm {
              *  Takes select_t object and returns SELECT query string
              */
             template<class T, class ...Args>
-            std::string string_from_expression(const internal::select_t<T, Args...> &sel, bool /*noTableName*/ = false, bool /*escape*/ = false) {
+            std::string string_from_expression(internal::query_context &context, const internal::select_t<T, Args...> &sel, bool /*noTableName*/ = false, bool /*escape*/ = false) {
                 std::stringstream ss;
                 ss << "SELECT ";
                 if(get_distinct(sel.col)) {
                     ss << static_cast<std::string>(distinct(0)) << " ";
                 }
-                auto columnNames = this->get_column_names(sel.col);
+                auto columnNames = this->get_column_names(context, sel.col);
                 for(size_t i = 0; i < columnNames.size(); ++i) {
                     ss << columnNames[i];
                     if(i < columnNames.size() - 1) {
@@ -6377,68 +8544,167 @@ namespace sqlite_orm {
                     }
                     ss << " ";
                 }
-                auto tableNamesSet = this->parse_table_names(sel.col);
-                internal::join_iterator<Args...>()([&tableNamesSet, this](auto c){
-                    using original_join_type = typename decltype(c)::type;
-                    using cross_join_type = typename internal::mapped_type_proxy<original_join_type>::type;
-                    auto crossJoinedTableName = this->impl.template find_table_name<cross_join_type>();
-                    auto tableAliasString = alias_exractor<original_join_type>::get();
-                    if(!tableAliasString.length()){
-                        tableNamesSet.erase(crossJoinedTableName);
-                    }
-                });
-                if(tableNamesSet.size()){
-                    ss << "FROM ";
-                    std::vector<std::string> tableNames(tableNamesSet.begin(), tableNamesSet.end());
-                    for(size_t i = 0; i < tableNames.size(); ++i) {
-                        ss << " '" << tableNames[i] << "' ";
-                        if(int(i) < int(tableNames.size()) - 1) {
-                            ss << ",";
+                auto tableNamesSet = this->parse_table_names(sel.col);
+                internal::join_iterator<Args...>()([&tableNamesSet, this](auto c){
+                    using original_join_type = typename decltype(c)::type;
+                    using cross_join_type = typename internal::mapped_type_proxy<original_join_type>::type;
+                    auto crossJoinedTableName = this->impl.template find_table_name<cross_join_type>();
+                    auto tableAliasString = alias_exractor<original_join_type>::get();
+                    if(!tableAliasString.length()){
+                        tableNamesSet.erase(crossJoinedTableName);
+                    }
+                });
+                if(tableNamesSet.size()){
+                    ss << "FROM ";
+                    std::vector<std::string> tableNames(tableNamesSet.begin(), tableNamesSet.end());
+                    for(size_t i = 0; i < tableNames.size(); ++i) {
+                        ss << " '" << tableNames[i] << "' ";
+                        if(int(i) < int(tableNames.size()) - 1) {
+                            ss << ",";
+                        }
+                        ss << " ";
+                    }
+                }
+                using tuple_t = typename std::decay<decltype(sel)>::type::conditions_type;
+                tuple_helper::iterator<std::tuple_size<tuple_t>::value - 1, Args...>()(sel.conditions, [&context, &ss, this](auto &v){
+                    this->process_single_condition(context, ss, v);
+                }, false);
+                return ss.str();
+            }
+            
+            /**
+             *  Takes get_all_t object and returns the same query `get_all` executes
+             */
+            template<class T, class ...Args>
+            std::string string_from_expression(internal::query_context &context, const internal::get_all_t<T, Args...> &expr, bool /*noTableName*/ = false, bool /*escape*/ = false) {
+                std::string query;
+                this->generate_select_asterisk<T>(context, &query);
+                std::stringstream ss;
+                ss << query;
+                tuple_helper::iterator<std::tuple_size<std::tuple<Args...>>::value - 1, Args...>()(expr.conditions, [&context, &ss, this](auto &v){
+                    this->process_single_condition(context, ss, v);
+                }, false);
+                return ss.str();
+            }
+            
+            /**
+             *  Takes count_all_t object and returns the same query `count` executes
+             */
+            template<class T, class ...Args>
+            std::string string_from_expression(internal::query_context &context, const internal::count_all_t<T, Args...> &expr, bool /*noTableName*/ = false, bool /*escape*/ = false) {
+                using mapped_type = typename mapped_type_proxy<T>::type;
+                auto tableAliasString = alias_exractor<T>::get();
+                std::stringstream ss;
+                ss << "SELECT " << static_cast<std::string>(sqlite_orm::count()) << "(*) FROM '" << this->get_impl<mapped_type>().table.name << "' ";
+                if(tableAliasString.length()) {
+                    ss << "'" << tableAliasString << "' ";
+                }
+                tuple_helper::iterator<std::tuple_size<std::tuple<Args...>>::value - 1, Args...>()(expr.conditions, [&context, &ss, this](auto &v){
+                    this->process_single_condition(context, ss, v);
+                }, false);
+                return ss.str();
+            }
+            
+            query_plan explain_query(sqlite3 *db, const std::string &query) {
+                query_plan res;
+                res.sql = query;
+                struct row {
+                    int id;
+                    int parent;
+                    std::string detail;
+                };
+                std::vector<row> rows;
+                auto explainQuery = "EXPLAIN QUERY PLAN " + query;
+                sqlite3_stmt *stmt;
+                if (sqlite3_prepare_v2(db, explainQuery.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+                    throw std::system_error(std::error_code(sqlite3_errcode(db), get_sqlite_error_category()));
+                }
+                statement_finalizer finalizer{stmt};
+                int stepRes;
+                while((stepRes = sqlite3_step(stmt)) == SQLITE_ROW) {
+                    row r;
+#if SQLITE_VERSION_NUMBER >= 3024000
+                    r.id = sqlite3_column_int(stmt, 0);
+                    r.parent = sqlite3_column_int(stmt, 1);
+#else
+                    
+                    //  selectid, order, from columns don't describe hierarchy
+                    r.id = static_cast<int>(rows.size()) + 1;
+                    r.parent = 0;
+#endif
+                    r.detail = row_extractor<std::string>().extract(stmt, 3);
+                    rows.push_back(std::move(r));
+                }
+                if(stepRes != SQLITE_DONE) {
+                    throw std::system_error(std::error_code(sqlite3_errcode(db), get_sqlite_error_category()));
+                }
+                std::function<std::vector<query_plan_node>(int)> collectChildren = [&rows, &collectChildren](int parent) {
+                    std::vector<query_plan_node> nodes;
+                    for(auto &r : rows) {
+                        if(r.parent == parent) {
+                            nodes.push_back({r.id, r.parent, r.detail, collectChildren(r.id)});
                         }
-                        ss << " ";
                     }
+                    return nodes;
+                };
+                res.nodes = collectChildren(0);
+                return res;
+            }
+            
+            /**
+             *  Debug builds only: fires an assertion if `query` plan contains a full scan of a table
+             *  marked with `mark_large_table`.
+             */
+            void assert_no_large_table_scan(sqlite3 *db, const std::string &query) {
+#ifndef NDEBUG
+                if(this->largeTables.empty()) {
+                    return;
                 }
-                using tuple_t = typename std::decay<decltype(sel)>::type::conditions_type;
-                tuple_helper::iterator<std::tuple_size<tuple_t>::value - 1, Args...>()(sel.conditions, [&ss, this](auto &v){
-                    this->process_single_condition(ss, v);
-                }, false);
-                return ss.str();
+                auto plan = this->explain_query(db, query);
+                for(auto &tableName : this->largeTables) {
+                    assert(!plan.scans(tableName) && "query plan contains full scan of a large table");
+                    (void)tableName;
+                }
+#else
+                (void)db;
+                (void)query;
+#endif
             }
              
             template<class T>
-            std::string process_where(const conditions::is_null_t<T> &c) {
+            std::string process_where(internal::query_context &context, const conditions::is_null_t<T> &c) {
                 std::stringstream ss;
-                ss << this->string_from_expression(c.t) << " " << static_cast<std::string>(c) << " ";
+                ss << this->string_from_expression(context, c.t) << " " << static_cast<std::string>(c) << " ";
                 return ss.str();
             }
             
             template<class T>
-            std::string process_where(const conditions::is_not_null_t<T> &c) {
+            std::string process_where(internal::query_context &context, const conditions::is_not_null_t<T> &c) {
                 std::stringstream ss;
-                ss << this->string_from_expression(c.t) << " " << static_cast<std::string>(c) << " ";
+                ss << this->string_from_expression(context, c.t) << " " << static_cast<std::string>(c) << " ";
                 return ss.str();
             }
             
             template<class C>
-            std::string process_where(const conditions::negated_condition_t<C> &c) {
+            std::string process_where(internal::query_context &context, const conditions::negated_condition_t<C> &c) {
                 std::stringstream ss;
                 ss << " " << static_cast<std::string>(c) << " ";
-                auto cString = this->process_where(c.c);
+                auto cString = this->process_where(context, c.c);
                 ss << " (" << cString << " ) ";
                 return ss.str();
             }
             
             template<class L, class R>
-            std::string process_where(const conditions::and_condition_t<L, R> &c) {
+            std::string process_where(internal::query_context &context, const conditions::and_condition_t<L, R> &c) {
                 std::stringstream ss;
-                ss << " (" << this->process_where(c.l) << ") " << static_cast<std::string>(c) << " (" << this->process_where(c.r) << ") ";
+                ss << " (" << this->process_where(context, c.l) << ") " << static_cast<std::string>(c) << " (" << this->process_where(context, c.r) << ") ";
                 return ss.str();
             }
             
             template<class L, class R>
-            std::string process_where(const conditions::or_condition_t<L, R> &c) {
+            std::string process_where(internal::query_context &context, const conditions::or_condition_t<L, R> &c) {
                 std::stringstream ss;
-                ss << " (" << this->process_where(c.l) << ") " << static_cast<std::string>(c) << " (" << this->process_where(c.r) << ") ";
+                ss << " (" << this->process_where(context, c.l) << ") " << static_cast<std::string>(c) << " (" << this->process_where(context, c.r) << ") ";
                 return ss.str();
             }
             
@@ -6446,34 +8712,79 @@ namespace sqlite_orm {
              *  Common case. Is used to process binary conditions like is_equal, not_equal
              */
             template<class C>
-            std::string process_where(const C &c) {
-                auto leftString = this->string_from_expression(c.l, false, true);
-                auto rightString = this->string_from_expression(c.r, false, true);
+            std::string process_where(internal::query_context &context, const C &c) {
+                auto leftString = this->string_from_expression(context, c.l, false, true);
+                auto rightString = this->string_from_expression(context, c.r, false, true);
                 std::stringstream ss;
                 ss << leftString << " " << static_cast<std::string>(c) << " " << rightString;
                 return ss.str();
             }
             
             template<class T>
-            std::string process_where(const conditions::named_collate<T> &col) {
-                auto res = this->process_where(col.expr);
+            std::string process_where(internal::query_context &context, const conditions::named_collate<T> &col) {
+                auto res = this->process_where(context, col.expr);
                 return res + " " + static_cast<std::string>(col);
             }
             
             template<class T>
-            std::string process_where(const conditions::collate_t<T> &col) {
-                auto res = this->process_where(col.expr);
+            std::string process_where(internal::query_context &context, const conditions::collate_t<T> &col) {
+                auto res = this->process_where(context, col.expr);
                 return res + " " + static_cast<std::string>(col);
             }
             
+            /**
+             *  Fills temp table `tableName` with values binding every value so SQLite doesn't have to parse them.
+             *  Statements are cached by connection.
+             */
+            template<class E>
+            void fill_in_table(internal::database_connection &connection, const std::string &tableName, const std::vector<E> &values) {
+                auto db = connection.get_db();
+                auto execute = [db](sqlite3_stmt *stmt) {
+                    statement_resetter resetter{stmt};
+                    if(sqlite3_step(stmt) != SQLITE_DONE) {
+                        throw std::system_error(std::error_code(sqlite3_errcode(db), get_sqlite_error_category()));
+                    }
+                };
+                execute(connection.get_statement("CREATE TEMP TABLE IF NOT EXISTS \"" + tableName + "\" (value)"));
+                execute(connection.get_statement("SAVEPOINT sqlite_orm_in"));
+                try{
+                    execute(connection.get_statement("DELETE FROM temp.\"" + tableName + "\""));
+                    auto stmt = connection.get_statement("INSERT INTO temp.\"" + tableName + "\" (value) VALUES (?)");
+                    for(auto &value : values) {
+                        statement_binder<E>().bind(stmt, 1, value);
+                        execute(stmt);
+                    }
+                }catch(...){
+                    sqlite3_exec(db, "ROLLBACK TO sqlite_orm_in; RELEASE sqlite_orm_in", nullptr, nullptr, nullptr);
+                    throw;
+                }
+                execute(connection.get_statement("RELEASE sqlite_orm_in"));
+            }
+            
+            /**
+             *  Long value lists are bound into a temp table of the context connection and condition is serialized as
+             *  `x IN temp."_sqlite_orm_in_N"` so query text doesn't depend on values count and values are not parsed.
+             *  Temp table belongs to the context until it is destroyed so statements alive at the same time never
+             *  share it. Short lists (filling a table costs several statements) and lists of a context without
+             *  connection are written into query text.
+             */
             template<class L, class E>
-            std::string process_where(const conditions::in_t<L, E> &inCondition) {
+            std::string process_where(internal::query_context &context, const conditions::in_t<L, E> &inCondition) {
                 std::stringstream ss;
-                auto leftString = this->string_from_expression(inCondition.l);
+                auto leftString = this->string_from_expression(context, inCondition.l);
+                const size_t maxInlinedValuesCount = 100;
+                if(context.connection && inCondition.values.size() > maxInlinedValuesCount) {
+                    auto id = context.connection->acquire_in_table();
+                    context.inTables.push_back(id);
+                    auto tableName = "_sqlite_orm_in_" + std::to_string(id);
+                    this->fill_in_table(*context.connection, tableName, inCondition.values);
+                    ss << leftString << " " << static_cast<std::string>(inCondition) << " temp.\"" << tableName << "\"";
+                    return ss.str();
+                }
                 ss << leftString << " " << static_cast<std::string>(inCondition) << " (";
                 for(size_t index = 0; index < inCondition.values.size(); ++index) {
                     auto &value = inCondition.values[index];
-                    ss << " " << this->string_from_expression(value);
+                    ss << " " << this->string_from_expression(context, value);
                     if(index < inCondition.values.size() - 1) {
                         ss << ", ";
                     }
@@ -6483,24 +8794,24 @@ namespace sqlite_orm {
             }
             
             template<class A, class T>
-            std::string process_where(const conditions::like_t<A, T> &l) {
+            std::string process_where(internal::query_context &context, const conditions::like_t<A, T> &l) {
                 std::stringstream ss;
-                ss << this->string_from_expression(l.a) << " " << static_cast<std::string>(l) << " " << this->string_from_expression(l.t) << " ";
+                ss << this->string_from_expression(context, l.a) << " " << static_cast<std::string>(l) << " " << this->string_from_expression(context, l.t) << " ";
                 return ss.str();
             }
             
             template<class A, class T>
-            std::string process_where(const conditions::between_t<A, T> &bw) {
+            std::string process_where(internal::query_context &context, const conditions::between_t<A, T> &bw) {
                 std::stringstream ss;
-                auto expr = this->string_from_expression(bw.expr);
-                ss << expr << " " << static_cast<std::string>(bw) << " " << this->string_from_expression(bw.b1) << " AND " << this->string_from_expression(bw.b2) << " ";
+                auto expr = this->string_from_expression(context, bw.expr);
+                ss << expr << " " << static_cast<std::string>(bw) << " " << this->string_from_expression(context, bw.b1) << " AND " << this->string_from_expression(context, bw.b2) << " ";
                 return ss.str();
             }
             
             template<class O>
-            std::string process_order_by(const conditions::order_by_t<O> &orderBy) {
+            std::string process_order_by(internal::query_context &context, const conditions::order_by_t<O> &orderBy, bool noTableName = false) {
                 std::stringstream ss;
-                auto columnName = this->string_from_expression(orderBy.o);
+                auto columnName = this->string_from_expression(context, orderBy.o, noTableName);
                 ss << columnName << " ";
                 if(orderBy._collate_argument.length()){
                     ss << "COLLATE " << orderBy._collate_argument << " ";
@@ -6517,16 +8828,16 @@ namespace sqlite_orm {
             }
             
             template<class T>
-            void process_join_constraint(std::stringstream &ss, const conditions::on_t<T> &t) {
-                ss << static_cast<std::string>(t) << " " << this->process_where(t.t) << " ";
+            void process_join_constraint(internal::query_context &context, std::stringstream &ss, const conditions::on_t<T> &t) {
+                ss << static_cast<std::string>(t) << " " << this->process_where(context, t.t) << " ";
             }
             
             template<class F, class O>
-            void process_join_constraint(std::stringstream &ss, const conditions::using_t<F, O> &u) {
-                ss << static_cast<std::string>(u) << " (" << this->string_from_expression(u.column, true) << " ) ";
+            void process_join_constraint(internal::query_context &context, std::stringstream &ss, const conditions::using_t<F, O> &u) {
+                ss << static_cast<std::string>(u) << " (" << this->string_from_expression(context, u.column, true) << " ) ";
             }
             
-            void process_single_condition(std::stringstream &ss, const conditions::limit_t &limt) {
+            void process_single_condition(internal::query_context &/*context*/, std::stringstream &ss, const conditions::limit_t &limt) {
                 ss << static_cast<std::string>(limt) << " ";
                 if(limt.has_offset) {
                     if(limt.offset_is_implicit){
@@ -6541,69 +8852,69 @@ namespace sqlite_orm {
             }
             
             template<class O>
-            void process_single_condition(std::stringstream &ss, const conditions::cross_join_t<O> &c) {
+            void process_single_condition(internal::query_context &/*context*/, std::stringstream &ss, const conditions::cross_join_t<O> &c) {
                 ss << static_cast<std::string>(c) << " ";
                 ss << " '" << this->impl.template find_table_name<O>() << "' ";
             }
             
             template<class O>
-            void process_single_condition(std::stringstream &ss, const conditions::natural_join_t<O> &c) {
+            void process_single_condition(internal::query_context &/*context*/, std::stringstream &ss, const conditions::natural_join_t<O> &c) {
                 ss << static_cast<std::string>(c) << " ";
                 ss << " '" << this->impl.template find_table_name<O>() << "' ";
             }
             
             template<class T, class O>
-            void process_single_condition(std::stringstream &ss, const conditions::inner_join_t<T, O> &l) {
+            void process_single_condition(internal::query_context &context, std::stringstream &ss, const conditions::inner_join_t<T, O> &l) {
                 ss << static_cast<std::string>(l) << " ";
                 auto aliasString = alias_exractor<T>::get();
                 ss << " '" << this->impl.template find_table_name<typename mapped_type_proxy<T>::type>() << "' ";
                 if(aliasString.length()){
                     ss << "'" << aliasString << "' ";
                 }
-                this->process_join_constraint(ss, l.constraint);
+                this->process_join_constraint(context, ss, l.constraint);
             }
             
             template<class T, class O>
-            void process_single_condition(std::stringstream &ss, const conditions::left_outer_join_t<T, O> &l) {
+            void process_single_condition(internal::query_context &context, std::stringstream &ss, const conditions::left_outer_join_t<T, O> &l) {
                 ss << static_cast<std::string>(l) << " ";
                 ss << " '" << this->impl.template find_table_name<T>() << "' ";
-                this->process_join_constraint(ss, l.constraint);
+                this->process_join_constraint(context, ss, l.constraint);
             }
             
             template<class T, class O>
-            void process_single_condition(std::stringstream &ss, const conditions::left_join_t<T, O> &l) {
+            void process_single_condition(internal::query_context &context, std::stringstream &ss, const conditions::left_join_t<T, O> &l) {
                 ss << static_cast<std::string>(l) << " ";
                 ss << " '" << this->impl.template find_table_name<T>() << "' ";
-                this->process_join_constraint(ss, l.constraint);
+                this->process_join_constraint(context, ss, l.constraint);
             }
             
             template<class T, class O>
-            void process_single_condition(std::stringstream &ss, const conditions::join_t<T, O> &l) {
+            void process_single_condition(internal::query_context &context, std::stringstream &ss, const conditions::join_t<T, O> &l) {
                 ss << static_cast<std::string>(l) << " ";
                 ss << " '" << this->impl.template find_table_name<T>() << "' ";
-                this->process_join_constraint(ss, l.constraint);
+                this->process_join_constraint(context, ss, l.constraint);
             }
             
             template<class C>
-            void process_single_condition(std::stringstream &ss, const conditions::where_t<C> &w) {
+            void process_single_condition(internal::query_context &context, std::stringstream &ss, const conditions::where_t<C> &w) {
                 ss << static_cast<std::string>(w) << " ";
-                auto whereString = this->process_where(w.c);
+                auto whereString = this->process_where(context, w.c);
                 ss << "( " << whereString << ") ";
             }
             
             template<class O>
-            void process_single_condition(std::stringstream &ss, const conditions::order_by_t<O> &orderBy) {
+            void process_single_condition(internal::query_context &context, std::stringstream &ss, const conditions::order_by_t<O> &orderBy) {
                 ss << static_cast<std::string>(orderBy) << " ";
-                auto orderByString = this->process_order_by(orderBy);
+                auto orderByString = this->process_order_by(context, orderBy);
                 ss << orderByString << " ";
             }
             
             template<class ...Args>
-            void process_single_condition(std::stringstream &ss, const conditions::multi_order_by_t<Args...> &orderBy) {
+            void process_single_condition(internal::query_context &context, std::stringstream &ss, const conditions::multi_order_by_t<Args...> &orderBy) {
                 std::vector<std::string> expressions;
                 using tuple_t = std::tuple<Args...>;
-                tuple_helper::iterator<std::tuple_size<tuple_t>::value - 1, Args...>()(orderBy.args, [&expressions, this](auto &v){
-                    auto expression = this->process_order_by(v);
+                tuple_helper::iterator<std::tuple_size<tuple_t>::value - 1, Args...>()(orderBy.args, [&context, &expressions, this](auto &v){
+                    auto expression = this->process_order_by(context, v);
                     expressions.insert(expressions.begin(), expression);
                 });
                 ss << static_cast<std::string>(orderBy) << " ";
@@ -6617,11 +8928,11 @@ namespace sqlite_orm {
             }
             
             template<class ...Args>
-            void process_single_condition(std::stringstream &ss, const conditions::group_by_t<Args...> &groupBy) {
+            void process_single_condition(internal::query_context &context, std::stringstream &ss, const conditions::group_by_t<Args...> &groupBy) {
                 std::vector<std::string> expressions;
                 using tuple_t = std::tuple<Args...>;
-                tuple_helper::iterator<std::tuple_size<tuple_t>::value - 1, Args...>()(groupBy.args, [&expressions, this](auto &v){
-                    auto expression = this->string_from_expression(v);
+                tuple_helper::iterator<std::tuple_size<tuple_t>::value - 1, Args...>()(groupBy.args, [&context, &expressions, this](auto &v){
+                    auto expression = this->string_from_expression(context, v);
                     expressions.push_back(expression);
                 });
                 ss << static_cast<std::string>(groupBy) << " ";
@@ -6638,14 +8949,14 @@ namespace sqlite_orm {
              *  Recursion end.
              */
             template<class ...Args>
-            void process_conditions(std::stringstream &, Args .../*args*/) {
+            void process_conditions(internal::query_context &/*context*/, std::stringstream &, Args .../*args*/) {
                 //..
             }
             
             template<class C, class ...Args>
-            void process_conditions(std::stringstream &ss, C c, Args&& ...args) {
-                this->process_single_condition(ss, c);
-                this->process_conditions(ss, std::forward<Args>(args)...);
+            void process_conditions(internal::query_context &context, std::stringstream &ss, C c, Args&& ...args) {
+                this->process_single_condition(context, ss, c);
+                this->process_conditions(context, ss, std::forward<Args>(args)...);
             }
             
             void on_open_internal(sqlite3 *db) {
@@ -6674,6 +8985,8 @@ namespace sqlite_orm {
                     sqlite3_limit(db, p.first, p.second);
                 }
                 
+                this->tracer->register_on(db);
+                
                 if(this->on_open){
                     this->on_open(db);
                 }
@@ -6706,6 +9019,161 @@ namespace sqlite_orm {
                 return {*this, connection, std::forward<Args>(args)...};
             }
             
+            /**
+             *  Enables collecting statistics of every statement executed by storage: calls count, rows count,
+             *  total, median, 99th percentile and max latencies. Statements are aggregated by text with literals
+             *  replaced with `?`. Uses `sqlite3_trace_v2` so requires SQLite 3.14.0 or newer. Statistics are
+             *  available with `profile_snapshot`.
+             */
+            void enable_profiling(bool value = true) {
+                this->tracer->isProfilingEnabled = value;
+                if(this->currentTransaction){
+                    this->tracer->register_on(this->currentTransaction->get_db());
+                }
+            }
+            
+            /**
+             *  @return statistics of at most `topN` statements with the biggest total time since profiling was
+             *  enabled or reset.
+             */
+            std::vector<query_profile> profile_snapshot(size_t topN = 10) {
+                return this->tracer->queryProfiler.snapshot(topN);
+            }
+            
+            void reset_profiling() {
+                this->tracer->queryProfiler.reset();
+            }
+            
+            /**
+             *  Enables logging of statements executed longer than `threshold`. Every record contains statement
+             *  text, statement text with bound values, mapped table and storage operation name and elapsed time.
+             *  Records are passed to `sink` if it is set or are kept in a ring buffer of `capacity` size otherwise
+             *  (see `slow_queries`). Sink can be called from any thread storage is used from. Uses `sqlite3_trace_v2`
+             *  so requires SQLite 3.14.0 or newer.
+             */
+            void enable_slow_query_log(std::chrono::nanoseconds threshold, std::function<void(const slow_query&)> sink = {}, size_t capacity = 100) {
+                this->tracer->slowQueryLog.configure(threshold, std::move(sink), capacity);
+                this->tracer->isSlowQueryLogEnabled = true;
+                if(this->currentTransaction){
+                    this->tracer->register_on(this->currentTransaction->get_db());
+                }
+            }
+            
+            void disable_slow_query_log() {
+                this->tracer->isSlowQueryLogEnabled = false;
+                if(this->currentTransaction){
+                    this->tracer->register_on(this->currentTransaction->get_db());
+                }
+            }
+            
+            /**
+             *  @return slow queries kept in ring buffer from oldest to newest.
+             */
+            std::vector<slow_query> slow_queries() {
+                return this->tracer->slowQueryLog.get_records();
+            }
+            
+            /**
+             *  Enables collecting `sqlite3_stmt_status` counters (full scan steps, sorts, automatic index rows,
+             *  VM steps, reprepares and memory used) of every statement executed by storage. Counters are grouped by
+             *  mapped table and storage operation and are available with `statement_stats`. Uses `sqlite3_trace_v2`
+             *  so requires SQLite 3.14.0 or newer.
+             */
+            void enable_statement_stats(bool value = true) {
+                this->tracer->isStatementStatsEnabled = value;
+                if(this->currentTransaction){
+                    this->tracer->register_on(this->currentTransaction->get_db());
+                }
+            }
+            
+            /**
+             *  @return counters collected since statement stats were enabled or reset.
+             */
+            sqlite_orm::statement_stats statement_stats() {
+                return this->tracer->statementStats.snapshot();
+            }
+            
+            /**
+             *  @return counters of `operation` called for mapped type `O`. Counters of all operations
+             *  called for `O` are summed if `operation` is empty.
+             */
+            template<class O>
+            statement_counters statement_stats(const std::string &operation = {}) {
+                this->assert_mapped_type<O>();
+                return this->statement_stats().get(this->get_impl<O>().table.name, operation);
+            }
+            
+            void reset_statement_stats() {
+                this->tracer->statementStats.reset();
+            }
+            
+            /**
+             *  Starts writing every statement executed by storage with bound values and timing into a compact
+             *  binary workload log at `path`. Log can be read with `read_workload` and replayed with `replay`
+             *  tool from benchmarks directory. Statements of all connections and threads are written into
+             *  a single log in order of completion. Uses `sqlite3_trace_v2` so requires SQLite 3.14.0 or newer.
+             *  Note: recorded execution time precision depends on VFS clock and is often a millisecond.
+             *  throws std::system_error if file cannot be opened.
+             */
+            void start_recording(const std::string &path) {
+                this->tracer->workloadRecorder.start(path);
+                this->tracer->isRecording = true;
+                if(this->currentTransaction){
+                    this->tracer->register_on(this->currentTransaction->get_db());
+                }
+            }
+            
+            /**
+             *  Stops recording started with `start_recording` and closes the log.
+             */
+            void stop_recording() {
+                this->tracer->isRecording = false;
+                this->tracer->workloadRecorder.stop();
+                if(this->currentTransaction){
+                    this->tracer->register_on(this->currentTransaction->get_db());
+                }
+            }
+            
+            /**
+             *  @return query which storage would execute for expression `expression` without executing it.
+             *  Accepts `get_all<T>(args...)`, `count<T>(args...)` and `select(...)` expressions, e.g.
+             *  `storage.sql(get_all<User>(where(c(&User::id) > 10)))`. `in` values are written into query text.
+             */
+            template<class T>
+            std::string sql(const T &expression) {
+                
+                //  nothing is executed so `in` values are written into query text
+                internal::query_context context{nullptr};
+                return this->string_from_expression(context, expression);
+            }
+            
+            /**
+             *  Runs `EXPLAIN QUERY PLAN` for an expression accepted by `sql`.
+             *  @return plan nodes tree.
+             */
+            template<class T>
+            query_plan explain(const T &expression) {
+                auto connection = this->get_or_create_connection();
+                internal::query_context context{connection};
+                return this->explain_query(connection->get_db(), this->string_from_expression(context, expression));
+            }
+            
+            /**
+             *  Marks table mapped to `O` as large. In debug builds (NDEBUG is not defined) `get_all`, `select`
+             *  and `count` explain their queries before execution if any table is marked as large and fire
+             *  an assertion if the plan contains full scan of a marked table.
+             */
+            template<class O>
+            void mark_large_table(bool value = true) {
+                this->assert_mapped_type<O>();
+                auto &tableName = this->get_impl<O>().table.name;
+                if(value) {
+                    this->largeTables.insert(tableName);
+                }else{
+                    this->largeTables.erase(tableName);
+                }
+            }
+            
             void create_collation(const std::string &name, collating_function f) {
                 collating_function *functionPointer = nullptr;
                 if(f){
@@ -6731,12 +9199,14 @@ namespace sqlite_orm {
             template<class O, class ...Args>
             void remove_all(Args&& ...args) {
                 this->assert_mapped_type<O>();
+                internal::operation_scope operationScope("remove_all", &this->get_impl<O>().table.name);
                 
                 auto connection = this->get_or_create_connection();
+                internal::query_context context{connection};
                 auto &impl = this->get_impl<O>();
                 std::stringstream ss;
                 ss << "DELETE FROM '" << impl.table.name << "' ";
-                this->process_conditions(ss, std::forward<Args>(args)...);
+                this->process_conditions(context, ss, std::forward<Args>(args)...);
                 auto query = ss.str();
                 sqlite3_stmt *stmt;
                 if (sqlite3_prepare_v2(connection->get_db(), query.c_str(), -1, &stmt, nullptr) == SQLITE_OK) {
@@ -6751,6 +9221,226 @@ namespace sqlite_orm {
                 }
             }
             
+        protected:
+            
+            /**
+             *  `WHERE "pk" = ? AND ...` clause matching a row by all primary key columns of `impl`. Values
+             *  are bound by `bind_primary_key` or `primary_key_value`.
+             */
+            template<class I>
+            std::string primary_key_where(I &impl) {
+                std::stringstream ss;
+                ss << "WHERE ";
+                auto primaryKeyColumnNames = impl.table.primary_key_column_names();
+                for(size_t i = 0; i < primaryKeyColumnNames.size(); ++i) {
+                    ss << "\"" << primaryKeyColumnNames[i] << "\"" << " = ?";
+                    if(i < primaryKeyColumnNames.size() - 1) {
+                        ss << " AND ";
+                    }else{
+                        ss << " ";
+                    }
+                }
+                return ss.str();
+            }
+            
+            /**
+             *  Whether `columnName` is one of `primaryKeyColumnNames`. Unlike checking `primary_key()` column
+             *  constraint it also matches columns of a table level (composite) primary key.
+             */
+            static bool is_primary_key_column(const std::string &columnName, const std::vector<std::string> &primaryKeyColumnNames) {
+                return std::find(primaryKeyColumnNames.begin(), primaryKeyColumnNames.end(), columnName) != primaryKeyColumnNames.end();
+            }
+            
+            /**
+             *  Binds primary key columns of `o` starting from `index` in the order of `primary_key_where`.
+             *  @param primaryKeyColumnNames result of `primary_key_column_names` of `impl` table.
+             */
+            template<class I, class O>
+            void bind_primary_key(sqlite3_stmt *stmt, I &impl, const O &o, const std::vector<std::string> &primaryKeyColumnNames, int &index) {
+                for(auto &columnName : primaryKeyColumnNames) {
+                    impl.table.for_each_column([&o, stmt, &index, &columnName] (auto c) {
+                        if(c.name == columnName) {
+                            using field_type = typename decltype(c)::field_type;
+                            const field_type *value = nullptr;
+                            if(c.member_pointer){
+                                value = &(o.*c.member_pointer);
+                            }else{
+                                value = &((o).*(c.getter))();
+                            }
+                            statement_binder<field_type>().bind(stmt, index++, *value);
+                        }
+                    });
+                }
+            }
+            
+            /**
+             *  Query used by `remove` and `remove_range`: `DELETE FROM 'table' WHERE "pk" = ?`.
+             */
+            template<class I>
+            std::string remove_query(I &impl) {
+                std::stringstream ss;
+                ss << "DELETE FROM '" << impl.table.name << "' ";
+                ss << this->primary_key_where(impl);
+                return ss.str();
+            }
+            
+            /**
+             *  Query used by `update` and `update_range`: `UPDATE 'table' SET "c" = ?, ... WHERE "pk" = ?`.
+             */
+            template<class I>
+            std::string update_query(I &impl) {
+                std::stringstream ss;
+                ss << "UPDATE '" << impl.table.name << "' SET ";
+                std::vector<std::string> setColumnNames;
+                auto primaryKeyColumnNames = impl.table.primary_key_column_names();
+                impl.table.for_each_column([&setColumnNames, &primaryKeyColumnNames](auto c) {
+                    if(!is_primary_key_column(c.name, primaryKeyColumnNames)) {
+                        setColumnNames.emplace_back(c.name);
+                    }
+                });
+                for(size_t i = 0; i < setColumnNames.size(); ++i) {
+                    ss << "\"" << setColumnNames[i] << "\"" << " = ?";
+                    if(i < setColumnNames.size() - 1) {
+                        ss << ", ";
+                    }else{
+                        ss << " ";
+                    }
+                }
+                ss << this->primary_key_where(impl);
+                return ss.str();
+            }
+            
+            template<class O, class F, class I>
+            void update_column_internal(const char *operation, F O::*m, const I &id, const F &value, bool increment) {
+                this->assert_mapped_type<O>();
+                auto &impl = this->get_impl<O>();
+                internal::operation_scope operationScope(operation, &impl.table.name);
+                measurement_type measurement(this->instrumentationPolicy, operation);
+                
+                measurement.phase(instrumentation_phase::connect);
+                auto connection = this->get_or_create_connection();
+                measurement.phase(instrumentation_phase::build);
+                auto columnName = impl.table.find_column_name(m);
+                if(columnName.empty()) {
+                    throw std::system_error(std::make_error_code(orm_error_code::column_not_found));
+                }
+                auto primaryKeyColumnNames = impl.table.primary_key_column_names();
+                if(primaryKeyColumnNames.empty()) {
+                    throw std::system_error(std::make_error_code(orm_error_code::table_has_no_primary_key_column));
+                }
+                std::stringstream ss;
+                ss << "UPDATE '" << impl.table.name << "' SET \"" << columnName << "\" = ";
+                if(increment) {
+                    ss << "\"" << columnName << "\" + ";
+                }
+                ss << "? " << this->primary_key_where(impl);
+                auto query = ss.str();
+                measurement.phase(instrumentation_phase::prepare);
+                auto stmt = connection->get_statement(query);
+                statement_resetter resetter{stmt};
+                measurement.phase(instrumentation_phase::bind);
+                auto index = 1;
+                statement_binder<F>().bind(stmt, index++, value);
+                internal::primary_key_value<I>::bind(stmt, index, id);
+                measurement.phase(instrumentation_phase::step);
+                if (sqlite3_step(stmt) == SQLITE_DONE) {
+                    //  done..
+                }else{
+                    throw std::system_error(std::error_code(sqlite3_errcode(connection->get_db()), get_sqlite_error_category()));
+                }
+            }
+            
+            /**
+             *  Query used by `update(o, original)`: `UPDATE 'table' SET "c" = ? WHERE "pk" = ?` with columns
+             *  set by `changedColumns` only.
+             */
+            template<class I>
+            std::string partial_update_query(I &impl, const std::vector<bool> &changedColumns) {
+                std::stringstream ss;
+                ss << "UPDATE '" << impl.table.name << "' SET ";
+                std::vector<std::string> setColumnNames;
+                auto primaryKeyColumnNames = impl.table.primary_key_column_names();
+                size_t columnIndex = 0;
+                impl.table.for_each_column([&setColumnNames, &primaryKeyColumnNames, &changedColumns, &columnIndex](auto c) {
+                    if(!is_primary_key_column(c.name, primaryKeyColumnNames) && changedColumns[columnIndex++]) {
+                        setColumnNames.emplace_back(c.name);
+                    }
+                });
+                for(size_t i = 0; i < setColumnNames.size(); ++i) {
+                    ss << "\"" << setColumnNames[i] << "\"" << " = ?";
+                    if(i < setColumnNames.size() - 1) {
+                        ss << ", ";
+                    }else{
+                        ss << " ";
+                    }
+                }
+                ss << this->primary_key_where(impl);
+                return ss.str();
+            }
+            
+            /**
+             *  Binds `o` to a statement prepared from `update_query`: non primary key columns first, primary key
+             *  columns after them.
+             *  @param primaryKeyColumnNames result of `primary_key_column_names` of `impl` table.
+             */
+            template<class I, class O>
+            void bind_update(sqlite3_stmt *stmt, I &impl, const O &o, const std::vector<std::string> &primaryKeyColumnNames) {
+                auto index = 1;
+                impl.table.for_each_column([&o, stmt, &index, &primaryKeyColumnNames] (auto c) {
+                    if(!is_primary_key_column(c.name, primaryKeyColumnNames)) {
+                        using field_type = typename decltype(c)::field_type;
+                        const field_type *value = nullptr;
+                        if(c.member_pointer){
+                            value = &(o.*c.member_pointer);
+                        }else{
+                            value = &((o).*(c.getter))();
+                        }
+                        statement_binder<field_type>().bind(stmt, index++, *value);
+                    }
+                });
+                this->bind_primary_key(stmt, impl, o, primaryKeyColumnNames, index);
+            }
+            
+            /**
+             *  Prepares `query` once and calls `bind(stmt, element)` and steps the statement for every element of
+             *  [from, to). Runs inside a transaction: the current one if `db` is already in a transaction or a new one
+             *  which is committed at the end and rolled back if any step fails.
+             */
+            template<class It, class B>
+            void execute_range(sqlite3 *db, const std::string &query, It from, It to, measurement_type &measurement, const B &bind) {
+                sqlite3_stmt *stmt;
+                measurement.phase(instrumentation_phase::prepare);
+                if (sqlite3_prepare_v2(db, query.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+                    throw std::system_error(std::error_code(sqlite3_errcode(db), get_sqlite_error_category()));
+                }
+                statement_finalizer finalizer{stmt};
+                measurement.phase(instrumentation_phase::step);
+                auto ownTransaction = sqlite3_get_autocommit(db) != 0;
+                if(ownTransaction) {
+                    this->impl.begin_transaction(db);
+                }
+                try{
+                    for(auto it = from; it != to; ++it) {
+                        bind(stmt, *it);
+                        if (sqlite3_step(stmt) != SQLITE_DONE) {
+                            throw std::system_error(std::error_code(sqlite3_errcode(db), get_sqlite_error_category()));
+                        }
+                        sqlite3_reset(stmt);
+                        sqlite3_clear_bindings(stmt);
+                    }
+                }catch(...){
+                    if(ownTransaction) {
+                        this->impl.rollback(db);
+                    }
+                    throw;
+                }
+                if(ownTransaction) {
+                    this->impl.commit(db);
+                }
+            }
+            
+        public:
+            
             /**
              *  Delete routine.
              *  O is an object's type. Must be specified explicitly.
@@ -6759,27 +9449,21 @@ namespace sqlite_orm {
             template<class O, class I>
             void remove(I id) {
                 this->assert_mapped_type<O>();
+                internal::operation_scope operationScope("remove", &this->get_impl<O>().table.name);
+                measurement_type measurement(this->instrumentationPolicy, "remove");
                 
+                measurement.phase(instrumentation_phase::connect);
                 auto connection = this->get_or_create_connection();
-                auto &impl = this->get_impl<O>();
-                std::stringstream ss;
-                ss << "DELETE FROM '" << impl.table.name << "' ";
-                ss << "WHERE ";
-                auto primaryKeyColumnNames = impl.table.primary_key_column_names();
-                for(size_t i = 0; i < primaryKeyColumnNames.size(); ++i) {
-                    ss << "\"" << primaryKeyColumnNames[i] << "\"" << " =  ?";
-                    if(i < primaryKeyColumnNames.size() - 1) {
-                        ss << " AND ";
-                    }else{
-                        ss << " ";
-                    }
-                }
-                auto query = ss.str();
+                measurement.phase(instrumentation_phase::build);
+                auto query = this->remove_query(this->get_impl<O>());
                 sqlite3_stmt *stmt;
+                measurement.phase(instrumentation_phase::prepare);
                 if (sqlite3_prepare_v2(connection->get_db(), query.c_str(), -1, &stmt, nullptr) == SQLITE_OK) {
                     statement_finalizer finalizer{stmt};
+                    measurement.phase(instrumentation_phase::bind);
                     auto index = 1;
                     statement_binder<I>().bind(stmt, index++, id);
+                    measurement.phase(instrumentation_phase::step);
                     if (sqlite3_step(stmt) == SQLITE_DONE) {
                         //  done..
                     }else{
@@ -6799,64 +9483,21 @@ namespace sqlite_orm {
             template<class O>
             void update(const O &o) {
                 this->assert_mapped_type<O>();
+                internal::operation_scope operationScope("update", &this->get_impl<O>().table.name);
+                measurement_type measurement(this->instrumentationPolicy, "update");
                 
+                measurement.phase(instrumentation_phase::connect);
                 auto connection = this->get_or_create_connection();
+                measurement.phase(instrumentation_phase::build);
                 auto &impl = this->get_impl<O>();
-                std::stringstream ss;
-                ss << "UPDATE '" << impl.table.name << "' SET ";
-                std::vector<std::string> setColumnNames;
-                impl.table.for_each_column([&setColumnNames](auto c) {
-                    if(!c.template has<constraints::primary_key_t<>>()) {
-                        setColumnNames.emplace_back(c.name);
-                    }
-                });
-                for(size_t i = 0; i < setColumnNames.size(); ++i) {
-                    ss << "\"" << setColumnNames[i] << "\"" << " = ?";
-                    if(i < setColumnNames.size() - 1) {
-                        ss << ", ";
-                    }else{
-                        ss << " ";
-                    }
-                }
-                ss << "WHERE ";
-                auto primaryKeyColumnNames = impl.table.primary_key_column_names();
-                for(size_t i = 0; i < primaryKeyColumnNames.size(); ++i) {
-                    ss << "\"" << primaryKeyColumnNames[i] << "\"" << " = ?";
-                    if(i < primaryKeyColumnNames.size() - 1) {
-                        ss << " AND ";
-                    }else{
-                        ss << " ";
-                    }
-                }
-                auto query = ss.str();
+                auto query = this->update_query(impl);
                 sqlite3_stmt *stmt;
+                measurement.phase(instrumentation_phase::prepare);
                 if (sqlite3_prepare_v2(connection->get_db(), query.c_str(), -1, &stmt, nullptr) == SQLITE_OK) {
                     statement_finalizer finalizer{stmt};
-                    auto index = 1;
-                    impl.table.for_each_column([&o, stmt, &index] (auto c) {
-                        if(!c.template has<constraints::primary_key_t<>>()) {
-                            using field_type = typename decltype(c)::field_type;
-                            const field_type *value = nullptr;
-                            if(c.member_pointer){
-                                value = &(o.*c.member_pointer);
-                            }else{
-                                value = &((o).*(c.getter))();
-                            }
-                            statement_binder<field_type>().bind(stmt, index++, *value);
-                        }
-                    });
-                    impl.table.for_each_column([&o, stmt, &index] (auto c) {
-                        if(c.template has<constraints::primary_key_t<>>()) {
-                            typedef typename decltype(c)::field_type field_type;
-                            const field_type *value = nullptr;
-                            if(c.member_pointer){
-                                value = &(o.*c.member_pointer);
-                            }else{
-                                value = &((o).*(c.getter))();
-                            }
-                            statement_binder<field_type>().bind(stmt, index++, *value);
-                        }
-                    });
+                    measurement.phase(instrumentation_phase::bind);
+                    this->bind_update(stmt, impl, o, impl.table.primary_key_column_names());
+                    measurement.phase(instrumentation_phase::step);
                     if (sqlite3_step(stmt) == SQLITE_DONE) {
                         //  done..
                     }else{
@@ -6867,9 +9508,169 @@ namespace sqlite_orm {
                 }
             }
             
+            /**
+             *  Partial update routine. Compares `o` with `original` (usually a copy made when the object was
+             *  fetched) and sets only non primary key fields which values differ. Does nothing if all fields are
+             *  equal. Fields are compared with `field_comparator`. Statements are cached by connection per table
+             *  and changed fields set.
+             *  @param o object to be updated.
+             *  @param original object state the database is known to have. Its primary key is not used.
+             */
+            template<class O>
+            void update(const O &o, const O &original) {
+                this->assert_mapped_type<O>();
+                internal::operation_scope operationScope("update", &this->get_impl<O>().table.name);
+                measurement_type measurement(this->instrumentationPolicy, "update");
+                auto &impl = this->get_impl<O>();
+                std::vector<bool> changedColumns;
+                auto changedColumnsCount = 0;
+                auto primaryKeyColumnNames = impl.table.primary_key_column_names();
+                impl.table.for_each_column([&o, &original, &primaryKeyColumnNames, &changedColumns, &changedColumnsCount] (auto c) {
+                    if(!is_primary_key_column(c.name, primaryKeyColumnNames)) {
+                        using field_type = typename decltype(c)::field_type;
+                        const field_type *value = nullptr;
+                        const field_type *originalValue = nullptr;
+                        if(c.member_pointer){
+                            value = &(o.*c.member_pointer);
+                            originalValue = &(original.*c.member_pointer);
+                        }else{
+                            value = &((o).*(c.getter))();
+                            originalValue = &((original).*(c.getter))();
+                        }
+                        auto changed = !field_comparator<field_type>()(*value, *originalValue);
+                        changedColumns.push_back(changed);
+                        changedColumnsCount += changed;
+                    }
+                });
+                if(!changedColumnsCount) {
+                    return;
+                }
+                
+                measurement.phase(instrumentation_phase::connect);
+                auto connection = this->get_or_create_connection();
+                measurement.phase(instrumentation_phase::build);
+                
+                //  statement is looked up by table and changed columns so query text is built once per connection
+                std::string key = "update " + impl.table.name + " ";
+                for(auto changed : changedColumns) {
+                    key += changed ? '1' : '0';
+                }
+                measurement.phase(instrumentation_phase::prepare);
+                auto stmt = connection->get_statement(key, [this, &impl, &changedColumns]{
+                    return this->partial_update_query(impl, changedColumns);
+                });
+                statement_resetter resetter{stmt};
+                measurement.phase(instrumentation_phase::bind);
+                auto index = 1;
+                size_t columnIndex = 0;
+                impl.table.for_each_column([&o, stmt, &index, &primaryKeyColumnNames, &changedColumns, &columnIndex] (auto c) {
+                    if(!is_primary_key_column(c.name, primaryKeyColumnNames) && changedColumns[columnIndex++]) {
+                        using field_type = typename decltype(c)::field_type;
+                        const field_type *value = nullptr;
+                        if(c.member_pointer){
+                            value = &(o.*c.member_pointer);
+                        }else{
+                            value = &((o).*(c.getter))();
+                        }
+                        statement_binder<field_type>().bind(stmt, index++, *value);
+                    }
+                });
+                this->bind_primary_key(stmt, impl, o, primaryKeyColumnNames, index);
+                measurement.phase(instrumentation_phase::step);
+                if (sqlite3_step(stmt) == SQLITE_DONE) {
+                    //  done..
+                }else{
+                    throw std::system_error(std::error_code(sqlite3_errcode(connection->get_db()), get_sqlite_error_category()));
+                }
+            }
+            
+            /**
+             *  Updates every object of [from, to) like `update` does. The `UPDATE` statement is built and
+             *  prepared once and rebound for every object. All updates are performed in one transaction:
+             *  the current one if it is active or a new one otherwise. If any update fails the new transaction
+             *  is rolled back and the error is thrown.
+             */
+            template<class It>
+            void update_range(It from, It to) {
+                using O = typename std::iterator_traits<It>::value_type;
+                this->assert_mapped_type<O>();
+                internal::operation_scope operationScope("update_range", &this->get_impl<O>().table.name);
+                measurement_type measurement(this->instrumentationPolicy, "update_range");
+                if(from == to) {
+                    return;
+                }
+                
+                measurement.phase(instrumentation_phase::connect);
+                auto connection = this->get_or_create_connection();
+                measurement.phase(instrumentation_phase::build);
+                auto &impl = this->get_impl<O>();
+                auto query = this->update_query(impl);
+                auto primaryKeyColumnNames = impl.table.primary_key_column_names();
+                this->execute_range(connection->get_db(), query, from, to, measurement, [this, &impl, &primaryKeyColumnNames](sqlite3_stmt *stmt, const O &o) {
+                    this->bind_update(stmt, impl, o, primaryKeyColumnNames);
+                });
+            }
+            
+            /**
+             *  Removes objects with ids from [from, to) like `remove` does. The `DELETE` statement is built and
+             *  prepared once and rebound for every id. Removes are performed in one transaction just like
+             *  `update_range` updates.
+             *  O is an object's type. Must be specified explicitly.
+             *  Id type is a primary key field type or `std::tuple` of fields types for a composite primary key
+             *  with values in the same order as columns are passed to `primary_key()`.
+             */
+            template<class O, class It>
+            void remove_range(It from, It to) {
+                using id_type = typename std::iterator_traits<It>::value_type;
+                this->assert_mapped_type<O>();
+                internal::operation_scope operationScope("remove_range", &this->get_impl<O>().table.name);
+                measurement_type measurement(this->instrumentationPolicy, "remove_range");
+                if(from == to) {
+                    return;
+                }
+                
+                measurement.phase(instrumentation_phase::connect);
+                auto connection = this->get_or_create_connection();
+                measurement.phase(instrumentation_phase::build);
+                auto query = this->remove_query(this->get_impl<O>());
+                this->execute_range(connection->get_db(), query, from, to, measurement, [](sqlite3_stmt *stmt, const id_type &id) {
+                    auto index = 1;
+                    internal::primary_key_value<id_type>::bind(stmt, index, id);
+                });
+            }
+            
+            /**
+             *  Sets one field of an object with primary key equal to `id`:
+             *  `UPDATE 'table' SET "column" = ? WHERE "pk" = ?`. Other fields are not touched so there is no
+             *  need to fetch the object first. Statement is cached by connection.
+             *  Id type is a primary key field type or `std::tuple` of fields types for a composite primary key.
+             *  Does nothing if there is no such object.
+             *  @param m member pointer of the field to be set.
+             *  @param value new field value. Is converted to the field type.
+             */
+            template<class O, class F, class I, class V>
+            void update_column(F O::*m, const I &id, const V &value) {
+                this->update_column_internal("update_column", m, id, F(value), false);
+            }
+            
+            /**
+             *  Adds `delta` to one field of an object with primary key equal to `id` inside the database:
+             *  `UPDATE 'table' SET "column" = "column" + ? WHERE "pk" = ?`. Unlike `get` + `update` it is one
+             *  statement so concurrent increments from different connections are not lost.
+             *  Statement is cached by connection. Does nothing if there is no such object.
+             *  @param m member pointer of a numeric field.
+             *  @param delta value added to the field. Pass a negative value to decrement.
+             */
+            template<class O, class F, class I, class V>
+            void increment(F O::*m, const I &id, const V &delta) {
+                this->update_column_internal("increment", m, id, F(delta), true);
+            }
+            
             template<class ...Args, class ...Wargs>
             void update_all(internal::set_t<Args...> set, Wargs ...wh) {
+                internal::operation_scope operationScope("update_all");
                 auto connection = this->get_or_create_connection();
+                internal::query_context context{connection};
                 
                 std::stringstream ss;
                 ss << "UPDATE ";
@@ -6883,9 +9684,9 @@ namespace sqlite_orm {
                         ss << " '" << *tableNamesSet.begin() << "' ";
                         ss << static_cast<std::string>(set) << " ";
                         std::vector<std::string> setPairs;
-                        set.for_each([this, &setPairs](auto &asgn){
+                        set.for_each([&context, this, &setPairs](auto &asgn){
                             std::stringstream sss;
-                            sss << this->string_from_expression(asgn.l, true) << " = " << this->string_from_expression(asgn.r) << " ";
+                            sss << this->string_from_expression(context, asgn.l, true) << " = " << this->string_from_expression(context, asgn.r) << " ";
                             setPairs.push_back(sss.str());
                         });
                         auto setPairsCount = setPairs.size();
@@ -6895,7 +9696,7 @@ namespace sqlite_orm {
                                 ss << ", ";
                             }
                         }
-                        this->process_conditions(ss, wh...);
+                        this->process_conditions(context, ss, wh...);
                         auto query = ss.str();
                         sqlite3_stmt *stmt;
                         if (sqlite3_prepare_v2(connection->get_db(), query.c_str(), -1, &stmt, nullptr) == SQLITE_OK) {
@@ -6925,7 +9726,7 @@ namespace sqlite_orm {
              *  @return impl for O
              */
             template<class O, class ...Args>
-            auto& generate_select_asterisk(std::string *query, Args&& ...args) {
+            auto& generate_select_asterisk(internal::query_context &context, std::string *query, Args&& ...args) {
                 std::stringstream ss;
                 ss << "SELECT ";
                 auto &impl = this->get_impl<O>();
@@ -6944,7 +9745,7 @@ namespace sqlite_orm {
                     }
                 }
                 ss << "FROM '" << impl.table.name << "' ";
-                this->process_conditions(ss, std::forward<Args>(args)...);
+                this->process_conditions(context, ss, std::forward<Args>(args)...);
                 if(query){
                     *query = ss.str();
                 }
@@ -7114,6 +9915,11 @@ namespace sqlite_orm {
                 return this->parse_table_name(f.t);
             }
             
+            template<class O>
+            std::set<std::string> parse_table_name(const conditions::order_by_t<O> &orderBy) {
+                return this->parse_table_name(orderBy.o);
+            }
+            
             template<class L, class R, class ...Args>
             std::set<std::string> parse_table_name(const conc_t<L, R> &f) {
                 std::set<std::string> res;
@@ -7207,20 +10013,22 @@ namespace sqlite_orm {
             template<class F, class O, class ...Args>
             std::string group_concat_internal(F O::*m, std::shared_ptr<const std::string> y, Args&& ...args) {
                 this->assert_mapped_type<O>();
+                internal::operation_scope operationScope("group_concat", &this->get_impl<O>().table.name);
                 
                 auto connection = this->get_or_create_connection();
+                internal::query_context context{connection};
                 auto &impl = this->get_impl<O>();
                 std::string res;
                 std::stringstream ss;
                 ss << "SELECT " << static_cast<std::string>(sqlite_orm::group_concat(0)) << "(";
-                auto columnName = this->string_from_expression(m);
+                auto columnName = this->string_from_expression(context, m);
                 if(columnName.length()){
                     ss << columnName;
                     if(y){
                         ss << ",\"" << *y << "\"";
                     }
                     ss << ") FROM '"<< impl.table.name << "' ";
-                    this->process_conditions(ss, std::forward<Args>(args)...);
+                    this->process_conditions(context, ss, std::forward<Args>(args)...);
                     auto query = ss.str();
                     auto rc = sqlite3_exec(connection->get_db(),
                                            query.c_str(),
@@ -7240,6 +10048,126 @@ namespace sqlite_orm {
                 return res;
             }
             
+            /**
+             *  Multi-get implementation. Fetches unique ids from [from, to) with as few statements as
+             *  `SQLITE_LIMIT_VARIABLE_NUMBER` allows. Composite ids are matched with row values which require
+             *  SQLite 3.15.0, older versions use `OR` chains limited by `SQLITE_LIMIT_EXPR_DEPTH`. Primary key columns are selected after object columns
+             *  so every row is mapped back to its id.
+             */
+            template<class O, class It, class Id = typename std::iterator_traits<It>::value_type>
+            std::map<Id, O> get_map_internal(It from, It to, const char *operation) {
+                this->assert_mapped_type<O>();
+                internal::operation_scope operationScope(operation, &this->get_impl<O>().table.name);
+                using primary_key_value = internal::primary_key_value<Id>;
+                
+                std::map<Id, O> res;
+                std::set<Id> ids(from, to);
+                if(ids.empty()) {
+                    return res;
+                }
+                auto connection = this->get_or_create_connection();
+                auto db = connection->get_db();
+                auto &impl = this->get_impl<O>();
+                auto primaryKeyColumnNames = impl.table.primary_key_column_names();
+                if(primaryKeyColumnNames.empty() || !primaryKeyColumnNames.front().length()) {
+                    throw std::system_error(std::make_error_code(orm_error_code::table_has_no_primary_key_column));
+                }
+                std::stringstream ss;
+                ss << "SELECT ";
+                for(auto &columnName : impl.table.column_names()) {
+                    ss << "\"" << columnName << "\", ";
+                }
+                for(size_t i = 0; i < primaryKeyColumnNames.size(); ++i) {
+                    ss << "\"" << primaryKeyColumnNames[i] << "\"";
+                    if(i < primaryKeyColumnNames.size() - 1) {
+                        ss << ", ";
+                    }
+                }
+                ss << " FROM '" << impl.table.name << "' WHERE ";
+                auto selectPart = ss.str();
+                auto variablesLimit = sqlite3_limit(db, SQLITE_LIMIT_VARIABLE_NUMBER, -1);
+                auto chunkSize = static_cast<size_t>(std::max(1, variablesLimit / primary_key_value::columns_count));
+#if SQLITE_VERSION_NUMBER < 3015000
+                if(primaryKeyColumnNames.size() > 1) {
+                    
+                    //  every `OR` term nests expression one level deeper
+                    auto exprDepthLimit = sqlite3_limit(db, SQLITE_LIMIT_EXPR_DEPTH, -1);
+                    chunkSize = std::min(chunkSize, static_cast<size_t>(std::max(1, exprDepthLimit / 2)));
+                }
+#endif
+                auto it = ids.begin();
+                auto remaining = ids.size();
+                while(remaining) {
+                    auto count = std::min(chunkSize, remaining);
+                    std::stringstream qs;
+                    qs << selectPart;
+                    if(primaryKeyColumnNames.size() == 1) {
+                        qs << "\"" << primaryKeyColumnNames.front() << "\" IN (";
+                        for(size_t i = 0; i < count; ++i) {
+                            qs << (i ? ", ?" : "?");
+                        }
+                        qs << ")";
+                    }else{
+#if SQLITE_VERSION_NUMBER >= 3015000
+                        
+                        //  row values keep expression flat for any ids count
+                        qs << "(";
+                        for(size_t j = 0; j < primaryKeyColumnNames.size(); ++j) {
+                            qs << (j ? ", \"" : "\"") << primaryKeyColumnNames[j] << "\"";
+                        }
+                        qs << ") IN (VALUES ";
+                        for(size_t i = 0; i < count; ++i) {
+                            qs << (i ? ", (" : "(");
+                            for(size_t j = 0; j < primaryKeyColumnNames.size(); ++j) {
+                                qs << (j ? ", ?" : "?");
+                            }
+                            qs << ")";
+                        }
+                        qs << ")";
+#else
+                        for(size_t i = 0; i < count; ++i) {
+                            qs << (i ? " OR (" : "(");
+                            for(size_t j = 0; j < primaryKeyColumnNames.size(); ++j) {
+                                qs << (j ? " AND \"" : "\"") << primaryKeyColumnNames[j] << "\" = ?";
+                            }
+                            qs << ")";
+                        }
+#endif
+                    }
+                    auto query = qs.str();
+                    sqlite3_stmt *stmt;
+                    if(sqlite3_prepare_v2(db, query.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+                        throw std::system_error(std::error_code(sqlite3_errcode(db), get_sqlite_error_category()));
+                    }
+                    statement_finalizer finalizer{stmt};
+                    auto index = 1;
+                    for(size_t i = 0; i < count; ++i, ++it) {
+                        primary_key_value::bind(stmt, index, *it);
+                    }
+                    remaining -= count;
+                    int stepRes;
+                    while((stepRes = sqlite3_step(stmt)) == SQLITE_ROW) {
+                        O object;
+                        index = 0;
+                        impl.table.for_each_column([&index, &object, stmt] (auto c) {
+                            using field_type = typename decltype(c)::field_type;
+                            auto value = row_extractor<field_type>().extract(stmt, index++);
+                            if(c.member_pointer){
+                                object.*c.member_pointer = value;
+                            }else{
+                                ((object).*(c.setter))(std::move(value));
+                            }
+                        });
+                        auto id = primary_key_value::extract(stmt, index);
+                        res.insert({std::move(id), std::move(object)});
+                    }
+                    if(stepRes != SQLITE_DONE) {
+                        throw std::system_error(std::error_code(sqlite3_errcode(db), get_sqlite_error_category()));
+                    }
+                }
+                return res;
+            }
+            
         public:
             
             /**
@@ -7250,19 +10178,28 @@ namespace sqlite_orm {
             template<class O, class C = std::vector<O>, class ...Args>
             C get_all(Args&& ...args) {
                 this->assert_mapped_type<O>();
+                internal::operation_scope operationScope("get_all", &this->get_impl<O>().table.name);
+                measurement_type measurement(this->instrumentationPolicy, "get_all");
                 
+                measurement.phase(instrumentation_phase::connect);
                 auto connection = this->get_or_create_connection();
+                internal::query_context context{connection};
+                measurement.phase(instrumentation_phase::build);
                 C res;
                 std::string query;
-                auto &impl = this->generate_select_asterisk<O>(&query, std::forward<Args>(args)...);
+                auto &impl = this->generate_select_asterisk<O>(context, &query, std::forward<Args>(args)...);
+                this->assert_no_large_table_scan(connection->get_db(), query);
                 sqlite3_stmt *stmt;
+                measurement.phase(instrumentation_phase::prepare);
                 if (sqlite3_prepare_v2(connection->get_db(), query.c_str(), -1, &stmt, nullptr) == SQLITE_OK) {
                     statement_finalizer finalizer{stmt};
                     int stepRes;
                     do{
+                        measurement.phase(instrumentation_phase::step);
                         stepRes = sqlite3_step(stmt);
                         switch(stepRes){
                             case SQLITE_ROW:{
+                                measurement.phase(instrumentation_phase::hydrate);
                                 O obj;
                                 auto index = 0;
                                 impl.table.for_each_column([&index, &obj, stmt] (auto c) {
@@ -7299,8 +10236,12 @@ namespace sqlite_orm {
             template<class O, class ...Ids>
             O get(Ids ...ids) {
                 this->assert_mapped_type<O>();
+                internal::operation_scope operationScope("get", &this->get_impl<O>().table.name);
+                measurement_type measurement(this->instrumentationPolicy, "get");
                 
+                measurement.phase(instrumentation_phase::connect);
                 auto connection = this->get_or_create_connection();
+                measurement.phase(instrumentation_phase::build);
                 auto &impl = this->get_impl<O>();
                 std::shared_ptr<O> res;
                 std::stringstream ss;
@@ -7326,8 +10267,10 @@ namespace sqlite_orm {
                     }
                     auto query = ss.str();
                     sqlite3_stmt *stmt;
+                    measurement.phase(instrumentation_phase::prepare);
                     if (sqlite3_prepare_v2(connection->get_db(), query.c_str(), -1, &stmt, nullptr) == SQLITE_OK) {
                         statement_finalizer finalizer{stmt};
+                        measurement.phase(instrumentation_phase::bind);
                         auto index = 1;
                         auto idsTuple = std::make_tuple(std::forward<Ids>(ids)...);
                         constexpr const auto idsCount = std::tuple_size<decltype(idsTuple)>::value;
@@ -7335,9 +10278,11 @@ namespace sqlite_orm {
                             using field_type = typename std::decay<decltype(v)>::type;
                             statement_binder<field_type>().bind(stmt, index++, v);
                         });
+                        measurement.phase(instrumentation_phase::step);
                         auto stepRes = sqlite3_step(stmt);
                         switch(stepRes){
                             case SQLITE_ROW:{
+                                measurement.phase(instrumentation_phase::hydrate);
                                 O res;
                                 index = 0;
                                 impl.table.for_each_column([&index, &res, stmt] (auto c) {
@@ -7373,6 +10318,7 @@ namespace sqlite_orm {
             template<class O, class ...Ids>
             std::shared_ptr<O> get_no_throw(Ids ...ids) {
                 this->assert_mapped_type<O>();
+                internal::operation_scope operationScope("get_no_throw", &this->get_impl<O>().table.name);
                 
                 auto connection = this->get_or_create_connection();
                 auto &impl = this->get_impl<O>();
@@ -7432,14 +10378,246 @@ namespace sqlite_orm {
                                 throw std::system_error(std::error_code(sqlite3_errcode(connection->get_db()), get_sqlite_error_category()));
                             }
                         }
-                    }else{
-                        throw std::system_error(std::error_code(sqlite3_errcode(connection->get_db()), get_sqlite_error_category()));
+                    }else{
+                        throw std::system_error(std::error_code(sqlite3_errcode(connection->get_db()), get_sqlite_error_category()));
+                    }
+                }else{
+                    throw std::system_error(std::make_error_code(orm_error_code::table_has_no_primary_key_column));
+                }
+            }
+            
+            /**
+             *  Fetches many objects by primary key in a few statements instead of calling `get` per id.
+             *  Ids are deduplicated and bound in `WHERE pk IN (?, ?, ...)` chunks so every statement has no more
+             *  variables than `SQLITE_LIMIT_VARIABLE_NUMBER`. Composite primary key ids are `std::tuple` with values
+             *  in `primary_key()` columns order. It must be a forward iterator cause ids are read twice.
+             *  O is an object type to be extracted. Must be specified explicitly.
+             *  throws std::system_error(orm_error_code::table_has_no_primary_key_column) if table has no primary key.
+             *  @return objects in ids order. Ids which are not found are skipped, repeated ids give repeated objects.
+             */
+            template<class O, class It>
+            std::vector<O> get_all_by_ids(It from, It to) {
+                auto objects = this->get_map_internal<O>(from, to, "get_all_by_ids");
+                std::vector<O> res;
+                res.reserve(objects.size());
+                for(auto it = from; it != to; ++it) {
+                    auto objectIt = objects.find(*it);
+                    if(objectIt != objects.end()) {
+                        res.push_back(objectIt->second);
+                    }
+                }
+                return res;
+            }
+            
+            /**
+             *  The same as `get_all_by_ids` but returns objects mapped by their ids. Ids which are not found
+             *  are absent in result.
+             */
+            template<class O, class C>
+            std::map<typename C::value_type, O> get_map(const C &ids) {
+                return this->get_map_internal<O>(ids.begin(), ids.end(), "get_map");
+            }
+            
+            /**
+             *  Keyset (seek) pagination. Returns up to `pageSize` objects ordered by `orderBy` which can be
+             *  `order_by(...)` or `multi_order_by(...)` and the token of the next page. Pages after the first one
+             *  are fetched with bound `WHERE (a, b) > (?, ?)` predicates built from the token instead of
+             *  `OFFSET` so deep pages cost as much as the first one if there is an index on sort keys.
+             *  Sort keys must identify a row uniquely (add a primary key as the last key) and must not be NULL.
+             *  @param token empty string for the first page or `next_token` of the previous page.
+             *  throws std::system_error with orm_error_code::incorrect_page_token if token is corrupted or was
+             *  made for a different keys count.
+             */
+            template<class O, class Ord>
+            page<O> paginate(const Ord &orderBy, int pageSize, const std::string &token = {}) {
+                return this->paginate_internal<O>(orderBy, pageSize, token, [](internal::query_context &){
+                    return std::string();
+                });
+            }
+            
+            /**
+             *  The same as `paginate` but with objects filtered by `w` condition.
+             */
+            template<class O, class Ord, class C>
+            page<O> paginate(const Ord &orderBy, int pageSize, const std::string &token, const conditions::where_t<C> &w) {
+                return this->paginate_internal<O>(orderBy, pageSize, token, [this, &w](internal::query_context &context){
+                    return this->process_where(context, w.c);
+                });
+            }
+            
+        protected:
+            
+            template<class T>
+            void paginate_keys(internal::query_context &context, const conditions::order_by_t<T> &orderBy, std::vector<std::string> &keyExpressions, std::vector<std::string> &orderExpressions, std::vector<bool> &descending) {
+                auto keyExpression = this->string_from_expression(context, orderBy.o);
+                if(orderBy._collate_argument.length()){
+                    keyExpression += " COLLATE " + orderBy._collate_argument;
+                }
+                keyExpressions.push_back(std::move(keyExpression));
+                orderExpressions.push_back(this->process_order_by(context, orderBy));
+                descending.push_back(orderBy.asc_desc == -1);
+            }
+            
+            template<class ...Args>
+            void paginate_keys(internal::query_context &context, const conditions::multi_order_by_t<Args...> &orderBy, std::vector<std::string> &keyExpressions, std::vector<std::string> &orderExpressions, std::vector<bool> &descending) {
+                tuple_helper::tuple_for_each(orderBy.args, [&context, &keyExpressions, &orderExpressions, &descending, this](auto &v){
+                    this->paginate_keys(context, v, keyExpressions, orderExpressions, descending);
+                });
+            }
+            
+            /**
+             *  Seek predicate selecting rows after the last row of the previous page: `(a, b) > (?, ?)` if all keys
+             *  have the same direction and `a > ? OR (a = ? AND b < ?)` otherwise.
+             *  @param boundKeys indexes of keys in order their values must be bound.
+             */
+            std::string paginate_seek_predicate(const std::vector<std::string> &keyExpressions, const std::vector<bool> &descending, std::vector<size_t> &boundKeys) {
+                std::stringstream ss;
+                auto keysCount = keyExpressions.size();
+                auto sameDirection = std::find(descending.begin(), descending.end(), !descending.front()) == descending.end();
+#if SQLITE_VERSION_NUMBER < 3015000
+                
+                //  row values are not supported
+                sameDirection = sameDirection && keysCount == 1;
+#endif
+                if(sameDirection) {
+                    auto op = descending.front() ? " < " : " > ";
+                    if(keysCount == 1) {
+                        ss << keyExpressions.front() << op << "?";
+                    }else{
+                        ss << "(";
+                        for(size_t i = 0; i < keysCount; ++i) {
+                            ss << keyExpressions[i] << (i < keysCount - 1 ? ", " : ")");
+                        }
+                        ss << op << "(";
+                        for(size_t i = 0; i < keysCount; ++i) {
+                            ss << (i < keysCount - 1 ? "?, " : "?)");
+                        }
+                    }
+                    for(size_t i = 0; i < keysCount; ++i) {
+                        boundKeys.push_back(i);
+                    }
+                }else{
+                    for(size_t i = 0; i < keysCount; ++i) {
+                        ss << (i ? " OR (" : "(");
+                        for(size_t j = 0; j < i; ++j) {
+                            ss << keyExpressions[j] << " = ? AND ";
+                            boundKeys.push_back(j);
+                        }
+                        ss << keyExpressions[i] << (descending[i] ? " < ?)" : " > ?)");
+                        boundKeys.push_back(i);
+                    }
+                }
+                return ss.str();
+            }
+            
+            template<class O, class Ord, class W>
+            page<O> paginate_internal(const Ord &orderBy, int pageSize, const std::string &token, const W &whereString) {
+                this->assert_mapped_type<O>();
+                auto &impl = this->get_impl<O>();
+                internal::operation_scope operationScope("paginate", &impl.table.name);
+                measurement_type measurement(this->instrumentationPolicy, "paginate");
+                page<O> res;
+                if(pageSize <= 0) {
+                    return res;
+                }
+                
+                measurement.phase(instrumentation_phase::connect);
+                auto connection = this->get_or_create_connection();
+                auto db = connection->get_db();
+                measurement.phase(instrumentation_phase::build);
+                internal::query_context context{connection};
+                std::vector<std::string> keyExpressions;
+                std::vector<std::string> orderExpressions;
+                std::vector<bool> descending;
+                this->paginate_keys(context, orderBy, keyExpressions, orderExpressions, descending);
+                auto keysCount = keyExpressions.size();
+                std::vector<internal::page_token::value> lastKeys;
+                if(token.length()) {
+                    lastKeys = internal::page_token::decode(token, keysCount);
+                }
+                std::stringstream ss;
+                ss << "SELECT ";
+                auto columnNames = impl.table.column_names();
+                for(auto &columnName : columnNames) {
+                    ss << "'" << impl.table.name << "'.\"" << columnName << "\", ";
+                }
+                for(size_t i = 0; i < keysCount; ++i) {
+                    ss << keyExpressions[i] << (i < keysCount - 1 ? ", " : " ");
+                }
+                ss << "FROM '" << impl.table.name << "' ";
+                auto condition = whereString(context);
+                std::vector<size_t> boundKeys;
+                if(condition.length() || lastKeys.size()) {
+                    ss << "WHERE ";
+                    if(condition.length()) {
+                        ss << "( " << condition << ") ";
+                        if(lastKeys.size()) {
+                            ss << "AND ";
+                        }
                     }
-                }else{
-                    throw std::system_error(std::make_error_code(orm_error_code::table_has_no_primary_key_column));
+                    if(lastKeys.size()) {
+                        ss << "(" << this->paginate_seek_predicate(keyExpressions, descending, boundKeys) << ") ";
+                    }
+                }
+                ss << "ORDER BY ";
+                for(size_t i = 0; i < keysCount; ++i) {
+                    ss << orderExpressions[i] << (i < keysCount - 1 ? ", " : "");
+                }
+                ss << "LIMIT ?";
+                auto query = ss.str();
+                sqlite3_stmt *stmt;
+                measurement.phase(instrumentation_phase::prepare);
+                if (sqlite3_prepare_v2(db, query.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+                    throw std::system_error(std::error_code(sqlite3_errcode(db), get_sqlite_error_category()));
+                }
+                statement_finalizer finalizer{stmt};
+                measurement.phase(instrumentation_phase::bind);
+                auto index = 1;
+                for(auto key : boundKeys) {
+                    internal::page_token::bind(stmt, index++, lastKeys[key]);
                 }
+                
+                //  one more row tells whether there is a next page
+                sqlite3_bind_int(stmt, index++, pageSize + 1);
+                res.objects.reserve(static_cast<size_t>(pageSize));
+                std::string lastToken;
+                int stepRes;
+                for(;;) {
+                    measurement.phase(instrumentation_phase::step);
+                    stepRes = sqlite3_step(stmt);
+                    if(stepRes != SQLITE_ROW) {
+                        break;
+                    }
+                    if(res.objects.size() == static_cast<size_t>(pageSize)) {
+                        res.next_token = std::move(lastToken);
+                        stepRes = SQLITE_DONE;
+                        break;
+                    }
+                    measurement.phase(instrumentation_phase::hydrate);
+                    O object;
+                    index = 0;
+                    impl.table.for_each_column([&index, &object, stmt] (auto c) {
+                        using field_type = typename decltype(c)::field_type;
+                        auto value = row_extractor<field_type>().extract(stmt, index++);
+                        if(c.member_pointer){
+                            object.*c.member_pointer = value;
+                        }else{
+                            ((object).*(c.setter))(std::move(value));
+                        }
+                    });
+                    res.objects.push_back(std::move(object));
+                    if(res.objects.size() == static_cast<size_t>(pageSize)) {
+                        lastToken = internal::page_token::encode(stmt, static_cast<int>(columnNames.size()), static_cast<int>(keysCount));
+                    }
+                }
+                if(stepRes != SQLITE_DONE) {
+                    throw std::system_error(std::error_code(sqlite3_errcode(db), get_sqlite_error_category()));
+                }
+                return res;
             }
             
+        public:
+            
             /**
              *  SELECT COUNT(*) with no conditions routine. https://www.sqlite.org/lang_aggfunc.html#count
              *  @return Number of O object in table.
@@ -7447,9 +10625,11 @@ namespace sqlite_orm {
             template<class O, class ...Args, class R = typename mapped_type_proxy<O>::type>
             int count(Args&& ...args) {
                 this->assert_mapped_type<R>();
+                internal::operation_scope operationScope("count", &this->get_impl<R>().table.name);
                 auto tableAliasString = alias_exractor<O>::get();
                 
                 auto connection = this->get_or_create_connection();
+                internal::query_context context{connection};
                 auto &impl = this->get_impl<R>();
                 int res = 0;
                 std::stringstream ss;
@@ -7457,8 +10637,9 @@ namespace sqlite_orm {
                 if(tableAliasString.length()) {
                     ss << "'" << tableAliasString << "' ";
                 }
-                this->process_conditions(ss, args...);
+                this->process_conditions(context, ss, args...);
                 auto query = ss.str();
+                this->assert_no_large_table_scan(connection->get_db(), query);
                 auto rc = sqlite3_exec(connection->get_db(),
                                        query.c_str(),
                                        [](void *data, int argc, char **argv, char **) -> int {
@@ -7481,16 +10662,18 @@ namespace sqlite_orm {
             template<class F, class O, class ...Args>
             int count(F O::*m, Args&& ...args) {
                 this->assert_mapped_type<O>();
+                internal::operation_scope operationScope("count", &this->get_impl<O>().table.name);
                 
                 auto connection = this->get_or_create_connection();
+                internal::query_context context{connection};
                 auto &impl = this->get_impl<O>();
                 int res = 0;
                 std::stringstream ss;
                 ss << "SELECT " << static_cast<std::string>(sqlite_orm::count(0)) << "(";
-                auto columnName = this->string_from_expression(m);
+                auto columnName = this->string_from_expression(context, m);
                 if(columnName.length()){
                     ss << columnName << ") FROM '"<< impl.table.name << "' ";
-                    this->process_conditions(ss, std::forward<Args>(args)...);
+                    this->process_conditions(context, ss, std::forward<Args>(args)...);
                     auto query = ss.str();
                     auto rc = sqlite3_exec(connection->get_db(),
                                            query.c_str(),
@@ -7518,16 +10701,18 @@ namespace sqlite_orm {
             template<class F, class O, class ...Args>
             double avg(F O::*m, Args&& ...args) {
                 this->assert_mapped_type<O>();
+                internal::operation_scope operationScope("avg", &this->get_impl<O>().table.name);
                 
                 auto connection = this->get_or_create_connection();
+                internal::query_context context{connection};
                 auto &impl = this->get_impl<O>();
                 double res = 0;
                 std::stringstream ss;
                 ss << "SELECT " << static_cast<std::string>(sqlite_orm::avg(0)) << "(";
-                auto columnName = this->string_from_expression(m);
+                auto columnName = this->string_from_expression(context, m);
                 if(columnName.length()){
                     ss << columnName << ") FROM '"<< impl.table.name << "' ";
-                    this->process_conditions(ss, std::forward<Args>(args)...);
+                    this->process_conditions(context, ss, std::forward<Args>(args)...);
                     auto query = ss.str();
                     auto rc = sqlite3_exec(connection->get_db(),
                                            query.c_str(),
@@ -7588,16 +10773,18 @@ namespace sqlite_orm {
             template<class F, class O, class ...Args, class Ret = typename column_result_t<F O::*>::type>
             std::shared_ptr<Ret> max(F O::*m, Args&& ...args) {
                 this->assert_mapped_type<O>();
+                internal::operation_scope operationScope("max", &this->get_impl<O>().table.name);
                 
                 auto connection = this->get_or_create_connection();
+                internal::query_context context{connection};
                 auto &impl = this->get_impl<O>();
                 std::shared_ptr<Ret> res;
                 std::stringstream ss;
                 ss << "SELECT " << static_cast<std::string>(sqlite_orm::max(0)) << "(";
-                auto columnName = this->string_from_expression(m);
+                auto columnName = this->string_from_expression(context, m);
                 if(columnName.length()){
                     ss << columnName << ") FROM '" << impl.table.name << "' ";
-                    this->process_conditions(ss, std::forward<Args>(args)...);
+                    this->process_conditions(context, ss, std::forward<Args>(args)...);
                     auto query = ss.str();
                     auto rc = sqlite3_exec(connection->get_db(),
                                            query.c_str(),
@@ -7627,16 +10814,18 @@ namespace sqlite_orm {
             template<class F, class O, class ...Args, class Ret = typename column_result_t<F O::*>::type>
             std::shared_ptr<Ret> min(F O::*m, Args&& ...args) {
                 this->assert_mapped_type<O>();
+                internal::operation_scope operationScope("min", &this->get_impl<O>().table.name);
                 
                 auto connection = this->get_or_create_connection();
+                internal::query_context context{connection};
                 auto &impl = this->get_impl<O>();
                 std::shared_ptr<Ret> res;
                 std::stringstream ss;
                 ss << "SELECT " << static_cast<std::string>(sqlite_orm::min(0)) << "(";
-                auto columnName = this->string_from_expression(m);
+                auto columnName = this->string_from_expression(context, m);
                 if(columnName.length()){
                     ss << columnName << ") FROM '" << impl.table.name << "' ";
-                    this->process_conditions(ss, std::forward<Args>(args)...);
+                    this->process_conditions(context, ss, std::forward<Args>(args)...);
                     auto query = ss.str();
                     auto rc = sqlite3_exec(connection->get_db(),
                                            query.c_str(),
@@ -7666,16 +10855,18 @@ namespace sqlite_orm {
             template<class F, class O, class ...Args, class Ret = typename column_result_t<F O::*>::type>
             std::shared_ptr<Ret> sum(F O::*m, Args&& ...args) {
                 this->assert_mapped_type<O>();
+                internal::operation_scope operationScope("sum", &this->get_impl<O>().table.name);
                 
                 auto connection = this->get_or_create_connection();
+                internal::query_context context{connection};
                 auto &impl = this->get_impl<O>();
                 std::shared_ptr<Ret> res;
                 std::stringstream ss;
                 ss << "SELECT " << static_cast<std::string>(sqlite_orm::sum(0)) << "(";
-                auto columnName = this->string_from_expression(m);
+                auto columnName = this->string_from_expression(context, m);
                 if(columnName.length()){
                     ss << columnName << ") FROM '"<< impl.table.name << "' ";
-                    this->process_conditions(ss, std::forward<Args>(args)...);
+                    this->process_conditions(context, ss, std::forward<Args>(args)...);
                     auto query = ss.str();
                     auto rc = sqlite3_exec(connection->get_db(),
                                            query.c_str(),
@@ -7703,12 +10894,14 @@ namespace sqlite_orm {
             template<class F, class O, class ...Args>
             double total(F O::*m, Args&& ...args) {
                 this->assert_mapped_type<O>();
+                internal::operation_scope operationScope("total", &this->get_impl<O>().table.name);
                 
                 auto connection = this->get_or_create_connection();
+                internal::query_context context{connection};
                 double res;
                 std::stringstream ss;
                 ss << "SELECT " << static_cast<std::string>(sqlite_orm::total(0)) << "(";
-                auto columnName = this->string_from_expression(m);
+                auto columnName = this->string_from_expression(context, m);
                 if(columnName.length()){
                     ss << columnName << ") ";
                     auto tableNamesSet = this->parse_table_names(m);
@@ -7723,7 +10916,7 @@ namespace sqlite_orm {
                             ss << " ";
                         }
                     }
-                    this->process_conditions(ss, std::forward<Args>(args)...);
+                    this->process_conditions(context, ss, std::forward<Args>(args)...);
                     auto query = ss.str();
                     auto rc = sqlite3_exec(connection->get_db(),
                                            query.c_str(),
@@ -7753,18 +10946,27 @@ namespace sqlite_orm {
             class ...Args,
             class R = typename internal::column_result_t<T>::type>
             std::vector<R> select(T m, Args ...args) {
+                internal::operation_scope operationScope("select");
+                measurement_type measurement(this->instrumentationPolicy, "select");
                 using select_type = select_t<T, Args...>;
-                auto query = this->string_from_expression(select_type{std::move(m), std::make_tuple<Args...>(std::forward<Args>(args)...)});
+                measurement.phase(instrumentation_phase::connect);
                 auto connection = this->get_or_create_connection();
+                internal::query_context context{connection};
+                measurement.phase(instrumentation_phase::build);
+                auto query = this->string_from_expression(context, select_type{std::move(m), std::make_tuple<Args...>(std::forward<Args>(args)...)});
+                this->assert_no_large_table_scan(connection->get_db(), query);
                 sqlite3_stmt *stmt;
+                measurement.phase(instrumentation_phase::prepare);
                 if (sqlite3_prepare_v2(connection->get_db(), query.c_str(), -1, &stmt, nullptr) == SQLITE_OK) {
                     statement_finalizer finalizer{stmt};
                     std::vector<R> res;
                     int stepRes;
                     do{
+                        measurement.phase(instrumentation_phase::step);
                         stepRes = sqlite3_step(stmt);
                         switch(stepRes){
                             case SQLITE_ROW:{
+                                measurement.phase(instrumentation_phase::hydrate);
                                 res.push_back(row_extractor<R>().extract(stmt, 0));
                             }break;
                             case SQLITE_DONE: break;
@@ -7785,12 +10987,14 @@ namespace sqlite_orm {
             class ...Args,
             class Ret = typename internal::column_result_t<union_t<L, R>>::type>
             std::vector<Ret> select(union_t<L, R> op, Args ...args) {
+                internal::operation_scope operationScope("select");
+                auto connection = this->get_or_create_connection();
+                internal::query_context context{connection};
                 std::stringstream ss;
-                ss << this->string_from_expression(op.left) << " ";
+                ss << this->string_from_expression(context, op.left) << " ";
                 ss << static_cast<std::string>(op) << " ";
-                ss << this->string_from_expression(op.right) << " ";
+                ss << this->string_from_expression(context, op.right) << " ";
                 auto query = ss.str();
-                auto connection = this->get_or_create_connection();
                 sqlite3_stmt *stmt;
                 if (sqlite3_prepare_v2(connection->get_db(), query.c_str(), -1, &stmt, nullptr) == SQLITE_OK) {
                     statement_finalizer finalizer{stmt};
@@ -7833,6 +11037,7 @@ namespace sqlite_orm {
             template<class O>
             void replace(const O &o) {
                 this->assert_mapped_type<O>();
+                internal::operation_scope operationScope("replace", &this->get_impl<O>().table.name);
                 
                 auto connection = this->get_or_create_connection();
                 auto &impl = get_impl<O>();
@@ -7886,6 +11091,7 @@ namespace sqlite_orm {
             void replace_range(It from, It to) {
                 using O = typename std::iterator_traits<It>::value_type;
                 this->assert_mapped_type<O>();
+                internal::operation_scope operationScope("replace_range", &this->get_impl<O>().table.name);
                 if(from == to) {
                     return;
                 }
@@ -7954,19 +11160,258 @@ namespace sqlite_orm {
                 }
             }
             
+#if SQLITE_VERSION_NUMBER >= 3024000
+            
+            /**
+             *  UPSERT routine. Inserts object with all fields like `replace` does but if a row with the same
+             *  primary key exists it is updated in place: `INSERT ... ON CONFLICT("pk") DO UPDATE SET ...`.
+             *  Unlike `REPLACE` the row is not deleted and reinserted so delete triggers are not fired, rowid is
+             *  kept and only changed index entries are rewritten. Rows which all fields are equal to the object
+             *  are not written at all.
+             */
+            template<class O>
+            void upsert(const O &o) {
+                this->assert_mapped_type<O>();
+                auto &impl = this->get_impl<O>();
+                this->upsert_internal("upsert", &o, &o + 1, this->upsert_conflict_column_names(impl), this->upsert_update_column_names(impl));
+            }
+            
+            /**
+             *  UPSERT routine with explicit conflict target and updated columns e.g.
+             *  `storage.upsert(user, columns(&User::email), columns(&User::name, &User::visits))`.
+             *  Conflict columns must have a unique index or constraint. Columns not listed in `updateColumns`
+             *  keep their values if the row exists.
+             */
+            template<class O, class ...Cs, class ...Us>
+            void upsert(const O &o, const columns_t<Cs...> &conflictColumns, const columns_t<Us...> &updateColumns) {
+                this->assert_mapped_type<O>();
+                this->upsert_internal("upsert", &o, &o + 1, this->upsert_column_names(conflictColumns), this->upsert_column_names(updateColumns));
+            }
+            
+            /**
+             *  Performs `upsert` for every object of [from, to). Objects are written with multi row
+             *  `INSERT ... VALUES (...), (...) ON CONFLICT ...` statements split by
+             *  `SQLITE_LIMIT_VARIABLE_NUMBER` in one transaction: the current one if it is active or a new one
+             *  otherwise. Statements are cached by connection.
+             */
+            template<class It>
+            void upsert_range(It from, It to) {
+                using O = typename std::iterator_traits<It>::value_type;
+                this->assert_mapped_type<O>();
+                auto &impl = this->get_impl<O>();
+                this->upsert_internal("upsert_range", from, to, this->upsert_conflict_column_names(impl), this->upsert_update_column_names(impl));
+            }
+            
+            template<class It, class ...Cs, class ...Us>
+            void upsert_range(It from, It to, const columns_t<Cs...> &conflictColumns, const columns_t<Us...> &updateColumns) {
+                using O = typename std::iterator_traits<It>::value_type;
+                this->assert_mapped_type<O>();
+                this->upsert_internal("upsert_range", from, to, this->upsert_column_names(conflictColumns), this->upsert_column_names(updateColumns));
+            }
+            
+        protected:
+            
+            template<class I>
+            std::vector<std::string> upsert_conflict_column_names(I &impl) {
+                auto res = impl.table.primary_key_column_names();
+                if(res.empty()) {
+                    throw std::system_error(std::make_error_code(orm_error_code::table_has_no_primary_key_column));
+                }
+                for(auto &columnName : res) {
+                    columnName = "\"" + columnName + "\"";
+                }
+                return res;
+            }
+            
+            template<class I>
+            std::vector<std::string> upsert_update_column_names(I &impl) {
+                auto primaryKeyColumnNames = impl.table.primary_key_column_names();
+                std::vector<std::string> res;
+                for(auto &columnName : impl.table.column_names()) {
+                    if(std::find(primaryKeyColumnNames.begin(), primaryKeyColumnNames.end(), columnName) == primaryKeyColumnNames.end()) {
+                        res.push_back("\"" + columnName + "\"");
+                    }
+                }
+                return res;
+            }
+            
+            template<class ...Cs>
+            std::vector<std::string> upsert_column_names(const columns_t<Cs...> &cols) {
+                std::vector<std::string> res;
+                internal::query_context context{nullptr};
+                cols.for_each([&context, &res, this](auto &m) {
+                    auto columnName = this->string_from_expression(context, m, true);
+                    if(columnName.length()){
+                        res.push_back(columnName);
+                    }else{
+                        throw std::system_error(std::make_error_code(orm_error_code::column_not_found));
+                    }
+                });
+                return res;
+            }
+            
+            /**
+             *  `INSERT INTO 'table' (...) VALUES (...), ... ON CONFLICT (...) DO UPDATE SET "c" = excluded."c", ...
+             *  WHERE "c" IS NOT excluded."c" OR ...` with `rowsCount` rows. `WHERE` skips rows which are not
+             *  changed. Column names must be quoted already.
+             */
+            template<class I>
+            std::string upsert_query(I &impl, size_t rowsCount, const std::vector<std::string> &conflictColumnNames, const std::vector<std::string> &updateColumnNames) {
+                std::stringstream ss;
+                ss << "INSERT INTO '" << impl.table.name << "' (";
+                auto columnNames = impl.table.column_names();
+                auto columnNamesCount = columnNames.size();
+                for(size_t i = 0; i < columnNamesCount; ++i) {
+                    ss << "\"" << columnNames[i] << "\"";
+                    if(i < columnNamesCount - 1) {
+                        ss << ", ";
+                    }else{
+                        ss << ") ";
+                    }
+                }
+                ss << "VALUES ";
+                for(size_t row = 0; row < rowsCount; ++row) {
+                    ss << "(";
+                    for(size_t i = 0; i < columnNamesCount; ++i) {
+                        ss << "?";
+                        if(i < columnNamesCount - 1) {
+                            ss << ", ";
+                        }
+                    }
+                    ss << ")";
+                    if(row < rowsCount - 1) {
+                        ss << ", ";
+                    }
+                }
+                ss << " ON CONFLICT (";
+                for(size_t i = 0; i < conflictColumnNames.size(); ++i) {
+                    ss << conflictColumnNames[i];
+                    if(i < conflictColumnNames.size() - 1) {
+                        ss << ", ";
+                    }
+                }
+                ss << ") DO ";
+                if(updateColumnNames.empty()) {
+                    ss << "NOTHING";
+                }else{
+                    ss << "UPDATE SET ";
+                    for(size_t i = 0; i < updateColumnNames.size(); ++i) {
+                        ss << updateColumnNames[i] << " = excluded." << updateColumnNames[i];
+                        if(i < updateColumnNames.size() - 1) {
+                            ss << ", ";
+                        }
+                    }
+                    ss << " WHERE ";
+                    for(size_t i = 0; i < updateColumnNames.size(); ++i) {
+                        ss << updateColumnNames[i] << " IS NOT excluded." << updateColumnNames[i];
+                        if(i < updateColumnNames.size() - 1) {
+                            ss << " OR ";
+                        }
+                    }
+                }
+                return ss.str();
+            }
+            
+            template<class It>
+            void upsert_internal(const char *operation, It from, It to, const std::vector<std::string> &conflictColumnNames, const std::vector<std::string> &updateColumnNames) {
+                using O = typename std::iterator_traits<It>::value_type;
+                auto &impl = this->get_impl<O>();
+                internal::operation_scope operationScope(operation, &impl.table.name);
+                measurement_type measurement(this->instrumentationPolicy, operation);
+                if(from == to) {
+                    return;
+                }
+                
+                measurement.phase(instrumentation_phase::connect);
+                auto connection = this->get_or_create_connection();
+                auto db = connection->get_db();
+                measurement.phase(instrumentation_phase::build);
+                auto columnsCount = impl.table.column_names().size();
+                auto rowsPerStatement = std::max(size_t(1), size_t(sqlite3_limit(db, SQLITE_LIMIT_VARIABLE_NUMBER, -1)) / columnsCount);
+                std::string fullQuery;
+                measurement.phase(instrumentation_phase::step);
+                auto ownTransaction = sqlite3_get_autocommit(db) != 0;
+                if(ownTransaction) {
+                    this->impl.begin_transaction(db);
+                }
+                try{
+                    while(from != to) {
+                        auto chunkEnd = from;
+                        size_t rowsCount = 0;
+                        while(chunkEnd != to && rowsCount < rowsPerStatement) {
+                            ++chunkEnd;
+                            ++rowsCount;
+                        }
+                        sqlite3_stmt *stmt;
+                        sqlite3_stmt *tailStmt = nullptr;
+                        if(rowsCount == rowsPerStatement) {
+                            if(fullQuery.empty()) {
+                                fullQuery = this->upsert_query(impl, rowsCount, conflictColumnNames, updateColumnNames);
+                            }
+                            stmt = connection->get_statement(fullQuery);
+                        }else if(rowsCount == 1) {
+                            
+                            //  single object upserts are frequent so their statement is cached too
+                            stmt = connection->get_statement(this->upsert_query(impl, rowsCount, conflictColumnNames, updateColumnNames));
+                        }else{
+                            
+                            //  tail length differs from call to call so the statement is not cached
+                            auto query = this->upsert_query(impl, rowsCount, conflictColumnNames, updateColumnNames);
+                            if(sqlite3_prepare_v2(db, query.c_str(), -1, &tailStmt, nullptr) != SQLITE_OK) {
+                                throw std::system_error(std::error_code(sqlite3_errcode(db), get_sqlite_error_category()));
+                            }
+                            stmt = tailStmt;
+                        }
+                        statement_finalizer finalizer{tailStmt};
+                        statement_resetter resetter{stmt};
+                        auto index = 1;
+                        for(; from != chunkEnd; ++from) {
+                            auto &o = *from;
+                            impl.table.for_each_column([&o, &index, stmt] (auto c) {
+                                using field_type = typename decltype(c)::field_type;
+                                const field_type *value = nullptr;
+                                if(c.member_pointer){
+                                    value = &(o.*c.member_pointer);
+                                }else{
+                                    value = &((o).*(c.getter))();
+                                }
+                                statement_binder<field_type>().bind(stmt, index++, *value);
+                            });
+                        }
+                        if (sqlite3_step(stmt) != SQLITE_DONE) {
+                            throw std::system_error(std::error_code(sqlite3_errcode(db), get_sqlite_error_category()));
+                        }
+                    }
+                }catch(...){
+                    if(ownTransaction) {
+                        this->impl.rollback(db);
+                    }
+                    throw;
+                }
+                if(ownTransaction) {
+                    this->impl.commit(db);
+                }
+            }
+            
+        public:
+            
+#endif
+            
             template<class O, class ...Cols>
             int insert(const O &o, columns_t<Cols...> cols) {
                 constexpr const size_t colsCount = std::tuple_size<std::tuple<Cols...>>::value;
                 static_assert(colsCount > 0, "Use insert or replace with 1 argument instead");
                 this->assert_mapped_type<O>();
+                internal::operation_scope operationScope("insert", &this->get_impl<O>().table.name);
                 auto connection = this->get_or_create_connection();
+                internal::query_context context{connection};
                 auto &impl = get_impl<O>();
                 std::stringstream ss;
                 ss << "INSERT INTO '" << impl.table.name << "' ";
                 std::vector<std::string> columnNames;
                 columnNames.reserve(colsCount);
-                cols.for_each([&columnNames, this](auto &m) {
-                    auto columnName = this->string_from_expression(m, true);
+                cols.for_each([&context, &columnNames, this](auto &m) {
+                    auto columnName = this->string_from_expression(context, m, true);
                     if(columnName.length()){
                         columnNames.push_back(columnName);
                     }else{
@@ -8022,8 +11467,12 @@ namespace sqlite_orm {
             template<class O>
             int insert(const O &o) {
                 this->assert_mapped_type<O>();
+                internal::operation_scope operationScope("insert", &this->get_impl<O>().table.name);
+                measurement_type measurement(this->instrumentationPolicy, "insert");
                 
+                measurement.phase(instrumentation_phase::connect);
                 auto connection = this->get_or_create_connection();
+                measurement.phase(instrumentation_phase::build);
                 auto &impl = get_impl<O>();
                 int res = 0;
                 std::stringstream ss;
@@ -8070,8 +11519,10 @@ namespace sqlite_orm {
                 }
                 auto query = ss.str();
                 sqlite3_stmt *stmt;
+                measurement.phase(instrumentation_phase::prepare);
                 if (sqlite3_prepare_v2(connection->get_db(), query.c_str(), -1, &stmt, nullptr) == SQLITE_OK) {
                     statement_finalizer finalizer{stmt};
+                    measurement.phase(instrumentation_phase::bind);
                     auto index = 1;
                     impl.table.for_each_column([&o, &index, &stmt, &impl, &compositeKeyColumnNames] (auto c) {
                         if(impl.table._without_rowid || !c.template has<constraints::primary_key_t<>>()){
@@ -8090,6 +11541,7 @@ namespace sqlite_orm {
                             }
                         }
                     });
+                    measurement.phase(instrumentation_phase::step);
                     if (sqlite3_step(stmt) == SQLITE_DONE) {
                         res = int(sqlite3_last_insert_rowid(connection->get_db()));
                     }else{
@@ -8105,11 +11557,15 @@ namespace sqlite_orm {
             void insert_range(It from, It to) {
                 using O = typename std::iterator_traits<It>::value_type;
                 this->assert_mapped_type<O>();
+                internal::operation_scope operationScope("insert_range", &this->get_impl<O>().table.name);
+                measurement_type measurement(this->instrumentationPolicy, "insert_range");
                 if(from == to) {
                     return;
                 }
                 
+                measurement.phase(instrumentation_phase::connect);
                 auto connection = this->get_or_create_connection();
+                measurement.phase(instrumentation_phase::build);
                 auto &impl = get_impl<O>();
                 
                 std::stringstream ss;
@@ -8154,8 +11610,10 @@ namespace sqlite_orm {
                 }
                 auto query = ss.str();
                 sqlite3_stmt *stmt;
+                measurement.phase(instrumentation_phase::prepare);
                 if (sqlite3_prepare_v2(connection->get_db(), query.c_str(), -1, &stmt, nullptr) == SQLITE_OK) {
                     statement_finalizer finalizer{stmt};
+                    measurement.phase(instrumentation_phase::bind);
                     auto index = 1;
                     for(auto it = from; it != to; ++it) {
                         auto &o = *it;
@@ -8172,6 +11630,7 @@ namespace sqlite_orm {
                             }
                         });
                     }
+                    measurement.phase(instrumentation_phase::step);
                     if (sqlite3_step(stmt) == SQLITE_DONE) {
                         //..
                     }else{
@@ -8200,6 +11659,25 @@ namespace sqlite_orm {
                 }
             }
             
+            /**
+             *  Rebuilds index with a given name or all indexes of a table with a given name using `REINDEX`.
+             *  Rebuilds all indexes in db if name is empty.
+             */
+            void reindex(const std::string &name = {}) {
+                auto connection = this->get_or_create_connection();
+                auto db = connection->get_db();
+                std::stringstream ss;
+                ss << "REINDEX";
+                if(name.length()){
+                    ss << " '" << name << "'";
+                }
+                auto query = ss.str();
+                auto rc = sqlite3_exec(db, query.c_str(), nullptr, nullptr, nullptr);
+                if(rc != SQLITE_OK) {
+                    throw std::system_error(std::error_code(sqlite3_errcode(db), get_sqlite_error_category()));
+                }
+            }
+            
             void vacuum() {
                 auto connection = this->get_or_create_connection();
                 std::string query = "VACUUM";
@@ -8261,62 +11739,199 @@ namespace sqlite_orm {
                 return sqlite3_total_changes(connection->get_db());
             }
             
-            int64 last_insert_rowid() {
-                auto connection = this->get_or_create_connection();
-                return sqlite3_last_insert_rowid(connection->get_db());
+            int64 last_insert_rowid() {
+                auto connection = this->get_or_create_connection();
+                return sqlite3_last_insert_rowid(connection->get_db());
+            }
+            
+            int busy_timeout(int ms) {
+                auto connection = this->get_or_create_connection();
+                return sqlite3_busy_timeout(connection->get_db(), ms);
+            }
+            
+            /**
+             *  Returns libsqltie3 lib version, not sqlite_orm
+             */
+            std::string libversion() {
+                return sqlite3_libversion();
+            }
+            
+        protected:
+            
+            /**
+             *  Adds an element of `make_index` call to index query parts. Columns and expressions are indexed
+             *  as is, `order_by(...)` specifies COLLATE and ASC/DESC for column and `where(...)` makes index partial.
+             *  Column names are not prefixed with table name cause SQLite prohibits it in index expressions.
+             */
+            template<class T>
+            void process_index_element(internal::query_context &context, const T &t, std::vector<std::string> &columns, std::string &) {
+                columns.push_back(this->string_from_expression(context, t, true));
+            }
+            
+            template<class O>
+            void process_index_element(internal::query_context &context, const conditions::order_by_t<O> &orderBy, std::vector<std::string> &columns, std::string &) {
+                columns.push_back(this->process_order_by(context, orderBy, true));
+            }
+            
+            template<class C>
+            void process_index_element(internal::query_context &context, const conditions::where_t<C> &w, std::vector<std::string> &, std::string &whereString) {
+                whereString = this->process_where(context, w.c);
+            }
+            
+            /**
+             *  Returns `CREATE INDEX IF NOT EXISTS` query for index of impl.
+             *  @param ifNotExists pass false to get the statement the way SQLite stores it in `sqlite_master`.
+             */
+            template<class ...Tss, class ...Cols>
+            std::string create_index_query(storage_impl<internal::index_t<Cols...>, Tss...> *impl, bool ifNotExists = true) {
+                std::stringstream ss;
+                ss << "CREATE ";
+                if(impl->table.unique){
+                    ss << "UNIQUE ";
+                }
+                using columns_type = typename decltype(impl->table)::columns_type;
+                std::vector<std::string> columns;
+                std::string whereString;
+                std::set<std::string> tableNames;
+                
+                //  partial index cannot refer to other tables so `in` values are written into query text
+                internal::query_context context{nullptr};
+                tuple_helper::iterator<std::tuple_size<columns_type>::value - 1, Cols...>()(impl->table.columns, [&context, &columns, &whereString, &tableNames, this](auto &v){
+                    this->process_index_element(context, v, columns, whereString);
+                    auto elementTableNames = this->parse_table_name(v);
+                    tableNames.insert(elementTableNames.begin(), elementTableNames.end());
+                }, false);
+                if(tableNames.empty()){
+                    throw std::system_error(std::make_error_code(orm_error_code::type_is_not_mapped_to_storage));
+                }else if(tableNames.size() > 1){
+                    throw std::system_error(std::make_error_code(orm_error_code::too_many_tables_specified));
+                }
+                ss << "INDEX ";
+                if(ifNotExists){
+                    ss << "IF NOT EXISTS ";
+                }
+                ss << impl->table.name << " ON '" << *tableNames.begin() << "' ( ";
+                for(size_t i = 0; i < columns.size(); ++i) {
+                    ss << columns[i];
+                    if(i < columns.size() - 1) {
+                        ss << ",";
+                    }
+                    ss << " ";
+                }
+                ss << ") ";
+                if(whereString.length()){
+                    ss << "WHERE ( " << whereString << ") ";
+                }
+                return ss.str();
+            }
+            
+            /**
+             *  Removes excess db columns. Columns are dropped in place if SQLite is able to do it and
+             *  table is copied using `backup_table` otherwise.
+             *  @param columns db columns that do not exist in storage.
+             */
+            template<class I>
+            void remove_columns(database_connection &connection, I *impl, const std::vector<table_info> &columns) {
+                auto db = connection.get_db();
+                for(auto &columnInfo : columns) {
+                    if(!impl->drop_column(columnInfo.name, db)) {
+                        this->backup_table(connection, impl);
+                        return;
+                    }
+                }
+            }
+            
+            template<class ...Tss, class ...Cols>
+            sync_schema_result sync_table(storage_impl<internal::index_t<Cols...>, Tss...> *impl, database_connection &connection, const tables_info &, const indexes_info &indexesInfo, bool) {
+                auto db = connection.get_db();
+                auto res = this->index_status(impl, indexesInfo);
+                if(res == decltype(res)::index_recreated) {
+                    this->drop_index_internal(impl->table.name, db);
+                }
+                
+                //  index is created even if it is in sync cause it might be dropped together with its table during this sync..
+                auto query = this->create_index_query(impl);
+                auto rc = sqlite3_exec(db, query.c_str(), nullptr, nullptr, nullptr);
+                if(rc != SQLITE_OK) {
+                    throw std::system_error(std::error_code(sqlite3_errcode(db), get_sqlite_error_category()));
+                }
+                return res;
+            }
+            
+            /**
+             *  Compares index from storage with index stored in db. Statements are compared without whitespaces
+             *  so formatting differences don't cause rebuild.
+             */
+            template<class ...Tss, class ...Cols>
+            sync_schema_result index_status(storage_impl<internal::index_t<Cols...>, Tss...> *impl, const indexes_info &indexesInfo) {
+                auto it = indexesInfo.find(impl->table.name);
+                if(it == indexesInfo.end()) {
+                    return sync_schema_result::new_index_created;
+                }
+                auto withoutWhitespaces = [](const std::string &text) {
+                    std::string res;
+                    std::copy_if(text.begin(), text.end(), std::back_inserter(res), [](char c) {
+                        return !std::isspace(static_cast<unsigned char>(c));
+                    });
+                    return res;
+                };
+                if(withoutWhitespaces(it->second.sql) != withoutWhitespaces(this->create_index_query(impl, false))) {
+                    return sync_schema_result::index_recreated;
+                }
+                return sync_schema_result::already_in_sync;
+            }
+            
+            void drop_index_internal(const std::string &indexName, sqlite3 *db) {
+                std::stringstream ss;
+                ss << "DROP INDEX IF EXISTS '" << indexName + "'";
+                auto query = ss.str();
+                sqlite3_stmt *stmt;
+                if (sqlite3_prepare_v2(db, query.c_str(), -1, &stmt, nullptr) == SQLITE_OK) {
+                    statement_finalizer finalizer{stmt};
+                    if (sqlite3_step(stmt) == SQLITE_DONE) {
+                        //  done..
+                    }else{
+                        throw std::system_error(std::error_code(sqlite3_errcode(db), get_sqlite_error_category()));
+                    }
+                }else {
+                    throw std::system_error(std::error_code(sqlite3_errcode(db), get_sqlite_error_category()));
+                }
+            }
+            
+            template<class ...Tss, class ...Cols>
+            void collect_schema_names(storage_impl<internal::index_t<Cols...>, Tss...> *impl, std::set<std::string> &, std::set<std::string> &indexNames) {
+                indexNames.insert(impl->table.name);
             }
             
-            int busy_timeout(int ms) {
-                auto connection = this->get_or_create_connection();
-                return sqlite3_busy_timeout(connection->get_db(), ms);
+            template<class ...Tss, class ...Cs>
+            void collect_schema_names(storage_impl<table_t<Cs...>, Tss...> *impl, std::set<std::string> &tableNames, std::set<std::string> &) {
+                tableNames.insert(impl->table.name);
             }
             
             /**
-             *  Returns libsqltie3 lib version, not sqlite_orm
+             *  Returns names of db indexes created on storage tables which are not specified in `make_storage` call.
              */
-            std::string libversion() {
-                return sqlite3_libversion();
-            }
-            
-        protected:
-            
-            template<class ...Tss, class ...Cols>
-            sync_schema_result sync_table(storage_impl<internal::index_t<Cols...>, Tss...> *impl, sqlite3 *db, bool) {
-                auto res = sync_schema_result::already_in_sync;
-                std::stringstream ss;
-                ss << "CREATE ";
-                if(impl->table.unique){
-                    ss << "UNIQUE ";
-                }
-                using columns_type = typename decltype(impl->table)::columns_type;
-                using head_t = typename std::tuple_element<0, columns_type>::type;
-                using indexed_type = typename internal::table_type<head_t>::type;
-                ss << "INDEX IF NOT EXISTS " << impl->table.name << " ON '" << this->impl.template find_table_name<indexed_type>() << "' ( ";
-                std::vector<std::string> columnNames;
-                tuple_helper::iterator<std::tuple_size<columns_type>::value - 1, Cols...>()(impl->table.columns, [&columnNames, this](auto &v){
-                    columnNames.push_back(this->impl.column_name(v));
+            std::vector<std::string> excess_indexes(const indexes_info &indexesInfo) {
+                std::set<std::string> tableNames;
+                std::set<std::string> indexNames;
+                this->impl.for_each([&tableNames, &indexNames, this](auto impl){
+                    this->collect_schema_names(impl, tableNames, indexNames);
                 });
-                for(size_t i = 0; i < columnNames.size(); ++i) {
-                    ss << columnNames[i];
-                    if(i < columnNames.size() - 1) {
-                        ss << ",";
+                std::vector<std::string> res;
+                for(auto &p : indexesInfo) {
+                    if(tableNames.count(p.second.table_name) && !indexNames.count(p.first)) {
+                        res.push_back(p.first);
                     }
-                    ss << " ";
-                }
-                ss << ") ";
-                auto query = ss.str();
-                auto rc = sqlite3_exec(db, query.c_str(), nullptr, nullptr, nullptr);
-                if(rc != SQLITE_OK) {
-                    throw std::system_error(std::error_code(sqlite3_errcode(db), get_sqlite_error_category()));
                 }
                 return res;
             }
             
             template<class ...Tss, class ...Cs>
-            sync_schema_result sync_table(storage_impl<table_t<Cs...>, Tss...> *impl, sqlite3 *db, bool preserve) {
+            sync_schema_result sync_table(storage_impl<table_t<Cs...>, Tss...> *impl, database_connection &connection, const tables_info &tablesInfo, const indexes_info &, bool preserve) {
+                auto db = connection.get_db();
                 auto res = sync_schema_result::already_in_sync;
                 
-                auto schema_stat = impl->schema_status(db, preserve);
+                auto schema_stat = impl->schema_status(tablesInfo, preserve);
                 if(schema_stat != decltype(schema_stat)::already_in_sync) {
                     if(schema_stat == decltype(schema_stat)::new_table_created) {
                         this->create_table(db, impl->table.name, impl);
@@ -8330,8 +11945,8 @@ namespace sqlite_orm {
                             //  get table info provided in `make_table` call..
                             auto storageTableInfo = impl->table.get_table_info();
                             
-                            //  now get current table info from db using `PRAGMA table_info` query..
-                            auto dbTableInfo = impl->get_table_info(impl->table.name, db);
+                            //  now get current table info from db loaded by `get_tables_info`..
+                            auto dbTableInfo = tablesInfo.find(impl->table.name)->second;
                             
                             //  this vector will contain pointers to columns that gotta be added..
                             std::vector<table_info*> columnsToAdd;
@@ -8341,7 +11956,7 @@ namespace sqlite_orm {
                             if(schema_stat == sync_schema_result::old_columns_removed) {
                                 
                                 //  extra table columns than storage columns
-                                this->backup_table(db, impl);
+                                this->remove_columns(connection, impl, dbTableInfo);
                                 res = decltype(res)::old_columns_removed;
                             }
                             
@@ -8355,7 +11970,7 @@ namespace sqlite_orm {
                             if(schema_stat == sync_schema_result::new_columns_added_and_old_columns_removed) {
                                 
                                 //remove extra columns
-                                this->backup_table(db, impl);
+                                this->remove_columns(connection, impl, dbTableInfo);
                                 for(auto columnPointer : columnsToAdd) {
                                     impl->add_column(*columnPointer, db);
                                 }
@@ -8371,6 +11986,77 @@ namespace sqlite_orm {
                 return res;
             }
             
+            template<class ...Tss, class ...Cols>
+            sync_schema_result schema_status(storage_impl<internal::index_t<Cols...>, Tss...> *impl, const tables_info &, const indexes_info &indexesInfo, bool) {
+                return this->index_status(impl, indexesInfo);
+            }
+            
+            template<class ...Tss, class ...Cs>
+            sync_schema_result schema_status(storage_impl<table_t<Cs...>, Tss...> *impl, const tables_info &tablesInfo, const indexes_info &, bool preserve) {
+                return impl->schema_status(tablesInfo, preserve);
+            }
+            
+            template<class ...Tss, class ...Cols>
+            std::string schema_definition(storage_impl<internal::index_t<Cols...>, Tss...> *impl) {
+                return this->create_index_query(impl);
+            }
+            
+            template<class ...Tss, class ...Cs>
+            std::string schema_definition(storage_impl<table_t<Cs...>, Tss...> *impl) {
+                return this->create_table_query(impl->table.name, impl);
+            }
+            
+            /**
+             *  Returns schema fingerprint stored by the last successful `sync_schema` call or empty string
+             *  if there is no one. Fingerprint is stored in `_sqlite_orm` metadata table (table names
+             *  starting with `sqlite_` are reserved by SQLite).
+             */
+            std::string stored_schema_fingerprint(database_connection &connection) {
+                auto db = connection.get_db();
+                if(!this->impl.table_exists("_sqlite_orm", connection)) {
+                    return {};
+                }
+                auto stmt = connection.get_statement("SELECT \"value\" FROM '_sqlite_orm' WHERE \"key\" = 'schema_fingerprint'");
+                statement_resetter resetter{stmt};
+                switch(sqlite3_step(stmt)){
+                    case SQLITE_ROW: return row_extractor<std::string>().extract(stmt, 0);
+                    case SQLITE_DONE: return {};
+                    default:{
+                        throw std::system_error(std::error_code(sqlite3_errcode(db), get_sqlite_error_category()));
+                    }
+                }
+            }
+            
+            void store_schema_fingerprint(database_connection &connection, const std::string &fingerprint) {
+                auto db = connection.get_db();
+                auto rc = sqlite3_exec(db, "CREATE TABLE IF NOT EXISTS '_sqlite_orm' ( 'key' TEXT PRIMARY KEY NOT NULL , 'value' TEXT NOT NULL )", nullptr, nullptr, nullptr);
+                if(rc != SQLITE_OK) {
+                    throw std::system_error(std::error_code(sqlite3_errcode(db), get_sqlite_error_category()));
+                }
+                auto stmt = connection.get_statement("REPLACE INTO '_sqlite_orm' (\"key\", \"value\") VALUES ('schema_fingerprint', ?)");
+                statement_resetter resetter{stmt};
+                statement_binder<std::string>().bind(stmt, 1, fingerprint);
+                if(sqlite3_step(stmt) != SQLITE_DONE) {
+                    throw std::system_error(std::error_code(sqlite3_errcode(db), get_sqlite_error_category()));
+                }
+            }
+            
+            /**
+             *  Fills result with `already_in_sync` for every table and index if schema fingerprint is enabled
+             *  and is equal to the one stored in db.
+             *  @return true if schema is known to be in sync and introspection can be skipped.
+             */
+            bool schema_fingerprint_matches(database_connection &connection, std::map<std::string, sync_schema_result> &result) {
+                if(this->useSchemaFingerprint && this->stored_schema_fingerprint(connection) == this->schema_fingerprint()) {
+                    this->impl.for_each([&result](auto impl){
+                        result.insert({impl->table.name, sync_schema_result::already_in_sync});
+                    });
+                    return true;
+                }else{
+                    return false;
+                }
+            }
+            
         public:
             
             /**
@@ -8383,25 +12069,44 @@ namespace sqlite_orm {
              *          * if there are columns in db that do not exist in storage (excess) table will be dropped and recreated
              *          * if there are columns in storage that do not exist in db they will be added using `ALTER TABLE ... ADD COLUMN ...' command
              *          * if there is any column existing in both db and storage but differs by any of properties/constraints (type, pk, notnull, dflt_value) table will be dropped and recreated
+             *  * every index from storage is compared with it's db analog and it is created if it doesn't exist or dropped and created again if its
+             *      definition differs. Indexes of storage tables that exist in db but not in storage are dropped
              *  Be aware that `sync_schema` doesn't guarantee that data will not be dropped. It guarantees only that it will make db schema the same
              *  as you specified in `make_storage` function call. A good point is that if you have no db file at all it will be created and
              *  all tables also will be created with exact tables and columns you specified in `make_storage`, `make_table` and `make_column` call.
              *  The best practice is to call this function right after storage creation.
              *  @param preserve affects on function behaviour in case it is needed to remove a column. If it is `false` so table will be dropped
-             *  if there is column to remove, if `true` -  table is being copied into another table, dropped and copied table is renamed with source table name.
+             *  if there is column to remove, if `true` -  column is dropped in place with `ALTER TABLE ... DROP COLUMN` if SQLite supports it (3.35.0+)
+             *  and allows it for this column, otherwise table is being copied into another table, dropped and copied table is renamed with source table name.
              *  Warning: sync_schema doesn't check foreign keys cause it is unable to do so in sqlite3. If you know how to get foreign key info
              *  please submit an issue https://github.com/fnc12/sqlite_orm/issues
              *  @return std::map with std::string key equal table name and `sync_schema_result` as value. `sync_schema_result` is a enum value that stores
              *  table state after syncing a schema. `sync_schema_result` can be printed out on std::ostream with `operator<<`.
+             *  If schema fingerprint is enabled (see `enable_schema_fingerprint`) and storage schema has not changed since
+             *  the last successful call introspection is skipped and every table is reported as `already_in_sync`.
              */
             std::map<std::string, sync_schema_result> sync_schema(bool preserve = false) {
+                internal::operation_scope operationScope("sync_schema");
                 auto connection = this->get_or_create_connection();
                 std::map<std::string, sync_schema_result> result;
-                auto db = connection->get_db();
-                this->impl.for_each([&result, db, preserve, this](auto impl){
-                    auto res = this->sync_table(impl, db, preserve);
+                if(this->schema_fingerprint_matches(*connection, result)) {
+                    return result;
+                }
+                auto tablesInfo = this->impl.get_tables_info(*connection);
+                auto indexesInfo = this->impl.get_indexes_info(*connection);
+                
+                //  excess indexes are dropped first so they don't slow down tables migration..
+                for(auto &indexName : this->excess_indexes(indexesInfo)) {
+                    this->drop_index_internal(indexName, connection->get_db());
+                    result.insert({indexName, sync_schema_result::index_dropped});
+                }
+                this->impl.for_each([&result, &connection, &tablesInfo, &indexesInfo, preserve, this](auto impl){
+                    auto res = this->sync_table(impl, *connection, tablesInfo, indexesInfo, preserve);
                     result.insert({impl->table.name, res});
                 });
+                if(this->useSchemaFingerprint) {
+                    this->store_schema_fingerprint(*connection, this->schema_fingerprint());
+                }
                 return result;
             }
             
@@ -8413,14 +12118,66 @@ namespace sqlite_orm {
             std::map<std::string, sync_schema_result> sync_schema_simulate(bool preserve = false) {
                 auto connection = this->get_or_create_connection();
                 std::map<std::string, sync_schema_result> result;
-                auto db = connection->get_db();
-                this->impl.for_each([&result, db, preserve](auto impl){
-                    result.insert({impl->table.name, impl->schema_status(db, preserve)});
+                if(this->schema_fingerprint_matches(*connection, result)) {
+                    return result;
+                }
+                auto tablesInfo = this->impl.get_tables_info(*connection);
+                auto indexesInfo = this->impl.get_indexes_info(*connection);
+                for(auto &indexName : this->excess_indexes(indexesInfo)) {
+                    result.insert({indexName, sync_schema_result::index_dropped});
+                }
+                this->impl.for_each([&result, &tablesInfo, &indexesInfo, preserve, this](auto impl){
+                    result.insert({impl->table.name, this->schema_status(impl, tablesInfo, indexesInfo, preserve)});
                 });
                 return result;
             }
             
+            /**
+             *  Returns stable hash of storage schema: tables, columns, types, constraints and indexes
+             *  specified in `make_storage` call. It is a 16 hex digits string (64-bit FNV-1a of schema
+             *  definition) which doesn't depend on platform or process.
+             */
+            std::string schema_fingerprint() {
+                uint64 hash = 14695981039346656037ULL;
+                this->impl.for_each([&hash, this](auto impl){
+                    auto definition = this->schema_definition(impl);
+                    definition += ';';
+                    for(auto c : definition) {
+                        hash ^= static_cast<unsigned char>(c);
+                        hash *= 1099511628211ULL;
+                    }
+                });
+                std::stringstream ss;
+                ss << std::hex << std::setw(16) << std::setfill('0') << hash;
+                return ss.str();
+            }
+            
+            /**
+             *  Enables storing schema fingerprint in db during `sync_schema` call. Once enabled `sync_schema` and
+             *  `sync_schema_simulate` compare stored fingerprint with `schema_fingerprint()` first and skip table
+             *  introspection if they are equal. Use it only if db schema is changed by this storage exclusively:
+             *  changes made outside of `sync_schema` are not detected while fingerprint matches.
+             */
+            void enable_schema_fingerprint(bool value = true) {
+                this->useSchemaFingerprint = value;
+            }
+            
+            /**
+             *  Enables online mode for table rebuilds performed by `sync_schema` (when a column cannot be removed
+             *  in place). Rows are copied in rowid order by chunks of `chunkSize` rows each one within a short
+             *  transaction so other connections can use the table during migration, and source table is replaced
+             *  with the copy atomically. Online mode is not used if `sync_schema` is called inside a transaction.
+             *  @param chunkSize rows count copied per transaction. Pass 0 to disable online mode.
+             *  @param onProgress optional callback fired after every copied chunk.
+             */
+            void enable_online_migration(int chunkSize, std::function<void(const migration_progress&)> onProgress = {}) {
+                this->migrationChunkSize = chunkSize;
+                this->onMigrationProgress = std::move(onProgress);
+            }
+            
             bool transaction(std::function<bool()> f) {
+                measurement_type measurement(this->instrumentationPolicy, "transaction");
+                measurement.phase(instrumentation_phase::step);
                 this->begin_transaction();
                 auto db = this->currentTransaction->get_db();
                 auto shouldCommit = f();
@@ -8471,7 +12228,7 @@ namespace sqlite_orm {
             
             std::string current_timestamp() {
                 auto connection = this->get_or_create_connection();
-                return this->impl.current_timestamp(connection->get_db());
+                return this->impl.current_timestamp(*connection);
             }
             
         protected:
@@ -8523,6 +12280,29 @@ namespace sqlite_orm {
             }
 #endif
             
+            /**
+             *  @return instrumentation policy passed to `make_instrumented_storage`. `no_instrumentation`
+             *  for storages created with `make_storage`.
+             */
+            instrumentation_type& instrumentation() {
+                return this->instrumentationPolicy;
+            }
+            
+            /**
+             *  Returns `sqlite3_db_status` values of connections kept open by storage and process wide
+             *  `sqlite3_status64` memory values. Is useful for `cache_size` and lookaside sizing.
+             *  @param reset resets highwater marks and cache counters after reading if true so every call
+             *  reports values collected since the previous one.
+             */
+            storage_stats stats(bool reset = false) {
+                storage_stats res;
+                if(this->currentTransaction) {
+                    res.connections.push_back(internal::get_connection_stats(this->currentTransaction->get_db(), reset));
+                }
+                internal::get_global_stats(res, reset);
+                return res;
+            }
+            
             /**
              *  Checks whether table exists in db. Doesn't check storage itself - works only with actual database.
              *  Note: table can be not mapped to a storage
@@ -8530,7 +12310,7 @@ namespace sqlite_orm {
              */
             bool table_exists(const std::string &tableName) {
                 auto connection = this->get_or_create_connection();
-                return this->impl.table_exists(tableName, connection->get_db());
+                return this->impl.table_exists(tableName, *connection);
             }
             
             /**
@@ -8539,24 +12319,7 @@ namespace sqlite_orm {
              */
             std::vector<std::string> table_names() {
                 auto connection = this->get_or_create_connection();
-                std::vector<std::string> tableNames;
-                std::string sql = "SELECT name FROM sqlite_master WHERE type='table'";
-                using Data = std::vector<std::string>;
-                int res = sqlite3_exec(connection->get_db(), sql.c_str(),
-                                       [] (void *data, int argc, char **argv, char ** /*columnName*/) -> int {
-                                           auto& tableNames = *(Data*)data;
-                                           for(int i = 0; i < argc; i++) {
-                                               if(argv[i]){
-                                                   tableNames.push_back(argv[i]);
-                                               }
-                                           }
-                                           return 0;
-                                       }, &tableNames,nullptr);
-                
-                if(res != SQLITE_OK) {
-                    throw std::system_error(std::error_code(sqlite3_errcode(connection->db()), get_sqlite_error_category()));
-                }
-                return tableNames;
+                return this->impl.table_names(*connection);
             }
             
             void open_forever() {
@@ -8571,12 +12334,249 @@ namespace sqlite_orm {
             pragma_t pragma;
             limit_accesor limit;
         };
+        
+        template<class ...Ts>
+        using storage_t = basic_storage<no_instrumentation, Ts...>;
     }
     
     template<class ...Ts>
     internal::storage_t<Ts...> make_storage(const std::string &filename, Ts ...tables) {
         return {filename, internal::storage_impl<Ts...>(tables...)};
     }
+    
+    /**
+     *  Creates a storage with instrumentation policy `P` e.g.
+     *  `make_instrumented_storage<latency_instrumentation>("db.sqlite", make_table(...))`.
+     */
+    template<class P, class ...Ts>
+    internal::basic_storage<P, Ts...> make_instrumented_storage(const std::string &filename, Ts ...tables) {
+        return {filename, internal::storage_impl<Ts...>(tables...)};
+    }
+}
+#pragma once
+
+#ifndef SQLITE_ORM_STORAGE_INTERFACE_H
+#define SQLITE_ORM_STORAGE_INTERFACE_H
+
+#include <string>   //  std::string
+#include <vector>   //  std::vector
+#include <memory>   //  std::shared_ptr
+#include <functional>   //  std::function
+#include <map>  //  std::map
+
+// #include "sync_schema_result.h"
+
+
+namespace sqlite_orm {
+    
+    /**
+     *  Non-template interface of storage operations which don't depend on a mapped type.
+     *  It is available as a standalone light header `sqlite_orm/storage_interface.h` which includes
+     *  only standard headers. So a storage can be defined and instantiated in a single translation unit
+     *  and other translation units work with it through this interface without including `sqlite_orm.h`.
+     *  Implementation is created with `make_storage_interface(storage)`.
+     */
+    struct storage_interface {
+        
+        virtual ~storage_interface() = default;
+        
+        /**
+         *  Calls `storage.sync_schema(preserve)`.
+         *  @return result of every table and index of the storage like `storage.sync_schema` does.
+         */
+        virtual std::map<std::string, sync_schema_result> sync_schema(bool preserve = false) = 0;
+        
+        virtual bool transaction(std::function<bool()> f) = 0;
+        
+        virtual void begin_transaction() = 0;
+        
+        virtual void commit() = 0;
+        
+        virtual void rollback() = 0;
+        
+        virtual bool table_exists(const std::string &tableName) = 0;
+        
+        virtual void drop_table(const std::string &tableName) = 0;
+        
+        virtual void vacuum() = 0;
+    };
+    
+    /**
+     *  Non-template interface of storage operations with mapped type O which primary key has type Id.
+     *  Is a part of the light header like `storage_interface`. Implementation is created with
+     *  `make_repository<O>(storage)`. Every function calls storage function with the same name.
+     */
+    template<class O, class Id = int>
+    struct repository {
+        
+        virtual ~repository() = default;
+        
+        /**
+         *  @return id of inserted object
+         */
+        virtual int insert(const O &o) = 0;
+        
+        virtual void insert_range(const std::vector<O> &objects) = 0;
+        
+        virtual void replace(const O &o) = 0;
+        
+        virtual void update(const O &o) = 0;
+        
+        virtual void remove(const Id &id) = 0;
+        
+        virtual void remove_all() = 0;
+        
+        /**
+         *  throws std::system_error(orm_error_code::not_found, orm_error_category) if object is not found.
+         */
+        virtual O get(const Id &id) = 0;
+        
+        /**
+         *  @return nullptr if object is not found.
+         */
+        virtual std::shared_ptr<O> get_no_throw(const Id &id) = 0;
+        
+        virtual std::vector<O> get_all() = 0;
+        
+        virtual int count() = 0;
+    };
+}
+
+#endif  //  SQLITE_ORM_STORAGE_INTERFACE_H
+#pragma once
+
+#include <string>   //  std::string
+#include <vector>   //  std::vector
+#include <memory>   //  std::shared_ptr, std::unique_ptr
+#include <functional>   //  std::function
+#include <map>  //  std::map
+#include <utility>  //  std::move
+
+// #include "storage_interface.h"
+
+
+namespace sqlite_orm {
+    
+    namespace internal {
+        
+        /**
+         *  storage_interface implementation which forwards calls to storage S. Keeps a reference so
+         *  storage must outlive it.
+         */
+        template<class S>
+        struct storage_interface_impl : public storage_interface {
+            
+            storage_interface_impl(S &storage_): storage(storage_) {}
+            
+            std::map<std::string, sync_schema_result> sync_schema(bool preserve) override {
+                return this->storage.sync_schema(preserve);
+            }
+            
+            bool transaction(std::function<bool()> f) override {
+                return this->storage.transaction(std::move(f));
+            }
+            
+            void begin_transaction() override {
+                this->storage.begin_transaction();
+            }
+            
+            void commit() override {
+                this->storage.commit();
+            }
+            
+            void rollback() override {
+                this->storage.rollback();
+            }
+            
+            bool table_exists(const std::string &tableName) override {
+                return this->storage.table_exists(tableName);
+            }
+            
+            void drop_table(const std::string &tableName) override {
+                this->storage.drop_table(tableName);
+            }
+            
+            void vacuum() override {
+                this->storage.vacuum();
+            }
+            
+        protected:
+            S &storage;
+        };
+        
+        /**
+         *  repository implementation which forwards calls to storage S. Keeps a reference so
+         *  storage must outlive it.
+         */
+        template<class S, class O, class Id>
+        struct repository_impl : public repository<O, Id> {
+            
+            repository_impl(S &storage_): storage(storage_) {}
+            
+            int insert(const O &o) override {
+                return this->storage.insert(o);
+            }
+            
+            void insert_range(const std::vector<O> &objects) override {
+                this->storage.insert_range(objects.begin(), objects.end());
+            }
+            
+            void replace(const O &o) override {
+                this->storage.replace(o);
+            }
+            
+            void update(const O &o) override {
+                this->storage.update(o);
+            }
+            
+            void remove(const Id &id) override {
+                this->storage.template remove<O>(id);
+            }
+            
+            void remove_all() override {
+                this->storage.template remove_all<O>();
+            }
+            
+            O get(const Id &id) override {
+                return this->storage.template get<O>(id);
+            }
+            
+            std::shared_ptr<O> get_no_throw(const Id &id) override {
+                return this->storage.template get_no_throw<O>(id);
+            }
+            
+            std::vector<O> get_all() override {
+                return this->storage.template get_all<O>();
+            }
+            
+            int count() override {
+                return this->storage.template count<O>();
+            }
+            
+        protected:
+            S &storage;
+        };
+    }
+    
+    /**
+     *  Creates `storage_interface` implementation for a storage. Storage must outlive the result.
+     *  Call it in the translation unit which defines the storage. Explicit instantiation of
+     *  `internal::storage_interface_impl<Storage>` in that unit makes sure all storage functions used by
+     *  the interface are instantiated there once.
+     */
+    template<class S>
+    std::unique_ptr<storage_interface> make_storage_interface(S &storage) {
+        return std::make_unique<internal::storage_interface_impl<S>>(storage);
+    }
+    
+    /**
+     *  Creates `repository<O, Id>` implementation for a storage. Storage must outlive the result.
+     *  O is a mapped type and must be specified explicitly.
+     */
+    template<class O, class Id = int, class S>
+    std::unique_ptr<repository<O, Id>> make_repository(S &storage) {
+        return std::make_unique<internal::repository_impl<S, O, Id>>(storage);
+    }
 }
 #pragma once
 
@@ -0,0 +1,169 @@
+#pragma once
+
+#ifndef SQLITE_ORM_STORAGE_INTERFACE_H
+#define SQLITE_ORM_STORAGE_INTERFACE_H
+
+#include <string>   //  std::string
+#include <vector>   //  std::vector
+#include <memory>   //  std::shared_ptr
+#include <functional>   //  std::function
+#include <map>  //  std::map
+
+// #include "sync_schema_result.h"
+
+
+#ifndef SQLITE_ORM_SYNC_SCHEMA_RESULT_H
+#define SQLITE_ORM_SYNC_SCHEMA_RESULT_H
+
+#include <ostream>
+
+namespace sqlite_orm {
+    
+    enum class sync_schema_result {
+        
+        /**
+         *  created new table, table with the same tablename did not exist
+         */
+        new_table_created,
+        
+        /**
+         *  table schema is the same as storage, nothing to be done
+         */
+        already_in_sync,
+        
+        /**
+         *  removed excess columns in table (than storage) without dropping a table
+         */
+        old_columns_removed,
+        
+        /**
+         *  lacking columns in table (than storage) added without dropping a table
+         */
+        new_columns_added,
+        
+        /**
+         *  both old_columns_removed and new_columns_added
+         */
+        new_columns_added_and_old_columns_removed,
+        
+        /**
+         *  old table is dropped and new is recreated. Reasons :
+         *      1. delete excess columns in the table than storage if preseve = false
+         *      2. Lacking columns in the table cannot be added due to NULL and DEFAULT constraint
+         *      3. Reasons 1 and 2 both together
+         *      4. data_type mismatch between table and storage.
+         */
+        dropped_and_recreated,
+        
+        /**
+         *  index from storage did not exist in db and was created
+         */
+        new_index_created,
+        
+        /**
+         *  index definition (columns, uniqueness, collation, order or condition) differs from storage
+         *  so index was dropped and created again
+         */
+        index_recreated,
+        
+        /**
+         *  index of a storage table exists in db but not in storage so it was dropped
+         */
+        index_dropped,
+    };
+    
+    
+    inline std::ostream& operator<<(std::ostream &os, sync_schema_result value) {
+        switch(value){
+            case sync_schema_result::new_table_created: return os << "new table created";
+            case sync_schema_result::already_in_sync: return os << "table and storage is already in sync.";
+            case sync_schema_result::old_columns_removed: return os << "old excess columns removed";
+            case sync_schema_result::new_columns_added: return os << "new columns added";
+            case sync_schema_result::new_columns_added_and_old_columns_removed: return os << "old excess columns removed and new columns added";
+            case sync_schema_result::dropped_and_recreated: return os << "old table dropped and recreated";
+            case sync_schema_result::new_index_created: return os << "new index created";
+            case sync_schema_result::index_recreated: return os << "index dropped and recreated";
+            case sync_schema_result::index_dropped: return os << "excess index dropped";
+        }
+    }
+}
+
+#endif  //  SQLITE_ORM_SYNC_SCHEMA_RESULT_H
+
+
+namespace sqlite_orm {
+    
+    /**
+     *  Non-template interface of storage operations which don't depend on a mapped type.
+     *  It is available as a standalone light header `sqlite_orm/storage_interface.h` which includes
+     *  only standard headers. So a storage can be defined and instantiated in a single translation unit
+     *  and other translation units work with it through this interface without including `sqlite_orm.h`.
+     *  Implementation is created with `make_storage_interface(storage)`.
+     */
+    struct storage_interface {
+        
+        virtual ~storage_interface() = default;
+        
+        /**
+         *  Calls `storage.sync_schema(preserve)`.
+         *  @return result of every table and index of the storage like `storage.sync_schema` does.
+         */
+        virtual std::map<std::string, sync_schema_result> sync_schema(bool preserve = false) = 0;
+        
+        virtual bool transaction(std::function<bool()> f) = 0;
+        
+        virtual void begin_transaction() = 0;
+        
+        virtual void commit() = 0;
+        
+        virtual void rollback() = 0;
+        
+        virtual bool table_exists(const std::string &tableName) = 0;
+        
+        virtual void drop_table(const std::string &tableName) = 0;
+        
+        virtual void vacuum() = 0;
+    };
+    
+    /**
+     *  Non-template interface of storage operations with mapped type O which primary key has type Id.
+     *  Is a part of the light header like `storage_interface`. Implementation is created with
+     *  `make_repository<O>(storage)`. Every function calls storage function with the same name.
+     */
+    template<class O, class Id = int>
+    struct repository {
+        
+        virtual ~repository() = default;
+        
+        /**
+         *  @return id of inserted object
+         */
+        virtual int insert(const O &o) = 0;
+        
+        virtual void insert_range(const std::vector<O> &objects) = 0;
+        
+        virtual void replace(const O &o) = 0;
+        
+        virtual void update(const O &o) = 0;
+        
+        virtual void remove(const Id &id) = 0;
+        
+        virtual void remove_all() = 0;
+        
+        /**
+         *  throws std::system_error(orm_error_code::not_found, orm_error_category) if object is not found.
+         */
+        virtual O get(const Id &id) = 0;
+        
+        /**
+         *  @return nullptr if object is not found.
+         */
+        virtual std::shared_ptr<O> get_no_throw(const Id &id) = 0;
+        
+        virtual std::vector<O> get_all() = 0;
+        
+        virtual int count() = 0;
+    };
+}
+
+#endif  //  SQLITE_ORM_STORAGE_INTERFACE_H
@@ -12,6 +12,1466 @@ using namespace sqlite_orm;
 using std::cout;
 using std::endl;
 
+void testPaginate() {
+    cout << __func__ << endl;
+    
+    struct Post {
+        int id;
+        std::string author;
+        int created;
+        double rating;
+    };
+    
+    auto storage = make_storage("",
+                                make_table("posts",
+                                           make_column("id", &Post::id, primary_key()),
+                                           make_column("author", &Post::author),
+                                           make_column("created", &Post::created),
+                                           make_column("rating", &Post::rating)));
+    storage.sync_schema();
+    std::vector<Post> posts;
+    for(auto i = 1; i <= 25; ++i) {
+        posts.push_back({i, i % 2 ? "alice" : "bob", i / 3, i * 0.5});
+    }
+    storage.replace_range(posts.begin(), posts.end());
+    
+    auto collect = [&storage](auto orderBy, int pageSize, auto ...conditions) {
+        std::vector<int> ids;
+        std::string token;
+        auto pagesCount = 0;
+        do{
+            auto p = storage.template paginate<Post>(orderBy, pageSize, token, conditions...);
+            assert(p.objects.size() <= size_t(pageSize));
+            for(auto &post : p.objects) {
+                ids.push_back(post.id);
+            }
+            token = p.next_token;
+            ++pagesCount;
+        }while(token.length());
+        return std::make_pair(ids, pagesCount);
+    };
+    
+    //  single key
+    auto byId = collect(order_by(&Post::id), 10);
+    assert(byId.second == 3);
+    assert(byId.first.size() == 25);
+    for(size_t i = 0; i < byId.first.size(); ++i) {
+        assert(byId.first[i] == int(i) + 1);
+    }
+    
+    //  all keys in one direction use row values
+    auto byCreated = collect(multi_order_by(order_by(&Post::created).desc(), order_by(&Post::id).desc()), 4);
+    assert(byCreated.first == storage.select(&Post::id, multi_order_by(order_by(&Post::created).desc(), order_by(&Post::id).desc())));
+    
+    //  mixed directions
+    auto mixed = collect(multi_order_by(order_by(&Post::created), order_by(&Post::id).desc()), 7);
+    assert(mixed.first == storage.select(&Post::id, multi_order_by(order_by(&Post::created), order_by(&Post::id).desc())));
+    
+    //  text and real keys with a condition
+    auto byAuthor = collect(multi_order_by(order_by(&Post::author), order_by(&Post::rating)), 5, where(c(&Post::id) > 3));
+    assert(byAuthor.first == storage.select(&Post::id, where(c(&Post::id) > 3), multi_order_by(order_by(&Post::author), order_by(&Post::rating))));
+    
+    //  page size equal to rows count gives no extra empty page
+    auto exact = storage.paginate<Post>(order_by(&Post::id), 25);
+    assert(exact.objects.size() == 25);
+    assert(exact.next_token.empty());
+    
+    try{
+        storage.paginate<Post>(order_by(&Post::id), 10, "x1;");
+        assert(false);
+    }catch(const std::system_error &e){
+        assert(e.code() == std::make_error_code(orm_error_code::incorrect_page_token));
+    }
+    try{
+        auto first = storage.paginate<Post>(order_by(&Post::id), 10);
+        storage.paginate<Post>(multi_order_by(order_by(&Post::created), order_by(&Post::id)), 10, first.next_token);
+        assert(false);
+    }catch(const std::system_error &e){
+        assert(e.code() == std::make_error_code(orm_error_code::incorrect_page_token));
+    }
+}
+
+void testUpsert() {
+    cout << __func__ << endl;
+    
+    struct Product {
+        std::string code;
+        std::string name;
+        double price;
+    };
+    
+    struct User {
+        int id;
+        std::string email;
+        std::string name;
+        int visits;
+    };
+    
+    auto storage = make_storage("",
+                                make_table("products",
+                                           make_column("code", &Product::code, primary_key()),
+                                           make_column("name", &Product::name),
+                                           make_column("price", &Product::price)),
+                                make_table("users",
+                                           make_column("id", &User::id, primary_key()),
+                                           make_column("email", &User::email, unique()),
+                                           make_column("name", &User::name),
+                                           make_column("visits", &User::visits)));
+    storage.sync_schema();
+    storage.upsert(Product{"a", "Apple", 1});
+    storage.upsert(Product{"b", "Banana", 2});
+    auto rowidOf = [&storage](const std::string &code) {
+        return std::get<0>(storage.select(columns(rowid(), &Product::code), where(c(&Product::code) == code)).front());
+    };
+    auto appleRowid = rowidOf("a");
+    
+    //  existing row is updated in place
+    storage.upsert(Product{"a", "Green apple", 1.5});
+    assert(storage.count<Product>() == 2);
+    assert(rowidOf("a") == appleRowid);
+    auto apple = storage.get<Product>("a");
+    assert(apple.name == "Green apple");
+    assert(apple.price == 1.5);
+    
+    //  unchanged row is not written
+    storage.upsert(Product{"a", "Green apple", 1.5});
+    assert(storage.changes() == 0);
+    
+    //  small limit splits range in several statements
+    storage.limit.variable_number(7);
+    std::vector<Product> products;
+    for(auto i = 0; i < 10; ++i) {
+        products.push_back({std::string(1, char('a' + i)), "product" + std::to_string(i), double(i)});
+    }
+    storage.upsert_range(products.begin(), products.end());
+    assert(storage.count<Product>() == 10);
+    assert(rowidOf("a") == appleRowid);
+    assert(storage.get<Product>("a").name == "product0");
+    assert(storage.get<Product>("j").price == 9);
+    auto totalChanges = storage.total_changes();
+    storage.upsert_range(products.begin(), products.end());
+    assert(storage.total_changes() == totalChanges);
+    
+    //  tail chunk of two rows gets its own uncached statement
+    storage.limit.variable_number(12);
+    for(auto &product : products) {
+        product.price += 100;
+    }
+    storage.upsert_range(products.begin(), products.end());
+    assert(storage.get<Product>("i").price == 108);
+    assert(storage.get<Product>("j").price == 109);
+    
+    //  failed chunk rolls back the whole range
+    std::vector<User> users = {{1, "alice@example.com", "Alice", 1}, {2, "bob@example.com", "Bob", 1}};
+    storage.upsert_range(users.begin(), users.end());
+    std::vector<User> conflicting = {{1, "alice@example.com", "Alice Smith", 2}, {3, "bob@example.com", "Robert", 1}};
+    try{
+        storage.upsert_range(conflicting.begin(), conflicting.end());
+        assert(false);
+    }catch(const std::system_error &){
+        //..
+    }
+    assert(storage.get<User>(1).name == "Alice");
+    
+    //  conflict on a unique column updates listed columns only
+    storage.upsert(User{10, "alice@example.com", "Alice Smith", 5}, columns(&User::email), columns(&User::visits));
+    assert(storage.count<User>() == 2);
+    auto alice = storage.get<User>(1);
+    assert(alice.name == "Alice");
+    assert(alice.visits == 5);
+}
+
+void testUpdateColumnAndIncrement() {
+    cout << __func__ << endl;
+    
+    struct Account {
+        int id;
+        std::string owner;
+        double balance;
+        int visits;
+    };
+    
+    struct Visit {
+        int userId;
+        int day;
+        int count;
+    };
+    
+    auto storage = make_storage("",
+                                make_table("accounts",
+                                           make_column("id", &Account::id, primary_key()),
+                                           make_column("owner", &Account::owner),
+                                           make_column("balance", &Account::balance),
+                                           make_column("visits", &Account::visits)),
+                                make_table("visits",
+                                           make_column("user_id", &Visit::userId),
+                                           make_column("day", &Visit::day),
+                                           make_column("count", &Visit::count),
+                                           primary_key(&Visit::userId, &Visit::day)));
+    storage.sync_schema();
+    storage.replace(Account{1, "Alice", 10.5, 0});
+    storage.replace(Account{2, "Bob", 20, 0});
+    storage.replace(Visit{1, 10, 100});
+    storage.replace(Visit{1, 11, 200});
+    
+    storage.update_column(&Account::balance, 1, 100);
+    storage.update_column(&Account::owner, 2, "Robert");
+    for(auto i = 0; i < 3; ++i) {
+        storage.increment(&Account::visits, 1, 1);
+    }
+    storage.increment(&Account::balance, 2, -5.5);
+    
+    auto alice = storage.get<Account>(1);
+    assert(alice.owner == "Alice");
+    assert(alice.balance == 100);
+    assert(alice.visits == 3);
+    auto bob = storage.get<Account>(2);
+    assert(bob.owner == "Robert");
+    assert(bob.balance == 14.5);
+    assert(bob.visits == 0);
+    
+    //  missing object is not an error
+    storage.increment(&Account::visits, 42, 1);
+    assert(storage.count<Account>() == 2);
+    
+    storage.increment(&Visit::count, std::make_tuple(1, 11), 5);
+    assert(storage.get<Visit>(1, 10).count == 100);
+    assert(storage.get<Visit>(1, 11).count == 205);
+}
+
+void testPartialUpdate() {
+    cout << __func__ << endl;
+    
+    struct User {
+        int id;
+        std::string name;
+        std::vector<char> avatar;
+        int visits;
+        std::shared_ptr<std::string> email;
+    };
+    
+    auto storage = make_storage("",
+                                make_table("users",
+                                           make_column("id", &User::id, primary_key()),
+                                           make_column("name", &User::name),
+                                           make_column("avatar", &User::avatar),
+                                           make_column("visits", &User::visits),
+                                           make_column("email", &User::email)));
+    storage.sync_schema();
+    storage.replace(User{1, "Alice", std::vector<char>(1000, 'a'), 0, std::make_shared<std::string>("alice@example.com")});
+    storage.enable_profiling();
+    
+    auto original = storage.get<User>(1);
+    auto user = original;
+    
+    //  nothing is changed so nothing is executed
+    storage.update(user, original);
+    
+    user.visits = 1;
+    storage.update(user, original);
+    user.visits = 2;
+    storage.update(user, original);
+    
+    user.email = std::make_shared<std::string>("alice@example.com");
+    user.name = "Alice Smith";
+    storage.update(user, original);
+    
+    auto updated = storage.get<User>(1);
+    assert(updated.name == "Alice Smith");
+    assert(updated.visits == 2);
+    assert(updated.avatar == original.avatar);
+    assert(updated.email && *updated.email == "alice@example.com");
+    
+    user.email = nullptr;
+    storage.update(user, original);
+    assert(!storage.get<User>(1).email);
+    
+    auto profiles = storage.profile_snapshot(100);
+    auto updatesCount = std::count_if(profiles.begin(), profiles.end(), [](const query_profile &p){
+        return p.sql.find("UPDATE") == 0;
+    });
+    assert(updatesCount == 3);
+    auto visitsUpdate = std::find_if(profiles.begin(), profiles.end(), [](const query_profile &p){
+        return p.sql.find("UPDATE 'users' SET \"visits\" = ? WHERE \"id\" = ?") == 0;
+    });
+    assert(visitsUpdate != profiles.end());
+    assert(visitsUpdate->calls == 2);
+    auto nameAndVisitsUpdate = std::find_if(profiles.begin(), profiles.end(), [](const query_profile &p){
+        return p.sql.find("UPDATE 'users' SET \"name\" = ?, \"visits\" = ? WHERE \"id\" = ?") == 0;
+    });
+    assert(nameAndVisitsUpdate != profiles.end());
+    
+    //  table level primary key listing columns in other order than table does
+    struct Visit {
+        int userId;
+        int day;
+        int count;
+    };
+    auto visitsStorage = make_storage("",
+                                      make_table("visits",
+                                                 make_column("user_id", &Visit::userId),
+                                                 make_column("day", &Visit::day),
+                                                 make_column("count", &Visit::count),
+                                                 primary_key(&Visit::day, &Visit::userId)));
+    visitsStorage.sync_schema();
+    visitsStorage.replace(Visit{1, 2, 3});
+    visitsStorage.replace(Visit{2, 1, 4});
+    auto originalVisit = visitsStorage.get<Visit>(2, 1);
+    auto visit = originalVisit;
+    visit.count = 99;
+    visitsStorage.update(visit, originalVisit);
+    assert(visitsStorage.get<Visit>(2, 1).count == 99);
+    assert(visitsStorage.get<Visit>(1, 2).count == 4);
+    
+    visit.count = 100;
+    visitsStorage.update(visit);
+    assert(visitsStorage.get<Visit>(2, 1).count == 100);
+    std::vector<Visit> visits = {Visit{1, 2, 7}, Visit{2, 1, 8}};
+    visitsStorage.update_range(visits.begin(), visits.end());
+    assert(visitsStorage.get<Visit>(2, 1).count == 7);
+    assert(visitsStorage.get<Visit>(1, 2).count == 8);
+}
+
+void testUpdateRemoveRange() {
+    cout << __func__ << endl;
+    
+    struct User {
+        int id;
+        std::string name;
+    };
+    
+    struct Visit {
+        int userId;
+        int day;
+        int count;
+    };
+    
+    auto filename = "update_remove_range.sqlite";
+    ::remove(filename);
+    auto storage = make_storage(filename,
+                                make_table("users",
+                                           make_column("id", &User::id, primary_key()),
+                                           make_column("name", &User::name, unique())),
+                                make_table("visits",
+                                           make_column("user_id", &Visit::userId),
+                                           make_column("day", &Visit::day),
+                                           make_column("count", &Visit::count),
+                                           primary_key(&Visit::userId, &Visit::day)));
+    storage.sync_schema();
+    std::vector<User> users;
+    for(auto i = 1; i <= 10; ++i) {
+        users.push_back({i, "user" + std::to_string(i)});
+        storage.replace(users.back());
+        storage.replace(Visit{i, i * 10, i * 100});
+    }
+    
+    for(auto &user : users) {
+        user.name = "renamed" + std::to_string(user.id);
+    }
+    storage.update_range(users.begin(), users.end());
+    assert(storage.get<User>(7).name == "renamed7");
+    assert(storage.count<User>(where(like(&User::name, "renamed%"))) == 10);
+    
+    //  second update violates unique constraint so the whole range is rolled back
+    std::vector<User> conflicting = {{1, "first"}, {2, "first"}};
+    try{
+        storage.update_range(conflicting.begin(), conflicting.end());
+        assert(false);
+    }catch(const std::system_error &){
+        //..
+    }
+    assert(storage.get<User>(1).name == "renamed1");
+    
+    std::vector<int> ids = {2, 4, 42, 6};
+    storage.remove_range<User>(ids.begin(), ids.end());
+    assert(storage.count<User>() == 7);
+    assert(!storage.get_no_throw<User>(4));
+    
+    std::vector<std::tuple<int, int>> visitIds = {std::make_tuple(3, 30), std::make_tuple(4, 41), std::make_tuple(5, 50)};
+    storage.remove_range<Visit>(visitIds.begin(), visitIds.end());
+    assert(storage.count<Visit>() == 8);
+    
+    //  range joins the current transaction
+    storage.transaction([&] {
+        std::vector<int> transactionIds = {7, 8};
+        storage.remove_range<User>(transactionIds.begin(), transactionIds.end());
+        assert(storage.count<User>() == 5);
+        return false;
+    });
+    assert(storage.count<User>() == 7);
+    
+    std::vector<int> noIds;
+    storage.remove_range<User>(noIds.begin(), noIds.end());
+    assert(storage.count<User>() == 7);
+}
+
+void testInCondition() {
+    cout << __func__ << endl;
+    
+    struct User {
+        int id;
+        std::string name;
+    };
+    
+    auto filename = "in_condition.sqlite";
+    ::remove(filename);
+    auto storage = make_storage(filename,
+                                make_table("users",
+                                           make_column("id", &User::id, primary_key()),
+                                           make_column("name", &User::name)));
+    storage.sync_schema();
+    storage.transaction([&] {
+        for(auto i = 1; i <= 100; ++i) {
+            storage.replace(User{i, "user" + std::to_string(i)});
+        }
+        return true;
+    });
+    
+    std::vector<int> manyIds;
+    for(auto i = 0; i < 10000; ++i) {
+        manyIds.push_back(i * 2);
+    }
+    
+    //  sql() executes nothing so values are written into query text
+    auto fewIdsQuery = storage.sql(get_all<User>(where(in(&User::id, {1, 2, 3}))));
+    assert(fewIdsQuery.find("_sqlite_orm_in") == std::string::npos);
+    assert(fewIdsQuery.find(" 3 )") != std::string::npos);
+    
+    //  every operation opens its own connection here so values are put into its temp table
+    assert(storage.get_all<User>(where(in(&User::id, manyIds))).size() == 50);
+    assert(storage.count<User>(where(not in(&User::id, manyIds))) == 50);
+    assert(storage.select(&User::id, where(in(&User::id, manyIds))).size() == 50);
+    auto names = storage.get_all<User>(where(in(&User::name, {"user3", "user4", "nobody"}) and in(&User::id, {3, 5})));
+    assert(names.size() == 1);
+    assert(names.front().id == 3);
+    
+    storage.begin_transaction();
+    storage.remove_all<User>(where(in(&User::id, {1, 2, 3})));
+    assert(storage.count<User>() == 97);
+    storage.rollback();
+    assert(storage.count<User>() == 100);
+    
+    //  temp table of an alive view is not reused by other statements of the same connection
+    storage.open_forever();
+    auto withMissingIds = [](std::vector<int> ids) {
+        for(auto i = 1000; i < 1200; ++i) {
+            ids.push_back(i);
+        }
+        return ids;
+    };
+    auto view = storage.iterate<User>(where(in(&User::id, withMissingIds({1, 2}))));
+    assert(storage.get_all<User>(where(in(&User::id, withMissingIds({5})))).size() == 1);
+    std::vector<int> viewIds;
+    for(auto &user : view) {
+        viewIds.push_back(user.id);
+        assert(storage.count<User>(where(in(&User::id, withMissingIds({7, 8, 9})))) == 3);
+    }
+    assert((viewIds == std::vector<int>{1, 2}));
+    ::remove(filename);
+}
+
+void testGetAllByIds() {
+    cout << __func__ << endl;
+    
+    struct User {
+        int id;
+        std::string name;
+    };
+    
+    struct Visit {
+        int userId;
+        int day;
+        int count;
+    };
+    
+    auto storage = make_storage("",
+                                make_table("users",
+                                           make_column("id", &User::id, primary_key()),
+                                           make_column("name", &User::name)),
+                                make_table("visits",
+                                           make_column("user_id", &Visit::userId),
+                                           make_column("day", &Visit::day),
+                                           make_column("count", &Visit::count),
+                                           primary_key(&Visit::userId, &Visit::day)));
+    storage.sync_schema();
+    for(auto i = 1; i <= 10; ++i) {
+        storage.replace(User{i, "user" + std::to_string(i)});
+        storage.replace(Visit{i, i * 10, i * 100});
+    }
+    
+    //  small limit splits ids in several statements
+    storage.limit.variable_number(3);
+    
+    std::vector<int> ids = {7, 2, 42, 9, 2, 1, 5};
+    auto users = storage.get_all_by_ids<User>(ids.begin(), ids.end());
+    assert(users.size() == 6);
+    std::vector<int> expectedIds = {7, 2, 9, 2, 1, 5};
+    for(size_t i = 0; i < users.size(); ++i) {
+        assert(users[i].id == expectedIds[i]);
+        assert(users[i].name == "user" + std::to_string(expectedIds[i]));
+    }
+    
+    auto usersMap = storage.get_map<User>(ids);
+    assert(usersMap.size() == 5);
+    assert(usersMap.count(42) == 0);
+    assert(usersMap.at(9).name == "user9");
+    
+    std::vector<int> noIds;
+    assert(storage.get_all_by_ids<User>(noIds.begin(), noIds.end()).empty());
+    
+    std::vector<std::tuple<int, int>> visitIds = {std::make_tuple(3, 30), std::make_tuple(4, 41), std::make_tuple(1, 10), std::make_tuple(8, 80)};
+    auto visits = storage.get_all_by_ids<Visit>(visitIds.begin(), visitIds.end());
+    assert(visits.size() == 3);
+    assert(visits[0].userId == 3 && visits[0].count == 300);
+    assert(visits[1].userId == 1 && visits[1].count == 100);
+    assert(visits[2].userId == 8 && visits[2].count == 800);
+    
+    auto visitsMap = storage.get_map<Visit>(visitIds);
+    assert(visitsMap.size() == 3);
+    assert(visitsMap.at(std::make_tuple(8, 80)).count == 800);
+    
+    //  composite ids count exceeds expression depth limit
+    storage.limit.variable_number(10000);
+    std::vector<std::tuple<int, int>> manyVisitIds;
+    storage.transaction([&] {
+        for(auto i = 1; i <= 2000; ++i) {
+            storage.replace(Visit{i, i * 10, i * 100});
+            manyVisitIds.push_back(std::make_tuple(i, i * 10));
+        }
+        return true;
+    });
+    auto manyVisits = storage.get_all_by_ids<Visit>(manyVisitIds.begin(), manyVisitIds.end());
+    assert(manyVisits.size() == 2000);
+    assert(manyVisits.back().userId == 2000 && manyVisits.back().count == 200000);
+}
+
+void testStorageInterface() {
+    cout << __func__ << endl;
+    
+    struct User {
+        int id;
+        std::string name;
+    };
+    
+    auto storage = make_storage("",
+                                make_table("users",
+                                           make_column("id", &User::id, primary_key()),
+                                           make_column("name", &User::name)));
+    auto db = make_storage_interface(storage);
+    auto users = make_repository<User>(storage);
+    
+    //  calls are made through base references just like in a translation unit with the light header only
+    storage_interface &dbInterface = *db;
+    repository<User> &usersRepository = *users;
+    auto syncSchemaResult = dbInterface.sync_schema();
+    assert(syncSchemaResult.at("users") == sync_schema_result::new_table_created);
+    assert(dbInterface.table_exists("users"));
+    
+    auto aliceId = usersRepository.insert(User{0, "Alice"});
+    usersRepository.insert_range({User{0, "Bob"}, User{0, "Carl"}});
+    assert(usersRepository.count() == 3);
+    
+    auto alice = usersRepository.get(aliceId);
+    assert(alice.name == "Alice");
+    alice.name = "Alicia";
+    usersRepository.update(alice);
+    assert(usersRepository.get(aliceId).name == "Alicia");
+    
+    usersRepository.remove(aliceId);
+    assert(!usersRepository.get_no_throw(aliceId));
+    try{
+        usersRepository.get(aliceId);
+        assert(0);
+    }catch(const std::system_error &e) {
+        assert(e.code() == std::make_error_code(orm_error_code::not_found));
+    }
+    
+    dbInterface.transaction([&] {
+        usersRepository.remove_all();
+        return false;
+    });
+    assert(usersRepository.get_all().size() == 2);
+    
+    usersRepository.replace(User{10, "Dan"});
+    assert(usersRepository.get(10).name == "Dan");
+    
+    dbInterface.drop_table("users");
+    assert(!dbInterface.table_exists("users"));
+}
+
+void testWorkloadRecording() {
+    cout << __func__ << endl;
+    
+    struct User {
+        int id;
+        std::string name;
+    };
+    
+    auto storage = make_storage("",
+                                make_table("users",
+                                           make_column("id", &User::id, primary_key()),
+                                           make_column("name", &User::name)));
+    storage.sync_schema();
+    auto logPath = "workload.log";
+    storage.start_recording(logPath);
+    storage.insert(User{0, "Alice"});
+    storage.insert(User{0, "Bob"});
+    storage.get<User>(1);
+    storage.get<User>(1);
+    storage.stop_recording();
+    storage.get_all<User>();
+    
+    auto records = read_workload(logPath);
+    assert(records.size() == 4);
+    assert(records[0].sql.find("INSERT INTO 'users'") == 0);
+    assert(records[0].sql.find("'Alice'") != std::string::npos);
+    assert(records[1].sql.find("'Bob'") != std::string::npos);
+    assert(records[2].sql == records[3].sql);
+    assert(records[2].sql.find("= 1") != std::string::npos);
+    
+    //  statement text is stored once, bound values are stored per execution
+    assert(records[0].prepared_sql == records[1].prepared_sql);
+    assert(records[0].prepared_sql.find("'Alice'") == std::string::npos);
+    assert(records[0].prepared_sql.find("?") != std::string::npos);
+    for(size_t i = 1; i < records.size(); ++i) {
+        assert(records[i].offset >= records[i - 1].offset);
+    }
+    
+    //  replay against an empty copy reproduces the data
+    sqlite3 *db;
+    sqlite3_open(":memory:", &db);
+    auto rc = sqlite3_exec(db, "CREATE TABLE users (id INTEGER PRIMARY KEY NOT NULL, name TEXT NOT NULL)", nullptr, nullptr, nullptr);
+    assert(rc == SQLITE_OK);
+    for(auto &record : records) {
+        rc = sqlite3_exec(db, record.sql.c_str(), nullptr, nullptr, nullptr);
+        assert(rc == SQLITE_OK);
+    }
+    sqlite3_stmt *stmt;
+    sqlite3_prepare_v2(db, "SELECT COUNT(*) FROM users", -1, &stmt, nullptr);
+    assert(sqlite3_step(stmt) == SQLITE_ROW);
+    assert(sqlite3_column_int(stmt, 0) == 2);
+    sqlite3_finalize(stmt);
+    sqlite3_close(db);
+    
+    try{
+        read_workload("missing_workload.log");
+        assert(0);
+    }catch(const std::system_error &e) {
+        assert(e.code().category() == std::generic_category());
+    }
+    {
+        std::ofstream file("not_workload.log");
+        file << "hello";
+    }
+    try{
+        read_workload("not_workload.log");
+        assert(0);
+    }catch(const std::system_error &e) {
+        assert(e.code() == std::make_error_code(orm_error_code::incorrect_workload_log));
+    }
+    
+    //  text length bigger than the file
+    {
+        std::ofstream file("corrupted_workload.log", std::ios::binary);
+        file << "SQLORMW2";
+        file.put(0);
+        file.put(0);
+        for(auto i = 0; i < 8; ++i) {
+            file.put(char(0xff));
+        }
+        file.put(0x7f);
+    }
+    try{
+        read_workload("corrupted_workload.log");
+        assert(0);
+    }catch(const std::system_error &e) {
+        assert(e.code() == std::make_error_code(orm_error_code::incorrect_workload_log));
+    }
+    
+    //  every truncation of a valid log is either read partially or reported as corrupted
+    std::string logContent;
+    {
+        std::ifstream file(logPath, std::ios::binary);
+        logContent.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+    for(size_t length = 0; length < logContent.length(); ++length) {
+        {
+            std::ofstream file("corrupted_workload.log", std::ios::binary | std::ios::trunc);
+            file.write(logContent.data(), length);
+        }
+        try{
+            assert(read_workload("corrupted_workload.log").size() <= records.size());
+        }catch(const std::system_error &e) {
+            assert(e.code() == std::make_error_code(orm_error_code::incorrect_workload_log));
+        }
+    }
+    ::remove(logPath);
+    ::remove("not_workload.log");
+    ::remove("corrupted_workload.log");
+}
+
+void testInstrumentation() {
+    cout << __func__ << endl;
+    
+    struct User {
+        int id;
+        std::string name;
+    };
+    
+    auto storage = make_instrumented_storage<latency_instrumentation>("",
+                                                                      make_table("users",
+                                                                                 make_column("id", &User::id, primary_key()),
+                                                                                 make_column("name", &User::name)));
+    storage.sync_schema();
+    assert(storage.instrumentation().snapshot().empty());
+    
+    storage.insert(User{0, "Alice"});
+    storage.insert(User{0, "Bob"});
+    std::vector<User> users = {User{0, "Carl"}, User{0, "Dan"}};
+    storage.insert_range(users.begin(), users.end());
+    storage.get<User>(1);
+    storage.get_all<User>();
+    storage.select(&User::name);
+    storage.update(User{1, "Alice Smith"});
+    storage.remove<User>(2);
+    storage.transaction([&storage] {
+        storage.insert(User{0, "Eve"});
+        return true;
+    });
+    
+    auto snapshot = storage.instrumentation().snapshot();
+    auto find = [&snapshot](const std::string &operation) {
+        return std::find_if(snapshot.begin(), snapshot.end(), [&operation](const operation_latency &l) {
+            return l.operation == operation;
+        });
+    };
+    for(auto operation : {"get", "get_all", "insert", "insert_range", "update", "remove", "select", "transaction"}) {
+        assert(find(operation) != snapshot.end());
+    }
+    auto insert = find("insert");
+    assert(insert->calls == 3);
+    assert(insert->latency.max >= insert->latency.p50);
+    assert(insert->latency.total >= insert->latency.max);
+    assert(insert->latency.total >= (*insert)[instrumentation_phase::step].total);
+    assert((*insert)[instrumentation_phase::hydrate].total.count() == 0);
+    auto getAll = find("get_all");
+    assert(getAll->calls == 1);
+    assert((*getAll)[instrumentation_phase::hydrate].total.count() > 0);
+    assert((*getAll)[instrumentation_phase::bind].total.count() == 0);
+    
+    //  copies share collected data
+    auto storageCopy = storage;
+    storageCopy.get_all<User>();
+    snapshot = storage.instrumentation().snapshot();
+    assert(find("get_all")->calls == 2);
+    
+    storage.instrumentation().reset();
+    assert(storage.instrumentation().snapshot().empty());
+}
+
+void testStats() {
+    cout << __func__ << endl;
+    
+    struct User {
+        int id;
+        std::string name;
+    };
+    
+    auto filename = "stats.sqlite";
+    ::remove(filename);
+    auto storage = make_storage(filename,
+                                make_table("users",
+                                           make_column("id", &User::id, primary_key()),
+                                           make_column("name", &User::name)));
+    storage.sync_schema();
+    
+    //  connection per call
+    auto stats = storage.stats();
+    assert(stats.connections.empty());
+    
+    //  global values are zero if SQLite is built with SQLITE_DEFAULT_MEMSTATUS=0
+    assert(stats.memory_highwater >= stats.memory_used);
+    
+    storage.open_forever();
+    for(auto i = 0; i < 10; ++i) {
+        storage.insert(User{0, "User" + std::to_string(i)});
+    }
+    storage.get_all<User>();
+    storage.get_all<User>();
+    stats = storage.stats(true);
+    assert(stats.connections.size() == 1);
+    auto &connectionStats = stats.connections.front();
+    assert(connectionStats.cache_used > 0);
+    assert(connectionStats.schema_used > 0);
+    assert(connectionStats.cache_hit > 0);
+    assert(connectionStats.cache_write > 0);
+    
+    //  counters are reset
+    auto nextStats = storage.stats();
+    assert(nextStats.connections.front().cache_hit == 0);
+    assert(nextStats.connections.front().cache_write == 0);
+}
+
+void testExplain() {
+    cout << __func__ << endl;
+    
+    struct User {
+        int id;
+        std::string name;
+        std::string email;
+    };
+    
+    auto storage = make_storage("",
+                                make_index("idx_users_email", &User::email),
+                                make_table("users",
+                                           make_column("id", &User::id, primary_key()),
+                                           make_column("name", &User::name),
+                                           make_column("email", &User::email)));
+    storage.sync_schema();
+    storage.insert(User{0, "Alice", "alice@example.com"});
+    
+    //  sql returns the same query get_all executes
+    auto query = storage.sql(get_all<User>(where(c(&User::name) == "Alice")));
+    assert(query.find("SELECT 'users'.\"id\", 'users'.\"name\", 'users'.\"email\" FROM 'users'") == 0);
+    assert(query.find("WHERE") != std::string::npos);
+    assert(storage.sql(get_all<User>()).find("WHERE") == std::string::npos);
+    assert(storage.sql(count<User>()).find("SELECT COUNT(*) FROM 'users'") == 0);
+    assert(storage.sql(select(&User::name, where(c(&User::id) == 1))).find("SELECT") == 0);
+    
+    auto scanPlan = storage.explain(get_all<User>(where(c(&User::name) == "Alice")));
+    assert(!scanPlan.nodes.empty());
+    assert(scanPlan.scans("users"));
+    assert(!scanPlan.scans("user"));
+    assert(!scanPlan.to_string().empty());
+    
+    auto searchPlan = storage.explain(get_all<User>(where(c(&User::email) == "alice@example.com")));
+    assert(!searchPlan.scans("users"));
+    assert(searchPlan.to_string().find("idx_users_email") != std::string::npos);
+    assert(!storage.explain(select(&User::name, where(c(&User::id) == 1))).scans("users"));
+    assert(storage.explain(count<User>(where(c(&User::name) == "Bob"))).scans("users"));
+    
+    //  queries which don't scan a large table pass the debug check
+    storage.mark_large_table<User>();
+    assert(storage.get_all<User>(where(c(&User::email) == "alice@example.com")).size() == 1);
+    assert(storage.select(&User::name, where(c(&User::id) == 1)).size() == 1);
+    storage.mark_large_table<User>(false);
+    assert(storage.count<User>(where(c(&User::name) == "Bob")) == 0);
+}
+
+void testStatementStats() {
+    cout << __func__ << endl;
+    
+    struct User {
+        int id;
+        std::string name;
+    };
+    
+    auto storage = make_storage("",
+                                make_table("users",
+                                           make_column("id", &User::id, primary_key()),
+                                           make_column("name", &User::name)));
+    storage.sync_schema();
+    storage.enable_statement_stats();
+    for(auto i = 0; i < 10; ++i) {
+        storage.insert(User{0, "User" + std::to_string(i)});
+    }
+    storage.get<User>(5);
+    storage.get_all<User>(where(c(&User::name) == "User3"));
+    storage.get_all<User>(order_by(&User::name));
+    
+    auto inserts = storage.statement_stats<User>("insert");
+    assert(inserts.calls == 10);
+    assert(inserts.fullscan_steps == 0);
+    
+    auto get = storage.statement_stats<User>("get");
+    assert(get.calls == 1);
+    assert(get.fullscan_steps == 0);
+    assert(get.sorts == 0);
+    
+    //  filter by a column without index scans the whole table, order by it sorts
+    auto getAll = storage.statement_stats<User>("get_all");
+    assert(getAll.calls == 2);
+    assert(getAll.fullscan_steps >= 10);
+    assert(getAll.sorts == 1);
+    assert(getAll.vm_steps > 0);
+    
+    auto all = storage.statement_stats<User>();
+    assert(all.calls == 13);
+    assert(storage.statement_stats().total().calls == 13);
+    
+    storage.reset_statement_stats();
+    storage.enable_statement_stats(false);
+    storage.get_all<User>();
+    assert(storage.statement_stats().entries.empty());
+}
+
+void testSlowQueryLog() {
+    cout << __func__ << endl;
+    
+    struct User {
+        int id;
+        std::string name;
+    };
+    
+    auto storage = make_storage("",
+                                make_table("users",
+                                           make_column("id", &User::id, primary_key()),
+                                           make_column("name", &User::name)));
+    storage.sync_schema();
+    storage.enable_slow_query_log(std::chrono::nanoseconds::zero(), {}, 2);
+    storage.insert(User{0, "Alice"});
+    auto records = storage.slow_queries();
+    assert(records.size() == 1);
+    assert(records.front().operation == "insert");
+    assert(records.front().table_name == "users");
+    assert(records.front().sql.find("?") != std::string::npos);
+    assert(records.front().expanded_sql.find("'Alice'") != std::string::npos);
+    
+    storage.get_all<User>();
+    storage.select(&User::name);
+    records = storage.slow_queries();
+    
+    //  capacity is 2 so insert record is evicted
+    assert(records.size() == 2);
+    assert(records[0].operation == "get_all");
+    assert(records[0].table_name == "users");
+    assert(records[1].operation == "select");
+    assert(records[1].table_name.empty());
+    
+    std::vector<slow_query> sinkRecords;
+    storage.enable_slow_query_log(std::chrono::nanoseconds::zero(), [&sinkRecords](const slow_query &record){
+        sinkRecords.push_back(record);
+    });
+    storage.count<User>();
+    assert(sinkRecords.size() == 1);
+    assert(sinkRecords.front().operation == "count");
+    assert(storage.slow_queries().size() == 2);
+    
+    storage.enable_slow_query_log(std::chrono::hours(1));
+    storage.get_all<User>();
+    assert(sinkRecords.size() == 1);
+    assert(storage.slow_queries().size() == 2);
+    
+    storage.enable_slow_query_log(std::chrono::nanoseconds::zero(), [&sinkRecords](const slow_query &record){
+        sinkRecords.push_back(record);
+    });
+    storage.disable_slow_query_log();
+    storage.get_all<User>();
+    assert(sinkRecords.size() == 1);
+}
+
+void testProfiling() {
+    cout << __func__ << endl;
+    
+    struct User {
+        int id;
+        std::string name;
+    };
+    
+    auto storage = make_storage("",
+                                make_table("users",
+                                           make_column("id", &User::id, primary_key()),
+                                           make_column("name", &User::name)));
+    storage.sync_schema();
+    assert(storage.profile_snapshot().empty());
+    
+    storage.enable_profiling();
+    storage.insert(User{0, "Alice"});
+    storage.insert(User{0, "Bob"});
+    storage.insert(User{0, "Carl"});
+    storage.get_all<User>();
+    storage.get_all<User>();
+    storage.get_all<User>(where(c(&User::id) == 1));
+    storage.get_all<User>(where(c(&User::id) == 2 and c(&User::name) == "Bob"));
+    storage.get_all<User>(where(c(&User::id) == 3 and c(&User::name) == "Carl"));
+    
+    //  long lists are bound into a temp table
+    std::vector<int> manyIds(200, 1);
+    storage.get_all<User>(where(in(&User::id, manyIds)));
+    manyIds.resize(300, 2);
+    storage.get_all<User>(where(in(&User::id, manyIds)));
+    
+    auto profiles = storage.profile_snapshot(100);
+    auto findProfile = [&profiles](const std::string &suffix) {
+        return std::find_if(profiles.begin(), profiles.end(), [&suffix](const query_profile &p){
+            return p.sql.find("SELECT") == 0 && p.sql.length() >= suffix.length() && p.sql.compare(p.sql.length() - suffix.length(), suffix.length(), suffix) == 0;
+        });
+    };
+    auto getAll = findProfile("FROM 'users'");
+    assert(getAll != profiles.end());
+    assert(getAll->calls == 2);
+    assert(getAll->rows == 6);
+    assert(getAll->p50 <= getAll->max);
+    assert(getAll->p99 >= getAll->p50);
+    assert(getAll->total >= getAll->max);
+    
+    //  statements differing by inlined values only are aggregated
+    auto withTwoConditions = findProfile("AND ('users'.\"name\" = ?) )");
+    assert(withTwoConditions != profiles.end());
+    assert(withTwoConditions->calls == 2);
+    assert(withTwoConditions->rows == 2);
+    auto withIn = findProfile("IN temp.\"_sqlite_orm_in_0\")");
+    assert(withIn != profiles.end());
+    assert(withIn->calls == 2);
+    
+    auto top = storage.profile_snapshot(1);
+    assert(top.size() == 1);
+    assert(top.front().total >= profiles.back().total);
+    
+    storage.reset_profiling();
+    assert(storage.profile_snapshot().empty());
+    storage.enable_profiling(false);
+    storage.get_all<User>();
+    assert(storage.profile_snapshot().empty());
+}
+
+void testIndexDrift() {
+    cout << __func__ << endl;
+    
+    struct User {
+        int id;
+        std::string name;
+        std::string email;
+        int status = 0;
+    };
+    
+    auto filename = "index_drift.sqlite";
+    remove(filename);
+    {
+        auto storage = make_storage(filename,
+                                    make_index("idx_users_name", &User::name),
+                                    make_index("idx_users_email", &User::email),
+                                    make_table("users",
+                                               make_column("id", &User::id, primary_key()),
+                                               make_column("name", &User::name),
+                                               make_column("email", &User::email),
+                                               make_column("status", &User::status)));
+        auto syncResult = storage.sync_schema();
+        assert(syncResult.at("idx_users_name") == sync_schema_result::new_index_created);
+        assert(syncResult.at("idx_users_email") == sync_schema_result::new_index_created);
+        storage.insert(User{0, "Alice", "alice@example.com", 1});
+    }
+    auto storage = make_storage(filename,
+                                make_unique_index("idx_users_name", &User::name),
+                                make_index("idx_users_status", &User::status),
+                                make_table("users",
+                                           make_column("id", &User::id, primary_key()),
+                                           make_column("name", &User::name),
+                                           make_column("email", &User::email),
+                                           make_column("status", &User::status)));
+    auto simulated = storage.sync_schema_simulate();
+    assert(simulated.at("users") == sync_schema_result::already_in_sync);
+    assert(simulated.at("idx_users_name") == sync_schema_result::index_recreated);
+    assert(simulated.at("idx_users_email") == sync_schema_result::index_dropped);
+    assert(simulated.at("idx_users_status") == sync_schema_result::new_index_created);
+    assert(storage.sync_schema() == simulated);
+    
+    auto syncResult = storage.sync_schema();
+    assert(syncResult.size() == 3);
+    assert(syncResult.at("idx_users_name") == sync_schema_result::already_in_sync);
+    assert(syncResult.at("idx_users_status") == sync_schema_result::already_in_sync);
+    
+    //  index is unique now
+    try{
+        storage.insert(User{0, "Alice", "alice2@example.com", 0});
+        assert(false);
+    }catch(std::system_error &){
+        //  ok
+    }
+    storage.reindex("idx_users_name");
+    storage.reindex();
+    assert(storage.count<User>() == 1);
+}
+
+void testIndexExpressions() {
+    cout << __func__ << endl;
+    
+    struct User {
+        int id;
+        std::string name;
+        std::string email;
+        int status = 0;
+    };
+    
+    auto filename = "index_expressions.sqlite";
+    remove(filename);
+    auto storage = make_storage(filename,
+                                make_index("idx_users_email_lower", lower(&User::email)),
+                                make_index("idx_users_active_name", &User::name, where(c(&User::status) == 1)),
+                                make_index("idx_users_name_id", order_by(&User::name).collate_nocase().desc(), &User::id),
+                                make_table("users",
+                                           make_column("id", &User::id, primary_key()),
+                                           make_column("name", &User::name),
+                                           make_column("email", &User::email),
+                                           make_column("status", &User::status)));
+    storage.sync_schema();
+    storage.insert(User{0, "Alice", "Alice@Example.com", 1});
+    storage.insert(User{0, "Bob", "bob@example.com", 0});
+    
+    auto indexSql = [filename](const std::string &indexName) {
+        sqlite3 *db;
+        sqlite3_open(filename, &db);
+        sqlite3_stmt *stmt;
+        sqlite3_prepare_v2(db, "SELECT sql FROM sqlite_master WHERE type = 'index' AND name = ?", -1, &stmt, nullptr);
+        sqlite3_bind_text(stmt, 1, indexName.c_str(), -1, SQLITE_TRANSIENT);
+        std::string res;
+        if(sqlite3_step(stmt) == SQLITE_ROW) {
+            res = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
+        }
+        sqlite3_finalize(stmt);
+        sqlite3_close(db);
+        return res;
+    };
+    assert(indexSql("idx_users_email_lower").find("LOWER(\"email\")") != std::string::npos);
+    auto partialSql = indexSql("idx_users_active_name");
+    assert(partialSql.find("WHERE") != std::string::npos);
+    assert(partialSql.find("\"status\" = 1") != std::string::npos);
+    auto orderedSql = indexSql("idx_users_name_id");
+    assert(orderedSql.find("\"name\" COLLATE NOCASE DESC ,") != std::string::npos);
+    assert(orderedSql.find("\"name\"") < orderedSql.find("\"id\""));
+    
+    auto users = storage.get_all<User>(where(lower(&User::email) == "alice@example.com"));
+    assert(users.size() == 1);
+    assert(storage.sync_schema().at("idx_users_active_name") == sync_schema_result::already_in_sync);
+    
+    //  index cannot span several tables
+    struct Visit {
+        int id;
+        int userId;
+    };
+    auto wrongStorage = make_storage("",
+                                     make_index("idx_users_visits", &User::name, &Visit::userId),
+                                     make_table("users",
+                                                make_column("id", &User::id, primary_key()),
+                                                make_column("name", &User::name),
+                                                make_column("email", &User::email),
+                                                make_column("status", &User::status)),
+                                     make_table("visits",
+                                                make_column("id", &Visit::id, primary_key()),
+                                                make_column("user_id", &Visit::userId)));
+    try{
+        wrongStorage.sync_schema();
+        assert(false);
+    }catch(const std::system_error &e){
+        assert(e.code() == std::make_error_code(orm_error_code::too_many_tables_specified));
+    }
+}
+
+void testOnlineMigration() {
+    cout << __func__ << endl;
+    
+    struct User {
+        int id;
+        std::string name;
+        std::string email;
+    };
+    
+    auto filename = "online_migration.sqlite";
+    remove(filename);
+    auto makeOldStorage = [filename]{
+        return make_storage(filename,
+                            make_table("users",
+                                       make_column("id", &User::id, primary_key()),
+                                       make_column("name", &User::name),
+                                       make_column("email", &User::email, unique())));
+    };
+    auto oldStorage = makeOldStorage();
+    oldStorage.sync_schema();
+    for(auto i = 0; i < 10; ++i) {
+        oldStorage.insert(User{0, "user" + std::to_string(i + 1), "email" + std::to_string(i + 1)});
+    }
+    
+    //  `email` is UNIQUE so table is rebuilt
+    auto storage = make_storage(filename,
+                                make_table("users",
+                                           make_column("id", &User::id, primary_key()),
+                                           make_column("name", &User::name)));
+    std::vector<migration_progress> progresses;
+    storage.enable_online_migration(3, [&progresses, &oldStorage](const migration_progress &progress){
+        if(progresses.empty()) {
+            
+            //  other connection changes already copied and not yet copied rows between chunks
+            oldStorage.remove<User>(1);
+            oldStorage.update(User{2, "updated", "email2"});
+            oldStorage.insert(User{0, "inserted", "email11"});
+        }
+        progresses.push_back(progress);
+    });
+    assert(storage.sync_schema(true).at("users") == sync_schema_result::old_columns_removed);
+    
+    assert(progresses.size() == 4);
+    assert(progresses.front().table_name == "users");
+    assert(progresses.front().rows_copied == 3);
+    assert(progresses.front().rows_total == 10);
+    assert(progresses.back().rows_copied == 11);
+    assert(progresses.back().eta.count() == 0);
+    
+    assert(storage.count<User>() == 10);
+    assert(!storage.get_no_throw<User>(1));
+    assert(storage.get<User>(2).name == "updated");
+    assert(storage.get<User>(11).name == "inserted");
+    assert(storage.table_names().size() == 1);
+    
+    //  triggers are dropped with source table
+    storage.insert(User{0, "after", ""});
+    assert(storage.count<User>() == 11);
+}
+
+void testOnlineMigrationFailure() {
+    cout << __func__ << endl;
+    
+    struct Item {
+        std::string code;
+        std::string name;
+        std::string barcode;
+    };
+    
+    auto filename = "online_migration_failure.sqlite";
+    remove(filename);
+    auto oldStorage = make_storage(filename,
+                                   make_table("items",
+                                              make_column("code", &Item::code, primary_key()),
+                                              make_column("name", &Item::name),
+                                              make_column("barcode", &Item::barcode, unique())));
+    oldStorage.sync_schema();
+    for(auto i = 0; i < 10; ++i) {
+        oldStorage.replace(Item{"code" + std::to_string(i), "item" + std::to_string(i), "barcode" + std::to_string(i)});
+    }
+    
+    //  progress callback fails after the first chunk
+    auto storage = make_storage(filename,
+                                make_table("items",
+                                           make_column("code", &Item::code, primary_key()),
+                                           make_column("name", &Item::name)));
+    storage.enable_online_migration(3, [](const migration_progress &){
+        throw std::runtime_error("cancelled");
+    });
+    try{
+        storage.sync_schema(true);
+        assert(false);
+    }catch(const std::runtime_error &){
+        //..
+    }
+    assert(oldStorage.table_names().size() == 1);
+    oldStorage.replace(Item{"code10", "item10", "barcode10"});
+    assert(oldStorage.count<Item>() == 11);
+    
+    //  WITHOUT ROWID table has no rowid to copy chunks by so it is copied at once
+    oldStorage.drop_table("items");
+    auto oldWithoutRowidStorage = make_storage(filename,
+                                               make_table("items",
+                                                          make_column("code", &Item::code, primary_key()),
+                                                          make_column("name", &Item::name),
+                                                          make_column("barcode", &Item::barcode, unique())).without_rowid());
+    oldWithoutRowidStorage.sync_schema();
+    for(auto i = 0; i < 10; ++i) {
+        oldWithoutRowidStorage.replace(Item{"code" + std::to_string(i), "item" + std::to_string(i), "barcode" + std::to_string(i)});
+    }
+    auto withoutRowidStorage = make_storage(filename,
+                                            make_table("items",
+                                                       make_column("code", &Item::code, primary_key()),
+                                                       make_column("name", &Item::name)).without_rowid());
+    withoutRowidStorage.enable_online_migration(3);
+    assert(withoutRowidStorage.sync_schema(true).at("items") == sync_schema_result::old_columns_removed);
+    assert(withoutRowidStorage.count<Item>() == 10);
+    assert(withoutRowidStorage.table_names().size() == 1);
+    withoutRowidStorage.replace(Item{"code10", "item10", ""});
+    assert(withoutRowidStorage.get<Item>("code10").name == "item10");
+}
+
+void testSyncSchemaDropColumn() {
+    cout << __func__ << endl;
+    
+    struct User {
+        int id;
+        std::string name;
+        int age = 0;
+        std::string email;
+        std::string nickname;
+    };
+    
+    auto filename = "drop_column.sqlite";
+    remove(filename);
+    auto indexesCount = [filename](const std::string &namePattern){
+        sqlite3 *db;
+        sqlite3_open(filename, &db);
+        sqlite3_stmt *stmt;
+        sqlite3_prepare_v2(db, "SELECT COUNT(*) FROM sqlite_master WHERE type = 'index' AND name LIKE ?", -1, &stmt, nullptr);
+        sqlite3_bind_text(stmt, 1, namePattern.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_step(stmt);
+        auto res = sqlite3_column_int(stmt, 0);
+        sqlite3_finalize(stmt);
+        sqlite3_close(db);
+        return res;
+    };
+    {
+        auto storage = make_storage(filename,
+                                    make_index("idx_users_email", &User::email),
+                                    make_table("users",
+                                               make_column("id", &User::id, primary_key()),
+                                               make_column("name", &User::name),
+                                               make_column("age", &User::age),
+                                               make_column("email", &User::email),
+                                               make_column("nickname", &User::nickname, unique())));
+        storage.sync_schema();
+        storage.insert(User{0, "Alice", 20, "alice@example.com", "alice"});
+        storage.insert(User{0, "Bob", 30, "bob@example.com", "bob"});
+    }
+    {
+        //  `age` is not indexed so it is dropped in place and index on `email` survives
+        auto storage = make_storage(filename,
+                                    make_index("idx_users_email", &User::email),
+                                    make_table("users",
+                                               make_column("id", &User::id, primary_key()),
+                                               make_column("name", &User::name),
+                                               make_column("email", &User::email),
+                                               make_column("nickname", &User::nickname, unique())));
+        assert(storage.sync_schema(true).at("users") == sync_schema_result::old_columns_removed);
+        assert(storage.count<User>() == 2);
+        assert(storage.get<User>(2).email == "bob@example.com");
+        assert(indexesCount("sqlite_autoindex_users_%") == 1);
+    }
+    
+    //  UNIQUE column cannot be dropped in place so table is copied
+    auto storage = make_storage(filename,
+                                make_index("idx_users_email", &User::email),
+                                make_table("users",
+                                           make_column("id", &User::id, primary_key()),
+                                           make_column("name", &User::name),
+                                           make_column("email", &User::email)));
+    assert(storage.sync_schema(true).at("users") == sync_schema_result::old_columns_removed);
+    assert(indexesCount("sqlite_autoindex_users_%") == 0);
+    assert(indexesCount("idx_users_email") == 1);
+    assert(storage.count<User>() == 2);
+    assert(storage.get<User>(1).name == "Alice");
+    assert(storage.sync_schema(true).at("users") == sync_schema_result::already_in_sync);
+}
+
+void testSyncSchemaSeveralTables() {
+    cout << __func__ << endl;
+    
+    struct User {
+        int id;
+        std::string name;
+    };
+    
+    struct Order {
+        int id;
+        int userId;
+        double total = 0;
+    };
+    
+    struct Visit {
+        int id;
+        int userId;
+    };
+    
+    auto filename = "several_tables.sqlite";
+    remove(filename);
+    {
+        auto storage = make_storage(filename,
+                                    make_table("users",
+                                               make_column("id", &User::id, primary_key()),
+                                               make_column("name", &User::name)),
+                                    make_table("orders",
+                                               make_column("id", &Order::id, primary_key()),
+                                               make_column("user_id", &Order::userId)));
+        storage.sync_schema();
+        storage.insert(Order{0, 1});
+    }
+    auto storage = make_storage(filename,
+                                make_table("users",
+                                           make_column("id", &User::id, primary_key()),
+                                           make_column("name", &User::name)),
+                                make_table("orders",
+                                           make_column("id", &Order::id, primary_key()),
+                                           make_column("user_id", &Order::userId),
+                                           make_column("total", &Order::total, default_value(0))),
+                                make_table("visits",
+                                           make_column("id", &Visit::id, primary_key()),
+                                           make_column("user_id", &Visit::userId)));
+    
+    //  every table is resolved against catalog loaded once per call
+    auto simulated = storage.sync_schema_simulate();
+    assert(simulated.at("users") == sync_schema_result::already_in_sync);
+    assert(simulated.at("orders") == sync_schema_result::new_columns_added);
+    assert(simulated.at("visits") == sync_schema_result::new_table_created);
+    assert(storage.sync_schema() == simulated);
+    assert(storage.count<Order>() == 1);
+    
+    auto synced = storage.sync_schema();
+    assert(synced.at("users") == sync_schema_result::already_in_sync);
+    assert(synced.at("orders") == sync_schema_result::already_in_sync);
+    assert(synced.at("visits") == sync_schema_result::already_in_sync);
+}
+
+void testSchemaFingerprint() {
+    cout << __func__ << endl;
+    
+    struct User {
+        int id;
+        std::string name;
+        int age = 0;
+    };
+    
+    auto filename = "fingerprint.sqlite";
+    remove(filename);
+    auto storage = make_storage(filename,
+                                make_index("idx_users_name", &User::name),
+                                make_table("users",
+                                           make_column("id", &User::id, primary_key()),
+                                           make_column("name", &User::name)));
+    storage.enable_schema_fingerprint();
+    
+    auto fingerprint = storage.schema_fingerprint();
+    assert(fingerprint.length() == 16);
+    assert(fingerprint == storage.schema_fingerprint());
+    
+    assert(storage.sync_schema().at("users") == sync_schema_result::new_table_created);
+    assert(storage.table_exists("_sqlite_orm"));
+    assert(storage.sync_schema().at("users") == sync_schema_result::already_in_sync);
+    assert(storage.sync_schema_simulate().at("users") == sync_schema_result::already_in_sync);
+    
+    auto storage2 = make_storage(filename,
+                                 make_index("idx_users_name", &User::name),
+                                 make_table("users",
+                                            make_column("id", &User::id, primary_key()),
+                                            make_column("name", &User::name),
+                                            make_column("age", &User::age, default_value(0))));
+    storage2.enable_schema_fingerprint();
+    assert(storage2.schema_fingerprint() != fingerprint);
+    assert(storage2.sync_schema_simulate().at("users") == sync_schema_result::new_columns_added);
+    assert(storage2.sync_schema().at("users") == sync_schema_result::new_columns_added);
+    assert(storage2.sync_schema().at("users") == sync_schema_result::already_in_sync);
+}
+
+void testTableNames() {
+    cout << __func__ << endl;
+    
+    struct User {
+        int id;
+        std::string name;
+    };
+    
+    auto storage = make_storage("",
+                                make_table("users",
+                                           make_column("id", &User::id, primary_key()),
+                                           make_column("name", &User::name)));
+    assert(storage.table_names().empty());
+    storage.sync_schema();
+    
+    auto tableNames = storage.table_names();
+    assert(tableNames.size() == 1);
+    assert(tableNames.front() == "users");
+    
+    assert(storage.table_exists("users"));
+    assert(!storage.table_exists("users' OR '1' = '1"));
+    
+    //  second sync uses cached introspection statements
+    auto syncResult = storage.sync_schema();
+    assert(syncResult.at("users") == sync_schema_result::already_in_sync);
+}
+
 void testDifferentGettersAndSetters() {
     cout << __func__ << endl;
     
@@ -2199,4 +3659,35 @@ int main(int argc, char **argv) {
     testExplicitColumns();
     
     testDifferentGettersAndSetters();
+    
+    testTableNames();
+    
+    testSchemaFingerprint();
+    
+    testSyncSchemaSeveralTables();
+    
+    testSyncSchemaDropColumn();
+    
+    testOnlineMigration();
+    testOnlineMigrationFailure();
+    
+    testIndexExpressions();
+    
+    testIndexDrift();
+    
+    testProfiling();
+    testSlowQueryLog();
+    testStatementStats();
+    testExplain();
+    testStats();
+    testInstrumentation();
+    testWorkloadRecording();
+    testStorageInterface();
+    testGetAllByIds();
+    testInCondition();
+    testUpdateRemoveRange();
+    testPartialUpdate();
+    testUpdateColumnAndIncrement();
+    testUpsert();
+    testPaginate();
 }